@@ -104,3 +104,79 @@ fragment float4 batch2d_fragment_simple(
     float4 texColor = tex.sample(texSampler, in.uv);
     return in.color * texColor;
 }
+
+// ---------------------------------------------------------------------------
+// Sprite mode (SpriteBatch): one SpriteInstance per sprite, expanded to a quad
+// here instead of four CPU-transformed vertices. Drawn with the batch's quad
+// index buffer (vertex_id 0..3) and firstInstance = the draw's first sprite.
+// ---------------------------------------------------------------------------
+
+// Matches SpriteInstance in sprite_batch.hpp (80 bytes)
+struct SpriteInstance {
+    float4 axes;      // xy = axisX, zw = axisY
+    float4 origin;
+    float4 uvRect;    // u0, v0, u1, v1
+    float4 color;
+    uint textureIndex;
+    int entityID;
+    uint2 _pad;
+};
+
+struct SpriteVertexOut {
+    float4 position [[position]];
+    float4 color;
+    float2 uv;
+    uint textureIndex [[flat]];
+};
+
+// Unit-quad corners in addQuad order (0,1,2 / 2,3,0 indices)
+constant float2 kSpriteCorners[4] = {
+    float2(-0.5, -0.5), float2(0.5, -0.5), float2(0.5, 0.5), float2(-0.5, 0.5)
+};
+
+vertex SpriteVertexOut sprite_vertex(
+    uint vertexID [[vertex_id]],
+    uint instanceID [[instance_id]],
+    device const SpriteInstance* instances [[buffer(0)]],
+    constant Batch2DUniforms& uniforms [[buffer(1)]]
+) {
+    device const SpriteInstance& sprite = instances[instanceID];
+    float2 c = kSpriteCorners[vertexID & 3];
+    float3 position = sprite.origin.xyz + float3(sprite.axes.xy * c.x + sprite.axes.zw * c.y, 0.0);
+
+    SpriteVertexOut out;
+    out.position = uniforms.projectionMatrix * float4(position, 1.0);
+    out.color = sprite.color;
+    out.uv = float2(mix(sprite.uvRect.x, sprite.uvRect.z, c.x + 0.5),
+                    mix(sprite.uvRect.w, sprite.uvRect.y, c.y + 0.5));
+    out.textureIndex = sprite.textureIndex;
+    return out;
+}
+
+// One texture per draw (bound at texture(0))
+fragment float4 sprite_fragment(
+    SpriteVertexOut in [[stage_in]],
+    texture2d<float, access::sample> tex [[texture(0)]]
+) {
+    constexpr sampler texSampler(coord::normalized,
+                                  address::clamp_to_edge,
+                                  filter::linear);
+    return in.color * tex.sample(texSampler, in.uv);
+}
+
+// Bindless: the sprite's texture comes from the argument table at buffer(0),
+// one SpriteTexture per SpriteBatch table slot, so every sprite texture can
+// share a single draw.
+struct SpriteTexture {
+    texture2d<float, access::sample> texture [[id(0)]];
+};
+
+fragment float4 sprite_fragment_bindless(
+    SpriteVertexOut in [[stage_in]],
+    const device SpriteTexture* spriteTextures [[buffer(0)]]
+) {
+    constexpr sampler texSampler(coord::normalized,
+                                  address::clamp_to_edge,
+                                  filter::linear);
+    return in.color * spriteTextures[in.textureIndex].texture.sample(texSampler, in.uv);
+}
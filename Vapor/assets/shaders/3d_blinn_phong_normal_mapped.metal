@@ -55,7 +55,9 @@ fragment half4 fragmentMain(RasterizerData in [[stage_in]], texture2d<float, acc
     constexpr sampler s(address::repeat, filter::linear, mip_filter::linear);
     float3 albedo = texAlbedo.sample(s, in.uv).rgb;
     float3x3 TBN = float3x3(float3(in.worldTangent), float3(in.worldBitangent), float3(in.worldNormal));
-    float3 norm = normalize(TBN * normalize(texNormal.sample(s, in.uv).rgb * 2.0 - 1.0));
+    // xy only (BC5-cooked normal maps); z from the unit length.
+    float2 nxy = texNormal.sample(s, in.uv).rg * 2.0 - 1.0;
+    float3 norm = normalize(TBN * float3(nxy, sqrt(saturate(1.0 - dot(nxy, nxy)))));
     float3 viewDir = normalize(*camPos - in.worldPosition.xyz);
     float3 lightDir = normalize(-lightDirection);
     float3 halfway = normalize(lightDir + viewDir);
@@ -280,6 +280,13 @@ float3 octDecode(float2 e) {
     return normalize(n);
 }
 
+// Tangent-space normal from a normal-map texel. Only xy is read: cooked normal
+// maps are BC5 (two channels), so z is rebuilt from the unit length.
+float3 decodeTangentNormal(float4 texel) {
+    float2 xy = texel.rg * 2.0 - 1.0;
+    return float3(xy, sqrt(saturate(1.0 - dot(xy, xy))));
+}
+
 float3 linearToSRGB(float3 color) {
     // return pow(linear, float3(INV_GAMMA));
     return mix(
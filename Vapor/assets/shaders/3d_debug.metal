@@ -7,6 +7,20 @@ struct DebugVertexIn {
     packed_float4 color;
 };
 
+// Unit primitive vertex (matches Vapor::DebugShapeVertex)
+struct DebugShapeVertexIn {
+    packed_float3 position;
+    float cap;// moved along local Y by the instance's stretch
+};
+
+// Per-instance placement of a unit primitive (matches Vapor::DebugInstance)
+struct DebugInstanceIn {
+    float4x4 transform;
+    float4 color;
+    float stretch;
+    float _pad[3];
+};
+
 // Camera data (same as 3d_common.metal)
 struct CameraData {
     float4x4 proj;
@@ -40,6 +54,26 @@ vertex DebugVertexOut debug_vertex(
     return out;
 }
 
+// Vertex shader for instanced unit primitives (boxes, spheres, capsules, ...)
+vertex DebugVertexOut debug_instance_vertex(
+    uint vertexID [[vertex_id]],
+    uint instanceID [[instance_id]],
+    device const DebugShapeVertexIn* vertices [[buffer(0)]],
+    device const CameraData& camera [[buffer(1)]],
+    device const DebugInstanceIn* instances [[buffer(2)]]
+) {
+    DebugVertexOut out;
+
+    DebugShapeVertexIn v = vertices[vertexID];
+    DebugInstanceIn instance = instances[instanceID];
+    float3 localPos = float3(v.position) + float3(0.0, v.cap * instance.stretch, 0.0);
+    float4 worldPos = instance.transform * float4(localPos, 1.0);
+    out.position = camera.proj * camera.view * worldPos;
+    out.color = instance.color;
+
+    return out;
+}
+
 // Fragment shader - simple pass-through color
 fragment float4 debug_fragment(DebugVertexOut in [[stage_in]]) {
     return in.color;
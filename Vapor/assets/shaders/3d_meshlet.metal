@@ -738,7 +738,7 @@ fragment float4 fragmentMain(MeshletVertexOut in [[stage_in]],
         T = normalize(T - dot(T, N) * N);
         B = normalize(cross(N, T) * in.worldTangent.w);
         float3x3 TBN = float3x3(T, B, N);
-        norm = normalize(TBN * normalize(tex.normal.sample(s, in.uv).rgb * 2.0 - 1.0));
+        norm = normalize(TBN * decodeTangentNormal(tex.normal.sample(s, in.uv)));
     } else {
         float3 up = abs(N.y) < 0.99 ? float3(0.0, 1.0, 0.0) : float3(1.0, 0.0, 0.0);
         T = normalize(cross(up, N));
@@ -299,7 +299,7 @@ fragment float4 fragmentMain(
     T = normalize(T - dot(T, N) * N);
     float3 B    = normalize(cross(N, T) * in.worldTangent.w);
     float3x3 TBN = float3x3(T, B, N);
-    float3 norm  = normalize(TBN * normalize(texNormal.sample(s, in.uv).rgb * 2.0 - 1.0));
+    float3 norm  = normalize(TBN * decodeTangentNormal(texNormal.sample(s, in.uv)));
     float3 viewDir = normalize(camera.position - in.worldPosition.xyz);
     float  NdotV   = max(dot(norm, viewDir), 0.0001);
 
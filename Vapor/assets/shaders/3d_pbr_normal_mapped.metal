@@ -267,7 +267,7 @@ fragment float4 fragmentMain(
         T = normalize(T - dot(T, N) * N);
         B = normalize(cross(N, T) * in.worldTangent.w);
         float3x3 TBN = float3x3(T, B, N);
-        norm = normalize(TBN * normalize(matNormal.sample(s, in.uv).rgb * 2.0 - 1.0));
+        norm = normalize(TBN * decodeTangentNormal(matNormal.sample(s, in.uv)));
     } else {
         // Arbitrary orthonormal basis for the anisotropic BRDF term, which still
         // consumes T/B. Anisotropy defaults to 0, so the exact axis is moot.
@@ -218,7 +218,9 @@ void main() {
         discard;
     }
 
-    vec3 texNorm = texture(normal_map, tex_uv).rgb * 2.0 - 1.0;
+    // xy only: cooked normal maps are BC5, z comes from the unit length.
+    vec2 texNormXY = texture(normal_map, tex_uv).rg * 2.0 - 1.0;
+    vec3 texNorm = vec3(texNormXY, sqrt(clamp(1.0 - dot(texNormXY, texNormXY), 0.0, 1.0)));
     vec3 N = normalize(world_normal.xyz);
     vec3 T = normalize(world_tangent.xyz);
     T = normalize(T - dot(T, N) * N);
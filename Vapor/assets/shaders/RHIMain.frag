@@ -592,7 +592,9 @@ void main() {
     if (dot(T, T) > 1e-8) {
         T = normalize(T - dot(T, N) * N);
         B = cross(N, T) * worldTangent.w;
-        vec3 nSample = texture(normalMap, fragUV).xyz * 2.0 - 1.0;
+        // xy only: cooked normal maps are BC5, z comes from the unit length.
+        vec2 nXY = texture(normalMap, fragUV).xy * 2.0 - 1.0;
+        vec3 nSample = vec3(nXY, sqrt(clamp(1.0 - dot(nXY, nXY), 0.0, 1.0)));
         nSample.xy *= mat.normalScale;
         N = normalize(mat3(T, B, N) * nSample);
     }
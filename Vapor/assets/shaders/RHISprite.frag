@@ -0,0 +1,31 @@
+#version 450
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+// RHI batch renderer, sprite mode — fragment shader.
+// Compiled twice by the asset pipeline: plain (RHISprite.frag.spv, one
+// texture per draw at set2 b0) and with -DBINDLESS (RHISpriteBindless.frag.spv,
+// the sprite's texture fetched from the set-3 table by its SpriteBatch slot,
+// so one draw covers every sprite texture).
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) flat in uint fragTextureIndex;
+
+#ifdef BINDLESS
+layout(set = 3, binding = 0) uniform texture2D bindlessTextures[];
+layout(set = 3, binding = 1) uniform sampler bindlessSampler;
+#else
+layout(set = 2, binding = 0) uniform sampler2D spriteTexture;
+#endif
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+#ifdef BINDLESS
+    vec4 texColor = texture(sampler2D(bindlessTextures[nonuniformEXT(fragTextureIndex)], bindlessSampler), fragUV);
+#else
+    vec4 texColor = texture(spriteTexture, fragUV);
+#endif
+    outColor = fragColor * texColor;
+}
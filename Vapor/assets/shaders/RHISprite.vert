@@ -0,0 +1,47 @@
+#version 450
+// RHI batch renderer, sprite mode (SpriteBatch) — Vulkan backend.
+// One SpriteInstance per sprite, expanded to a quad here; drawn with the
+// batch's quad index buffer (gl_VertexIndex 0..3) and firstInstance = the
+// draw's first sprite (gl_InstanceIndex includes it).
+//   RHI::setVertexBuffer(0, instances)            -> set 0 binding 0
+//   RHI::setVertexBytes(&viewProj, 64, /*binding=*/0) -> push constants [0,64)
+
+// Matches SpriteInstance in sprite_batch.hpp (80 bytes)
+struct SpriteInstance {
+    vec4 axes;      // xy = axisX, zw = axisY
+    vec4 origin;
+    vec4 uvRect;    // u0, v0, u1, v1
+    vec4 color;
+    uint textureIndex;
+    int entityID;
+    uvec2 _pad;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer SpriteInstances {
+    SpriteInstance sprites[];
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 viewProj;
+};
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUV;
+layout(location = 2) flat out uint fragTextureIndex;
+
+// Unit-quad corners in addQuad order (0,1,2 / 2,3,0 indices)
+const vec2 kCorners[4] = vec2[](
+    vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5)
+);
+
+void main() {
+    SpriteInstance sprite = sprites[gl_InstanceIndex];
+    vec2 c = kCorners[gl_VertexIndex & 3];
+    vec3 position = sprite.origin.xyz + vec3(sprite.axes.xy * c.x + sprite.axes.zw * c.y, 0.0);
+
+    gl_Position = viewProj * vec4(position, 1.0);
+    fragColor = sprite.color;
+    fragUV = vec2(mix(sprite.uvRect.x, sprite.uvRect.z, c.x + 0.5),
+                  mix(sprite.uvRect.w, sprite.uvRect.y, c.y + 0.5));
+    fragTextureIndex = sprite.textureIndex;
+}
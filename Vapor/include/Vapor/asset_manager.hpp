@@ -10,6 +10,9 @@ namespace Vapor {
 class AssetManager {
 public:
     static std::shared_ptr<Vapor::Image> loadImage(const std::string& filename);
+    // The decode half of loadImage, for bytes already in memory (AsyncIo
+    // reads). `filename` is only the uri and the log label.
+    static std::shared_ptr<Vapor::Image> decodeImage(const std::string& filename, const uint8_t* data, size_t size);
     static std::shared_ptr<Vapor::HDRImage> loadHDRI(const std::string& filename);
     static std::shared_ptr<Vapor::Mesh> loadOBJ(const std::string& filename, const std::string& mtl_basedir = "");
 
@@ -50,6 +50,10 @@ namespace cereal {
         archive(b.cullSphere, b.coneApex, b.coneAxisCutoff, b.lodSphere, b.parentSphere,
                 b.lodError, b.parentError, b.group, b.refined, b.depth);
     }
+
+    template<class Archive> void serialize(Archive& archive, Vapor::MeshletQuantization& q) {
+        archive(q.origin[0], q.origin[1], q.origin[2], q.stepExponent);
+    }
 }// namespace cereal
 
 namespace Vapor {
@@ -65,7 +69,12 @@ public:
     // per-mesh layout the blueprint cook writes changed. Bump so a stale v3 .vscene
     // (whose meshes have no meshlet fields) is rejected and re-cooked instead of
     // misreading later bytes as a meshlet count (huge alloc -> crash).
-    static constexpr uint32_t BLUEPRINT_FORMAT_VERSION = 4; // v3: EntityBlueprint::primitive; v4: mesh meshletData
+    // v5: mesh vertex/index and meshlet streams are written through the
+    // meshoptimizer codecs (lossless), plus the optional packed meshlet vertices.
+    // v8: a compressed mesh writes its packed vertices (on per-meshlet grids)
+    // in place of the full vertex buffer; indices and meshletVertices are
+    // kept, so the load decodes the source vertex order.
+    static constexpr uint32_t BLUEPRINT_FORMAT_VERSION = 8; // v3: EntityBlueprint::primitive; v4: mesh meshletData; v5: meshopt-coded streams; v6: image format + mipLevels; v8: packed meshes
     static void serializeBlueprint(cereal::BinaryOutputArchive& archive, const Vapor::SceneBlueprint& blueprint);
     // Returns ok == false on a version mismatch.
     static Vapor::SceneBlueprint deserializeBlueprint(cereal::BinaryInputArchive& archive);
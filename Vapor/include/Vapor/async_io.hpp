@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Vapor {
+
+    /**
+     * One read: a whole file, or a byte range of it (an archive entry).
+     */
+    struct IoRequest {
+        std::string path;
+        uint64_t offset = 0;
+        uint64_t size = UINT64_MAX;// UINT64_MAX = to the end of the file
+    };
+
+    // Runs on an I/O thread with the bytes read, or std::nullopt on failure.
+    // Keep it short (hand decoding to the TaskScheduler): it holds up every
+    // other read on that thread.
+    using IoCallback = std::function<void(std::optional<std::vector<uint8_t>>)>;
+
+    /**
+     * Asynchronous file reads, kept off the task workers so a streaming burst
+     * doesn't park every worker on the disk.
+     *
+     * On Linux one thread drives an io_uring: every request queued since it
+     * last woke is submitted in a single io_uring_enter and completions are
+     * reaped as they land, so up to queueDepth reads are in flight at once.
+     * Elsewhere, or when the kernel refuses io_uring or lacks IORING_OP_READ
+     * (seccomp, pre-5.6 kernel), a small pool of threads does blocking reads
+     * instead.
+     */
+    class AsyncIo {
+    public:
+        struct Config {
+            uint32_t threads = 2;// thread-pool backend only
+            uint32_t queueDepth = 128;// io_uring only: reads in flight
+            // Run on each I/O thread as it starts / just before it exits, e.g.
+            // to register it with the TaskScheduler.
+            std::function<void()> onThreadStart;
+            std::function<void()> onThreadExit;
+        };
+
+        AsyncIo();
+        explicit AsyncIo(Config config);
+        ~AsyncIo();// finishes every queued read first
+
+        AsyncIo(const AsyncIo&) = delete;
+        AsyncIo& operator=(const AsyncIo&) = delete;
+
+        // Threads start on the first read, not at construction.
+        void read(IoRequest request, IoCallback callback);
+
+        // Block until every read issued so far has completed and its callback
+        // has returned.
+        void waitIdle();
+        size_t getPendingCount() const;
+
+        // "io_uring" or "threads"; decided on the first read. A ring that
+        // fails later hands its reads to blocking I/O and reports "threads".
+        const char* getBackendName() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+
+}// namespace Vapor
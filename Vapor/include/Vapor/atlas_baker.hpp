@@ -10,12 +10,16 @@
 
 namespace Vapor {
 
+class TaskScheduler;
+
 // ─────────────────────────────────────────────────────────────────────────────
 // AtlasBaker
 //
 // CPU-side sprite atlas packer.  Accepts a list of individual Images and packs
 // them into a single atlas Image using the MaxRects / BestShortSideFit
-// algorithm.
+// algorithm. Trimming and pixel copies run per sprite on the TaskScheduler
+// when one is given; packCached() skips the whole bake when the inputs match
+// the last one written to disk.
 //
 // Typical usage:
 //
@@ -46,17 +50,41 @@ public:
 
     // Pack sprites into a single atlas.
     //
-    //  maxSize  — largest allowed atlas dimension in pixels (power-of-two).
-    //             The baker tries 512 → 1024 → 2048 → … up to maxSize until
-    //             all sprites fit.
-    //  padding  — transparent pixel gap between sprites; prevents UV bleeding.
-    //  trim     — strip fully-transparent border pixels before packing; reduces
-    //             wasted atlas space for sprites with large transparent margins.
+    //  maxSize   — largest allowed atlas dimension in pixels (power-of-two).
+    //              Packing starts at the smallest power-of-two size (W×W or
+    //              2W×W) whose area fits the padded sprites at typical MaxRects
+    //              density, and grows one step at a time up to maxSize.
+    //  padding   — transparent pixel gap between sprites; prevents UV bleeding.
+    //  trim      — strip fully-transparent border pixels before packing; reduces
+    //              wasted atlas space for sprites with large transparent margins.
+    //  scheduler — runs the per-sprite trim and blit phases in parallel.
     static Result pack(
         const std::vector<SpriteInput>& sprites,
         Uint32 maxSize = 4096,
         Uint32 padding = 1,
-        bool   trim    = true
+        bool   trim    = true,
+        TaskScheduler* scheduler = nullptr
+    );
+
+    // pack(), backed by a bake cache at cachePath: when the file was written
+    // for the same inputs (names, pivots, pixels) and settings, the atlas is
+    // read back instead of baked; otherwise it is baked and the file
+    // rewritten. An empty cachePath is a plain pack().
+    static Result packCached(
+        const std::string& cachePath,
+        const std::vector<SpriteInput>& sprites,
+        Uint32 maxSize = 4096,
+        Uint32 padding = 1,
+        bool   trim    = true,
+        TaskScheduler* scheduler = nullptr
+    );
+
+    // Key of a bake: every sprite's name, pivot, size and pixels plus the
+    // pack settings. Images are hashed in parallel on the scheduler.
+    static uint64_t inputHash(
+        const std::vector<SpriteInput>& sprites,
+        Uint32 maxSize, Uint32 padding, bool trim,
+        TaskScheduler* scheduler = nullptr
     );
 
 private:
@@ -68,22 +96,29 @@ private:
     public:
         MaxRectsBin(Uint32 width, Uint32 height);
 
-        // Returns the top-left position where the rect was placed, or
-        // {UINT32_MAX, UINT32_MAX} if it did not fit.
+        // Returns the top-left position where the rect was placed; ok is
+        // false if it did not fit.
         struct PlaceResult { Uint32 x, y; bool ok; };
         PlaceResult insert(Uint32 w, Uint32 h);
 
     private:
         Uint32            binW, binH;
         std::vector<Rect> freeRects;
+        std::vector<Rect> newFreeRects;  // scratch: pieces split off by the last insert
 
-        void splitFreeNode(const Rect& freeNode, const Rect& placed);
+        // Splits freeNode around placed into newFreeRects; false if they
+        // don't overlap (freeNode is kept as is).
+        bool splitFreeNode(const Rect& freeNode, const Rect& placed);
+        // Drops new pieces contained in another free rect, then appends the
+        // rest. Only new pieces are checked: every old rect was maximal.
         void pruneFreeList();
         static bool isContainedIn(const Rect& a, const Rect& b);
     };
 
     // Find the tight non-transparent bounding box of an image.
     // Returns the full image rect if channelCount < 4 (no alpha).
+    // Rows are scanned 4–16 pixels at a time (SSE2 / NEON / 64-bit words),
+    // and only the columns outside the box found so far.
     static Rect trimmedBounds(const Image& img);
 
     // Copy a region of src into dst at (dstX, dstY).
@@ -92,19 +127,26 @@ private:
                      const Image& src, Uint32 srcX, Uint32 srcY,
                      Uint32 w, Uint32 h);
 
-    // Try packing all sprites into an atlas of the given size.
-    // Returns empty optional if any sprite doesn't fit.
+    // One sprite ready to place: its source region (after trim), in pack
+    // order (descending area).
+    struct PackItem {
+        Rect   srcRect;
+        size_t sprite;  // index into the input list
+    };
+
+    // Where tryPack put a PackItem.
     struct PackEntry {
-        Uint32    x, y;         // position in atlas
-        Rect      srcRect;      // region of source image to copy (after trim)
-        glm::vec2 pivot;
-        std::string name;
-        const Image* image;
+        Uint32 x, y;            // position in atlas
+        Rect   srcRect;         // region of source image to copy (after trim)
+        size_t sprite;
     };
+
+    // Try packing all items into an atlas of the given size.
+    // Returns empty optional if any item doesn't fit.
     static std::optional<std::vector<PackEntry>> tryPack(
-        const std::vector<SpriteInput>& sprites,
+        const std::vector<PackItem>& items,
         Uint32 atlasW, Uint32 atlasH,
-        Uint32 padding, bool trim
+        Uint32 padding
     );
 };
 
@@ -6,6 +6,7 @@
 namespace JPH {
     class CharacterVirtual;
     class PhysicsSystem;
+    class TempAllocator;
 }// namespace JPH
 
 namespace Vapor {
@@ -52,8 +53,20 @@ public:
     void setMaxSpeed(float speed);
     void setGravity(const glm::vec3& gravity);
 
-    // Internal update (called by Physics3D)
+    // Internal update (called by Physics3D). The allocator overload is for
+    // parallel updates: TempAllocatorImpl isn't thread-safe, so each worker
+    // passes its own.
     void update(float deltaTime, const glm::vec3& gravity);
+    void update(float deltaTime, const glm::vec3& gravity, JPH::TempAllocator& tempAllocator);
+
+    // Radius around getPosition() the character can touch during one step
+    // (shape, padding and motion); Physics3D groups characters by it.
+    float getStepReach(float deltaTime, const glm::vec3& gravity) const;
+    // This step's index in Physics3D's character list (CharacterCrowd lookup).
+    void setCrowdIndex(Uint32 index);
+    JPH::CharacterVirtual* getCharacter() const {
+        return character.get();
+    }
 
     // Store current position as previous (for interpolation)
     void storePreviousPosition() {
@@ -0,0 +1,79 @@
+#pragma once
+#include <SDL3/SDL_stdinc.h>
+#include <glm/vec3.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace JPH {
+    class Shape;
+}
+
+namespace Vapor {
+
+struct Mesh;
+class TaskScheduler;
+
+// Cooked Jolt collision shapes keyed by a hash of their source geometry.
+// Building a MeshShape (BVH) or ConvexHullShape (hull) is the expensive part
+// of creating a mesh body; here it happens once per unique geometry. The
+// result is kept as Jolt binary state (Shape::SaveWithChildren), persisted
+// next to the scene cook as a .vshapes file, and restored instead of rebuilt
+// on the next load. Process-wide, like FileSystem; thread-safe.
+class CollisionShapeCache {
+public:
+    enum class Kind : Uint8 {
+        Mesh,
+        ConvexHull,
+    };
+
+    static CollisionShapeCache& instance();
+
+    CollisionShapeCache();
+    ~CollisionShapeCache();
+
+    // Content key: kind + positions + indices (indices unused for hulls).
+    static Uint64 hashGeometry(Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices);
+    // Concatenates the positions/triangles of every triangle mesh, for a
+    // collider built from an entity's meshes (same input at cook and load).
+    static void gatherGeometry(
+        const std::vector<std::shared_ptr<Mesh>>& meshes, std::vector<glm::vec3>& vertices, std::vector<Uint32>& indices
+    );
+
+    // Live shape for the geometry: already restored -> returned; cooked ->
+    // restored; otherwise built and cooked. nullptr if the build fails. The
+    // cache keeps a reference, so the pointer stays valid while it's cached.
+    const JPH::Shape* acquire(Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices);
+
+    // Offline path: make sure the geometry is cooked and return its key (0 if
+    // Jolt isn't initialized yet or the build fails).
+    Uint64 cook(Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices);
+
+    // Restore every cooked-but-not-live entry, in parallel when a scheduler
+    // is given. No-op until Jolt is initialized (acquire restores lazily).
+    void restoreAll(TaskScheduler* scheduler = nullptr);
+
+    // .vshapes file: the cooked bytes of `keys`. Load merges into the cache;
+    // a file from another Jolt version or with a bad header is ignored.
+    bool save(const std::string& path, const std::vector<Uint64>& keys) const;
+    bool load(const std::string& path);
+
+    size_t size() const;
+    // Drops live entries nothing but the cache references any more (no body
+    // uses the shape); cooked entries not yet restored are kept. Returns the
+    // number dropped.
+    size_t trim();
+    // Drops everything. Releasing a live shape goes through Jolt's allocator,
+    // so this must run while Jolt is still up: Physics3D::deinit calls it
+    // when the last physics system goes away.
+    void clear();
+
+private:
+    struct Entry;
+    std::unordered_map<Uint64, std::unique_ptr<Entry>> entries;
+    mutable std::mutex mutex;
+};
+
+} // namespace Vapor
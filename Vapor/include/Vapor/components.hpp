@@ -56,6 +56,9 @@ namespace Vapor {
         BodyMotionType motionType = BodyMotionType::Dynamic;
         bool syncToPhysics = false;
         bool syncFromPhysics = true;
+        // Write the pose blended between the last two fixed steps (by
+        // Physics3D::getInterpolationAlpha) instead of snapping to the latest.
+        bool interpolate = true;
     };
 
     struct BoxColliderComponent {
@@ -66,6 +69,13 @@ namespace Vapor {
         float radius = 0.5f;
     };
 
+    // Collider built from the entity's MeshRendererComponent geometry (via
+    // CollisionShapeCache, so it's cooked with the scene). convex = hull of
+    // the vertices, which can be dynamic; otherwise a static triangle mesh.
+    struct MeshColliderComponent {
+        bool convex = false;
+    };
+
     // ============================================================================
     // Camera
     // ============================================================================
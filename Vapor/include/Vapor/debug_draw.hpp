@@ -1,7 +1,15 @@
 #pragma once
 #include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace Vapor {
@@ -12,29 +20,73 @@ namespace Vapor {
         glm::vec4 color;
     };
 
+    // Unit primitives drawn instanced: one shared line mesh each, placed by a
+    // per-instance transform instead of expanded into vertices on the CPU.
+    enum class DebugShape : uint8_t { Box, Sphere, Capsule, Cylinder, Cone, Count };
+    constexpr size_t kDebugShapeCount = static_cast<size_t>(DebugShape::Count);
+
+    // Vertex of a unit primitive's line list. `cap` moves it along local Y by
+    // the instance's stretch before the transform (capsule hemispheres: +1
+    // top, -1 bottom), so one mesh serves every capsule proportion.
+    struct DebugShapeVertex {
+        glm::vec3 position;
+        float cap = 0.0f;
+    };
+
+    // One instanced primitive:
+    //   world = transform * vec4(position + vec3(0, cap * stretch, 0), 1)
+    // Layout matches DebugInstanceIn in 3d_debug.metal.
+    struct DebugInstance {
+        glm::mat4 transform = glm::mat4(1.0f);
+        glm::vec4 color = glm::vec4(1.0f);
+        float stretch = 0.0f;
+        float _pad[3] = {};
+    };
+    static_assert(sizeof(DebugInstance) == 96, "DebugInstance must match the Metal DebugInstanceIn layout");
+
     // Debug draw command queue - graphics layer agnostic
     // Collects draw commands from various systems (physics, AI, etc.)
-    // and is consumed by DebugDrawPass for rendering
+    // and is consumed by DebugDrawPass for rendering.
+    //
+    // Every add* call is thread-safe: each producer thread records into its
+    // own buffer, and flush() merges them for the renderer. Boxes, spheres,
+    // capsules, cylinders and cones become DebugInstances (96 bytes) rather
+    // than hundreds of line vertices; everything else is lines.
+    //
+    // Geometry recorded between beginPersistent(key) / endPersistent() on a
+    // thread is kept and drawn every frame until it is replaced (the same
+    // key recorded again), removed, or its lifetime runs out — static
+    // colliders, or a timed marker for a one-off event, need not be
+    // re-submitted each frame.
     class DebugDraw {
     public:
+        // Segment counts the instanced unit meshes are built with; other
+        // counts are expanded into lines on the CPU.
+        static constexpr int kSphereSegments = 16;
+        static constexpr int kShapeSegments = 12;
+        static constexpr float kForever = std::numeric_limits<float>::infinity();
+
+        DebugDraw();
+        ~DebugDraw();
+
         // Primitive drawing
         void addLine(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color);
         void addTriangle(
             const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, const glm::vec4& color, bool wireframe = true
         );
 
-        // Shape helpers - all generate line primitives
+        // Shape helpers - instanced unit primitives at the default segment counts
         void addBox(
             const glm::vec3& center, const glm::vec3& halfExtents, const glm::quat& rotation, const glm::vec4& color
         );
-        void addSphere(const glm::vec3& center, float radius, const glm::vec4& color, int segments = 16);
+        void addSphere(const glm::vec3& center, float radius, const glm::vec4& color, int segments = kSphereSegments);
         void addCapsule(
             const glm::vec3& center,
             float halfHeight,
             float radius,
             const glm::quat& rotation,
             const glm::vec4& color,
-            int segments = 12
+            int segments = kShapeSegments
         );
         void addCylinder(
             const glm::vec3& center,
@@ -42,7 +94,7 @@ namespace Vapor {
             float radius,
             const glm::quat& rotation,
             const glm::vec4& color,
-            int segments = 12
+            int segments = kShapeSegments
         );
         void addCone(
             const glm::vec3& apex,
@@ -50,7 +102,7 @@ namespace Vapor {
             float height,
             float radius,
             const glm::vec4& color,
-            int segments = 12
+            int segments = kShapeSegments
         );
         void addArrow(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color, float headSize = 0.1f);
         void addAABB(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color);
@@ -75,34 +127,111 @@ namespace Vapor {
         // Text (screen-space, requires separate handling)
         // void addText(const glm::vec3& worldPos, const std::string& text, const glm::vec4& color);
 
-        // Access to generated vertices (for renderer)
+        // Persistent geometry. Until endPersistent(), this thread's add*
+        // calls replace the geometry stored under key, which is then drawn
+        // by every flush() for `lifetime` seconds (from the first flush
+        // after recording). The new geometry replaces the old at
+        // endPersistent(), so the entry never draws half-recorded. Key 0
+        // makes a fresh anonymous entry, for fire-and-forget timed markers.
+        void beginPersistent(uint64_t key, float lifetime = kForever);
+        void endPersistent();
+        void removePersistent(uint64_t key);
+        void clearPersistent();
+        size_t getPersistentCount() const;
+
+        // Merge every thread's commands since the last flush and the live
+        // persistent geometry into the frame output below, and expire timed
+        // entries. `time` is in seconds on any monotonic clock. Called by
+        // the renderer once per frame, before reading the output.
+        void flush(double time);
+
+        // Frame output of the last flush() (for renderer)
         const std::vector<DebugVertex>& getLineVertices() const {
-            return lineVertices;
+            return output.lines;
         }
         const std::vector<DebugVertex>& getTriangleVertices() const {
-            return triangleVertices;
+            return output.triangles;
+        }
+        const std::vector<DebugInstance>& getInstances(DebugShape shape) const {
+            return output.instances[static_cast<size_t>(shape)];
         }
 
         size_t getLineVertexCount() const {
-            return lineVertices.size();
+            return output.lines.size();
         }
         size_t getTriangleVertexCount() const {
-            return triangleVertices.size();
+            return output.triangles.size();
         }
+        size_t getInstanceCount() const;
 
-        bool hasContent() const {
-            return !lineVertices.empty() || !triangleVertices.empty();
-        }
+        bool hasContent() const;
 
-        // Clear all queued commands (call after rendering)
+        // Drop the frame output and everything queued since the last flush
+        // (persistent geometry stays).
         void clear();
 
+        // Line list of a unit primitive, as uploaded for instancing (built
+        // with the default segment counts above)
+        static const std::vector<DebugShapeVertex>& getShapeLines(DebugShape shape);
+        // CPU mirror of the instanced vertex shader
+        static glm::vec3 transformShapeVertex(const DebugInstance& instance, const DebugShapeVertex& vertex);
+
     private:
-        std::vector<DebugVertex> lineVertices;// For line primitives
-        std::vector<DebugVertex> triangleVertices;// For filled triangles
+        // Recorded geometry: one producer thread's commands since the last
+        // flush, or the content of a persistent entry
+        struct Geometry {
+            std::vector<DebugVertex> lines;
+            std::vector<DebugVertex> triangles;
+            std::array<std::vector<DebugInstance>, kDebugShapeCount> instances;
+
+            void clear();
+            void appendTo(Geometry& out) const;
+            void pushLine(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color);
+        };
+
+        struct ThreadBuffer {
+            std::mutex mutex;// the owning thread vs flush()/clear()
+            Geometry transient;
+            // Between beginPersistent() and endPersistent(); touched by the
+            // owning thread only, published as a whole by endPersistent()
+            std::unique_ptr<Geometry> recording;
+            uint64_t recordingKey = 0;
+            float recordingLifetime = kForever;
+        };
+
+        struct Persistent {
+            Geometry content;
+            float lifetime = kForever;
+            double expiresAt = -1.0;// set by the first flush after recording
+        };
+
+        // Where this thread's add* calls go; the lock is held until it is
+        // destroyed, so each add* call takes it once
+        class Target {
+        public:
+            explicit Target(DebugDraw& debugDraw);
+            Geometry* operator->() {
+                return geometry;
+            }
+
+        private:
+            std::unique_lock<std::mutex> lock;
+            Geometry* geometry;
+        };
+
+        // This thread's buffer, registered on first use
+        ThreadBuffer& threadBuffer();
+
+        void addShape(DebugShape shape, const DebugInstance& instance, int segments, int defaultSegments);
+
+        const uint64_t serial;// tells this DebugDraw apart from an earlier one at the same address
+        mutable std::mutex mutex;// guards threadBuffers and persistent
+        std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> threadBuffers;
+        std::unordered_map<uint64_t, Persistent> persistent;
+        uint64_t nextAnonymousKey = 1ull << 63;
+
+        Geometry output;// result of the last flush()
 
-        // Helper to rotate a point around origin
-        glm::vec3 rotatePoint(const glm::vec3& point, const glm::quat& rotation) const;
     };
 
     // Predefined colors for convenience
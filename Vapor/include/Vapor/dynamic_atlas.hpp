@@ -0,0 +1,159 @@
+#pragma once
+#include "rhi.hpp"
+#include <SDL3/SDL_stdinc.h>
+#include <glm/vec4.hpp>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Vapor {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SkylineAllocator
+//
+// Incremental rect allocator for one atlas page: the packed area is tracked as
+// a skyline (the height of the filled region across the page), and each rect
+// goes where its bottom edge is lowest, least wasted area under it on ties.
+// Cheap enough to call per glyph; space is only reclaimed by clear().
+// ─────────────────────────────────────────────────────────────────────────────
+class SkylineAllocator {
+public:
+    SkylineAllocator() = default;
+    SkylineAllocator(Uint32 width, Uint32 height);
+
+    // Forget every allocation.
+    void clear();
+
+    // Top-left of a free width x height rect, or false when it doesn't fit.
+    bool allocate(Uint32 width, Uint32 height, Uint32& outX, Uint32& outY);
+
+    Uint64 usedArea() const { return used; }
+
+private:
+    struct Node { Uint32 x, y, width; };  // [x, x + width) is filled up to y
+
+    Uint32            pageW = 0, pageH = 0;
+    Uint64            used  = 0;
+    std::vector<Node> nodes;
+};
+
+struct DynamicAtlasDesc {
+    Uint32 pageSize     = 1024;  // square pages, pixels
+    Uint32 maxPages     = 4;
+    Uint32 padding      = 1;     // transparent gap kept around every entry
+    Uint32 channelCount = 4;     // 4 → RGBA8 pages, 1 → R8
+    // Entries used within this many frames survive when their page is
+    // defragmented (repacked); older ones are evicted.
+    Uint32 retainFrames = 120;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// DynamicAtlas
+//
+// Runtime atlas over several texture pages for content that isn't known up
+// front: glyphs rasterized on first use (CJK, user text), user-generated
+// sprites. Entries are added one at a time under a caller-chosen 64-bit key;
+// only the rects that changed are re-uploaded (RHI::updateTextureRegion, via
+// Renderer::uploadDynamicAtlas), never the whole page.
+//
+// When every page is full, the page whose entries were used least recently is
+// defragmented: entries older than retainFrames are evicted and the rest are
+// repacked tightly from the CPU copy of the page. Entries used in the current
+// frame (since beginFrame) are pinned — never moved or evicted — so regions
+// handed out this frame stay valid until the next beginFrame. Callers look
+// keys up again each frame rather than caching a Region.
+//
+//   atlas.beginFrame();
+//   const auto* r = atlas.find(key);
+//   if (!r) r = atlas.insert(key, w, h, pixels);
+//   renderer->uploadDynamicAtlas(atlas);   // before drawing with r->uvRect
+//
+// ─────────────────────────────────────────────────────────────────────────────
+class DynamicAtlas {
+public:
+    struct Region {
+        Uint32    page = 0;
+        Uint32    x = 0, y = 0, width = 0, height = 0;  // pixels, excluding padding
+        glm::vec4 uvRect = {0, 0, 0, 0};                // minU, minV, maxU, maxV
+    };
+
+    struct Stats {
+        Uint64 inserts   = 0;
+        Uint64 evictions = 0;  // entries dropped by defragmentation
+        Uint64 defrags   = 0;  // pages repacked
+        Uint64 uploadedBytes = 0;
+    };
+
+    explicit DynamicAtlas(const DynamicAtlasDesc& desc = {});
+
+    // Start a new frame: unpins everything used in the previous one.
+    void beginFrame();
+
+    // Region of key, marked used this frame; nullptr if it isn't in the atlas
+    // (never added, removed or evicted).
+    const Region* find(Uint64 key);
+
+    // Copy width x height texels (channelCount bytes each, tightly packed)
+    // into the atlas under key, replacing any previous entry. nullptr when it
+    // can't be placed: larger than a page, or every page is full of entries
+    // pinned this frame.
+    const Region* insert(Uint64 key, Uint32 width, Uint32 height, const Uint8* texels);
+
+    // Drop key; its space is reclaimed at the page's next defragmentation.
+    void remove(Uint64 key);
+
+    // Hand every rect changed since the last call to upload(page, x, y, w, h,
+    // texels, size), texels tightly packed. A new or defragmented page goes
+    // up whole, once.
+    using UploadFn = std::function<void(Uint32 page, Uint32 x, Uint32 y, Uint32 width, Uint32 height,
+                                        const Uint8* texels, size_t size)>;
+    void flushUploads(const UploadFn& upload);
+
+    // GPU textures of the pages, owned by whoever uploads (the renderer).
+    TextureHandle getPageTexture(Uint32 page) const;
+    void setPageTexture(Uint32 page, TextureHandle texture);
+
+    Uint32 pageCount() const { return static_cast<Uint32>(pages.size()); }
+    Uint32 entryCount() const { return static_cast<Uint32>(entries.size()); }
+    const DynamicAtlasDesc& getDesc() const { return desc; }
+    const std::vector<Uint8>& getPagePixels(Uint32 page) const { return pages[page].pixels; }
+    const Stats& getStats() const { return stats; }
+    // Bumped whenever a defragmentation moves or evicts entries: a Region
+    // copied at an older generation may point at someone else's texels.
+    Uint64 generation() const { return stats.defrags; }
+
+private:
+    struct Rect { Uint32 x, y, width, height; };
+
+    struct Entry {
+        Region region;
+        Uint64 lastUsedFrame = 0;
+    };
+
+    struct Page {
+        SkylineAllocator  allocator;
+        std::vector<Uint8> pixels;
+        std::vector<Rect> dirty;
+        bool              fullyDirty = true;
+        TextureHandle     texture;
+    };
+
+    // Place and copy a w x h block on page; false if it doesn't fit.
+    bool place(Uint32 pageIndex, Uint32 width, Uint32 height, const Uint8* texels, size_t srcPitch,
+               Region& out);
+    // Evict stale entries of pageIndex and repack the rest.
+    void defragment(Uint32 pageIndex, bool evictAll);
+    // Least recently used page with nothing pinned, or UINT32_MAX.
+    Uint32 pickVictim() const;
+    Uint32 addPage();
+
+    DynamicAtlasDesc desc;
+    std::vector<Page> pages;
+    std::unordered_map<Uint64, Entry> entries;
+    std::vector<Uint8> scratch;  // packed texels for flushUploads / defragment
+    Uint64 frame = 1;
+    Stats  stats;
+};
+
+} // namespace Vapor
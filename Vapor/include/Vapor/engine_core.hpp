@@ -102,6 +102,7 @@ namespace Vapor {
 
         bool _initialized{ false };
         uint32_t _numThreads{ 0 };
+        float _fileWatchTimer{ 0.0f };
     };
 
 }// namespace Vapor
\ No newline at end of file
@@ -1,10 +1,27 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
+#include "vfs_archive.hpp"
+
 namespace Vapor {
 
+// Where a relative path's bytes live: a whole OS file, or the stored bytes of
+// an archive entry (which still need archive->decode). For readers doing
+// their own I/O (AsyncIo).
+struct FileLocation {
+    std::string osPath;
+    uint64_t offset = 0;
+    uint64_t size = UINT64_MAX;// UINT64_MAX = the whole file
+    std::shared_ptr<VfsArchive> archive;// set for archive entries
+    const VfsArchive::Entry* entry = nullptr;// owned by `archive`
+};
+
 class FileSystem {
 public:
     static FileSystem& instance();
@@ -16,10 +33,30 @@ public:
     void addSearchPath(std::string absolutePath, int priority);
     void removeSearchPath(const std::string& absolutePath);
 
+    // Mount a packed archive (vfs_archive.hpp) at `priority`, interleaved with
+    // the search paths. Archive entries are visible to exists / readFile /
+    // list; resolvePath skips archives, since it must return a real file.
+    // False (with a log) if the archive can't be opened.
+    bool mountArchive(const std::string& archivePath, int priority);
+    void unmountArchive(const std::string& archivePath);
+
     // Returns the first resolved absolute path where relativePath exists,
-    // or std::nullopt if not found in any search path.
+    // or std::nullopt if not found in any search path. Answered from the
+    // search-path indexes, so a lookup never touches the disk.
     [[nodiscard]] std::optional<std::string> resolvePath(const std::string& relativePath) const;
 
+    // Whether relativePath exists in any search path or archive.
+    [[nodiscard]] bool exists(const std::string& relativePath) const;
+
+    // Whole file from the highest-priority mount holding it (archive entries
+    // decompressed); std::nullopt if missing or unreadable. Prefer this to
+    // resolvePath + open for anything read as bytes, so packed builds work.
+    [[nodiscard]] std::optional<std::vector<uint8_t>> readFile(const std::string& relativePath) const;
+
+    // The lookup half of readFile: which file (and byte range) to read,
+    // without reading it. std::nullopt if missing.
+    [[nodiscard]] std::optional<FileLocation> locate(const std::string& relativePath) const;
+
     // Like resolvePath but throws std::runtime_error if not found.
     [[nodiscard]] std::string resolvePathOrThrow(const std::string& relativePath) const;
 
@@ -33,19 +70,53 @@ public:
     // entry file) without descending into that folder's own sub-trees; N
     // descends N levels; a negative value is unlimited. Shallow keeps a picker
     // from being flooded by a self-contained asset package's referenced parts.
+    // Answered from the indexes; archive entries are listed too.
     [[nodiscard]] std::vector<std::string>
         list(const std::string& relativeDir, const std::string& extensions = "", int maxDepth = 0) const;
 
+    // Each search path is walked once, on first lookup, into an index of its
+    // files and directories. invalidate() drops every index (rebuilt lazily).
+    // pollChanges() is the watcher: it stats the indexed directories only
+    // (adding, removing or renaming a file bumps its directory's mtime) and
+    // drops the indexes of roots that changed. Returns true if any did.
+    void invalidate();
+    bool pollChanges();
+
+    // Runtime hot-reload switch: while on, EngineCore::update calls
+    // pollChanges() about once a second. On by default in debug builds (the
+    // ResHR workflow), off in release builds, where the indexes stay fixed
+    // unless the app turns it on or calls pollChanges() itself.
+    void setHotReloadEnabled(bool enabled) {
+        m_hotReload.store(enabled, std::memory_order_relaxed);
+    }
+    [[nodiscard]] bool isHotReloadEnabled() const {
+        return m_hotReload.load(std::memory_order_relaxed);
+    }
+
 private:
+    struct DirectoryIndex;
     struct SearchEntry {
-        std::string absolutePath;
+        std::string absolutePath;// directory, or the archive file
         int priority;
+        std::shared_ptr<VfsArchive> archive;        // null for a directory
+        std::shared_ptr<const DirectoryIndex> index;// directories; null until first lookup
     };
     std::vector<SearchEntry> m_paths; // sorted ascending by priority (lower = searched first)
     bool m_initialized = false;
+#ifndef NDEBUG
+    std::atomic<bool> m_hotReload{ true };
+#else
+    std::atomic<bool> m_hotReload{ false };
+#endif
+    // Lookups (worker threads) share; mounting and index rebuilds are exclusive.
+    mutable std::shared_mutex m_mutex;
 
     // Called automatically by resolvePath if initialize() was never called.
     void lazyInitialize();
+    // lazyInitialize + build any missing directory index.
+    void prepare();
+    void insertMount(SearchEntry entry);
+    static std::shared_ptr<const DirectoryIndex> buildIndex(const std::string& root);
 };
 
 } // namespace Vapor
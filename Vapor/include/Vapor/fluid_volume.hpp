@@ -5,6 +5,7 @@
 #include <vector>
 
 namespace JPH {
+    class Body;
     class BodyID;
 }
 
@@ -29,12 +30,15 @@ struct FluidVolumeSettings {
 
 class FluidVolume {
 public:
-    FluidVolume(Physics3D* physics, const FluidVolumeSettings& settings);
+    // A volume only affects bodies once registered with
+    // Physics3D::registerFluidVolume; it holds no reference to the physics
+    // system, which is passed to the queries that need it.
+    explicit FluidVolume(const FluidVolumeSettings& settings);
     ~FluidVolume();
 
     // Queries
-    bool isBodyInFluid(const JPH::BodyID& bodyID) const;
-    float getSubmergedVolume(const JPH::BodyID& bodyID) const;
+    bool isBodyInFluid(Physics3D& physics, const JPH::BodyID& bodyID) const;
+    float getSubmergedVolume(Physics3D& physics, const JPH::BodyID& bodyID) const;
     glm::vec3 getFluidVelocityAt(const glm::vec3& position) const;
 
     // Settings
@@ -68,18 +72,26 @@ public:
     void setPosition(const glm::vec3& position);
     void setRotation(const glm::quat& rotation);
 
-    // Internal update (called by Physics3D)
-    void applyForcesToBodies(float deltaTime);
+    // World-space AABB of the (possibly rotated) volume box.
+    void getWorldBounds(glm::vec3& outMin, glm::vec3& outMax) const;
+
+    // Internal update (called by Physics3D before each step, for bodies the
+    // broadphase found overlapping getWorldBounds()). The top face is the
+    // fluid surface; buoyancy and drag come from Body::ApplyBuoyancyImpulse,
+    // scaled by how much of the body lies within the side and bottom faces.
+    // The caller must own the body (no lock is taken).
+    bool applyBuoyancy(JPH::Body& body, const glm::vec3& gravity, float deltaTime) const;
 
 private:
-    Physics3D* physics;
     FluidVolumeSettings settings;
 
     // Helper methods
     bool isPointInFluid(const glm::vec3& point) const;
-    float calculateSubmergedRatio(const JPH::BodyID& bodyID) const;
-    glm::vec3 calculateBuoyancyForce(const JPH::BodyID& bodyID, float submergedVolume) const;
-    glm::vec3 calculateDragForce(const JPH::BodyID& bodyID, const glm::vec3& velocity) const;
+    float calculateSubmergedRatio(Physics3D& physics, const JPH::BodyID& bodyID) const;
+    // Fraction of the body's bounding box inside the oriented volume box,
+    // measured in the volume's local space. Without clipSurface the top face
+    // is left open (Jolt clips the shape against the surface plane itself).
+    float submergedFraction(const JPH::Body& body, bool clipSurface) const;
 };
 
 } // namespace Vapor
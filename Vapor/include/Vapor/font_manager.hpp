@@ -1,9 +1,15 @@
 #pragma once
+#include "dynamic_atlas.hpp"
 #include "graphics.hpp"
 #include "rhi.hpp"
 #include <SDL3/SDL_stdinc.h>
 #include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <array>
+#include <bitset>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -36,6 +42,10 @@ struct Glyph {
     float width = 0.0f;// Glyph width in pixels
     float height = 0.0f;// Glyph height in pixels
     float advance = 0.0f;// Horizontal advance
+    // kBakedAtlas: UVs are in the font's own atlas (textureHandle); otherwise
+    // a page of FontManager::getGlyphAtlas().
+    static constexpr Uint32 kBakedAtlas = UINT32_MAX;
+    Uint32 atlasPage = kBakedAtlas;
 };
 
 // Font data
@@ -47,14 +57,35 @@ struct Font {
     Uint32 textureWidth = 0;// Atlas texture width
     Uint32 textureHeight = 0;// Atlas texture height
     TextureHandle textureHandle;// Atlas texture handle
-    std::unordered_map<int, Glyph> glyphs;// Codepoint -> Glyph mapping
+    std::unordered_map<int, Glyph> glyphs;// Codepoint -> Glyph mapping (baked range)
+    // Baked ASCII/Latin-1 glyphs indexed directly by codepoint: the common
+    // case skips the hash lookup.
+    static constexpr int kFlatGlyphCount = 256;
+    std::array<Glyph, kFlatGlyphCount> flatGlyphs{};
+    std::bitset<kFlatGlyphCount> hasFlatGlyph;
+    std::unordered_map<int, Glyph> dynamicGlyphs;// Rasterized on first use into the glyph atlas
+};
+
+// A string laid out once at one scale: a quad per visible glyph, in pixels
+// relative to the top-left of the first line (drawText2D's position), with
+// '\n' starting a new line. Renderers offset the quads and copy them into
+// their batch in one go instead of walking the string each frame.
+struct TextLayout {
+    struct Quad {
+        glm::vec4 rect;// x0, y0, x1, y1
+        glm::vec4 uv;  // u0, v0, u1, v1
+        Uint32 atlasPage = Glyph::kBakedAtlas;// as Glyph::atlasPage
+    };
+    std::vector<Quad> quads;
+    glm::vec2 size = glm::vec2(0.0f);// measureText's result
+    bool usesGlyphAtlas = false;     // some quads sample the glyph atlas
 };
 
 // FontManager - handles font loading, atlas generation, and glyph lookup
 class FontManager {
 public:
-    FontManager() = default;
-    ~FontManager() = default;
+    FontManager();
+    ~FontManager();
 
     // Initialize with Metal device (must be called before loading fonts)
     void initialize(MTL::Device* device);
@@ -75,9 +106,31 @@ public:
     // Measure text dimensions at given scale
     glm::vec2 measureText(FontHandle handle, const std::string& text, float scale);
 
-    // Get a specific glyph (returns nullptr if not found)
+    // Layout of text at scale, cached across frames by (font, scale, text)
+    // so static labels are laid out once. nullptr for an unknown font. The
+    // pointer is valid until the next layoutText or beginFrame call.
+    const TextLayout* layoutText(FontHandle handle, const std::string& text, float scale);
+
+    // Once per frame: starts a glyph atlas frame and drops layouts that
+    // haven't been used for a while (per-frame strings such as counters).
+    void beginFrame();
+
+    // Get a specific glyph (returns nullptr if the font has none). Codepoints
+    // outside the baked range are rasterized on first use into the shared
+    // glyph atlas; their UVs are refreshed on every call, so look glyphs up
+    // each frame instead of keeping the pointer.
     const Glyph* getGlyph(FontHandle handle, int codepoint);
 
+    // Shared atlas for on-demand glyphs (CJK and anything else outside the
+    // baked range). The renderer uploads it (Renderer::uploadDynamicAtlas)
+    // before drawing; FontManager::beginFrame() advances its frame.
+    DynamicAtlas& getGlyphAtlas() { return m_glyphAtlas; }
+    const DynamicAtlas& getGlyphAtlas() const { return m_glyphAtlas; }
+
+    // Decode the UTF-8 codepoint at text[offset] and advance offset past it.
+    // Malformed bytes decode to U+FFFD, one byte at a time.
+    static int nextCodepoint(std::string_view text, size_t& offset);
+
     // Register a texture handle (called by Renderer after creating Metal texture)
     void setFontTextureHandle(FontHandle fontHandle, TextureHandle texHandle);
 
@@ -91,9 +144,33 @@ public:
 
 private:
     bool bakeFontAtlas(Font& font, const unsigned char* fontData, float fontSize, int firstChar, int numChars);
+    const Glyph* findGlyph(Uint32 fontID, Font& font, int codepoint);
+    const Glyph* rasterizeGlyph(Uint32 fontID, Font& font, int codepoint);
+    void buildLayout(Uint32 fontID, Font& font, const std::string& text, float scale, TextLayout& out,
+                     std::vector<Uint64>& atlasKeys);
+
+    // Font file + stb_truetype state kept for on-demand rasterization.
+    struct FontSource;
+
+    struct CachedLayout {
+        TextLayout layout;
+        std::string text;
+        Uint32 fontID = 0;
+        float scale = 0.0f;
+        Uint64 lastUsedFrame = 0;
+        // Glyph atlas entries the quads sample, and the atlas generation
+        // their UVs were taken at; a move or eviction forces a re-layout.
+        std::vector<Uint64> atlasKeys;
+        Uint64 atlasGeneration = 0;
+    };
 
     MTL::Device* m_device = nullptr;
     std::unordered_map<Uint32, Font> m_fonts;
+    std::unordered_map<Uint32, std::unique_ptr<FontSource>> m_sources;
+    DynamicAtlas m_glyphAtlas;
+    std::unordered_map<Uint64, CachedLayout> m_layouts;// keyed by hash of (font, scale, text)
+    Uint64 m_frame = 0;
+    Uint64 m_glyphAtlasMisses = 0;// glyphs that found the atlas full of pinned entries
     std::unordered_map<Uint32, AtlasData> m_atlasData;// Temporary storage until texture is created
     Uint32 m_nextFontID = 1;
 };
@@ -43,6 +43,12 @@ struct Image {
     // and ignores this; the native Metal renderer stores the uploaded texture
     // here (main's data model). Harmless/unused on the RHI path.
     TextureHandle texture;
+
+    // Layout of byteArray. Loaders produce a single RGBA8/R8 level; the scene
+    // texture cook (TextureCook) replaces it with mipLevels tightly packed
+    // levels in `format`, level 0 first.
+    PixelFormat format = PixelFormat::RGBA8_UNORM;
+    Uint32 mipLevels = 1;
 };
 
 // Floating-point image for HDR equirectangular environment maps (.hdr / .exr)
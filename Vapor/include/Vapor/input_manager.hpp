@@ -108,6 +108,20 @@ namespace Vapor {
         uint64_t timestamp;// Milliseconds
     };
 
+    /**
+     * One tick of input: held/pressed/released as bitmasks over InputAction,
+     * plus the cursor. What lockstep records (InputLog) and replays.
+     */
+    struct InputFrame {
+        uint32_t held = 0;
+        uint32_t pressed = 0;
+        uint32_t released = 0;
+        glm::vec2 mousePosition{ 0.0f };
+
+        bool operator==(const InputFrame&) const = default;
+    };
+    static_assert(static_cast<int>(InputAction::UNKNOWN) <= 32, "InputFrame masks hold 32 actions");
+
 
     class InputManager {
     public:
@@ -144,6 +158,17 @@ namespace Vapor {
             return mouseDelta;
         }
 
+        /**
+         * Snapshot of this frame's input (call after the frame's events).
+         */
+        InputFrame captureFrame() const;
+
+        /**
+         * Replace this frame's input with a recorded one (call after update(),
+         * instead of feeding SDL events). Key history isn't replayed.
+         */
+        void applyFrame(const InputFrame& frame);
+
     private:
         std::unordered_map<SDL_Scancode, InputAction> keyToAction;
 
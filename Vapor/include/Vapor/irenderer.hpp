@@ -28,12 +28,14 @@
 #include "camera.hpp"
 #include "graphics.hpp"       // Image, FontHandle via font_manager
 #include "font_manager.hpp"   // FontHandle
+#include "sprite_batch.hpp"   // SpriteDraw2D
 #include "render_scene.hpp"
 #include <SDL3/SDL_video.h>
 #include <entt/entt.hpp>
 #include <array>
 #include <functional>
 #include <memory>
+#include <span>
 #include <vector>
 #include <string>
 
@@ -52,6 +54,7 @@ namespace Rml {
 namespace Vapor {
 
 class DebugDraw;
+class DynamicAtlas;
 class VoxelWorld;
 
 // One raymarched micro-voxel volume, resolved from the ECS
@@ -173,6 +176,31 @@ public:
     virtual void drawQuad2D(const glm::mat4& transform, const glm::vec4& color, int entityID = -1) {}
     virtual void drawQuad2D(const glm::mat4& transform, TextureHandle texture, const glm::vec2* texCoords,
                             const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1) {}
+    // A batch of sprites, drawn into the 2D canvas at this point of the
+    // frame's 2D draws and ordered among themselves by layer, then order in
+    // layer. The RHI renderer batches them as instances (see SpriteBatch);
+    // this default sorts them the same way and emits one textured drawQuad2D
+    // each.
+    virtual void drawSprites2D(std::span<const SpriteDraw2D> sprites) {
+        SpriteBatch batch;
+        batch.add(sprites);
+        batch.build(false);
+        const std::vector<SpriteInstance>& instances = batch.getInstances();
+        for (const SpriteBatch::Draw& draw : batch.getDraws()) {
+            for (Uint32 i = draw.firstInstance; i < draw.firstInstance + draw.instanceCount; ++i) {
+                const SpriteInstance& s = instances[i];
+                glm::mat4 transform(1.0f);
+                transform[0] = glm::vec4(s.axes.x, s.axes.y, 0.0f, 0.0f);
+                transform[1] = glm::vec4(s.axes.z, s.axes.w, 0.0f, 0.0f);
+                transform[3] = s.origin;
+                const glm::vec2 texCoords[4] = {
+                    {s.uvRect.x, s.uvRect.w}, {s.uvRect.z, s.uvRect.w},
+                    {s.uvRect.z, s.uvRect.y}, {s.uvRect.x, s.uvRect.y}
+                };
+                drawQuad2D(transform, draw.texture, texCoords, s.color, s.entityID);
+            }
+        }
+    }
 
     virtual void drawQuad3D(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color) {}
     virtual void drawQuad3D(const glm::vec3& position, const glm::vec2& size, TextureHandle texture,
@@ -216,6 +244,9 @@ public:
     // ---- Texture creation ------------------------------------------------
     virtual TextureHandle createTexture(const std::shared_ptr<Vapor::Image>& img) { return {}; }
     virtual void updateTexture(TextureHandle handle, const std::shared_ptr<Vapor::Image>& img) {}
+    // Create textures for the atlas's new pages and upload the rects changed
+    // since the last call. Call before drawing with its regions' UVs.
+    virtual void uploadDynamicAtlas(DynamicAtlas& atlas) {}
 
     // ---- Render-to-texture ----------------------------------------------
     virtual RenderTextureHandle createRenderTexture(const RenderTextureDesc& desc) { return {}; }
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "input_manager.hpp"
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Vapor {
+
+    /**
+     * Fixed-tick timeline for deterministic (lockstep) simulation. Time is an
+     * integer tick count, and every system gets the same getTickDelta(), never
+     * the wall-clock frame time. Wall time only decides how many ticks to run.
+     * It is banked exactly, in nanoseconds scaled by the tick rate (a tick is
+     * 1e9 units at any rate), so the schedule doesn't drift even when the rate
+     * doesn't divide a second.
+     */
+    class LockstepClock {
+    public:
+        explicit LockstepClock(uint32_t tickRate = 60);
+
+        uint32_t getTickRate() const {
+            return m_tickRate;
+        }
+        float getTickDelta() const {
+            return 1.0f / static_cast<float>(m_tickRate);
+        }
+        uint64_t getTick() const {
+            return m_tick;
+        }
+        double getSeconds() const {
+            return static_cast<double>(m_tick) / m_tickRate;
+        }
+
+        // Interactive loop: bank elapsed wall time and return how many ticks
+        // are due now. Anything beyond maxTicks is dropped (a hitch slows the
+        // simulation down rather than spiralling).
+        uint32_t accumulate(uint64_t elapsedNs, uint32_t maxTicks = 4);
+        // Fraction of the next tick already banked, for render interpolation.
+        float getAlpha() const;
+
+        void advance() {
+            ++m_tick;
+        }
+        void reset(uint64_t tick = 0);
+
+    private:
+        static constexpr uint64_t kNsPerSecond = 1'000'000'000;
+
+        uint32_t m_tickRate;
+        uint64_t m_tick = 0;
+        uint64_t m_banked = 0;// elapsed ns * m_tickRate, less the ticks handed out
+    };
+
+    /**
+     * Recorded lockstep session: the world seed (RngStreams), the input of
+     * every tick and the state hash after it. Input is stored only when it
+     * changes. On disk, each change takes a varint tick delta plus 20 bytes,
+     * followed by one 64-bit hash per tick.
+     *
+     * Recording, per tick:
+     *     input.update(dt); <feed this tick's SDL events>;
+     *     <simulate>; log.record(input.captureFrame(), hash());
+     */
+    class InputLog {
+    public:
+        // Starts a new recording and reseeds RngStreams with `seed`.
+        void begin(uint32_t tickRate, uint64_t seed);
+        void record(const InputFrame& frame, uint64_t stateHash);
+
+        uint64_t getTickCount() const {
+            return m_hashes.size();
+        }
+        uint32_t getTickRate() const {
+            return m_tickRate;
+        }
+        uint64_t getSeed() const {
+            return m_seed;
+        }
+        InputFrame frameAt(uint64_t tick) const;
+        uint64_t hashAt(uint64_t tick) const {
+            return tick < m_hashes.size() ? m_hashes[tick] : 0;
+        }
+        size_t getChangeCount() const {
+            return m_changes.size();
+        }
+
+        bool save(const std::string& path) const;
+        bool load(const std::string& path);
+
+    private:
+        struct Change {
+            uint64_t tick;
+            InputFrame frame;
+        };
+        std::vector<Change> m_changes;// sorted by tick
+        std::vector<uint64_t> m_hashes;// one per tick
+        uint32_t m_tickRate = 60;
+        uint64_t m_seed = 0;
+    };
+
+    struct ReplayResult {
+        uint64_t ticks = 0;// ticks simulated
+        uint64_t firstDesync = UINT64_MAX;// first tick whose hash differs
+        uint64_t expectedHash = 0;
+        uint64_t actualHash = 0;
+        double elapsedSeconds = 0.0;// wall time spent; ticks / tickRate / this = speed-up
+
+        bool ok() const {
+            return firstDesync == UINT64_MAX;
+        }
+    };
+
+    using LockstepTick = std::function<void(uint64_t tick, float dt)>;
+    using LockstepHash = std::function<uint64_t()>;
+
+    /**
+     * Headless fast-forward replay. It reseeds RngStreams with the log's seed.
+     * Then, for every recorded tick, it applies that tick's input to `input`,
+     * runs `tick` and compares `hash` against the recorded hash. There is no
+     * wall clock and no renderer, so it runs as fast as the simulation itself.
+     * The caller must start from the same initial state as the recording.
+     */
+    ReplayResult replayInputLog(
+        const InputLog& log, InputManager& input, const LockstepTick& tick, const LockstepHash& hash,
+        bool stopAtDesync = true
+    );
+
+    // FNV-1a over raw bytes, chainable; for building per-tick state hashes.
+    uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+    // Position/rotation/scale of every TransformComponent, in storage order.
+    uint64_t hashTransforms(const entt::registry& registry, uint64_t hash = 14695981039346656037ull);
+
+}// namespace Vapor
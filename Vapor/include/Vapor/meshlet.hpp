@@ -44,17 +44,53 @@ struct MeshletBounds {
 static_assert(sizeof(MeshletBounds) == 112,
               "MeshletBounds must match the std430/MSL layout the meshlet shaders declare");
 
+// Position grid of one meshlet in the packed form: a packed position decodes
+// to (origin + position) * 2^stepExponent per axis. Each meshlet gets the
+// finest power-of-two step its own bounds fit in 16 bits; a vertex shared
+// with coarser meshlets (a seam or a kept LOD border) is snapped to the
+// coarsest of their grids, which every finer power-of-two grid contains, so
+// it decodes to the same bits in all of them.
+struct MeshletQuantization {
+    Sint32 origin[3];
+    Sint32 stepExponent;
+};
+
+// Quantized copy of one mesh vertex: 16 bytes instead of VertexData's 48.
+// position is a u16 offset on the grid of the vertex's home meshlet (the
+// first meshlet that references it). uv is half-float, and `frame` holds the
+// octahedral normal (2x12 bits), octahedral tangent (2x11 bits) and the
+// tangent sign (bit 46) as one little-endian 48-bit field.
+// MeshletBuilder::decodeVertex is the reference decoder.
+struct PackedMeshletVertex {
+    Uint16 position[3];
+    Uint16 uv[2];
+    Uint16 frame[3];
+};
+static_assert(sizeof(PackedMeshletVertex) == 16, "PackedMeshletVertex is a 16-byte disk record");
+
 struct MeshletData {
     std::vector<Meshlet>       meshlets;
     std::vector<Uint32>        meshletVertices;   // -> mesh vertex buffer
     std::vector<Uint8>         meshletTriangles;  // local, 3 per triangle
     std::vector<MeshletBounds> bounds;            // parallel to meshlets
     Uint32 lodLevelCount = 0;                     // max(depth)+1
+    // Compressed payload (MeshletBuilder::compress), an on-disk form only:
+    // the cook writes it in place of the mesh's vertex buffer, and
+    // MeshletBuilder::decompress turns it back into full vertices at load
+    // and drops it.
+    std::vector<PackedMeshletVertex> packedVertices;  // parallel to the mesh's vertices
+    std::vector<MeshletQuantization> quantization;    // parallel to meshlets
 
     bool isBuilt() const { return !meshlets.empty(); }
+    bool isCompressed() const { return !packedVertices.empty(); }
     void clear() {
         meshlets.clear(); meshletVertices.clear();
         meshletTriangles.clear(); bounds.clear(); lodLevelCount = 0;
+        clearPacked();
+    }
+    void clearPacked() {
+        packedVertices.clear(); packedVertices.shrink_to_fit();
+        quantization.clear(); quantization.shrink_to_fit();
     }
 };
 
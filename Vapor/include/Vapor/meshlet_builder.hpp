@@ -1,5 +1,11 @@
 #pragma once
 #include "graphics.hpp"
+#include <memory>
+#include <vector>
+
+namespace Vapor {
+class TaskScheduler;
+}
 
 // Offline meshlet + cluster-LOD bake for a mesh, using meshoptimizer +
 // clusterlod.h. Runs as part of the optimized-scene bake; the result lives in
@@ -12,7 +18,52 @@ public:
     static constexpr Uint32 MAX_MESHLET_VERTICES  = 64;
     static constexpr Uint32 MAX_MESHLET_TRIANGLES = 128;
 
+    // Bake-time summary of the DAG: one entry per LOD level (index = depth).
+    // maxLodError is the largest lodError among the level's clusters (mesh
+    // units; 0 at level 0), i.e. the error budget at which the whole level is
+    // accurate enough to draw.
+    struct Report {
+        struct Level {
+            Uint32 clusters = 0;
+            Uint32 triangles = 0;
+            float maxLodError = 0.0f;
+        };
+        std::vector<Level> levels;
+        double milliseconds = 0.0;
+
+        // Folds another mesh's report in level by level (for scene totals).
+        void accumulate(const Report& other);
+    };
+
     // Build meshletData for one mesh (no-op if already built or empty). Fills
     // meshlets, meshletVertices, meshletTriangles, bounds, lodLevelCount.
-    static void build(Vapor::Mesh& mesh);
+    // With a scheduler, the groups of each DAG level are simplified and
+    // re-clusterized in parallel; the output is identical to the serial bake.
+    static void build(Vapor::Mesh& mesh, Vapor::TaskScheduler* scheduler = nullptr, Report* report = nullptr);
+
+    // Bakes every mesh, in parallel across meshes (and across groups inside
+    // each mesh) when a scheduler is given, and logs the combined per-level
+    // report.
+    static void buildAll(const std::vector<std::shared_ptr<Vapor::Mesh>>& meshes,
+                         Vapor::TaskScheduler* scheduler = nullptr);
+
+    // Opt-in cook compression (SceneBlueprint::compressMeshlets). Quantizes
+    // the mesh's vertices into meshletData.packedVertices on per-meshlet grids
+    // (see MeshletQuantization) and replaces mesh.vertices with their decoded
+    // values, so the mesh already holds exactly what a load of the cook will
+    // see. Vertex count and order, indices and meshletVertices are untouched.
+    // No-op unless meshlets are built and reference every vertex. Lossy, but
+    // deterministic: decodeVertex is what every consumer must reproduce.
+    static void compress(Vapor::Mesh& mesh);
+
+    // Inverse of compress for the load path: decodes packedVertices back into
+    // mesh.vertices in their original order, then drops the packed form. Needs
+    // meshletVertices (each vertex decodes on its home meshlet's grid). No-op
+    // if not compressed.
+    static void decompress(Vapor::Mesh& mesh);
+
+    static Vapor::PackedMeshletVertex encodeVertex(const Vapor::VertexData& vertex,
+                                                   const Vapor::MeshletQuantization& grid);
+    static Vapor::VertexData decodeVertex(const Vapor::PackedMeshletVertex& packed,
+                                          const Vapor::MeshletQuantization& grid);
 };
@@ -0,0 +1,69 @@
+#pragma once
+#include "meshlet.hpp"
+#include <array>
+#include <cstddef>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <vector>
+
+// CPU reference of the meshlet task/object-stage cull (Meshlet.task /
+// 3d_meshlet.metal objectMain): frustum sphere test, backface cone test and the
+// two-sphere cluster-LOD cut documented on MeshletBounds. Selects the same
+// clusters as the GPU path for the same inputs, so the cut can be tested
+// headless, benchmarked, and used to drive cluster LOD on backends without
+// mesh shaders.
+namespace Vapor {
+
+class Camera;
+
+// Per-view inputs; the CameraData fields the task shader reads plus
+// MeshletParams::errorThreshold.
+struct MeshletCullView {
+    std::array<glm::vec4, 6> frustumPlanes{};  // world space, normalized
+    glm::vec3 position{ 0.0f };
+    float nearPlane = 0.1f;
+    float projScale = 1.0f;       // proj[1][1] (cot(fovy/2))
+    float errorThreshold = 0.0f;  // screen fraction; negative = emit everything (debug bypass)
+
+    // errorThreshold is a screen fraction (pixel error / screen height), as
+    // the renderer passes it to the task stage.
+    static MeshletCullView fromCamera(Camera& camera, float errorThreshold);
+};
+
+struct MeshletCullStats {
+    Uint32 tested = 0;
+    Uint32 frustumCulled = 0;
+    Uint32 coneCulled = 0;
+    Uint32 lodRejected = 0;   // visible, but not on the LOD cut
+    Uint32 selected = 0;
+};
+
+// Structure-of-arrays copy of MeshletData::bounds, padded to whole LANES-wide
+// blocks so the cull runs as fixed-width lane loops the compiler vectorizes.
+// Build once per mesh after the bake/load; it does not track later edits.
+struct MeshletCullBounds {
+    static constexpr Uint32 LANES = 8;
+
+    Uint32 count = 0;
+    std::vector<float> cullX, cullY, cullZ, cullR;
+    std::vector<float> apexX, apexY, apexZ;
+    std::vector<float> axisX, axisY, axisZ, cutoff;
+    std::vector<float> lodX, lodY, lodZ, lodR, lodError;
+    std::vector<float> parentX, parentY, parentZ, parentR, parentError;
+    std::vector<Uint8> original;  // refined < 0
+
+    void build(const std::vector<MeshletBounds>& bounds);
+};
+
+// Appends the meshlets of one instance that survive the cull to `out`, in
+// ascending order, offset by meshletOffset (the mesh's range in a global
+// meshlet buffer). Returns how many were appended.
+Uint32 cullMeshlets(const MeshletCullBounds& bounds, const glm::mat4& model, const MeshletCullView& view,
+                    std::vector<Uint32>& out, Uint32 meshletOffset = 0, MeshletCullStats* stats = nullptr);
+
+// Expands selected meshlets (indices into data.meshlets) into a triangle list
+// over the mesh's vertex buffer, for drawing the cut without a mesh stage.
+void appendMeshletTriangles(const MeshletData& data, const Uint32* meshlets, size_t count,
+                            std::vector<Uint32>& indices);
+
+} // namespace Vapor
@@ -1,10 +1,12 @@
 #pragma once
 #include <SDL3/SDL_stdinc.h>
+#include <atomic>
 #include <entt/entt.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/vec3.hpp>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -19,6 +21,7 @@ namespace JPH {
     class BroadPhaseLayerInterface;
     class ObjectVsBroadPhaseLayerFilter;
     class ObjectLayerPairFilter;
+    class CharacterVsCharacterCollision;
 }// namespace JPH
 
 namespace Vapor {
@@ -29,6 +32,8 @@ class TaskScheduler;
 class DebugDraw;
 class PhysicsDebugRenderer;
 
+struct SceneQueryShapes;
+struct CharacterCrowd;
 class BPLayerInterfaceImpl;
 class ObjectVsBroadPhaseLayerFilterImpl;
 class ObjectLayerPairFilterImpl;
@@ -64,6 +69,7 @@ struct RaycastHit {
     entt::entity entity = entt::null;
     float hitDistance;
     float hitFraction;
+    bool hasHit = false; // batched queries report misses in place
 };
 
 struct OverlapResult {
@@ -71,6 +77,60 @@ struct OverlapResult {
     std::vector<entt::entity> entities;
 };
 
+// ====== 批次場景查詢 (Batched scene queries) ======
+struct RayQuery {
+    glm::vec3 from;
+    glm::vec3 to;
+    BodyHandle ignoreBody;
+};
+
+// Sphere swept from `from` to `to`; the hit point/normal are on the body hit.
+struct SweepQuery {
+    glm::vec3 from;
+    glm::vec3 to;
+    float radius = 0.5f;
+    BodyHandle ignoreBody;
+};
+
+struct OverlapQuery {
+    enum class Shape : Uint8 { Sphere, Box, Capsule };
+    Shape shape = Shape::Sphere;
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.5f;                   // Sphere, Capsule
+    glm::vec3 halfExtents = glm::vec3(0.5f); // Box
+    glm::quat rotation = glm::quat(1, 0, 0, 0);
+    float halfHeight = 0.5f;               // Capsule: half the segment length, along local Y
+};
+
+// Queries plus their results, index-aligned. Filled by executeQueries() or,
+// when handed to deferQueries(), at the end of the next Physics3D::process().
+struct SceneQueryBatch {
+    std::vector<RayQuery> rays;
+    std::vector<SweepQuery> sweeps;
+    std::vector<OverlapQuery> overlaps;
+
+    std::vector<RaycastHit> rayHits;
+    std::vector<RaycastHit> sweepHits;
+    std::vector<OverlapResult> overlapResults;
+    // Set (release) once the results are written, possibly by another thread;
+    // read it through isResolved() before touching the results.
+    std::atomic<bool> resolved = false;
+
+    bool isResolved() const {
+        return resolved.load(std::memory_order_acquire);
+    }
+
+    void clear() {
+        rays.clear();
+        sweeps.clear();
+        overlaps.clear();
+        rayHits.clear();
+        sweepHits.clear();
+        overlapResults.clear();
+        resolved.store(false, std::memory_order_relaxed);
+    }
+};
+
 // ECS-mode collision events: bodies are identified by BodyHandle (resolve entity via getBodyUserData)
 struct CollisionEvent {
     BodyHandle body1;
@@ -84,8 +144,33 @@ struct TriggerEvent {
     bool isEnter;
 };
 
+// ====== 狀態快照 (Snapshot / Restore) ======
+enum class PhysicsSnapshotMode {
+    Full,         // every body, contact cache and constraint (level reset, rollback)
+    ActiveBodies, // only bodies awake at save time (short rollback windows)
+};
+
+// Serialized Jolt world state. `data` keeps its capacity across saves, so a
+// snapshot reused every frame doesn't allocate once warmed up.
+struct PhysicsSnapshot {
+    std::vector<Uint8> data;
+    PhysicsSnapshotMode mode = PhysicsSnapshotMode::Full;
+    Uint32 step = 0;
+    float timeAccum = 0.0f;
+
+    bool empty() const {
+        return data.empty();
+    }
+};
+
+struct PhysicsStepHash {
+    Uint32 step;
+    Uint64 hash;
+};
+
 class CharacterController;
 class VehicleController;
+class FluidVolume;
 
 class Physics3D {
 private:
@@ -101,6 +186,8 @@ public:
 
     void init(Vapor::TaskScheduler& taskScheduler, std::shared_ptr<Vapor::DebugDraw> debugDraw = nullptr);
     void process(float dt);
+    // Ties body lifetime to the registry: destroying a RigidbodyComponent
+    // destroys its body. Call once per registry.
     void attach(entt::registry& reg);
     void process(entt::registry& reg, float dt);
 
@@ -108,15 +195,31 @@ public:
     void unregisterCharacterController(CharacterController* ctrl);
     void registerVehicleController(VehicleController* ctrl);
     void unregisterVehicleController(VehicleController* ctrl);
+    // Registered volumes are kept alive until unregistered or deinit().
+    void registerFluidVolume(std::shared_ptr<FluidVolume> volume);
+    void unregisterFluidVolume(const FluidVolume* volume);
 
     void setDebugEnabled(bool enabled);
     bool isDebugEnabled() const;
     void drawImGui(float dt);
     void deinit();
 
+    // Lockstep: every process() call runs exactly one fixed step (dt is
+    // ignored) and characters update serially, so a run is a pure function
+    // of the calls made — see LockstepClock / InputLog.
+    void setLockstep(bool enabled) {
+        lockstep = enabled;
+    }
+    bool isLockstep() const {
+        return lockstep;
+    }
+    constexpr static float getFixedTimeStep() {
+        return FIXED_TIME_STEP;
+    }
+
     // Get interpolation alpha for smooth rendering between physics steps
     float getInterpolationAlpha() const {
-        return timeAccum / FIXED_TIME_STEP;
+        return lockstep ? 1.0f : timeAccum / FIXED_TIME_STEP;
     }
 
     // ====== 創建剛體（各種形狀） ======
@@ -180,6 +283,19 @@ public:
     );
     OverlapResult overlapCapsule(const glm::vec3& point1, const glm::vec3& point2, float radius);
 
+    // ====== 批次查詢 (Batched Queries) ======
+    // Run every query in parallel on the TaskScheduler against the lock-free
+    // narrow phase; outputs must be at least as long as the inputs. The
+    // broadphase is read as-is, so call between steps and don't add, remove
+    // or move bodies while a batch runs.
+    void castRays(std::span<const RayQuery> queries, std::span<RaycastHit> hits);
+    void castSpheres(std::span<const SweepQuery> queries, std::span<RaycastHit> hits);
+    void overlap(std::span<const OverlapQuery> queries, std::span<OverlapResult> results);
+    void executeQueries(SceneQueryBatch& batch);
+    // Resolves the batch right after the next process() steps the world. The
+    // batch must stay alive until then; safe to call from any thread.
+    void deferQueries(SceneQueryBatch& batch);
+
     // ====== 力與力矩 ======
     void applyForce(BodyHandle body, const glm::vec3& force, const glm::vec3& relativePos = glm::vec3(0.0f));
     void applyCentralForce(BodyHandle body, const glm::vec3& force);
@@ -223,6 +339,51 @@ public:
     glm::quat getRotation(BodyHandle body) const;
     void setRotation(BodyHandle body, const glm::quat& rotation);
 
+    // Pose blended between the last two fixed steps; the latest pose for
+    // bodies that weren't awake before the last step.
+    glm::vec3 getInterpolatedPosition(BodyHandle body) const;
+    glm::quat getInterpolatedRotation(BodyHandle body) const;
+
+    // ====== 批次 ECS 同步 (RigidbodyComponent <-> TransformComponent) ======
+    // Physics -> Scene for dynamic bodies with syncFromPhysics. Walks Jolt's
+    // active body list, not the registry, reading poses lock-free in parallel
+    // chunks; nothing is read when no body is awake. Sleeping bodies are
+    // written once more when they fell asleep, were created or were
+    // teleported with setPosition/setRotation since the last sync (they snap
+    // to that pose); awake bodies with `interpolate` get the
+    // getInterpolatedPosition/Rotation pose.
+    // Call between steps, never while PhysicsSystem::Update runs.
+    void syncFromPhysics(entt::registry& reg);
+    // Scene -> Physics for kinematic/static bodies with syncToPhysics. Writes
+    // through the lock-free interface and only touches bodies whose transform
+    // actually differs, so unchanged bodies cost no broadphase update.
+    void syncToPhysics(entt::registry& reg);
+
+    // ====== 狀態快照 (Snapshot / Restore) ======
+    // Captures bodies, contacts and constraints through Jolt's StateRecorder,
+    // plus the fixed-step clock. Restore needs the same bodies to still exist
+    // (their BodyIDs are recorded); bodies created after the save are left
+    // as they are. Character controllers aren't bodies and aren't captured.
+    void saveState(PhysicsSnapshot& snapshot, PhysicsSnapshotMode mode = PhysicsSnapshotMode::Full);
+    bool restoreState(const PhysicsSnapshot& snapshot);
+
+    // Determinism check: FNV-1a of the full serialized state. With step
+    // hashing on, one hash is recorded after every fixed step so two runs
+    // (or two peers) can be compared step by step. Only the last `window`
+    // steps are kept (a fixed ring, so long sessions don't grow it); size it
+    // to how far back a desync has to be detectable.
+    static constexpr Uint32 kDefaultStepHashWindow = 256;
+    Uint64 hashState();
+    void setStepHashingEnabled(bool enabled, Uint32 window = kDefaultStepHashWindow);
+    // Recorded hashes, oldest first.
+    std::vector<PhysicsStepHash> getStepHashes() const;
+    // Hash recorded after step `atStep`, if it is still in the window.
+    bool getStepHash(Uint32 atStep, Uint64& hash) const;
+    void clearStepHashes() {
+        stepHashHead = 0;
+        stepHashCount = 0;
+    }
+
     // ====== UserData 管理（用於 raycast 和 trigger） ======
     void setBodyUserData(BodyHandle body, Uint64 userData);
     Uint64 getBodyUserData(BodyHandle body) const;
@@ -243,14 +404,32 @@ public:
     JPH::TempAllocatorImpl* getTempAllocator() {
         return tempAllocator.get();
     }
+    // Shared by every CharacterController (see CharacterCrowd).
+    JPH::CharacterVsCharacterCollision* getCharacterCollision();
+    // Invalid BodyID for a stale (destroyed) or never-issued handle.
     JPH::BodyID getBodyID(BodyHandle handle) const;
+    BodyHandle getBodyHandle(const JPH::BodyID& bodyID) const;
+    bool isValid(BodyHandle handle) const;
 
 private:
     constexpr static float FIXED_TIME_STEP = 1.0f / 60.0f;
 
-    std::unordered_map<Uint32, JPH::BodyID> bodies;
-    std::unordered_map<Uint32, Uint32> bodyIDToRid; // JPH::BodyID.GetIndexAndSequenceNumber() -> rid
-    Uint32 nextBodyID = 0;
+    // Generational handle table: BodyHandle::rid = generation << BODY_INDEX_BITS
+    // | slot index. Destroying a body bumps its slot's generation, so stale
+    // handles resolve to an invalid BodyID instead of whatever reuses the slot.
+    constexpr static Uint32 BODY_INDEX_BITS = 20;
+    constexpr static Uint32 BODY_INDEX_MASK = (1u << BODY_INDEX_BITS) - 1;
+    constexpr static Uint32 BODY_GENERATION_MASK = (1u << (32 - BODY_INDEX_BITS)) - 1;
+    struct BodySlot {
+        Uint32 bodyID = UINT32_MAX; // JPH::BodyID::GetIndexAndSequenceNumber(), UINT32_MAX = free
+        Uint32 generation = 0;
+        Uint32 nextFree = UINT32_MAX;
+    };
+    std::vector<BodySlot> bodySlots;
+    Uint32 freeBodySlot = UINT32_MAX;
+    std::vector<Uint32> ridByBodyIndex; // JPH::BodyID::GetIndex() -> rid (UINT32_MAX = none)
+    BodyHandle registerBody(const JPH::BodyID& bodyID);
+    void releaseBody(BodyHandle handle);
 
     std::vector<CollisionEvent> pendingCollisionEvents;
     std::vector<TriggerEvent> pendingTriggerEvents;
@@ -272,13 +451,77 @@ private:
 
     JPH::BodyInterface* bodyInterface;
 
+    // Render interpolation: each awake body's pose right before the latest
+    // fixed step, indexed by JPH::BodyID::GetIndex(). `step` is the step it
+    // was captured for, so stale entries (woken/teleported/reused slots) snap.
+    struct BodyPose {
+        glm::vec3 position;
+        glm::quat rotation;
+        Uint32 step = UINT32_MAX;
+    };
+    std::vector<BodyPose> previousPoses;
+    void capturePreviousPoses();
+    void resetPreviousPose(const JPH::BodyID& bodyID);
+    bool interpolatePose(const JPH::BodyID& bodyID, glm::vec3& position, glm::quat& rotation) const;
+
+    void resolveDeferredQueries();
+    static void onRigidbodyDestroyed(entt::registry& reg, entt::entity entity);
+
+    std::vector<Uint8> hashScratch;
+    void recordStepHash();
+    std::vector<PhysicsStepHash> stepHashes; // ring of the last window steps
+    Uint32 stepHashHead = 0;                 // next slot to write
+    Uint32 stepHashCount = 0;
+    bool stepHashingEnabled = false;
+    bool syncAllNext = false; // after a restore, sleeping bodies moved too
+    // Buoyancy/drag for bodies overlapping a fluid volume; runs before each step.
+    void applyFluidBuoyancy(float dt);
+
+    std::unique_ptr<SceneQueryShapes> queryShapes; // unit shapes, scaled per query
+
+    // Characters update in parallel, one group of possibly-touching
+    // characters per task; scratch below is reused across steps.
+    void updateCharacters(float dt);
+    std::unique_ptr<CharacterCrowd> characterCrowd;
+    std::vector<std::unique_ptr<JPH::TempAllocatorImpl>> characterAllocators; // per worker thread
+    std::vector<glm::vec3> characterReachMin;
+    std::vector<glm::vec3> characterReachMax;
+    std::vector<Uint32> characterParent;
+    std::vector<Uint32> characterOrder;
+    std::vector<SceneQueryBatch*> deferredQueries;
+    std::mutex deferredMutex;
+
+    // Batched ECS sync. syncEntities maps JPH::BodyID::GetIndex() to the
+    // entity whose RigidbodyComponent holds the body; it is rebuilt from the
+    // registry only when bodies or rigidbody components come and go.
+    void refreshSyncEntities(entt::registry& reg);
+    std::vector<entt::entity> syncEntities;
+    const entt::registry* syncRegistry = nullptr;
+    size_t syncRigidbodyCount = 0;
+    bool syncEntitiesDirty = true;
+    void queueSync(const JPH::BodyID& bodyID); // pose must sync even if the body sleeps
+    std::vector<Uint32> syncPending; // BodyIDs queued since the last sync
+    std::vector<JPH::BodyID> syncBodies;
+    Vapor::TaskScheduler* taskScheduler = nullptr;
+
     std::vector<CharacterController*> characterControllers;
     std::vector<VehicleController*>   vehicleControllers;
+    std::vector<std::shared_ptr<FluidVolume>> fluidVolumes;
+
+    // (BodyID, volume index) pairs found by the broadphase, sorted by body so
+    // each body's volumes are applied by one worker (reused across steps).
+    struct FluidContact {
+        Uint32 body;
+        Uint32 volume;
+    };
+    std::vector<FluidContact> fluidContacts;
+    std::vector<Uint32> fluidContactGroups;
 
     float timeAccum;
     Uint32 step;
     bool isInitialized = false;
     bool isDebugUIEnabled = false;
+    bool lockstep = false;
     glm::vec3 currentGravity = glm::vec3(0.0f, -9.81f, 0.0f);
 };
 } // namespace Vapor
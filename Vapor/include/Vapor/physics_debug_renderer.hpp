@@ -2,6 +2,7 @@
 #include "debug_draw.hpp"
 #include "physics_3d.hpp"
 #include <memory>
+#include <vector>
 
 namespace JPH {
     class PhysicsSystem;
@@ -12,6 +13,8 @@ namespace JPH {
 
 namespace Vapor {
 
+    class TaskScheduler;
+
     // Configuration for what to draw
     struct PhysicsDebugConfig {
         bool drawBodies = true;
@@ -34,6 +37,11 @@ namespace Vapor {
 
     // Physics debug renderer - collects physics data and generates debug draw commands
     // This class knows about Jolt Physics and translates it to generic debug draw commands
+    //
+    // Moving bodies are drawn every frame, spread over the task scheduler's
+    // threads. Static bodies are recorded once into a persistent DebugDraw
+    // layer and only re-recorded when the set of static bodies or the
+    // config changes.
     class PhysicsDebugRenderer {
     public:
         PhysicsDebugRenderer();
@@ -45,6 +53,11 @@ namespace Vapor {
         // Set the debug draw queue to output commands to
         void setDebugDraw(std::shared_ptr<DebugDraw> debugDraw);
 
+        // Without a scheduler, update() runs on the calling thread
+        void setTaskScheduler(TaskScheduler* taskScheduler) {
+            this->taskScheduler = taskScheduler;
+        }
+
         // Configuration
         void setConfig(const PhysicsDebugConfig& config) {
             this->config = config;
@@ -57,13 +70,17 @@ namespace Vapor {
         }
 
         // Enable/disable rendering
-        void setEnabled(bool enabled) {
-            this->enabled = enabled;
-        }
+        void setEnabled(bool enabled);
         bool isEnabled() const {
             return enabled;
         }
 
+        // Re-record the static layer on the next update(), e.g. after
+        // teleporting a static body
+        void invalidateStatic() {
+            staticSignature = 0;
+        }
+
         // Generate debug draw commands from current physics state
         // Call this once per frame before rendering
         void update();
@@ -71,9 +88,22 @@ namespace Vapor {
     private:
         Physics3D* physics = nullptr;
         std::shared_ptr<DebugDraw> debugDraw = nullptr;
+        TaskScheduler* taskScheduler = nullptr;
         PhysicsDebugConfig config;
         bool enabled = false;
 
+        std::vector<std::vector<Uint32>> staticBodies;// Per-thread scratch: static body IDs seen this update
+        Uint64 staticSignature = 0;// Static body IDs and config the static layer was recorded with
+
+        // Persistent DebugDraw key of the static layer
+        Uint64 staticLayerKey() const {
+            return reinterpret_cast<uintptr_t>(this);
+        }
+        void removeStaticLayer();
+
+        // Draw a body with its velocity and center of mass, as configured
+        void visitBody(const JPH::Body& body);
+
         // Draw individual body based on its shape
         void drawBody(const JPH::Body& body, const glm::vec4& color);
 
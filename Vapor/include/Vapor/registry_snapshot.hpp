@@ -0,0 +1,328 @@
+#pragma once
+#include "hidden.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <entt/entt.hpp>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#ifdef VAPOR_HAS_BOOST_PFR
+#include <boost/pfr.hpp>
+#endif
+
+namespace Vapor {
+
+// ============================================================================
+// Registry snapshots — binary, column-wise ECS state.
+//
+// captureRegistry() writes every living entity id, then one column per
+// registered component type: the entity ids of its storage followed by the
+// components, in packed storage order. Trivially copyable components are
+// copied page by page straight out of the entt storage. Other aggregates are
+// encoded field by field via Boost.PFR (strings and vectors are
+// length-prefixed). restoreRegistry() clears the registry (destroy hooks fire,
+// e.g. Physics3D::attach's, which destroys rigidbody bodies) and recreates the
+// same entity ids, versions included. So entt::entity fields such as
+// TransformComponent::parent stay valid, and each column is batch-inserted.
+//
+// Columns are registered next to the blueprint appliers: registerComponent<T>
+// adds one, and hand-written appliers opt in with registerSnapshot<T>. Fields
+// with no encoding (shared_ptr, callbacks, ...) come back default-constructed.
+// Handles and ids are copied as they are, so a snapshot is for the same session
+// (quick-save, editor undo, replay); SceneSerializer is the interchange format.
+// Physics state is not captured: restored rigidbodies come back without a body
+// and the body-create system rebuilds them at the restored transforms.
+// ============================================================================
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void write(const void* data, size_t size) {
+        if (size == 0) return;
+        const size_t at = m_out.size();
+        m_out.resize(at + size);
+        std::memcpy(m_out.data() + at, data, size);
+    }
+    template<typename T> void pod(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(&value, sizeof(T));
+    }
+    size_t size() const {
+        return m_out.size();
+    }
+    // For back-patching a length written before its payload.
+    template<typename T> void patch(size_t offset, const T& value) {
+        std::memcpy(m_out.data() + offset, &value, sizeof(T));
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+};
+
+// Bounds-checked; once a read runs past the end every later read yields zeros
+// and failed() stays set.
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+    bool read(void* dst, size_t size) {
+        if (m_failed || size > remaining()) {
+            m_failed = true;
+            if (size) std::memset(dst, 0, size);
+            return false;
+        }
+        if (size) std::memcpy(dst, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+    template<typename T> bool pod(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return read(&value, sizeof(T));
+    }
+    bool skip(size_t size) {
+        if (m_failed || size > remaining()) {
+            m_failed = true;
+            return false;
+        }
+        m_cursor += size;
+        return true;
+    }
+    void fail() {
+        m_failed = true;
+    }
+    size_t remaining() const {
+        return static_cast<size_t>(m_end - m_cursor);
+    }
+    bool failed() const {
+        return m_failed;
+    }
+
+private:
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_failed = false;
+};
+
+namespace detail {
+    template<typename> struct IsVector : std::false_type {};
+    template<typename U, typename A> struct IsVector<std::vector<U, A>> : std::true_type {};
+
+    // Whether a value has a snapshot encoding. Aggregates always do (their
+    // unencodable fields are skipped one by one); vectors only when their
+    // elements do, so a vector<shared_ptr> isn't restored as N null pointers.
+    template<typename V> constexpr bool isSnapshotEncodable() {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            return true;
+        } else if constexpr (is_hidden_v<V>) {
+            return isSnapshotEncodable<decltype(V::value)>();
+        } else if constexpr (std::is_same_v<V, std::string>) {
+            return true;
+        } else if constexpr (IsVector<V>::value) {
+            return !std::is_same_v<typename V::value_type, bool> && isSnapshotEncodable<typename V::value_type>();
+#ifdef VAPOR_HAS_BOOST_PFR
+        } else if constexpr (std::is_aggregate_v<V> && !std::is_array_v<V>) {
+            return true;
+#endif
+        } else {
+            return false;
+        }
+    }
+
+    template<typename V> void writeSnapshotValue(SnapshotWriter& out, const V& value) {
+        if constexpr (!isSnapshotEncodable<V>()) {
+            (void)out;
+            (void)value;
+        } else if constexpr (std::is_trivially_copyable_v<V>) {
+            out.pod(value);
+        } else if constexpr (is_hidden_v<V>) {
+            writeSnapshotValue(out, value.value);
+        } else if constexpr (std::is_same_v<V, std::string>) {
+            out.pod(static_cast<uint32_t>(value.size()));
+            out.write(value.data(), value.size());
+        } else if constexpr (IsVector<V>::value) {
+            out.pod(static_cast<uint32_t>(value.size()));
+            if constexpr (std::is_trivially_copyable_v<typename V::value_type>) {
+                out.write(value.data(), value.size() * sizeof(typename V::value_type));
+            } else {
+                for (const auto& element : value) writeSnapshotValue(out, element);
+            }
+        } else {
+#ifdef VAPOR_HAS_BOOST_PFR
+            boost::pfr::for_each_field(value, [&](const auto& field) { writeSnapshotValue(out, field); });
+#endif
+        }
+    }
+
+    template<typename V> void readSnapshotValue(SnapshotReader& in, V& value) {
+        if constexpr (!isSnapshotEncodable<V>()) {
+            (void)in;
+            (void)value;
+        } else if constexpr (std::is_trivially_copyable_v<V>) {
+            in.pod(value);
+        } else if constexpr (is_hidden_v<V>) {
+            readSnapshotValue(in, value.value);
+        } else if constexpr (std::is_same_v<V, std::string>) {
+            uint32_t size = 0;
+            in.pod(size);
+            if (size > in.remaining()) {
+                in.fail();
+                return;
+            }
+            value.resize(size);
+            in.read(value.data(), size);
+        } else if constexpr (IsVector<V>::value) {
+            using E = typename V::value_type;
+            uint32_t size = 0;
+            in.pod(size);
+            if constexpr (std::is_trivially_copyable_v<E>) {
+                if (static_cast<uint64_t>(size) * sizeof(E) > in.remaining()) {
+                    in.fail();
+                    return;
+                }
+                value.resize(size);
+                in.read(value.data(), size * sizeof(E));
+            } else {
+                // Every encoded element takes at least one byte except empty
+                // aggregates; the bound only guards against a corrupt count.
+                if (size > in.remaining() + 1) {
+                    in.fail();
+                    return;
+                }
+                value.clear();
+                value.resize(size);
+                for (auto& element : value) readSnapshotValue(in, element);
+            }
+        } else {
+#ifdef VAPOR_HAS_BOOST_PFR
+            boost::pfr::for_each_field(value, [&](auto& field) { readSnapshotValue(in, field); });
+#endif
+        }
+    }
+
+    // Changes when the component's size or field count does, so a snapshot
+    // taken by a different build skips the column instead of misreading it.
+    template<typename T> constexpr uint32_t snapshotLayout() {
+        uint32_t fields = 0;
+#ifdef VAPOR_HAS_BOOST_PFR
+        if constexpr (!std::is_empty_v<T> && std::is_aggregate_v<T>) fields = boost::pfr::tuple_size_v<T>;
+#endif
+        return static_cast<uint32_t>(sizeof(T)) | (fields << 24);
+    }
+
+    constexpr uint32_t snapshotColumnId(std::string_view name) {
+        uint32_t h = 2166136261u;
+        for (char c : name) h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+        return h;
+    }
+}// namespace detail
+
+struct SnapshotColumn {
+    std::string name;
+    uint32_t id = 0;// FNV-1a of name; what the snapshot stores
+    uint32_t layout = 0;
+    std::function<void(const entt::registry&, SnapshotWriter&)> save;
+    // Entities must already exist; false on a corrupt or mismatched payload.
+    std::function<bool(entt::registry&, SnapshotReader&)> load;
+    // Optional fix-up once the column is loaded, for fields that point into
+    // state the snapshot doesn't hold (e.g. Jolt body handles).
+    std::function<void(entt::registry&)> restored;
+};
+
+template<typename T> constexpr bool isSnapshotComponent_v =
+    std::is_empty_v<T> || detail::isSnapshotEncodable<T>();
+
+template<typename T> SnapshotColumn makeSnapshotColumn(const std::string& name) {
+    static_assert(isSnapshotComponent_v<T>);
+    // Raw fast path: storage pages hold the packed components contiguously.
+    constexpr bool raw = std::is_trivially_copyable_v<T> && !std::is_empty_v<T>
+                         && !entt::component_traits<T>::in_place_delete;
+
+    SnapshotColumn column;
+    column.name = name;
+    column.id = detail::snapshotColumnId(name);
+    column.layout = detail::snapshotLayout<T>();
+
+    column.save = [](const entt::registry& registry, SnapshotWriter& out) {
+        const auto* storage = registry.storage<T>();
+        const entt::sparse_set* set = storage;
+        std::vector<entt::entity> alive;
+        const entt::entity* entities = nullptr;
+        uint32_t count = 0;
+        if (set && !entt::component_traits<T>::in_place_delete) {
+            entities = set->data();
+            count = static_cast<uint32_t>(set->size());
+        } else if (set) {
+            alive.reserve(set->size());
+            for (const entt::entity e : *set) {
+                if (e != entt::tombstone) alive.push_back(e);
+            }
+            entities = alive.data();
+            count = static_cast<uint32_t>(alive.size());
+        }
+        out.pod(count);
+        out.write(entities, count * sizeof(entt::entity));
+        if constexpr (raw) {
+            constexpr size_t page = entt::component_traits<T>::page_size;
+            const auto pages = storage ? storage->raw() : nullptr;
+            for (size_t i = 0; i < count; i += page) {
+                out.write(pages[i / page], std::min<size_t>(page, count - i) * sizeof(T));
+            }
+        } else if constexpr (!std::is_empty_v<T>) {
+            for (uint32_t i = 0; i < count; ++i) detail::writeSnapshotValue(out, storage->get(entities[i]));
+        }
+    };
+
+    column.load = [](entt::registry& registry, SnapshotReader& in) {
+        uint32_t count = 0;
+        in.pod(count);
+        if (static_cast<uint64_t>(count) * sizeof(entt::entity) > in.remaining()) return false;
+        std::vector<entt::entity> entities(count);
+        in.read(entities.data(), count * sizeof(entt::entity));
+        for (const entt::entity e : entities) {
+            if (!registry.valid(e)) return false;
+        }
+        if constexpr (std::is_empty_v<T>) {
+            registry.insert<T>(entities.begin(), entities.end());
+        } else {
+            std::vector<T> values(count);
+            if constexpr (raw) {
+                if (static_cast<uint64_t>(count) * sizeof(T) > in.remaining()) return false;
+                in.read(values.data(), count * sizeof(T));
+            } else {
+                for (auto& value : values) detail::readSnapshotValue(in, value);
+                if (in.failed()) return false;
+            }
+            registry.insert<T>(entities.begin(), entities.end(), std::make_move_iterator(values.begin()));
+        }
+        return !in.failed();
+    };
+    return column;
+}
+
+// A captured registry. The buffer is reused across captures, so a snapshot
+// taken every frame (undo ring, replay) stops allocating once warmed up.
+struct RegistrySnapshot {
+    std::vector<uint8_t> bytes;
+    uint32_t entityCount = 0;
+
+    bool empty() const {
+        return bytes.empty();
+    }
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+// Snapshot every entity plus every column registered with BlueprintComponents.
+void captureRegistry(const entt::registry& registry, RegistrySnapshot& snapshot);
+
+// Replace the registry's contents with the snapshot. Columns the running
+// binary doesn't know (or whose layout changed) are skipped with a log; false
+// if the snapshot is malformed, in which case the registry may be partially
+// restored.
+bool restoreRegistry(entt::registry& registry, const RegistrySnapshot& snapshot);
+
+}// namespace Vapor
@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <span>
 
 // Forward declarations
 namespace Rml {
@@ -201,6 +202,7 @@ public:
         const glm::vec4& tintColor = glm::vec4(1.0f),
         int entityID = -1
     ) override;
+    void drawSprites2D(std::span<const SpriteDraw2D> sprites) override;
 
     // Quad drawing (3D - world space with depth)
     void drawQuad3D(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color) override;
@@ -281,6 +283,7 @@ public:
     ) override;
     glm::vec2 measureText(FontHandle font, const std::string& text, float scale = 1.0f) override;
     float getFontLineHeight(FontHandle font, float scale = 1.0f) override;
+    void uploadDynamicAtlas(DynamicAtlas& atlas) override;
 
     // ========================================================================
     // Render-to-Texture API
@@ -1571,11 +1574,14 @@ private:
         SamplerHandle sampler;       // Sampler used for the batch texture
         // Quads are grouped into segments by texture; flush() issues one draw
         // per segment. Texture switches therefore never force a mid-frame
-        // flush (draws are only legal inside a render pass).
+        // flush (draws are only legal inside a render pass). A sprite run
+        // (addSprites) is a segment of its own, so sprites draw in submission
+        // order with the quads.
         struct Segment {
             TextureHandle texture;
             uint32_t quadStart = 0;
             uint32_t quadCount = 0;
+            int spriteRun = -1;  // SpriteBatch run drawn here instead of quads
         };
         std::vector<Segment> segments;
         TextureHandle pendingTexture;  // texture for the next quad added
@@ -1592,13 +1598,41 @@ private:
         uint32_t drawCalls = 0;
         uint32_t totalQuads = 0;
 
+        // Sprite mode (2D only, see SpriteBatch): one 80-byte instance per
+        // sprite, sorted by layer/order/texture, uploaded for the whole frame
+        // with a single updateBuffer and expanded to quads by the vertex
+        // shader. With bindless textures the sprites' textures come from
+        // spriteTextureTable and each run is one draw.
+        SpriteBatch sprites;
+        BufferHandle spriteBufferSlots[kSlots];
+        size_t spriteBufferSizes[kSlots] = {};
+        PipelineHandle spritePipeline;
+        PipelineHandle spritePipelineBindless;
+        ShaderHandle spriteVertexShader;
+        ShaderHandle spriteFragmentShader;
+        ShaderHandle spriteFragmentShaderBindless;
+        BufferHandle spriteTextureTable;
+        uint32_t spriteTableWritten = 0;  // table slots written so far
+
         void init(RHI* rhi, GraphicsBackend backend, bool is3D, TextureHandle defaultTex, SamplerHandle samplerHandle);
+        // Sprite-mode shaders/pipelines; bindless when the device supports
+        // texture tables.
+        void initSprites(RHI* rhi, bool bindlessTextures);
+        // Queue sprites as a new run at the current point of the segment
+        // stream; flush() draws them there.
+        void addSprites(std::span<const SpriteDraw2D> sprites);
+        // Drop queued sprites and their segments (quads stay queued).
+        void clearSprites();
+        // flush() helpers: build and upload the frame's sprites (false when
+        // there is nothing to draw), then draw one run's draws from `cursor`.
+        bool uploadSprites(RHI* rhi);
+        void drawSpriteRun(RHI* rhi, const glm::mat4& viewProj, uint32_t run, size_t& cursor);
         // Advance to the next vertex-buffer slot; call once per frame.
         void nextFrame();
         // Set the texture for subsequent quads (invalid = white). Recorded as
         // a segment split; the actual draws happen in flush().
         void setTexture(TextureHandle texture);
-        void accountQuadSegment();
+        void accountQuadSegment(uint32_t count = 1);
         void shutdown(RHI* rhi);
         void flush(RHI* rhi, const glm::mat4& viewProj, PipelineHandle overridePipeline = {});
         void beginBatch(RHI* rhi, const glm::mat4& viewProj);
@@ -1611,6 +1645,11 @@ private:
             const glm::vec4& tint,
             int entityID = -1
         );
+        // Append count quads as one contiguous span of 4 * count vertices
+        // (addQuad's corner order: top-left, top-right, bottom-right,
+        // bottom-left) for the caller to fill in place. Shorter than asked
+        // when the batch is full and can't auto-flush.
+        std::span<Vertex2D> appendQuads(uint32_t count);
         // Filled triangle as a degenerate quad (v3 duplicates v2, so the
         // second triangle of the quad's 0,1,2 / 2,3,0 indices is zero-area).
         void addTriangle(
@@ -1629,6 +1668,11 @@ private:
 
     std::unique_ptr<FontManager> fontManager;
 
+    // UTF-8 decode + glyph lookup for one string ('\n' kept as a blank
+    // entry), uploading any glyphs it rasterized.
+    std::vector<std::pair<int, Glyph>> resolveGlyphs(FontHandle font, const std::string& text);
+    TextureHandle glyphTexture(const Glyph& glyph, TextureHandle fontTexture) const;
+
     // ========================================================================
     // Render Texture Resources
     // ========================================================================
@@ -13,6 +13,7 @@
 #include <memory>
 #include <mutex>
 #include <os/signpost.h>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -528,6 +529,7 @@ public:
     ) override;
     glm::vec2 measureText(FontHandle font, const std::string& text, float scale = 1.0f) override;
     float getFontLineHeight(FontHandle font, float scale = 1.0f) override;
+    void uploadDynamicAtlas(DynamicAtlas& atlas) override;
 
     BufferHandle createVertexBuffer(const std::vector<Vapor::VertexData>& vertices);
     BufferHandle createIndexBuffer(const std::vector<Uint32>& indices);
@@ -629,6 +631,11 @@ protected:
     NS::SharedPtr<MTL::RenderPipelineState> debugDrawPipeline;
     NS::SharedPtr<MTL::DepthStencilState> debugDrawDepthStencilState;
     std::vector<NS::SharedPtr<MTL::Buffer>> debugDrawVertexBuffers;// Per-frame buffers
+    NS::SharedPtr<MTL::RenderPipelineState> debugDrawInstancePipeline;
+    NS::SharedPtr<MTL::Buffer> debugDrawShapeBuffer;// Unit primitive line lists, all shapes back to back
+    std::array<Uint32, Vapor::kDebugShapeCount> debugDrawShapeStart{};
+    std::array<Uint32, Vapor::kDebugShapeCount> debugDrawShapeCount{};
+    std::vector<NS::SharedPtr<MTL::Buffer>> debugDrawInstanceBuffers;// Per-frame buffers
     std::shared_ptr<Vapor::DebugDraw> debugDraw = nullptr;
 
     // 2D Batch rendering pipeline and resources
@@ -674,6 +681,10 @@ protected:
     bool batch2DActive = false;
 
     void splitBatch2D(); // flush current batch into sub-batches, reset slots
+    // Reserve count quads sampling texture as one span of 4 * count vertices
+    // (drawQuad2D's corner order) with indices and texIndex already written;
+    // the caller fills position / color / uv. Shorter when the batch is full.
+    std::span<Batch2DVertex> appendBatch2DQuads(TextureHandle texture, Uint32 count);
 
     // 3D Batch CPU-side state (world space, with depth)
     std::vector<Batch2DVertex> batch3DVertices;
@@ -1014,6 +1025,8 @@ private:
 
     // Font rendering
     FontManager m_fontManager;
+    std::vector<Glyph> resolveGlyphs(FontHandle fontHandle, const std::string& text);
+    TextureHandle glyphTexture(const Glyph& glyph, TextureHandle fontTexture) const;
 
     void createResources();
     void renderUI();// Internal method called by RmlUiPass
@@ -1,17 +1,25 @@
 #pragma once
 
+#include "async_io.hpp"
 #include "atlas_baker.hpp"
+#include "file_system.hpp"
 #include "graphics.hpp"
 #include "scene_blueprint.hpp"
 #include "renderer.hpp"
 #include "task_scheduler.hpp"
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace Vapor {
 
@@ -30,6 +38,19 @@ namespace Vapor {
         Async// Load in background
     };
 
+    /**
+     * Async load priority. Queued loads run highest-priority first (FIFO within
+     * a level), so near-camera or about-to-block requests overtake a backlog of
+     * background prefetch. Requesting a queued path again at a higher priority
+     * (or with LoadMode::Sync) promotes it. Image loads start in this order,
+     * but their reads then complete in whatever order the disk returns them.
+     */
+    enum class LoadPriority {
+        Background,// prefetch
+        Normal,
+        High// needed now
+    };
+
     /**
      * Generic resource container with loading state tracking
      *
@@ -73,6 +94,13 @@ namespace Vapor {
             return m_state.load() == ResourceState::Loading;
         }
 
+        // Holders of the loaded data, this Resource included (0 = no data).
+        // The cache only evicts entries nobody else holds.
+        long getDataUseCount() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_data.use_count();
+        }
+
         // Get current state
         ResourceState getState() const {
             return m_state.load();
@@ -89,43 +117,42 @@ namespace Vapor {
             return m_error;
         }
 
-        // Set completion callback. THREADING CONTRACT: Async callbacks run on
-        // the loader's worker thread — never touch single-threaded systems
-        // (RHI, entt registry, renderer). Runs immediately on the calling
-        // thread when the resource is already Ready; a completion landing
-        // between the caller's isReady() check and this call would otherwise
-        // drop the callback.
-        void setCallback(std::function<void(std::shared_ptr<T>)> callback) {
+        // Add a completion callback; every subscriber runs once, in order.
+        // THREADING CONTRACT: Async callbacks run on the loader's worker
+        // thread — never touch single-threaded systems (RHI, entt registry,
+        // renderer). Runs immediately on the calling thread when the resource
+        // is already Ready; a completion landing between the caller's
+        // isReady() check and this call would otherwise drop the callback.
+        // Callbacks on a load that fails are dropped.
+        void addCallback(std::function<void(std::shared_ptr<T>)> callback) {
+            if (!callback) return;
             std::shared_ptr<T> ready;
             {
                 std::lock_guard<std::mutex> lock(m_mutex);
-                if (m_state.load() == ResourceState::Ready) {
-                    ready = m_data;
-                } else {
-                    m_callback = std::move(callback);
+                if (m_state.load() != ResourceState::Ready) {
+                    if (m_state.load() != ResourceState::Failed) m_callbacks.push_back(std::move(callback));
                     return;
                 }
+                ready = m_data;
             }
-            if (callback) {
-                callback(ready);
-            }
+            callback(ready);
         }
 
         // Internal: Set resource data (called by loader)
         void setData(std::shared_ptr<T> data) {
-            std::function<void(std::shared_ptr<T>)> callback;
+            std::vector<std::function<void(std::shared_ptr<T>)>> callbacks;
 
             {
                 std::lock_guard<std::mutex> lock(m_mutex);
                 m_data = data;
                 m_state.store(ResourceState::Ready);
-                callback = m_callback;
+                callbacks.swap(m_callbacks);
             }
 
             m_cv.notify_all();
 
-            // Call callback outside of lock
-            if (callback) {
+            // Call callbacks outside of lock
+            for (auto& callback : callbacks) {
                 callback(data);
             }
         }
@@ -141,6 +168,7 @@ namespace Vapor {
                 std::lock_guard<std::mutex> lock(m_mutex);
                 m_error = error;
                 m_state.store(ResourceState::Failed);
+                m_callbacks.clear();
             }
 
             m_cv.notify_all();
@@ -151,82 +179,322 @@ namespace Vapor {
         std::shared_ptr<T> m_data;
         std::atomic<ResourceState> m_state{ ResourceState::Unloaded };
         std::string m_error;
-        std::function<void(std::shared_ptr<T>)> m_callback;
+        std::vector<std::function<void(std::shared_ptr<T>)>> m_callbacks;
 
         mutable std::mutex m_mutex;
         std::condition_variable m_cv;
     };
 
+    /**
+     * A resource path hashed once per request. Shard selection, lookup and
+     * rehashing all reuse the hash instead of walking the string again.
+     */
+    struct ResourceKey {
+        std::string_view path;
+        uint64_t hash;
+
+        explicit ResourceKey(std::string_view keyPath)
+            : path(keyPath), hash(std::hash<std::string_view>{}(keyPath)) {
+        }
+        ResourceKey(std::string_view keyPath, uint64_t keyHash) : path(keyPath), hash(keyHash) {
+        }
+    };
+
+    /**
+     * Budget/LRU side of a ResourceCache, type-erased so the manager can
+     * enforce one global budget across every resource type.
+     */
+    class ResourceCacheBase {
+    public:
+        struct Stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint64_t evictedBytes = 0;
+        };
+
+        virtual ~ResourceCacheBase() = default;
+
+        // Bytes held by loaded entries. Kept up to date as loads finish and
+        // entries leave, so this is O(1) (no walk, no lock).
+        size_t getMemoryUsage() const {
+            return m_bytes.load(std::memory_order_relaxed);
+        }
+
+        // 0 = unlimited.
+        void setBudget(size_t bytes) {
+            m_budget.store(bytes, std::memory_order_relaxed);
+        }
+        size_t getBudget() const {
+            return m_budget.load(std::memory_order_relaxed);
+        }
+
+        Stats getStats() const {
+            return { m_hits.load(), m_misses.load(), m_evictions.load(), m_evictedBytes.load() };
+        }
+
+        // Evict down to this cache's own budget.
+        void trim() {
+            if (const size_t budget = getBudget()) evictDownTo(budget);
+        }
+
+        // Evict least-recently-used entries that nobody outside the cache
+        // references until usage <= bytes (or nothing evictable is left).
+        virtual void evictDownTo(size_t bytes) = 0;
+        // Last-use tick of the entry evictOldest() would remove; UINT64_MAX if
+        // none can be. Ticks are global, so caches of different types compare.
+        virtual uint64_t getOldestEvictableTick() const = 0;
+        virtual bool evictOldest() = 0;
+
+    protected:
+        static uint64_t nextTick() {
+            static std::atomic<uint64_t> clock{ 0 };
+            return clock.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        std::atomic<size_t> m_bytes{ 0 };
+        std::atomic<size_t> m_budget{ 0 };
+        std::atomic<uint64_t> m_hits{ 0 };
+        std::atomic<uint64_t> m_misses{ 0 };
+        std::atomic<uint64_t> m_evictions{ 0 };
+        std::atomic<uint64_t> m_evictedBytes{ 0 };
+    };
+
     /**
      * Thread-safe resource cache
-     * Manages loaded resources and prevents duplicate loading
+     * Manages loaded resources and prevents duplicate loading. The map is
+     * striped into kShardCount independently locked shards picked by the key
+     * hash, so concurrent lookups of different paths rarely contend. Each shard
+     * keeps its entries in LRU order; ticks are global, so eviction still picks
+     * the globally oldest entry. An entry is only evicted while unreferenced,
+     * i.e. neither its Resource nor its data is held outside the cache.
      */
-    template<typename T> class ResourceCache {
+    template<typename T> class ResourceCache : public ResourceCacheBase {
     public:
+        static constexpr size_t kShardCount = 16;
+
         ResourceCache() = default;
 
-        // Try to get cached resource
+        // Atomic get-or-create: returns the cached resource, or inserts a new
+        // one in the Loading state. `created` is true for exactly one caller
+        // per key, which owns the load (single flight).
+        std::pair<std::shared_ptr<Resource<T>>, bool> acquire(const ResourceKey& key) {
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (auto it = shard.map.find(key); it != shard.map.end()) {
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                touch(shard, it->second);
+                return { it->second.resource, false };
+            }
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            auto resource = std::make_shared<Resource<T>>(std::string(key.path));
+            resource->setLoading();
+            insert(shard, key, resource);
+            return { std::move(resource), true };
+        }
+
+        // Try to get cached resource (a hit refreshes its LRU position)
         std::shared_ptr<Resource<T>> get(const std::string& path) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            auto it = m_cache.find(path);
-            if (it != m_cache.end()) {
-                return it->second;
+            const ResourceKey key(path);
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it == shard.map.end()) {
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
             }
-            return nullptr;
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            touch(shard, it->second);
+            return it->second.resource;
         }
 
-        // Store resource in cache
+        // Store resource in cache (replacing any entry for the path)
         void put(const std::string& path, std::shared_ptr<Resource<T>> resource) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_cache[path] = resource;
+            const ResourceKey key(path);
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (auto it = shard.map.find(key); it != shard.map.end()) {
+                m_bytes.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+                it->second.bytes = 0;
+                it->second.resource = std::move(resource);
+                touch(shard, it->second);
+                return;
+            }
+            insert(shard, key, std::move(resource));
+        }
+
+        // Record the loaded size of `resource` (ignored if the path has since
+        // been removed or replaced).
+        void setSize(const ResourceKey& key, const std::shared_ptr<Resource<T>>& resource, size_t bytes) {
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it == shard.map.end() || it->second.resource != resource) return;
+            m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            m_bytes.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+            it->second.bytes = bytes;
         }
 
         // Check if resource is cached
         bool contains(const std::string& path) const {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            return m_cache.find(path) != m_cache.end();
+            const ResourceKey key(path);
+            const Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.map.find(key) != shard.map.end();
         }
 
         // Remove resource from cache
         void remove(const std::string& path) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_cache.erase(path);
+            const ResourceKey key(path);
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it == shard.map.end()) return;
+            m_bytes.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+            shard.lru.erase(it->second.lru);
+            shard.map.erase(it);
         }
 
         // Clear all cached resources
         void clear() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_cache.clear();
+            for (Shard& shard : m_shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (const auto& [key, entry] : shard.map) m_bytes.fetch_sub(entry.bytes, std::memory_order_relaxed);
+                shard.lru.clear();
+                shard.map.clear();
+            }
         }
 
         // Get number of cached resources
         size_t size() const {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            return m_cache.size();
+            size_t count = 0;
+            for (const Shard& shard : m_shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                count += shard.map.size();
+            }
+            return count;
         }
 
-        // Get memory usage estimate (in bytes)
-        size_t getMemoryUsage() const {
-            std::lock_guard<std::mutex> lock(m_mutex);
+        void evictDownTo(size_t bytes) override {
+            while (getMemoryUsage() > bytes && evictOldest()) {
+            }
+        }
 
-            size_t total = 0;
-            for (const auto& [path, resource] : m_cache) {
-                if (resource->isReady()) {
-                    auto data = resource->tryGet();
-                    if (data) {
-                        total += estimateSize(data);
-                    }
+        uint64_t getOldestEvictableTick() const override {
+            uint64_t oldest = UINT64_MAX;
+            for (const Shard& shard : m_shards) oldest = std::min(oldest, oldestEvictableTick(shard));
+            return oldest;
+        }
+
+        // Shards are locked one at a time, so an entry touched between the
+        // scan and the eviction may lose its turn to the shard's next oldest;
+        // the budget only needs approximate LRU.
+        bool evictOldest() override {
+            Shard* victim = nullptr;
+            uint64_t oldest = UINT64_MAX;
+            for (Shard& shard : m_shards) {
+                const uint64_t tick = oldestEvictableTick(shard);
+                if (tick < oldest) {
+                    oldest = tick;
+                    victim = &shard;
                 }
             }
-            return total;
+            if (!victim) return false;
+
+            // Destroyed after the lock is released: freeing a large image or
+            // blueprint shouldn't stall other lookups.
+            std::shared_ptr<Resource<T>> evicted;
+            {
+                std::lock_guard<std::mutex> lock(victim->mutex);
+                for (auto it = victim->lru.rbegin(); it != victim->lru.rend(); ++it) {
+                    Entry& entry = **it;
+                    if (!isEvictable(entry)) continue;
+                    m_bytes.fetch_sub(entry.bytes, std::memory_order_relaxed);
+                    m_evictions.fetch_add(1, std::memory_order_relaxed);
+                    m_evictedBytes.fetch_add(entry.bytes, std::memory_order_relaxed);
+                    evicted = std::move(entry.resource);
+                    const auto node = victim->map.find(*entry.key);
+                    victim->lru.erase(std::next(it).base());
+                    victim->map.erase(node);
+                    break;
+                }
+            }
+            return evicted != nullptr;
         }
 
     private:
-        mutable std::mutex m_mutex;
-        std::unordered_map<std::string, std::shared_ptr<Resource<T>>> m_cache;
+        // Owning copy of a ResourceKey; the map hashes it with the stored
+        // hash, so rehashing never touches the string.
+        struct StoredKey {
+            std::string path;
+            uint64_t hash;
+        };
+        struct KeyHash {
+            using is_transparent = void;
+            size_t operator()(const StoredKey& key) const {
+                return static_cast<size_t>(key.hash);
+            }
+            size_t operator()(const ResourceKey& key) const {
+                return static_cast<size_t>(key.hash);
+            }
+        };
+        struct KeyEqual {
+            using is_transparent = void;
+            template<typename A, typename B> bool operator()(const A& a, const B& b) const {
+                return a.hash == b.hash && std::string_view(a.path) == std::string_view(b.path);
+            }
+        };
+
+        struct Entry {
+            std::shared_ptr<Resource<T>> resource;
+            size_t bytes = 0;// 0 until loaded
+            uint64_t tick = 0;// last use
+            const StoredKey* key = nullptr;// key of this entry's map node
+            typename std::list<Entry*>::iterator lru;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            // Map nodes are stable, so the LRU list can point into them.
+            std::unordered_map<StoredKey, Entry, KeyHash, KeyEqual> map;
+            std::list<Entry*> lru;// most recently used first
+        };
+        std::array<Shard, kShardCount> m_shards;
+
+        Shard& shardFor(const ResourceKey& key) {
+            return m_shards[(key.hash ^ (key.hash >> 32)) % kShardCount];
+        }
+        const Shard& shardFor(const ResourceKey& key) const {
+            return m_shards[(key.hash ^ (key.hash >> 32)) % kShardCount];
+        }
+
+        void insert(Shard& shard, const ResourceKey& key, std::shared_ptr<Resource<T>> resource) {
+            auto [it, inserted] = shard.map.try_emplace(StoredKey{ std::string(key.path), key.hash });
+            Entry& entry = it->second;
+            entry.key = &it->first;
+            entry.resource = std::move(resource);
+            shard.lru.push_front(&entry);
+            entry.lru = shard.lru.begin();
+            entry.tick = nextTick();
+        }
+
+        void touch(Shard& shard, Entry& entry) {
+            entry.tick = nextTick();
+            shard.lru.splice(shard.lru.begin(), shard.lru, entry.lru);
+        }
+
+        static bool isEvictable(const Entry& entry) {
+            return entry.resource.use_count() == 1 && !entry.resource->isLoading()
+                   && entry.resource->getDataUseCount() <= 1;
+        }
 
-        // Helper to estimate resource size (can be specialized for different types)
-        size_t estimateSize(const std::shared_ptr<T>& data) const;
+        static uint64_t oldestEvictableTick(const Shard& shard) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.lru.rbegin(); it != shard.lru.rend(); ++it) {
+                if (isEvictable(**it)) return (*it)->tick;
+            }
+            return UINT64_MAX;
+        }
     };
 
 
@@ -244,7 +512,8 @@ namespace Vapor {
         std::shared_ptr<Resource<Image>> loadImage(
             const std::string& path,
             LoadMode mode = LoadMode::Async,
-            std::function<void(std::shared_ptr<Image>)> onComplete = nullptr
+            std::function<void(std::shared_ptr<Image>)> onComplete = nullptr,
+            LoadPriority priority = LoadPriority::Normal
         );
 
         // === Scene Loading ===
@@ -252,7 +521,8 @@ namespace Vapor {
         std::shared_ptr<Resource<Vapor::SceneBlueprint>> loadScene(
             const std::string& path,
             LoadMode mode = LoadMode::Async,
-            std::function<void(std::shared_ptr<Vapor::SceneBlueprint>)> onComplete = nullptr
+            std::function<void(std::shared_ptr<Vapor::SceneBlueprint>)> onComplete = nullptr,
+            LoadPriority priority = LoadPriority::Normal
         );
 
         // === OBJ Loading ===
@@ -261,7 +531,8 @@ namespace Vapor {
             const std::string& path,
             const std::string& mtlBasedir = "",
             LoadMode mode = LoadMode::Async,
-            std::function<void(std::shared_ptr<Mesh>)> onComplete = nullptr
+            std::function<void(std::shared_ptr<Mesh>)> onComplete = nullptr,
+            LoadPriority priority = LoadPriority::Normal
         );
 
         // === Text Loading ===
@@ -269,7 +540,8 @@ namespace Vapor {
         std::shared_ptr<Resource<std::string>> loadText(
             const std::string& path,
             LoadMode mode = LoadMode::Async,
-            std::function<void(std::shared_ptr<std::string>)> onComplete = nullptr
+            std::function<void(std::shared_ptr<std::string>)> onComplete = nullptr,
+            LoadPriority priority = LoadPriority::Normal
         );
 
         // === Cache Management ===
@@ -289,9 +561,38 @@ namespace Vapor {
         size_t getMeshCacheSize() const;
         size_t getTextCacheSize() const;
 
+        // === Memory Budget ===
+        //
+        // Cached bytes are estimated from the loaded data (vector capacities,
+        // not element counts) when a load finishes. Over budget, the least
+        // recently used entries that nobody outside the cache holds are
+        // evicted; a handle (or a copy of its data) pins an entry. 0 = no limit.
+
+        // Budget across every cache; evicts globally oldest-first.
+        void setMemoryBudget(size_t bytes);
+        size_t getMemoryBudget() const;
+        // Per-type budgets, enforced before the global one.
+        void setImageCacheBudget(size_t bytes);
+        void setSceneCacheBudget(size_t bytes);
+        void setMeshCacheBudget(size_t bytes);
+        void setTextCacheBudget(size_t bytes);
+
+        size_t getMemoryUsage() const;
+        size_t getImageMemoryUsage() const;
+        size_t getSceneMemoryUsage() const;
+        size_t getMeshMemoryUsage() const;
+        size_t getTextMemoryUsage() const;
+
+        // Evict down to the budgets now (also runs after every finished load).
+        void trimCaches();
+
+        // Cumulative lookups and evictions across every cache.
+        ResourceCacheBase::Stats getCacheStats() const;
+
         // === Task Management ===
 
-        // Wait for all pending loads
+        // Wait for all pending loads, including reads still on the I/O thread
+        // and the decodes they hand back to the scheduler.
         void waitForAll();
 
         // Check if there are pending loads
@@ -307,6 +608,8 @@ namespace Vapor {
 
         // Pack individual images into a new atlas using AtlasBaker, upload the
         // resulting texture via renderer, and register it — all in one call.
+        // Trim and blit run on the task scheduler. With a cachePath, an
+        // unchanged sprite set is read back from the bake cache instead.
         // Returns an invalid handle if packing fails (sprites too large for maxSize).
         AtlasHandle bakeAtlas(
             const std::string& name,
@@ -314,7 +617,8 @@ namespace Vapor {
             Renderer* renderer,
             Uint32 maxSize = 4096,
             Uint32 padding = 1,
-            bool trim = true
+            bool trim = true,
+            const std::string& cachePath = {}
         );
 
         // Get atlas by handle (returns nullptr if not found)
@@ -349,6 +653,44 @@ namespace Vapor {
         mutable std::mutex m_atlasMutex;
 
         std::atomic<size_t> m_activeLoads{ 0 };
+        std::atomic<size_t> m_memoryBudget{ 0 };
+        ResourceCacheBase::Stats m_reportedStats;// last StatsLog line, for deltas
+
+        // Queued async loads. Every submitted task pops the best job, so the
+        // scheduler's FIFO order doesn't matter. Promotion pushes a second heap
+        // node for the same job; whichever node is popped first runs it.
+        struct PendingLoad {
+            std::function<void()> run;
+            LoadPriority priority;
+            const void* resource;
+            bool taken = false;// guarded by m_queueMutex
+        };
+        struct QueuedLoad {
+            LoadPriority priority;
+            uint64_t sequence;
+            std::shared_ptr<PendingLoad> job;
+        };
+        std::vector<QueuedLoad> m_loadQueue;// max-heap on (priority, -sequence)
+        std::unordered_map<const void*, std::shared_ptr<PendingLoad>> m_queuedByResource;
+        uint64_t m_loadSequence = 0;
+        std::mutex m_queueMutex;
+
+        void enqueueLoad(const void* resource, std::function<void()> run, LoadPriority priority);
+        void promoteLoad(const void* resource, LoadPriority priority);
+        void runNextLoad();
+
+        // Async image loads read through m_io and decode on a task worker;
+        // `locate` runs on the worker that picked the job up. Empty (scenes and
+        // OBJ, whose importers open files themselves; text) = the blocking
+        // loader does both.
+        template<typename T> struct ByteLoader {
+            std::function<std::optional<FileLocation>()> locate;
+            std::function<std::shared_ptr<T>(std::vector<uint8_t>&)> decode;
+        };
+
+        void finishLoad();
+        // Decode `work` off the I/O thread when it can submit tasks.
+        void dispatchDecode(std::function<void()> work);
 
         // Internal loading functions (static, called on worker threads)
         static std::shared_ptr<Image> loadImageInternal(const std::string& path);
@@ -363,8 +705,14 @@ namespace Vapor {
             ResourceCache<T>& cache,
             std::function<std::shared_ptr<T>()> loader,
             LoadMode mode,
-            std::function<void(std::shared_ptr<T>)> onComplete
+            std::function<void(std::shared_ptr<T>)> onComplete,
+            LoadPriority priority,
+            ByteLoader<T> byteLoader
         ) -> std::shared_ptr<Resource<T>>;
+
+        // Last member: destroyed (draining its reads) before anything the
+        // completions touch.
+        std::unique_ptr<AsyncIo> m_io;
     };
 
 }// namespace Vapor
\ No newline at end of file
@@ -128,6 +128,12 @@ enum class PixelFormat {
     RGB32_FLOAT,
     Depth32Float,
     Depth24Stencil8,
+    // Block-compressed, sampled-only (4x4 texel blocks). Produced offline by
+    // TextureCook; gated by RHICapabilities::textureCompressionBC / ASTC.
+    BC1_RGBA_UNORM,
+    BC5_UNORM,
+    BC7_UNORM,
+    ASTC_4x4_UNORM,
     // Sentinel: "whatever the swapchain format is". Only valid in
     // PipelineDesc attachment formats; resolved by the backend.
     Swapchain,
@@ -154,6 +160,34 @@ inline Uint32 pixelFormatBytesPerPixel(PixelFormat format) {
     }
 }
 
+inline bool isCompressedPixelFormat(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BC1_RGBA_UNORM:
+        case PixelFormat::BC5_UNORM:
+        case PixelFormat::BC7_UNORM:
+        case PixelFormat::ASTC_4x4_UNORM: return true;
+        default: return false;
+    }
+}
+
+// Bytes per 4x4 block of a compressed format.
+inline Uint32 pixelFormatBlockBytes(PixelFormat format) {
+    return format == PixelFormat::BC1_RGBA_UNORM ? 8 : 16;
+}
+
+// Bytes per row of texels (compressed: per row of blocks) for a tightly
+// packed upload of the given width.
+inline Uint32 pixelFormatRowPitch(PixelFormat format, Uint32 width) {
+    if (isCompressedPixelFormat(format)) return ((width + 3) / 4) * pixelFormatBlockBytes(format);
+    return width * pixelFormatBytesPerPixel(format);
+}
+
+// Bytes of one tightly packed width x height level.
+inline size_t pixelFormatLevelSize(PixelFormat format, Uint32 width, Uint32 height) {
+    const Uint32 rows = isCompressedPixelFormat(format) ? (height + 3) / 4 : height;
+    return size_t(pixelFormatRowPitch(format, width)) * rows;
+}
+
 // Bitmask — combine with operator| (e.g. RenderTarget | Sampled for a render
 // target that is later sampled by a post-process pass).
 enum class TextureUsage : Uint32 {
@@ -469,8 +503,23 @@ struct RHICapabilities {
     // indexing with runtime arrays + update-after-bind). Required for the
     // Bindless MDI draw mode on either backend.
     bool bindlessTextures = false;
+    // Sampling block-compressed textures. BC1/BC5/BC7 are universal on desktop
+    // GPUs and Apple-silicon Macs; ASTC LDR on mobile and Apple GPUs. Callers
+    // decode on the CPU when the format they hold isn't supported.
+    bool textureCompressionBC = false;
+    bool textureCompressionASTC = false;
 };
 
+inline bool isPixelFormatSupported(const RHICapabilities& caps, PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BC1_RGBA_UNORM:
+        case PixelFormat::BC5_UNORM:
+        case PixelFormat::BC7_UNORM: return caps.textureCompressionBC;
+        case PixelFormat::ASTC_4x4_UNORM: return caps.textureCompressionASTC;
+        default: return true;
+    }
+}
+
 // ============================================================================
 // GPU Profiling
 // ============================================================================
@@ -551,6 +600,11 @@ public:
     void updateTexture(TextureHandle handle, const void* data, size_t size) {
         updateTexture(handle, data, size, 0, 0);
     }
+    // Upload tightly-packed pixels into the width x height rect at (x, y) of
+    // one mip level (layer 0), leaving the rest of the texture as is. For
+    // incremental atlases (DynamicAtlas) that add entries to a live page.
+    virtual void updateTextureRegion(TextureHandle handle, const void* data, size_t size,
+                                     Uint32 x, Uint32 y, Uint32 width, Uint32 height, Uint32 mipLevel) = 0;
 
     // Generate the full mip chain from level 0 (all array layers).
     // Recorded into the batched upload stream like updateTexture.
@@ -76,6 +76,8 @@ public:
     void updateTexture(TextureHandle handle, const void* data, size_t size,
                        Uint32 mipLevel, Uint32 arrayLayer) override;
     using RHI::updateTexture;
+    void updateTextureRegion(TextureHandle handle, const void* data, size_t size,
+                             Uint32 x, Uint32 y, Uint32 width, Uint32 height, Uint32 mipLevel) override;
     void generateMipmaps(TextureHandle handle) override;
     void copyTexture(TextureHandle src, Uint32 srcMip, TextureHandle dst, Uint32 dstMip) override;
     void flushUploads() override;
@@ -261,6 +263,7 @@ private:
         Uint32 mipLevels;
         Uint32 bytesPerPixel = 4;
         MTL::PixelFormat format;
+        PixelFormat pixelFormat = PixelFormat::RGBA8_UNORM;
     };
 
     struct ShaderResource {
@@ -83,6 +83,8 @@ public:
     void updateTexture(TextureHandle handle, const void* data, size_t size,
                        Uint32 mipLevel, Uint32 arrayLayer) override;
     using RHI::updateTexture;
+    void updateTextureRegion(TextureHandle handle, const void* data, size_t size,
+                             Uint32 x, Uint32 y, Uint32 width, Uint32 height, Uint32 mipLevel) override;
     void generateMipmaps(TextureHandle handle) override;
     void copyTexture(TextureHandle src, Uint32 srcMip, TextureHandle dst, Uint32 dstMip) override;
     void flushUploads() override;
@@ -444,6 +446,10 @@ private:
     // Copy `data` into staging memory: the ring for normal sizes, a dedicated
     // one-shot buffer (deferred-destroyed) when larger than the whole ring.
     VkBuffer stageData(const void* data, VkDeviceSize size, VkDeviceSize& outOffset);
+    // Stage `data` and record its copy into one box of one subresource
+    // (updateTexture / updateTextureRegion).
+    void copyToTexture(TextureResource& tex, const void* data, size_t size, Uint32 mipLevel,
+                       Uint32 arrayLayer, VkOffset3D offset, VkExtent3D extent);
     // Submit recorded uploads. waitForCompletion also reclaims ring space.
     void submitUploads(bool waitForCompletion);
 
@@ -1,5 +1,10 @@
 #pragma once
+#include <cstdint>
+#include <mutex>
 #include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace Vapor {
 
@@ -40,6 +45,56 @@ namespace Vapor {
         std::uniform_int_distribution<int> _intDist;
     };
 
+    // Named, independently seeded engines for simulation systems. Each stream
+    // is seeded from (world seed, name), so adding a stream or drawing more
+    // from one never shifts another. The world seed is random by default;
+    // lockstep record/replay sets it (InputLog stores it) so every stream
+    // restarts identically. stream() references stay valid until reseed().
+    class RngStreams {
+    public:
+        static RngStreams& instance() {
+            static RngStreams streams;
+            return streams;
+        }
+
+        void reseed(uint64_t worldSeed) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _worldSeed = worldSeed;
+            for (auto& [name, engine] : _streams) engine.seed(seedFor(name));
+        }
+
+        uint64_t getWorldSeed() const {
+            return _worldSeed;
+        }
+
+        std::mt19937& stream(std::string_view name) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _streams.find(std::string(name));
+            if (it == _streams.end()) {
+                it = _streams.emplace(std::string(name), std::mt19937(seedFor(name))).first;
+            }
+            return it->second;
+        }
+
+    private:
+        RngStreams() : _worldSeed((uint64_t(std::random_device{}()) << 32) | std::random_device{}()) {
+        }
+
+        std::mt19937::result_type seedFor(std::string_view name) const {
+            // FNV-1a over the name, mixed with the world seed (splitmix64 finalizer).
+            uint64_t h = 14695981039346656037ull;
+            for (char c : name) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            uint64_t z = h ^ _worldSeed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return static_cast<std::mt19937::result_type>(z ^ (z >> 31));
+        }
+
+        std::mutex _mutex;
+        uint64_t _worldSeed;
+        std::unordered_map<std::string, std::mt19937> _streams;
+    };
+
 }// namespace Vapor
 
 // Usage example
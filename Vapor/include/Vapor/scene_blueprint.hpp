@@ -1,6 +1,7 @@
 #pragma once
 #include "graphics.hpp"// Image, Material, Mesh
 #include "hidden.hpp"
+#include "registry_snapshot.hpp"
 #include <entt/entt.hpp>
 #include <fmt/core.h>
 #include <functional>
@@ -8,6 +9,7 @@
 #include <glm/vec3.hpp>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -38,7 +40,8 @@ class RenderScene;
 //       { "name": "Helmet", "source": "models/helmet.glb",   // model ref
 //         "position": [0, 1, 0], "children": [ ... ] },
 //       { "name": "Door", "prefab": "prefabs/door.json" }    // nested blueprint
-//     ]
+//     ],
+//     "cook": { "compressMeshlets": true }   // optional, see compressMeshlets
 //   }
 //
 // The flow:
@@ -84,6 +87,16 @@ struct PrimitiveBlueprint {
     int material = -1;  // index into SceneBlueprint::materials, -1 = default
 };
 
+// One authored component, resolved once against BlueprintComponents (see
+// resolveComponents): the applier's index plus its decoded value. For a PFR
+// component that value is the finished T; for a hand-written applier it's the
+// parsed JSON object. instantiate() groups records by applier and emplaces
+// each group in one batch, so spawning a prefab N times parses nothing.
+struct ComponentRecord {
+    uint32_t applier = UINT32_MAX;
+    std::shared_ptr<const void> value;// shared by every instantiate() of the blueprint
+};
+
 struct EntityBlueprint {
     std::string name;
     glm::vec3 position{ 0.0f };
@@ -106,6 +119,9 @@ struct EntityBlueprint {
     // none. Kept as text so the blueprint (and its cook) stay independent of
     // which component types the running binary knows about.
     std::string componentsJson;
+    // componentsJson resolved (resolveComponents). Runtime only, never cooked:
+    // records index this binary's applier table.
+    std::vector<ComponentRecord> components;
 };
 
 struct SceneBlueprint {
@@ -123,6 +139,17 @@ struct SceneBlueprint {
     // cook-freshness hash.
     std::vector<std::string> sources;
 
+    // Cook option ("cook": { "compressMeshlets": true }): the cook stores this
+    // scene's meshes quantized (MeshletBuilder::compress), a smaller .vscene
+    // at the cost of lossy vertices. Off by default. Not itself cooked: a
+    // cooked mesh records whether it was packed.
+    bool compressMeshlets = false;
+
+    // BlueprintComponents revision the entities' records were resolved at; 0 =
+    // unresolved. When it doesn't match, instantiate() resolves into a
+    // temporary on every call (the old parse-per-spawn cost).
+    uint64_t componentsRevision = 0;
+
     bool ok = false;
 };
 
@@ -135,6 +162,10 @@ struct SceneBlueprint {
 // auto-applier (fields filled by name, same reflection the inspector draws
 // with); components needing runtime setup (physics bodies, UI pages) take a
 // hand-written applier via registerApplier.
+//
+// The same registration also declares the component's registry-snapshot
+// column (see registry_snapshot.hpp): registerComponent adds it, and a type
+// behind a hand-written applier opts in with registerSnapshot.
 
 namespace detail {
     // Name→entity map for the instantiate() batch currently applying its
@@ -218,24 +249,76 @@ namespace detail {
             (readField(boost::pfr::get_name<Is, T>(), boost::pfr::get<Is>(out), j), ...);
         }(std::make_index_sequence<fieldCount>{});
     }
+
+    // Whether readField can reach an entt::entity inside V (same recursion:
+    // nested aggregates, never into Hidden<>).
+    template<typename V> constexpr bool readsEntityRef();
+    template<typename V, size_t... Is> constexpr bool anyFieldReadsEntityRef(std::index_sequence<Is...>) {
+        return (readsEntityRef<boost::pfr::tuple_element_t<Is, V>>() || ...);
+    }
+    template<typename V> constexpr bool readsEntityRef() {
+        if constexpr (std::is_same_v<V, entt::entity>) {
+            return true;
+        } else if constexpr (is_hidden_v<V> || std::is_empty_v<V>) {
+            return false;
+        } else if constexpr (std::is_aggregate_v<V> && !std::is_array_v<V>) {
+            return anyFieldReadsEntityRef<V>(std::make_index_sequence<boost::pfr::tuple_size_v<V>>{});
+        } else {
+            return false;
+        }
+    }
 #endif
+
+    // Whether registerComponent<T> can decode T once and copy it per entity.
+    template<typename T> constexpr bool decodesOnce() {
+#ifdef VAPOR_HAS_BOOST_PFR
+        return !std::is_empty_v<T> && std::is_copy_constructible_v<T> && !readsEntityRef<T>();
+#else
+        return false;
+#endif
+    }
 }// namespace detail
 
 class BlueprintComponents {
 public:
     using Applier = std::function<void(entt::registry&, entt::entity, const nlohmann::json&)>;
+    // JSON -> decoded value, run once per authored component by
+    // resolveComponents(). The blob is what a ComponentRecord holds.
+    using Decoder = std::function<std::shared_ptr<const void>(const nlohmann::json&)>;
+    // Emplace one component type on a batch of entities; values[i] is the
+    // decoded blob for entities[i].
+    using BatchEmplacer =
+        std::function<void(entt::registry&, std::span<const entt::entity>, std::span<const void* const>)>;
+
+    static constexpr uint32_t npos = UINT32_MAX;
 
     // Engine-default appliers are registered on first access.
     static BlueprintComponents& instance();
 
+    // Hand-written applier. Its decoded blob is the JSON object itself (parsed
+    // once), and it still runs entity by entity.
     void registerApplier(const std::string& name, Applier fn) {
-        m_appliers[name] = std::move(fn);
+        auto decode = [](const nlohmann::json& j) -> std::shared_ptr<const void> {
+            return std::make_shared<const nlohmann::json>(j);
+        };
+        auto emplace = [fn](entt::registry& reg, std::span<const entt::entity> entities,
+                            std::span<const void* const> values) {
+            for (size_t i = 0; i < entities.size(); ++i)
+                fn(reg, entities[i], *static_cast<const nlohmann::json*>(values[i]));
+        };
+        setEntry(name, std::move(fn), std::move(decode), std::move(emplace));
     }
 
     // PFR auto-applier: default-construct T, fill fields by JSON key, emplace.
     // Empty tag types (SunComponent) emplace directly and need no reflection.
+    // Also registers T's snapshot column when it has an encoding.
+    // T is decoded once at resolve time and batch-inserted at instantiate().
+    // The exception is a T with entt::entity fields: those are authored as
+    // entity names, which only resolve inside an instantiate() batch, so such
+    // a T keeps the per-entity JSON path.
     template<typename T> void registerComponent(const std::string& name) {
-        registerApplier(name, [](entt::registry& reg, entt::entity e, const nlohmann::json& j) {
+        if constexpr (isSnapshotComponent_v<T>) registerSnapshot<T>(name);
+        Applier apply = [](entt::registry& reg, entt::entity e, const nlohmann::json& j) {
             if constexpr (std::is_empty_v<T>) {
                 (void)j;
                 reg.emplace_or_replace<T>(e);
@@ -251,21 +334,136 @@ public:
                 fmt::print(stderr, "BlueprintComponents: Boost.PFR unavailable; component skipped\n");
 #endif
             }
-        });
+        };
+
+        if constexpr (std::is_empty_v<T>) {
+            setEntry(
+                name, std::move(apply), [](const nlohmann::json&) { return std::shared_ptr<const void>(); },
+                [](entt::registry& reg, std::span<const entt::entity> entities, std::span<const void* const>) {
+                    auto& storage = reg.storage<T>();
+                    std::vector<entt::entity> fresh;
+                    fresh.reserve(entities.size());
+                    for (const entt::entity e : entities)
+                        if (!storage.contains(e)) fresh.push_back(e);
+                    reg.insert<T>(fresh.begin(), fresh.end());
+                }
+            );
+        } else if constexpr (detail::decodesOnce<T>()) {
+#ifdef VAPOR_HAS_BOOST_PFR
+            setEntry(
+                name, std::move(apply),
+                [](const nlohmann::json& j) -> std::shared_ptr<const void> {
+                    auto component = std::make_shared<T>();
+                    detail::fillFromJson(*component, j);
+                    return component;
+                },
+                [](entt::registry& reg, std::span<const entt::entity> entities, std::span<const void* const> values) {
+                    // Fresh entities go in with one insert; one that already
+                    // carries T (e.g. from the lights pass) is replaced.
+                    auto& storage = reg.storage<T>();
+                    std::vector<entt::entity> fresh;
+                    std::vector<T> freshValues;
+                    fresh.reserve(entities.size());
+                    freshValues.reserve(entities.size());
+                    for (size_t i = 0; i < entities.size(); ++i) {
+                        const T& value = *static_cast<const T*>(values[i]);
+                        if (storage.contains(entities[i])) {
+                            reg.replace<T>(entities[i], value);
+                        } else {
+                            fresh.push_back(entities[i]);
+                            freshValues.push_back(value);
+                        }
+                    }
+                    reg.insert<T>(fresh.begin(), fresh.end(), std::make_move_iterator(freshValues.begin()));
+                }
+            );
+#endif
+        } else {
+            registerApplier(name, std::move(apply));
+        }
+    }
+
+    // Snapshot column only (no JSON applier), keyed by `name`; registering a
+    // name again replaces its column.
+    template<typename T>
+    void registerSnapshot(const std::string& name, std::function<void(entt::registry&)> restored = {}) {
+        SnapshotColumn column = makeSnapshotColumn<T>(name);
+        column.restored = std::move(restored);
+        for (auto& existing : m_columns) {
+            if (existing.id == column.id) {
+                existing = std::move(column);
+                return;
+            }
+        }
+        m_columns.push_back(std::move(column));
+    }
+
+    const std::vector<SnapshotColumn>& getSnapshotColumns() const {
+        return m_columns;
     }
 
     // True if an applier existed and ran.
     bool apply(const std::string& name, entt::registry& registry, entt::entity e, const nlohmann::json& j) const {
-        const auto it = m_appliers.find(name);
-        if (it == m_appliers.end()) return false;
-        it->second(registry, e, j);
+        const uint32_t index = find(name);
+        if (index == npos) return false;
+        m_entries[index].apply(registry, e, j);
         return true;
     }
 
+    // ── Resolved path (see ComponentRecord) ──
+    uint32_t find(const std::string& name) const {
+        const auto it = m_index.find(name);
+        return it == m_index.end() ? npos : it->second;
+    }
+    const std::string& getName(uint32_t index) const {
+        return m_entries[index].name;
+    }
+    size_t size() const {
+        return m_entries.size();
+    }
+    std::shared_ptr<const void> decode(uint32_t index, const nlohmann::json& j) const {
+        return m_entries[index].decode(j);
+    }
+    void emplace(
+        uint32_t index, entt::registry& registry, std::span<const entt::entity> entities,
+        std::span<const void* const> values
+    ) const {
+        m_entries[index].emplace(registry, entities, values);
+    }
+    // Bumped by every registration; records resolved at an older revision
+    // may point at a replaced applier (or miss a newly registered one).
+    uint64_t getRevision() const {
+        return m_revision;
+    }
+
 private:
-    std::unordered_map<std::string, Applier> m_appliers;
+    struct Entry {
+        std::string name;
+        Applier apply;
+        Decoder decode;
+        BatchEmplacer emplace;
+    };
+
+    void setEntry(const std::string& name, Applier apply, Decoder decode, BatchEmplacer emplace) {
+        ++m_revision;
+        const auto [it, inserted] = m_index.try_emplace(name, static_cast<uint32_t>(m_entries.size()));
+        if (inserted) m_entries.emplace_back();
+        m_entries[it->second] = Entry{ name, std::move(apply), std::move(decode), std::move(emplace) };
+    }
+
+    std::vector<Entry> m_entries;// stable indices: a re-registered name keeps its slot
+    std::unordered_map<std::string, uint32_t> m_index;
+    std::vector<SnapshotColumn> m_columns;
+    uint64_t m_revision = 1;
 };
 
+// Resolve every entity's componentsJson into ComponentRecords against the
+// current BlueprintComponents. Call it once the appliers the blueprint uses
+// are registered (loading doesn't, since the app usually registers its
+// gameplay components after the scene is loaded). An unknown key logs here
+// instead of at every instantiate().
+void resolveComponents(SceneBlueprint& blueprint);
+
 // Splice `sub` into `dst` under dst entity index `parentIndex` (-1 = top
 // level): entities are appended with mesh/light/parent indices rebased, and
 // the payload vectors are concatenated. Consumes `sub`.
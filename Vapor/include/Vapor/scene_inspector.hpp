@@ -49,6 +49,7 @@ namespace Vapor {
             registerComponent<RigidbodyComponent>("Rigidbody");
             registerComponent<BoxColliderComponent>("Box Collider");
             registerComponent<SphereColliderComponent>("Sphere Collider");
+            registerComponent<MeshColliderComponent>("Mesh Collider");
             registerComponent<VirtualCameraComponent>("Virtual Camera");
             registerComponent<FlyCameraComponent>("Fly Camera");
             registerComponent<FollowCameraComponent>("Follow Camera");
@@ -0,0 +1,136 @@
+#pragma once
+#include "rhi.hpp"
+#include <SDL3/SDL_stdinc.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Vapor {
+
+// One sprite as submitted by gameplay code: the unit quad (-0.5..0.5 on both
+// axes) placed at origin + axisX * x + axisY * y, i.e. the first, second and
+// last columns of its 2D world transform (z of the axes is dropped — canvas
+// sprites are planar).
+struct SpriteDraw2D {
+    glm::vec2     axisX  = {1.0f, 0.0f};
+    glm::vec2     axisY  = {0.0f, 1.0f};
+    glm::vec3     origin = {0.0f, 0.0f, 0.0f};
+    TextureHandle texture;                      // invalid = white
+    glm::vec4     uvRect = {0.0f, 0.0f, 1.0f, 1.0f};  // u0, v0, u1, v1; swap a pair to flip
+    glm::vec4     tint   = {1.0f, 1.0f, 1.0f, 1.0f};
+    int           layer  = 0;                   // Sprite2DComponent::sortingLayer
+    int           order  = 0;                   // Sprite2DComponent::orderInLayer
+    int           entityID = -1;
+};
+
+// Per-instance record the sprite vertex shader expands into a quad
+// (SpriteInstance in 2d_batch.metal / RHISprite.vert). Corner c of the unit
+// quad lands at origin.xyz + vec3(axes.xy * c.x + axes.zw * c.y, 0) with uv
+// (mix(u0, u1, c.x + 0.5), mix(v1, v0, c.y + 0.5)), matching addQuad's
+// texCoords order.
+struct SpriteInstance {
+    glm::vec4 axes;          // xy = axisX, zw = axisY
+    glm::vec4 origin;        // xyz, w unused
+    glm::vec4 uvRect;
+    glm::vec4 color;
+    Uint32    textureIndex;  // slot in the bindless texture table
+    Sint32    entityID;
+    Uint32    _pad[2];
+};
+static_assert(sizeof(SpriteInstance) == 80, "SpriteInstance must match the shader layout");
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SpriteBatch
+//
+// CPU side of the renderer's sprite mode. add() turns each sprite into an
+// 80-byte SpriteInstance (vs. four 48-byte Vertex2D through addQuad) plus a
+// 64-bit sort key: run, then layer, then order in layer, then texture. build()
+// sorts the keys with an LSD radix sort (stable, so equal keys keep submission
+// order; byte passes every key agrees on are skipped), gathers the instances
+// in draw order, and splits them into draws: one per texture run, or one per
+// run when the textures come from the bindless table.
+//
+// Runs keep sprites in submission order relative to the renderer's other 2D
+// draws: each drawSprites2D call opens one, and its draws go where the call
+// was made, sorted only among themselves.
+//
+// Table slots are sticky: a texture keeps its slot for the lifetime of the
+// batch, so the renderer only ever writes slots no in-flight frame reads. RHI
+// texture ids are never recycled, so a destroyed texture's slot just goes
+// unused. Once all kMaxTextures slots are taken, new textures still draw but
+// that frame falls back to one draw per texture run.
+// ─────────────────────────────────────────────────────────────────────────────
+class SpriteBatch {
+public:
+    static constexpr Uint32 kMaxTextures = 1024;  // bindless table entries
+
+    struct Draw {
+        Uint32        firstInstance = 0;
+        Uint32        instanceCount = 0;
+        TextureHandle texture;  // texture to bind; unused when usesTextureTable()
+        Uint32        run = 0;
+    };
+
+    // Queue sprites for the next build(). Sprites past 65535 distinct
+    // textures in one frame are dropped.
+    void add(const SpriteDraw2D& sprite);
+    void add(std::span<const SpriteDraw2D> sprites);
+
+    // Sprites added from here on form a new run, drawn after every earlier
+    // one. Returns its index (Draw::run). Past 65535 runs in a frame the
+    // last one is reused.
+    Uint32 beginRun();
+
+    // Sort everything queued since the last clear() and build the draws.
+    // With bindless, the draws index the texture table instead of binding
+    // textures (unless the table overflowed this frame).
+    void build(bool bindless);
+
+    // Forget the queued sprites and draws (texture slots are kept).
+    void clear();
+
+    Uint32 size() const  { return static_cast<Uint32>(pending.size()); }
+    bool   empty() const { return pending.empty(); }
+
+    // Output of the last build(): instances in draw order, and the draws.
+    const std::vector<SpriteInstance>& getInstances() const { return sorted; }
+    const std::vector<Draw>&           getDraws() const     { return draws; }
+    bool usesTextureTable() const { return tableDraws; }
+
+    // Texture in each table slot, in slot order. Slots past the count the
+    // caller has already written are new since it last looked.
+    const std::vector<TextureHandle>& getTableTextures() const { return tableTextures; }
+
+private:
+    static constexpr Uint32 kKeyBytes  = 8;  // run:16 | layer:16 | order:16 | texture:16
+    static constexpr Uint32 kMaxRun    = 0xFFFF;
+    static constexpr Uint32 kNoTexture = UINT32_MAX;
+
+    Uint32 textureKey(TextureHandle texture);
+    TextureHandle keyTexture(Uint32 key) const;
+    void   sortKeys();
+
+    std::vector<SpriteInstance> pending;  // submission order
+    std::vector<Uint64>         keys;     // parallel to pending
+    std::vector<SpriteInstance> sorted;
+    std::vector<Draw>           draws;
+    bool                        tableDraws = false;
+    Uint32                      run = 0;
+
+    // Sticky table slots, plus this frame's textures that found the table full
+    std::unordered_map<Uint32, Uint32> textureSlots;  // TextureHandle::id → key
+    std::vector<TextureHandle>         tableTextures;
+    std::unordered_map<Uint32, Uint32> overflowSlots;
+    std::vector<TextureHandle>         overflowTextures;
+    Uint32 lastTextureId  = UINT32_MAX;  // sprites from one atlas arrive in runs
+    Uint32 lastTextureKey = kNoTexture;
+
+    // Radix sort output and scratch
+    std::vector<Uint64> sortedKeys, keyScratch;
+    std::vector<Uint32> indices, indexScratch;
+};
+
+}  // namespace Vapor
@@ -7,6 +7,7 @@
 #include "physics_3d.hpp"
 #include "render_data.hpp"
 #include "renderer.hpp"
+#include "rng.hpp"
 #include "render_scene.hpp"
 #include "voxel_world.hpp"
 #include <entt/entt.hpp>
@@ -132,55 +133,14 @@ namespace Vapor {
     // ============================================================================
     class PhysicsSyncSystem {
     public:
-        // Scene → Physics: 同步 Kinematic/Static 物體
+        // Scene → Physics: 同步 Kinematic/Static 物體 (batched, see Physics3D::syncToPhysics)
         static void syncToPhysics(entt::registry& registry, Physics3D* physics) {
-            auto view = registry.view<RigidbodyComponent>();
-
-            for (auto entity : view) {
-                auto& phys = view.get<RigidbodyComponent>(entity);
-
-                if (!phys.body.valid() || !phys.syncToPhysics) {
-                    continue;
-                }
-
-                auto* transform = registry.try_get<TransformComponent>(entity);
-                if (!transform) {
-                    continue;
-                }
-
-                // 檢查運動類型
-                auto motionType = physics->getMotionType(phys.body);
-                if (motionType == BodyMotionType::Kinematic || motionType == BodyMotionType::Static) {
-                    physics->setPosition(phys.body, transform->position);
-                    physics->setRotation(phys.body, transform->rotation);
-                }
-            }
+            physics->syncToPhysics(registry);
         }
 
-        // Physics → Scene: 同步 Dynamic 物體
+        // Physics → Scene: 同步 Dynamic 物體 (batched, see Physics3D::syncFromPhysics)
         static void syncFromPhysics(entt::registry& registry, Physics3D* physics) {
-            auto view = registry.view<RigidbodyComponent>();
-
-            for (auto entity : view) {
-                auto& phys = view.get<RigidbodyComponent>(entity);
-
-                if (!phys.body.valid() || !phys.syncFromPhysics) {
-                    continue;
-                }
-
-                auto* transform = registry.try_get<TransformComponent>(entity);
-                if (!transform) {
-                    continue;
-                }
-
-                // 檢查運動類型
-                auto motionType = physics->getMotionType(phys.body);
-                if (motionType == BodyMotionType::Dynamic) {
-                    transform->position = physics->getPosition(phys.body);
-                    transform->rotation = physics->getRotation(phys.body);
-                    transform->isDirty = true;// 標記需要重新計算世界變換
-                }
-            }
+            physics->syncFromPhysics(registry);
         }
     };
 
@@ -1026,7 +986,7 @@ namespace Vapor {
                            bool emissionEnabled = true) {
             if (!renderer) return;
 
-            static std::mt19937 rng(std::random_device{}());
+            std::mt19937& rng = RngStreams::instance().stream("particles.emitter");
             static std::uniform_real_distribution<float> u01(0.0f, 1.0f);
 
             auto view = registry.view<ParticleEmitterComponent, TransformComponent>(entt::exclude<InactiveComponent>);
@@ -1244,7 +1204,7 @@ namespace Vapor {
         static void update(entt::registry& registry, IRenderer* renderer) {
             if (!renderer) return;
 
-            static std::mt19937 rng(std::random_device{}());
+            std::mt19937& rng = RngStreams::instance().stream("particles.burst");
             static std::uniform_real_distribution<float> u01(0.0f, 1.0f);
 
             auto view = registry.view<ParticleBurstRequest>(entt::exclude<InactiveComponent>);
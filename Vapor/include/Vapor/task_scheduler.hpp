@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <enkiTS/TaskScheduler.h>
 #include <functional>
 #include <memory>
@@ -36,6 +37,33 @@ namespace Vapor {
         // Submit a lambda function as a task
         template<typename Func> void submitTask(Func&& func);
 
+        // Let a thread the scheduler didn't create (e.g. an AsyncIo thread)
+        // call submitTask. Takes one of kMaxExternalThreads slots; false when
+        // none is free or the scheduler isn't initialized. A registered
+        // thread must deregister before it exits.
+        static constexpr uint32_t kMaxExternalThreads = 4;
+        bool registerExternalThread();
+        void deregisterExternalThread();
+
+        // Run func(begin, end, threadIndex) over [0, count), split into ranges
+        // of at least minRange, and block until every range has finished. The
+        // calling thread helps, so this is safe to call from a worker (nested
+        // parallelFor included). threadIndex is in [0, getNumThreads()) and
+        // unique among concurrently running ranges, so it can index per-thread
+        // scratch. Runs inline when the scheduler is not initialized.
+        template<typename Func> void parallelFor(uint32_t count, uint32_t minRange, Func&& func);
+
+        // parallelFor on scheduler, or one inline func(0, count, 0) call when
+        // scheduler is null, for code that takes an optional scheduler.
+        template<typename Func>
+        static void forRange(TaskScheduler* scheduler, size_t count, uint32_t minRange, Func&& func);
+
+        // Thread slots: workers, the main thread and the external-thread
+        // slots (1 when not initialized). Bounds any threadIndex.
+        uint32_t getNumThreads() const {
+            return m_initialized ? m_scheduler->GetNumTaskThreads() : 1u;
+        }
+
         // Check if scheduler is initialized
 
         // Submit a task to be executed on the Main Thread (during processMainThreadTasks)
@@ -85,4 +113,25 @@ namespace Vapor {
         m_scheduler->AddTaskSetToPipe(task);
     }
 
+    template<typename Func> void TaskScheduler::parallelFor(uint32_t count, uint32_t minRange, Func&& func) {
+        if (count == 0) return;
+        if (!m_initialized || count <= minRange) {
+            func(0u, count, m_initialized ? m_scheduler->GetThreadNum() : 0u);
+            return;
+        }
+
+        enki::TaskSet task(count, [&func](enki::TaskSetPartition range, uint32_t threadnum) {
+            func(range.start, range.end, threadnum);
+        });
+        task.m_MinRange = minRange > 0 ? minRange : 1;
+        m_scheduler->AddTaskSetToPipe(&task);
+        m_scheduler->WaitforTask(&task);
+    }
+
+    template<typename Func>
+    void TaskScheduler::forRange(TaskScheduler* scheduler, size_t count, uint32_t minRange, Func&& func) {
+        if (scheduler) scheduler->parallelFor(static_cast<uint32_t>(count), minRange, func);
+        else if (count > 0) func(0u, static_cast<uint32_t>(count), 0u);
+    }
+
 }// namespace Vapor
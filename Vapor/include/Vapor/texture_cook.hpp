@@ -0,0 +1,98 @@
+#pragma once
+#include "graphics.hpp"
+#include <SDL3/SDL_stdinc.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Vapor {
+
+class TaskScheduler;
+
+// How a texture is sampled, which decides its filter and block format.
+enum class TextureCookUsage {
+    Color, // base color / emissive: filtered in linear light, BC7 (BC1 if allowed)
+    Normal,// tangent-space normal: renormalized per mip, xy only in BC5
+    Data,  // ORM / masks / anything else: filtered as stored, BC7
+};
+
+enum class MipFilter {
+    Box,   // 2x2 average; fast, slightly blurry
+    Kaiser,// windowed sinc over 8 taps; keeps detail in the small mips
+};
+
+enum class TextureCookTarget {
+    Desktop,// BC1 / BC5 / BC7
+    Mobile, // ASTC 4x4 (needs astcenc; falls back to Desktop without it)
+};
+
+struct TextureCookOptions {
+    TextureCookTarget target = TextureCookTarget::Desktop;
+    MipFilter mipFilter = MipFilter::Kaiser;
+    bool generateMips = true;
+    // Fully opaque Color/Data images go to BC1 (half of BC7's size) instead
+    // of BC7. Off by default: BC1's 565 endpoints band smooth gradients.
+    bool allowBC1 = false;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TextureCook
+//
+// Offline texture preparation for the scene bake: builds the full mip chain on
+// the CPU and block-compresses every level, so the GPU uploads ready-to-sample
+// data (a quarter of RGBA8's memory or less) and never runs generateMipmaps.
+// Cooked levels are cached in a .vtex file next to the scene's .vscene cook;
+// see writeContainer / readContainer.
+//
+//   TextureCook::cook(*image, TextureCookUsage::Normal, {});
+//   // image->format == BC5_UNORM, image->mipLevels == log2(max(w, h)) + 1
+//
+// ─────────────────────────────────────────────────────────────────────────────
+class TextureCook {
+public:
+    struct Job {
+        std::shared_ptr<Image> image;
+        TextureCookUsage usage = TextureCookUsage::Color;
+    };
+
+    // Replace an RGBA8 (or R8) image's single level with a compressed mip
+    // chain in place. Returns false, leaving the image untouched, when it is
+    // empty, already cooked, or its byte size doesn't match its dimensions.
+    static bool cook(Image& image, TextureCookUsage usage, const TextureCookOptions& options,
+                     TaskScheduler* scheduler = nullptr);
+
+    // Cook every job, in parallel across images (and across block rows inside
+    // each level) when a scheduler is given, and log a one-line summary.
+    static void cookAll(const std::vector<Job>& jobs, const TextureCookOptions& options,
+                        TaskScheduler* scheduler = nullptr);
+
+    // Decode a cooked image back to RGBA8, keeping its mip chain: the runtime
+    // fallback for devices without the block format. False for formats with
+    // no CPU decoder (ASTC without astcenc).
+    static bool decompress(Image& image);
+
+    // True once cook() has replaced the image's loader output.
+    static bool isCooked(const Image& image) {
+        return image.mipLevels > 1 || isCompressedPixelFormat(image.format);
+    }
+
+    // RGBA8 mip chain of a w x h RGBA8 image, level 0 (a copy) first.
+    static std::vector<std::vector<Uint8>> buildMipChain(const std::vector<Uint8>& rgba, Uint32 width,
+                                                         Uint32 height, TextureCookUsage usage, MipFilter filter);
+
+    // .vtex container: every cooked image (isCooked) of a scene, keyed by its
+    // index in `images`, tagged with the source hash of the scene it was
+    // cooked from. Levels are stored smallest first, each 16-byte aligned (as
+    // KTX2 does), so a streamer can read the small mips without touching the
+    // large ones.
+    static bool writeContainer(const std::string& path, const std::vector<std::shared_ptr<Image>>& images,
+                               uint64_t sourceHash);
+    // Fills the byteArray / format / mipLevels of every image the file holds.
+    // False (images untouched) if the file is missing, corrupt, or was cooked
+    // from a different source hash.
+    static bool readContainer(const std::string& path, const std::vector<std::shared_ptr<Image>>& images,
+                              uint64_t sourceHash);
+};
+
+} // namespace Vapor
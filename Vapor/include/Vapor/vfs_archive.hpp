@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Vapor {
+
+// ============================================================================
+// Packed archives — one file per shipped content root.
+//
+//     header  'VPAK', u32 version, u32 alignment, u32 entryCount,
+//             u64 tocOffset, u64 tocSize
+//     data    entries back to back, each starting on an `alignment` boundary
+//     toc     per entry: u64 offset, u64 storedSize, u64 size, u32 codec,
+//             u32 pathLength, path (relative, '/'-separated)
+//
+// The TOC is read once at mount; a lookup is a hash probe and a read is one
+// pread() of the stored bytes (plus a decompress), so a mounted pack costs a
+// single open() however many files it holds. Entries are compressed only when
+// the codec is compiled in and saves at least 1/8; codecs a build lacks fail
+// the read of that entry, not the mount.
+// ============================================================================
+
+enum class VfsCodec : uint32_t {
+    None = 0,
+    LZ4 = 1, // VAPOR_HAS_LZ4
+    Zstd = 2,// VAPOR_HAS_ZSTD
+};
+
+class VfsArchive {
+public:
+    struct Entry {
+        std::string path;
+        uint64_t offset = 0;
+        uint64_t storedSize = 0;// bytes in the archive
+        uint64_t size = 0;      // bytes once decoded
+        VfsCodec codec = VfsCodec::None;
+    };
+
+    // nullptr (with a log) if the file is missing or not a valid archive.
+    static std::shared_ptr<VfsArchive> open(const std::string& archivePath);
+    ~VfsArchive();
+
+    VfsArchive(const VfsArchive&) = delete;
+    VfsArchive& operator=(const VfsArchive&) = delete;
+
+    // `relativePath` must already be normalized (normalizeVfsPath).
+    [[nodiscard]] const Entry* find(std::string_view relativePath) const;
+    // True for the root ("") and every directory some entry lies under.
+    [[nodiscard]] bool hasDirectory(std::string_view relativePath) const;
+    // Whole entry, decoded. Thread-safe.
+    [[nodiscard]] std::optional<std::vector<uint8_t>> read(const Entry& entry) const;
+    // Second half of read(), for callers that fetched the stored bytes
+    // themselves (AsyncIo reads [entry.offset, +storedSize) of getPath()).
+    [[nodiscard]] std::optional<std::vector<uint8_t>> decode(const Entry& entry, std::vector<uint8_t> stored) const;
+
+    // Sorted by path.
+    const std::vector<Entry>& getEntries() const {
+        return m_entries;
+    }
+    const std::string& getPath() const {
+        return m_path;
+    }
+
+private:
+    VfsArchive() = default;
+
+    std::string m_path;
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, uint32_t> m_lookup;// vfsLookupKey -> m_entries index
+    std::unordered_set<std::string> m_directories;      // vfsLookupKey of every entry's parents
+#ifdef _WIN32
+    mutable std::mutex m_readMutex;
+    std::FILE* m_file = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+struct VfsArchiveOptions {
+    VfsCodec codec = VfsCodec::None;
+    uint32_t alignment = 16;// power of two
+};
+
+// Pack every regular file under `sourceDir` (recursively, sorted by path) into
+// `archivePath`. False (with a log) on I/O failure or an unavailable codec.
+bool writeVfsArchive(
+    const std::string& archivePath, const std::string& sourceDir, const VfsArchiveOptions& options = {}
+);
+
+// Canonical relative form used as the lookup key everywhere in the VFS:
+// '/'-separated, lexically normalized, no trailing slash, "" for the root.
+// nullopt for absolute paths and paths escaping the root ("../x"), which
+// bypass the mount indexes.
+std::optional<std::string> normalizeVfsPath(std::string_view path);
+
+// Hash key of a normalized path: case-folded where the host file system is
+// case-insensitive (Windows, macOS), verbatim elsewhere.
+std::string vfsLookupKey(std::string_view normalizedPath);
+
+}// namespace Vapor
@@ -101,6 +101,10 @@ public:
     // generateColumnChunk fills one GEN_CHUNK_DIM x gridDim.y x GEN_CHUNK_DIM
     // column block; chunks are disjoint, so any number may run concurrently on
     // worker threads. generate() = prepare + every chunk, single-threaded.
+    // A chunk is built brick by brick: noise lattices are hashed once per
+    // brick (caves) or chunk (heightfield), bricks above the surface or fully
+    // carved are rejected before any per-voxel work, and each brick is packed
+    // straight into the pool.
     void prepareGeneration(Uint32 seedIn);
     void generateColumnChunk(int chunkX, int chunkZ);
     void generate(Uint32 seedIn);
@@ -170,6 +174,10 @@ private:
     }
 
     void setDefaultPalette();
+    // Heightfield sampling frequency (cycles per voxel) and the fbm -> voxel
+    // height shaping shared by terrainHeight and the chunk kernel's cached path.
+    float terrainFrequency() const;
+    float shapeTerrainHeight(float h01) const;
     // Allocates a pool slot (mutex-held by caller); PAGE_EMPTY when exhausted.
     Uint32 allocSlotLocked();
     void freeSlotLocked(Uint32 slot);
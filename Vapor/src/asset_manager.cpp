@@ -33,13 +33,20 @@ using namespace Vapor;
 // missing content must not take the engine down, and these also run on
 // ResourceManager worker threads where an escaped exception is fatal.
 auto AssetManager::loadImage(const std::string& filename) -> std::shared_ptr<Image> {
-    auto fullPath = FileSystem::instance().resolvePath(filename);
-    if (!fullPath) {
+    // Read through the VFS so packed archives serve images too.
+    auto bytes = FileSystem::instance().readFile(filename);
+    if (!bytes) {
         fmt::print(stderr, "loadImage '{}': not found in any search path\n", filename);
         return nullptr;
     }
+    return decodeImage(filename, bytes->data(), bytes->size());
+}
+
+auto AssetManager::decodeImage(const std::string& filename, const uint8_t* encoded, size_t size)
+    -> std::shared_ptr<Image> {
+    const int encodedSize = static_cast<int>(size);
     int width, height, numChannels;
-    if (!stbi_info(fullPath->c_str(), &width, &height, &numChannels)) {
+    if (!stbi_info_from_memory(encoded, encodedSize, &width, &height, &numChannels)) {
         fmt::print(stderr, "loadImage '{}': {}\n", filename, stbi_failure_reason());
         return nullptr;
     }
@@ -56,7 +63,7 @@ auto AssetManager::loadImage(const std::string& filename) -> std::shared_ptr<Ima
         fmt::print(stderr, "loadImage '{}': unsupported channel count {}\n", filename, numChannels);
         return nullptr;
     }
-    uint8_t* data = stbi_load(fullPath->c_str(), &width, &height, &numChannels, desiredChannels);
+    uint8_t* data = stbi_load_from_memory(encoded, encodedSize, &width, &height, &numChannels, desiredChannels);
     if (!data) {
         fmt::print(stderr, "loadImage '{}': {}\n", filename, stbi_failure_reason());
         return nullptr;
@@ -1,12 +1,64 @@
 #include "asset_serializer.hpp"
+#include "meshlet_builder.hpp"
 #include <SDL3/SDL_stdinc.h>
 #include <SDL3/SDL_timer.h>
+#include <algorithm>
 #include <fmt/core.h>
 #include <fstream>
+#include <meshoptimizer.h>
+#include <stdexcept>
 #include <unordered_map>
 
 using namespace Vapor;
 
+namespace {
+
+// Vertex-like streams go through meshopt's vertex codec: element count, then
+// the encoded bytes. Lossless, so decode reproduces the exact input bytes.
+template<typename T>
+void writeVertexStream(cereal::BinaryOutputArchive& archive, const std::vector<T>& values) {
+    static_assert(sizeof(T) % 4 == 0 && sizeof(T) <= 256, "meshopt vertex codec element size");
+    std::vector<unsigned char> blob;
+    if (!values.empty()) {
+        blob.resize(meshopt_encodeVertexBufferBound(values.size(), sizeof(T)));
+        blob.resize(meshopt_encodeVertexBuffer(blob.data(), blob.size(), values.data(), values.size(), sizeof(T)));
+    }
+    archive(static_cast<Uint64>(values.size()), blob);
+}
+
+template<typename T>
+void readVertexStream(cereal::BinaryInputArchive& archive, std::vector<T>& values) {
+    Uint64 count = 0;
+    std::vector<unsigned char> blob;
+    archive(count, blob);
+    values.resize(count);
+    if (count > 0 && meshopt_decodeVertexBuffer(values.data(), count, sizeof(T), blob.data(), blob.size()) != 0)
+        throw std::runtime_error("corrupt vertex stream");
+}
+
+// Index-like streams use the index sequence codec rather than the triangle
+// codec: the latter may rotate triangles, and these must come back verbatim.
+void writeIndexStream(cereal::BinaryOutputArchive& archive, const std::vector<Uint32>& indices) {
+    std::vector<unsigned char> blob;
+    if (!indices.empty()) {
+        const size_t vertexCount = size_t(*std::max_element(indices.begin(), indices.end())) + 1;
+        blob.resize(meshopt_encodeIndexSequenceBound(indices.size(), vertexCount));
+        blob.resize(meshopt_encodeIndexSequence(blob.data(), blob.size(), indices.data(), indices.size()));
+    }
+    archive(static_cast<Uint64>(indices.size()), blob);
+}
+
+void readIndexStream(cereal::BinaryInputArchive& archive, std::vector<Uint32>& indices) {
+    Uint64 count = 0;
+    std::vector<unsigned char> blob;
+    archive(count, blob);
+    indices.resize(count);
+    if (count > 0 && meshopt_decodeIndexSequence(indices.data(), count, sizeof(Uint32), blob.data(), blob.size()) != 0)
+        throw std::runtime_error("corrupt index stream");
+}
+
+}// namespace
+
 void AssetSerializer::serializeMaterial(
     cereal::BinaryOutputArchive& archive,
     const std::shared_ptr<Material>& material,
@@ -127,6 +179,8 @@ void AssetSerializer::serializeImage(cereal::BinaryOutputArchive& archive, const
     archive(image->width);
     archive(image->height);
     archive(image->channelCount);
+    archive(static_cast<Uint32>(image->format));
+    archive(image->mipLevels);
     archive(image->byteArray);
 }
 
@@ -142,6 +196,10 @@ auto AssetSerializer::deserializeImage(cereal::BinaryInputArchive& archive) -> s
     archive(image->width);
     archive(image->height);
     archive(image->channelCount);
+    Uint32 format = 0;
+    archive(format);
+    image->format = static_cast<PixelFormat>(format);
+    archive(image->mipLevels);
     archive(image->byteArray);
 
     return image;
@@ -163,8 +221,12 @@ void AssetSerializer::serializeMesh(
     archive(mesh->hasUV0);
     archive(mesh->hasUV1);
     archive(mesh->hasColor);
-    archive(mesh->vertices);
-    archive(mesh->indices);
+    // A compressed mesh ships its packed vertices in place of the full ones;
+    // they decode back at load, in the same order (v8).
+    const bool packed = mesh->meshletData.isCompressed();
+    archive(packed);
+    if (!packed) writeVertexStream(archive, mesh->vertices);
+    writeIndexStream(archive, mesh->indices);
     archive(static_cast<int>(mesh->primitiveMode));
 
     archive(mesh->vertexOffset);
@@ -174,12 +236,17 @@ void AssetSerializer::serializeMesh(
     archive(mesh->localAABBMin);
     archive(mesh->localAABBMax);
 
-    // Baked meshlet + cluster-LOD data (v4). Empty vectors when not built.
+    // Baked meshlet + cluster-LOD data (v4; v5 codes the vertex refs, v8 adds
+    // the packed vertices and their grids). Empty vectors when not built.
     archive(mesh->meshletData.meshlets);
-    archive(mesh->meshletData.meshletVertices);
+    writeIndexStream(archive, mesh->meshletData.meshletVertices);
     archive(mesh->meshletData.meshletTriangles);
     archive(mesh->meshletData.bounds);
     archive(mesh->meshletData.lodLevelCount);
+    if (packed) {
+        archive(mesh->meshletData.quantization);
+        writeVertexStream(archive, mesh->meshletData.packedVertices);
+    }
 
     if (mesh->material) {
         auto it = materialIDs.find(mesh->material);
@@ -210,8 +277,10 @@ auto AssetSerializer::deserializeMesh(
     archive(mesh->hasUV0);
     archive(mesh->hasUV1);
     archive(mesh->hasColor);
-    archive(mesh->vertices);
-    archive(mesh->indices);
+    bool packed = false;
+    archive(packed);
+    if (!packed) readVertexStream(archive, mesh->vertices);
+    readIndexStream(archive, mesh->indices);
 
     int primitiveModeInt;
     archive(primitiveModeInt);
@@ -225,12 +294,17 @@ auto AssetSerializer::deserializeMesh(
     archive(mesh->localAABBMax);
     mesh->isGeometryDirty = false;// prevent AABB updating
 
-    // Baked meshlet + cluster-LOD data (v4), written after localAABBMax above.
+    // Baked meshlet + cluster-LOD data (v4/v5/v8), written after localAABBMax above.
     archive(mesh->meshletData.meshlets);
-    archive(mesh->meshletData.meshletVertices);
+    readIndexStream(archive, mesh->meshletData.meshletVertices);
     archive(mesh->meshletData.meshletTriangles);
     archive(mesh->meshletData.bounds);
     archive(mesh->meshletData.lodLevelCount);
+    if (packed) {
+        archive(mesh->meshletData.quantization);
+        readVertexStream(archive, mesh->meshletData.packedVertices);
+        MeshletBuilder::decompress(*mesh);
+    }
 
     bool hasMaterial;
     archive(hasMaterial);
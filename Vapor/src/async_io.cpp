@@ -0,0 +1,489 @@
+#include "async_io.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fmt/core.h>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define VAPOR_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace Vapor {
+
+    namespace {
+
+        struct PendingRead {
+            IoRequest request;
+            IoCallback callback;
+        };
+
+        // Blocking read: the thread-pool backend, and io_uring's fallback.
+        std::optional<std::vector<uint8_t>> readBlocking(const IoRequest& request) {
+#ifdef _WIN32
+            std::FILE* file = std::fopen(request.path.c_str(), "rb");
+            if (!file) return std::nullopt;
+            _fseeki64(file, 0, SEEK_END);
+            const int64_t fileSize = _ftelli64(file);
+            if (fileSize < 0 || request.offset > static_cast<uint64_t>(fileSize)) {
+                std::fclose(file);
+                return std::nullopt;
+            }
+            std::vector<uint8_t> data(
+                static_cast<size_t>(std::min(request.size, static_cast<uint64_t>(fileSize) - request.offset))
+            );
+            _fseeki64(file, static_cast<int64_t>(request.offset), SEEK_SET);
+            const bool ok = std::fread(data.data(), 1, data.size(), file) == data.size();
+            std::fclose(file);
+            if (!ok) return std::nullopt;
+            return data;
+#else
+            const int fd = ::open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return std::nullopt;
+            struct stat st {};
+            if (::fstat(fd, &st) != 0 || request.offset > static_cast<uint64_t>(st.st_size)) {
+                ::close(fd);
+                return std::nullopt;
+            }
+            std::vector<uint8_t> data(
+                static_cast<size_t>(std::min(request.size, static_cast<uint64_t>(st.st_size) - request.offset))
+            );
+            size_t done = 0;
+            while (done < data.size()) {
+                const ssize_t n =
+                    ::pread(fd, data.data() + done, data.size() - done, static_cast<off_t>(request.offset + done));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) {
+                    ::close(fd);
+                    return std::nullopt;
+                }
+                done += static_cast<size_t>(n);
+            }
+            ::close(fd);
+            return data;
+#endif
+        }
+
+        void deliver(PendingRead& read, std::optional<std::vector<uint8_t>> bytes) {
+            try {
+                read.callback(std::move(bytes));
+            } catch (const std::exception& e) {
+                fmt::print(stderr, "[AsyncIo] callback for '{}' threw: {}\n", read.request.path, e.what());
+            }
+        }
+
+#ifdef VAPOR_IO_URING
+        // Minimal io_uring over the raw syscalls (no liburing dependency).
+        // Only the owning thread touches the rings.
+        class Uring {
+        public:
+            ~Uring() {
+                if (m_sqes) ::munmap(m_sqes, m_sqesSize);
+                if (m_cqPtr && m_cqPtr != m_sqPtr) ::munmap(m_cqPtr, m_cqSize);
+                if (m_sqPtr) ::munmap(m_sqPtr, m_sqSize);
+                if (m_fd >= 0) ::close(m_fd);
+            }
+
+            bool init(unsigned entries) {
+                io_uring_params params{};
+                m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (m_fd < 0) return false;
+
+                m_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+                if (single) m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+
+                m_sqPtr = map(m_sqSize, IORING_OFF_SQ_RING);
+                if (!m_sqPtr) return false;
+                m_cqPtr = single ? m_sqPtr : map(m_cqSize, IORING_OFF_CQ_RING);
+                m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+                m_sqes = static_cast<io_uring_sqe*>(map(m_sqesSize, IORING_OFF_SQES));
+                if (!m_cqPtr || !m_sqes) return false;
+
+                auto* sq = static_cast<uint8_t*>(m_sqPtr);
+                auto* cq = static_cast<uint8_t*>(m_cqPtr);
+                m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+                m_entries = params.sq_entries;
+                m_localTail = *m_sqTail;
+                return true;
+            }
+
+            unsigned getEntries() const {
+                return m_entries;
+            }
+
+            // Whether the kernel implements `opcode`. IORING_REGISTER_PROBE
+            // arrived in Linux 5.6 together with IORING_OP_READ, so on older
+            // kernels the probe itself fails and nothing counts as supported.
+            bool supports(unsigned opcode) const {
+                constexpr unsigned kProbeOps = 256;
+                std::vector<uint8_t> buffer(sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op));
+                auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+                if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0) return false;
+                return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+            }
+
+            // Zeroed slot, published on the next enter(). The caller keeps the
+            // number of unreaped submissions within getEntries().
+            io_uring_sqe* prepare() {
+                const unsigned index = m_localTail & m_sqMask;
+                io_uring_sqe* sqe = &m_sqes[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                m_sqArray[index] = index;
+                ++m_localTail;
+                ++m_unsubmitted;
+                return sqe;
+            }
+
+            // Submit everything prepared, then block until at least one
+            // completion is ready.
+            bool enter() {
+                __atomic_store_n(m_sqTail, m_localTail, __ATOMIC_RELEASE);
+                for (;;) {
+                    const long n = ::syscall(__NR_io_uring_enter, m_fd, m_unsubmitted, 1u, IORING_ENTER_GETEVENTS,
+                                             nullptr, 0);
+                    if (n >= 0) {
+                        m_unsubmitted -= std::min<unsigned>(static_cast<unsigned>(n), m_unsubmitted);
+                        if (m_unsubmitted == 0) return true;
+                        continue;
+                    }
+                    if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+                }
+            }
+
+            template<typename Fn> void reap(Fn&& fn) {
+                unsigned head = *m_cqHead;
+                const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head) {
+                    const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+                    fn(cqe.user_data, cqe.res);
+                }
+                __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+            }
+
+        private:
+            void* map(size_t size, off_t offset) const {
+                void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+                return ptr == MAP_FAILED ? nullptr : ptr;
+            }
+
+            int m_fd = -1;
+            void* m_sqPtr = nullptr;
+            void* m_cqPtr = nullptr;
+            size_t m_sqSize = 0;
+            size_t m_cqSize = 0;
+            size_t m_sqesSize = 0;
+            io_uring_sqe* m_sqes = nullptr;
+            io_uring_cqe* m_cqes = nullptr;
+            unsigned* m_sqTail = nullptr;
+            unsigned* m_sqArray = nullptr;
+            unsigned* m_cqHead = nullptr;
+            unsigned* m_cqTail = nullptr;
+            unsigned m_sqMask = 0;
+            unsigned m_cqMask = 0;
+            unsigned m_entries = 0;
+            unsigned m_localTail = 0;
+            unsigned m_unsubmitted = 0;
+        };
+
+        // One whole-file or ranged read in flight on the ring.
+        struct UringRead {
+            PendingRead read;
+            int fd = -1;
+            uint64_t done = 0;
+            std::vector<uint8_t> data;
+        };
+
+        constexpr uint64_t kWakeTag = 0;// user_data of the eventfd read
+        constexpr size_t kMaxReadChunk = 1u << 30;
+#endif
+
+    }// namespace
+
+    struct AsyncIo::Impl {
+        Config config;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;// thread-pool backend: new work or stop
+        std::condition_variable idle;// pending dropped to 0
+        std::deque<PendingRead> queue;
+        size_t pending = 0;// queued + in flight + callback running
+        bool stopping = false;
+        bool started = false;
+        const char* backend = "threads";
+        std::vector<std::thread> threads;
+
+#ifdef VAPOR_IO_URING
+        std::unique_ptr<Uring> ring;
+        std::atomic<bool> useRing{ false };// cleared if the ring fails mid-run
+        int eventFd = -1;
+        uint64_t wakeValue = 0;
+        std::unordered_set<UringRead*> live;// submitted to the kernel
+#endif
+
+        void finishOne() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) idle.notify_all();
+        }
+
+        // Called with `mutex` held, on the first read.
+        void start() {
+            started = true;
+#ifdef VAPOR_IO_URING
+            auto candidate = std::make_unique<Uring>();
+            const int fd = ::eventfd(0, EFD_CLOEXEC);
+            // Reads and the eventfd wake are both IORING_OP_READ (Linux 5.6+);
+            // older kernels get the thread pool.
+            if (fd >= 0 && candidate->init(std::max(config.queueDepth, 4u)) && candidate->supports(IORING_OP_READ)) {
+                ring = std::move(candidate);
+                useRing = true;
+                eventFd = fd;
+                backend = "io_uring";
+                threads.emplace_back([this] { runUring(); });
+                return;
+            }
+            if (fd >= 0) ::close(fd);
+#endif
+            for (uint32_t i = 0; i < std::max(config.threads, 1u); ++i) {
+                threads.emplace_back([this] { runThreadPool(); });
+            }
+        }
+
+        void notify() {
+#ifdef VAPOR_IO_URING
+            if (useRing) {
+                const uint64_t one = 1;
+                [[maybe_unused]] const ssize_t n = ::write(eventFd, &one, sizeof(one));
+                return;
+            }
+#endif
+            wake.notify_one();
+        }
+
+        void runThreadPool() {
+            if (config.onThreadStart) config.onThreadStart();
+            serveQueue();
+            if (config.onThreadExit) config.onThreadExit();
+        }
+
+        // Blocking reads off the queue until stopped and drained.
+        void serveQueue() {
+            for (;;) {
+                PendingRead read;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                    if (queue.empty()) break;
+                    read = std::move(queue.front());
+                    queue.pop_front();
+                }
+                auto bytes = readBlocking(read.request);
+                deliver(read, std::move(bytes));
+                finishOne();
+            }
+        }
+
+#ifdef VAPOR_IO_URING
+        void runUring() {
+            if (config.onThreadStart) config.onThreadStart();
+            // One slot stays armed on the eventfd, so read() can wake the
+            // thread out of io_uring_enter.
+            const unsigned capacity = ring->getEntries() - 1;
+            armWake();
+
+            for (;;) {
+                std::deque<PendingRead> incoming;
+                bool stop = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    while (!queue.empty() && live.size() + incoming.size() < capacity) {
+                        incoming.push_back(std::move(queue.front()));
+                        queue.pop_front();
+                    }
+                    stop = stopping && queue.empty();
+                }
+                for (PendingRead& read : incoming) begin(std::move(read));
+                if (stop && live.empty()) break;
+
+                // Everything gathered above goes to the kernel in this one call.
+                if (!ring->enter()) {
+                    fmt::print(stderr, "[AsyncIo] io_uring_enter failed: {}; falling back to blocking reads\n",
+                               std::strerror(errno));
+                    abandonRing();
+                    serveQueue();
+                    break;
+                }
+                ring->reap([&](uint64_t tag, int32_t result) {
+                    if (tag == kWakeTag) {
+                        armWake();
+                    } else {
+                        advance(reinterpret_cast<UringRead*>(tag), result);
+                    }
+                });
+            }
+            if (config.onThreadExit) config.onThreadExit();
+        }
+
+        // The ring is unusable: switch notify() to the condition variable and
+        // re-read every submitted request blocking, so none stays pending
+        // (waitIdle would hang). The kernel may still own those reads'
+        // buffers, so they are leaked rather than freed.
+        void abandonRing() {
+            useRing = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                backend = "threads";
+            }
+            for (UringRead* op : live) {
+                auto bytes = readBlocking(op->read.request);
+                deliver(op->read, std::move(bytes));
+                finishOne();
+            }
+            live.clear();
+        }
+
+        void armWake() {
+            io_uring_sqe* sqe = ring->prepare();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = eventFd;
+            sqe->addr = reinterpret_cast<uint64_t>(&wakeValue);
+            sqe->len = sizeof(wakeValue);
+            sqe->user_data = kWakeTag;
+        }
+
+        void submitChunk(UringRead* op) {
+            io_uring_sqe* sqe = ring->prepare();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = op->fd;
+            sqe->addr = reinterpret_cast<uint64_t>(op->data.data() + op->done);
+            sqe->len = static_cast<uint32_t>(std::min<uint64_t>(op->data.size() - op->done, kMaxReadChunk));
+            sqe->off = op->read.request.offset + op->done;
+            sqe->user_data = reinterpret_cast<uint64_t>(op);
+        }
+
+        // Opens the file and queues its first chunk, unless the read finishes
+        // (or fails) on the spot.
+        void begin(PendingRead read) {
+            auto op = std::make_unique<UringRead>();
+            op->read = std::move(read);
+            const IoRequest& request = op->read.request;
+            op->fd = ::open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st {};
+            if (op->fd < 0 || ::fstat(op->fd, &st) != 0 || request.offset > static_cast<uint64_t>(st.st_size)) {
+                complete(op.release(), false);
+                return;
+            }
+            op->data.resize(static_cast<size_t>(std::min(request.size, static_cast<uint64_t>(st.st_size) - request.offset)));
+            if (op->data.empty()) {
+                complete(op.release(), true);
+                return;
+            }
+            live.insert(op.get());
+            submitChunk(op.release());
+        }
+
+        // Handles one completion: the next chunk, or the end of the read.
+        void advance(UringRead* op, int32_t result) {
+            if (result == -EINTR || result == -EAGAIN) {
+                submitChunk(op);
+                return;
+            }
+            if (result <= 0) {
+                // Error, or EOF before the expected size (file shrank).
+                complete(op, false);
+                return;
+            }
+            op->done += static_cast<uint64_t>(result);
+            if (op->done < op->data.size()) {
+                submitChunk(op);
+                return;
+            }
+            complete(op, true);
+        }
+
+        void complete(UringRead* op, bool ok) {
+            live.erase(op);
+            std::unique_ptr<UringRead> owned(op);
+            if (owned->fd >= 0) ::close(owned->fd);
+            if (ok) {
+                deliver(owned->read, std::move(owned->data));
+            } else {
+                deliver(owned->read, std::nullopt);
+            }
+            finishOne();
+        }
+#endif
+    };
+
+    AsyncIo::AsyncIo() : AsyncIo(Config{}) {
+    }
+
+    AsyncIo::AsyncIo(Config config) : m_impl(std::make_unique<Impl>()) {
+        m_impl->config = std::move(config);
+    }
+
+    AsyncIo::~AsyncIo() {
+        {
+            std::lock_guard<std::mutex> lock(m_impl->mutex);
+            m_impl->stopping = true;
+        }
+        m_impl->wake.notify_all();
+        m_impl->notify();
+        for (auto& thread : m_impl->threads) thread.join();
+#ifdef VAPOR_IO_URING
+        m_impl->ring.reset();
+        if (m_impl->eventFd >= 0) ::close(m_impl->eventFd);
+#endif
+    }
+
+    void AsyncIo::read(IoRequest request, IoCallback callback) {
+        {
+            std::lock_guard<std::mutex> lock(m_impl->mutex);
+            if (!m_impl->started) m_impl->start();
+            m_impl->queue.push_back({ std::move(request), std::move(callback) });
+            ++m_impl->pending;
+        }
+        m_impl->notify();
+    }
+
+    void AsyncIo::waitIdle() {
+        std::unique_lock<std::mutex> lock(m_impl->mutex);
+        m_impl->idle.wait(lock, [this] { return m_impl->pending == 0; });
+    }
+
+    size_t AsyncIo::getPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        return m_impl->pending;
+    }
+
+    const char* AsyncIo::getBackendName() const {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        return m_impl->backend;
+    }
+
+}// namespace Vapor
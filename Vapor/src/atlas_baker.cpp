@@ -1,12 +1,222 @@
 #include "Vapor/atlas_baker.hpp"
+#include "Vapor/task_scheduler.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <climits>
+#include <cmath>
 #include <cstring>
+#include <fmt/core.h>
+#include <fstream>
 #include <numeric>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 using namespace Vapor;
 
+namespace {
+
+// ── Alpha scans (RGBA8, alpha in the high byte of each little-endian texel) ──
+
+// True if any of the 16 texels at px has a non-zero alpha.
+bool anyOpaque16(const Uint8* px) {
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i v = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px)),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + 16))),
+        _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px + 32)),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + 48))));
+    const __m128i alpha = _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFF000000u)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) != 0xFFFF;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    return vmaxvq_u8(vld4q_u8(px).val[3]) != 0;
+#else
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t word;
+        std::memcpy(&word, px + i * 8, sizeof(word));
+        bits |= word;
+    }
+    return (bits & 0xFF000000FF000000ull) != 0;
+#endif
+}
+
+// Index of the first texel in [0, count) with non-zero alpha, or count.
+Uint32 firstOpaque(const Uint8* px, Uint32 count) {
+    Uint32 i = 0;
+    while (i + 16 <= count && !anyOpaque16(px + size_t(i) * 4)) i += 16;
+    for (; i < count; ++i)
+        if (px[size_t(i) * 4 + 3]) return i;
+    return count;
+}
+
+// Index of the last texel in [0, count) with non-zero alpha, or count.
+Uint32 lastOpaque(const Uint8* px, Uint32 count) {
+    Uint32 end = count;
+    while (end >= 16 && !anyOpaque16(px + size_t(end - 16) * 4)) end -= 16;
+    while (end > 0)
+        if (px[size_t(--end) * 4 + 3]) return end;
+    return count;
+}
+
+// ── Channel expansion to RGBA8 ───────────────────────────────────────────────
+
+void expandRgbToRgba(Uint8* dst, const Uint8* src, Uint32 count) {
+    Uint32 i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x3_t rgb = vld3q_u8(src + size_t(i) * 3);
+        uint8x16x4_t rgba;
+        rgba.val[0] = rgb.val[0];
+        rgba.val[1] = rgb.val[1];
+        rgba.val[2] = rgb.val[2];
+        rgba.val[3] = vdupq_n_u8(255);
+        vst4q_u8(dst + size_t(i) * 4, rgba);
+    }
+#elif defined(__SSSE3__)
+    // 4 texels per shuffle; the 16-byte load reads 4 bytes past them, so stop
+    // while 6 texels (18 bytes) remain.
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    for (; i + 6 <= count; i += 4) {
+        const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(i) * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(i) * 4),
+                         _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+// Fixed-stride loops the compiler vectorizes on its own.
+void expandGrayToRgba(Uint8* dst, const Uint8* src, Uint32 count) {
+    for (Uint32 i = 0; i < count; ++i) {
+        const uint32_t texel = src[i] * 0x010101u | 0xFF000000u;
+        std::memcpy(dst + size_t(i) * 4, &texel, sizeof(texel));
+    }
+}
+
+void expandRgToRgba(Uint8* dst, const Uint8* src, Uint32 count) {
+    for (Uint32 i = 0; i < count; ++i) {
+        dst[i * 4 + 0] = src[i * 2 + 0];
+        dst[i * 4 + 1] = src[i * 2 + 1];
+        dst[i * 4 + 2] = src[i * 2 + 0];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+// ── Bake cache ───────────────────────────────────────────────────────────────
+// Binary file: header, frame table, then the atlas pixels. Keyed by
+// AtlasBaker::inputHash; any mismatch (or a version bump) is a miss.
+
+constexpr char     kCacheMagic[4] = {'V', 'A', 'T', 'L'};
+constexpr uint32_t kCacheVersion  = 1;
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t h) {
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15ull;
+    const auto* bytes = static_cast<const Uint8*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        h = std::rotl(h ^ word, 29) * kMul;
+    }
+    for (; i < size; ++i) h = (h ^ bytes[i]) * 0x100000001B3ull;
+    return h ^ (h >> 32);
+}
+
+// maxSize and maxFrames bound what pack could have written for these inputs,
+// so a garbled header can't size the frame table or pixel buffer.
+std::optional<AtlasBaker::Result> readCache(const std::string& path, uint64_t key, Uint32 maxSize, size_t maxFrames) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return std::nullopt;
+    auto get = [&](auto& value) { in.read(reinterpret_cast<char*>(&value), sizeof(value)); };
+
+    char magic[4] = {};
+    uint32_t version = 0, width = 0, height = 0, frameCount = 0;
+    uint64_t storedKey = 0;
+    in.read(magic, sizeof(magic));
+    get(version);
+    get(storedKey);
+    if (!in || std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 || version != kCacheVersion || storedKey != key)
+        return std::nullopt;
+    get(width);
+    get(height);
+    get(frameCount);
+    if (!in || width == 0 || height == 0 || width > maxSize || height > maxSize || frameCount > maxFrames ||
+        frameCount > 0xFFFF)
+        return std::nullopt;
+
+    AtlasBaker::Result result;
+    result.atlas.name = "baked_atlas";
+    result.atlas.size = {static_cast<float>(width), static_cast<float>(height)};
+    result.atlas.frames.resize(frameCount);
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        SpriteFrame& frame = result.atlas.frames[i];
+        uint32_t nameSize = 0;
+        get(nameSize);
+        if (!in || nameSize > 4096) return std::nullopt;
+        frame.name.resize(nameSize);
+        in.read(frame.name.data(), nameSize);
+        get(frame.uvRect);
+        get(frame.sourceSize);
+        get(frame.offset);
+        get(frame.pivot);
+        result.atlas.nameToIndex[frame.name] = static_cast<Uint16>(i);
+    }
+
+    auto image          = std::make_shared<Image>();
+    image->width        = width;
+    image->height       = height;
+    image->channelCount = 4;
+    image->byteArray.resize(size_t(width) * height * 4);
+    in.read(reinterpret_cast<char*>(image->byteArray.data()), static_cast<std::streamsize>(image->byteArray.size()));
+    if (!in) return std::nullopt;
+
+    result.success    = true;
+    result.atlasImage = std::move(image);
+    return result;
+}
+
+void writeCache(const std::string& path, uint64_t key, const AtlasBaker::Result& result) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fmt::print(stderr, "atlas bake: cannot write cache '{}'\n", path);
+        return;
+    }
+    auto put = [&](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    const Image& image = *result.atlasImage;
+    out.write(kCacheMagic, sizeof(kCacheMagic));
+    put(kCacheVersion);
+    put(key);
+    put(static_cast<uint32_t>(image.width));
+    put(static_cast<uint32_t>(image.height));
+    put(static_cast<uint32_t>(result.atlas.frames.size()));
+    for (const SpriteFrame& frame : result.atlas.frames) {
+        put(static_cast<uint32_t>(frame.name.size()));
+        out.write(frame.name.data(), static_cast<std::streamsize>(frame.name.size()));
+        put(frame.uvRect);
+        put(frame.sourceSize);
+        put(frame.offset);
+        put(frame.pivot);
+    }
+    out.write(reinterpret_cast<const char*>(image.byteArray.data()), static_cast<std::streamsize>(image.byteArray.size()));
+}
+
+} // namespace
+
 namespace Vapor {
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -39,44 +249,65 @@ AtlasBaker::MaxRectsBin::PlaceResult AtlasBaker::MaxRectsBin::insert(Uint32 w, U
 
     if (bestIdx < 0) return {0, 0, false};
 
+    // Free rects overlap each other, so every one the placed rect touches is
+    // split, not only the one it was placed in.
     Rect placed = {freeRects[bestIdx].x, freeRects[bestIdx].y, w, h};
-    splitFreeNode(freeRects[bestIdx], placed);
-    freeRects.erase(freeRects.begin() + bestIdx);
+    newFreeRects.clear();
+    for (size_t i = 0; i < freeRects.size();) {
+        if (splitFreeNode(freeRects[i], placed)) {
+            freeRects[i] = freeRects.back();
+            freeRects.pop_back();
+        } else {
+            ++i;
+        }
+    }
     pruneFreeList();
 
     return {placed.x, placed.y, true};
 }
 
-void AtlasBaker::MaxRectsBin::splitFreeNode(const Rect& fn, const Rect& pl) {
+bool AtlasBaker::MaxRectsBin::splitFreeNode(const Rect& fn, const Rect& pl) {
+    if (pl.x >= fn.x + fn.w || pl.x + pl.w <= fn.x
+        || pl.y >= fn.y + fn.h || pl.y + pl.h <= fn.y)
+        return false;
+
     // Right slice
     if (pl.x + pl.w < fn.x + fn.w)
-        freeRects.push_back({pl.x + pl.w, fn.y,
-                             (fn.x + fn.w) - (pl.x + pl.w), fn.h});
+        newFreeRects.push_back({pl.x + pl.w, fn.y,
+                                (fn.x + fn.w) - (pl.x + pl.w), fn.h});
     // Top slice
     if (pl.y + pl.h < fn.y + fn.h)
-        freeRects.push_back({fn.x, pl.y + pl.h,
-                             fn.w, (fn.y + fn.h) - (pl.y + pl.h)});
+        newFreeRects.push_back({fn.x, pl.y + pl.h,
+                                fn.w, (fn.y + fn.h) - (pl.y + pl.h)});
     // Left slice
     if (fn.x < pl.x)
-        freeRects.push_back({fn.x, fn.y, pl.x - fn.x, fn.h});
+        newFreeRects.push_back({fn.x, fn.y, pl.x - fn.x, fn.h});
     // Bottom slice
     if (fn.y < pl.y)
-        freeRects.push_back({fn.x, fn.y, fn.w, pl.y - fn.y});
+        newFreeRects.push_back({fn.x, fn.y, fn.w, pl.y - fn.y});
+    return true;
 }
 
 void AtlasBaker::MaxRectsBin::pruneFreeList() {
-    for (int i = 0; i < static_cast<int>(freeRects.size()); ++i) {
-        for (int j = i + 1; j < static_cast<int>(freeRects.size()); ++j) {
-            if (isContainedIn(freeRects[i], freeRects[j])) {
-                freeRects.erase(freeRects.begin() + i);
-                --i; break;
-            }
-            if (isContainedIn(freeRects[j], freeRects[i])) {
-                freeRects.erase(freeRects.begin() + j);
-                --j;
-            }
+    // New vs. new (of two equal rects, the later one goes).
+    for (size_t i = 0; i < newFreeRects.size(); ++i) {
+        for (size_t j = 0; j < newFreeRects.size(); ++j) {
+            if (i == j || !isContainedIn(newFreeRects[i], newFreeRects[j])) continue;
+            if (j > i && isContainedIn(newFreeRects[j], newFreeRects[i])) continue;
+            newFreeRects[i] = newFreeRects.back();
+            newFreeRects.pop_back();
+            --i;
+            break;
         }
     }
+    // New vs. old.
+    const size_t oldCount = freeRects.size();
+    for (const Rect& r : newFreeRects) {
+        bool contained = false;
+        for (size_t j = 0; j < oldCount && !contained; ++j)
+            contained = isContainedIn(r, freeRects[j]);
+        if (!contained) freeRects.push_back(r);
+    }
 }
 
 bool AtlasBaker::MaxRectsBin::isContainedIn(const Rect& a, const Rect& b) {
@@ -90,25 +321,37 @@ bool AtlasBaker::MaxRectsBin::isContainedIn(const Rect& a, const Rect& b) {
 // ─────────────────────────────────────────────────────────────────────────────
 
 AtlasBaker::Rect AtlasBaker::trimmedBounds(const Image& img) {
-    if (img.channelCount < 4 || img.byteArray.empty())
+    if (img.channelCount != 4 || img.byteArray.size() < size_t(img.width) * img.height * 4)
         return {0, 0, img.width, img.height};
 
-    Uint32 minX = img.width, maxX = 0;
-    Uint32 minY = img.height, maxY = 0;
-
-    for (Uint32 y = 0; y < img.height; ++y) {
-        for (Uint32 x = 0; x < img.width; ++x) {
-            Uint8 alpha = img.byteArray[(y * img.width + x) * img.channelCount + 3];
-            if (alpha > 0) {
-                if (x < minX) minX = x;
-                if (x > maxX) maxX = x;
-                if (y < minY) minY = y;
-                if (y > maxY) maxY = y;
-            }
+    const Uint32 w = img.width;
+    auto row = [&](Uint32 y) { return img.byteArray.data() + size_t(y) * w * 4; };
+
+    // Top and bottom rows first; they also seed the column range.
+    Uint32 minY = 0;
+    while (minY < img.height && firstOpaque(row(minY), w) == w) ++minY;
+    if (minY == img.height) return {0, 0, 1, 1};  // fully transparent → keep 1×1
+    Uint32 maxY = img.height - 1;
+    while (firstOpaque(row(maxY), w) == w) --maxY;
+
+    Uint32 minX = std::min(firstOpaque(row(minY), w), firstOpaque(row(maxY), w));
+    Uint32 maxX = std::max(lastOpaque(row(minY), w), lastOpaque(row(maxY), w));
+
+    // Rows in between can only widen the range: scan just the columns left
+    // of minX and right of maxX.
+    for (Uint32 y = minY + 1; y < maxY; ++y) {
+        const Uint8* r = row(y);
+        if (minX > 0) {
+            const Uint32 x = firstOpaque(r, minX);
+            if (x < minX) minX = x;
+        }
+        if (maxX + 1 < w) {
+            const Uint32 tail = w - maxX - 1;
+            const Uint32 x = lastOpaque(r + size_t(maxX + 1) * 4, tail);
+            if (x < tail) maxX += x + 1;
         }
     }
 
-    if (minX > maxX) return {0, 0, 1, 1};  // fully transparent → keep 1×1
     return {minX, minY, maxX - minX + 1, maxY - minY + 1};
 }
 
@@ -124,12 +367,18 @@ void AtlasBaker::blit(Image& dst, Uint32 dstX, Uint32 dstY,
 
     for (Uint32 row = 0; row < h; ++row) {
         const Uint8* srcPtr = src.byteArray.data()
-            + ((srcY + row) * src.width + srcX) * srcCh;
+            + (size_t(srcY + row) * src.width + srcX) * srcCh;
         Uint8* dstPtr = dst.byteArray.data()
-            + ((dstY + row) * dst.width + dstX) * dstCh;
+            + (size_t(dstY + row) * dst.width + dstX) * dstCh;
 
         if (srcCh == dstCh) {
             std::memcpy(dstPtr, srcPtr, w * srcCh);
+        } else if (dstCh == 4 && srcCh == 3) {
+            expandRgbToRgba(dstPtr, srcPtr, w);
+        } else if (dstCh == 4 && srcCh == 1) {
+            expandGrayToRgba(dstPtr, srcPtr, w);
+        } else if (dstCh == 4 && srcCh == 2) {
+            expandRgToRgba(dstPtr, srcPtr, w);
         } else {
             // Convert: expand/collapse channels, fill missing with 0/255
             for (Uint32 col = 0; col < w; ++col) {
@@ -151,32 +400,17 @@ void AtlasBaker::blit(Image& dst, Uint32 dstX, Uint32 dstY,
 // ─────────────────────────────────────────────────────────────────────────────
 
 std::optional<std::vector<AtlasBaker::PackEntry>> AtlasBaker::tryPack(
-    const std::vector<SpriteInput>& sprites,
+    const std::vector<PackItem>& items,
     Uint32 atlasW, Uint32 atlasH,
-    Uint32 padding, bool trim
+    Uint32 padding
 ) {
     MaxRectsBin bin(atlasW, atlasH);
     std::vector<PackEntry> entries;
-    entries.reserve(sprites.size());
-
-    // Sort by descending area for better packing density
-    std::vector<size_t> order(sprites.size());
-    std::iota(order.begin(), order.end(), 0);
-    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
-        const auto& ia = *sprites[a].image;
-        const auto& ib = *sprites[b].image;
-        return (ia.width * ia.height) > (ib.width * ib.height);
-    });
-
-    for (size_t idx : order) {
-        const SpriteInput& s = sprites[idx];
-        if (!s.image) continue;
-
-        Rect srcRect = trim ? trimmedBounds(*s.image)
-                            : Rect{0, 0, s.image->width, s.image->height};
+    entries.reserve(items.size());
 
-        Uint32 pw = srcRect.w + padding * 2;
-        Uint32 ph = srcRect.h + padding * 2;
+    for (const PackItem& item : items) {
+        Uint32 pw = item.srcRect.w + padding * 2;
+        Uint32 ph = item.srcRect.h + padding * 2;
 
         auto placed = bin.insert(pw, ph);
         if (!placed.ok) return std::nullopt;
@@ -184,10 +418,8 @@ std::optional<std::vector<AtlasBaker::PackEntry>> AtlasBaker::tryPack(
         entries.push_back({
             placed.x + padding,
             placed.y + padding,
-            srcRect,
-            s.pivot,
-            s.name,
-            s.image.get()
+            item.srcRect,
+            item.sprite
         });
     }
 
@@ -202,42 +434,91 @@ AtlasBaker::Result AtlasBaker::pack(
     const std::vector<SpriteInput>& sprites,
     Uint32 maxSize,
     Uint32 padding,
-    bool   trim
+    bool   trim,
+    TaskScheduler* scheduler
 ) {
     if (sprites.empty()) return {};
 
-    // Try increasing power-of-two atlas sizes until everything fits
+    // Skip missing images and ones whose pixels don't cover their size.
+    std::vector<PackItem> items;
+    items.reserve(sprites.size());
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        const Image* img = sprites[i].image.get();
+        if (img && img->byteArray.size() >= size_t(img->width) * img->height * img->channelCount)
+            items.push_back({Rect{0, 0, img->width, img->height}, i});
+    }
+    if (items.empty()) return {};
+
+    // Trim once per sprite (not per size attempt), in parallel.
+    if (trim) {
+        TaskScheduler::forRange(scheduler, items.size(), 16, [&](Uint32 begin, Uint32 end, Uint32) {
+            for (Uint32 i = begin; i < end; ++i)
+                items[i].srcRect = trimmedBounds(*sprites[items[i].sprite].image);
+        });
+    }
+
+    // Sort by descending area for better packing density
+    std::stable_sort(items.begin(), items.end(), [](const PackItem& a, const PackItem& b) {
+        return uint64_t(a.srcRect.w) * a.srcRect.h > uint64_t(b.srcRect.w) * b.srcRect.h;
+    });
+
+    // Start from the padded area instead of 512: the smallest power-of-two
+    // W×W or 2W×W that holds the largest sprite and the total area at typical
+    // MaxRects density, then grow one step (double the short side) per miss.
+    constexpr double kExpectedFill = 0.9;
+    uint64_t area = 0;
+    Uint32 largest = 1;
+    for (const PackItem& item : items) {
+        const Uint32 pw = item.srcRect.w + padding * 2;
+        const Uint32 ph = item.srcRect.h + padding * 2;
+        area += uint64_t(pw) * ph;
+        largest = std::max({largest, pw, ph});
+    }
+    Uint32 atlasW = std::bit_ceil(largest);
+    Uint32 atlasH = atlasW;
+    auto grow = [&] {
+        if (atlasH < atlasW) atlasH *= 2;
+        else atlasW *= 2;
+    };
+    while (atlasW <= maxSize && double(atlasW) * atlasH * kExpectedFill < double(area)) grow();
+
     std::optional<std::vector<PackEntry>> entries;
-    Uint32 atlasSize = 512;
-    while (atlasSize <= maxSize) {
-        entries = tryPack(sprites, atlasSize, atlasSize, padding, trim);
+    while (atlasW <= maxSize) {
+        entries = tryPack(items, atlasW, atlasH, padding);
         if (entries) break;
-        atlasSize *= 2;
+        grow();
     }
     if (!entries) return {};  // sprites don't fit even at maxSize
 
     // Allocate atlas image (RGBA8, zeroed = fully transparent)
     auto atlasImg        = std::make_shared<Image>();
-    atlasImg->width      = atlasSize;
-    atlasImg->height     = atlasSize;
+    atlasImg->width      = atlasW;
+    atlasImg->height     = atlasH;
     atlasImg->channelCount = 4;
-    atlasImg->byteArray.resize(atlasSize * atlasSize * 4, 0);
+    atlasImg->byteArray.resize(size_t(atlasW) * atlasH * 4, 0);
+
+    // Blit source pixels into atlas; entries never overlap, so in parallel.
+    TaskScheduler::forRange(scheduler, entries->size(), 8, [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            const PackEntry& e = (*entries)[i];
+            blit(*atlasImg, e.x, e.y,
+                 *sprites[e.sprite].image, e.srcRect.x, e.srcRect.y,
+                 e.srcRect.w, e.srcRect.h);
+        }
+    });
 
-    // Build SpriteAtlas metadata and blit pixels
+    // Build SpriteAtlas metadata
     SpriteAtlas atlas;
     atlas.name = "baked_atlas";
-    atlas.size = {static_cast<float>(atlasSize), static_cast<float>(atlasSize)};
-    atlas.frames.reserve(sprites.size());
+    atlas.size = {static_cast<float>(atlasW), static_cast<float>(atlasH)};
+    atlas.frames.reserve(entries->size());
 
+    const float invW = 1.0f / static_cast<float>(atlasW);
+    const float invH = 1.0f / static_cast<float>(atlasH);
     for (const PackEntry& e : *entries) {
-        // Blit source pixels into atlas
-        blit(*atlasImg, e.x, e.y,
-             *e.image, e.srcRect.x, e.srcRect.y,
-             e.srcRect.w, e.srcRect.h);
+        const SpriteInput& s = sprites[e.sprite];
 
         // Compute normalised UV rect (minU, minV, maxU, maxV)
-        float invW = 1.0f / static_cast<float>(atlasSize);
-        float invH = 1.0f / static_cast<float>(atlasSize);
         glm::vec4 uvRect = {
             static_cast<float>(e.x)              * invW,
             static_cast<float>(e.y)              * invH,
@@ -246,13 +527,13 @@ AtlasBaker::Result AtlasBaker::pack(
         };
 
         Uint16 frameIdx = static_cast<Uint16>(atlas.frames.size());
-        atlas.nameToIndex[e.name] = frameIdx;
+        atlas.nameToIndex[s.name] = frameIdx;
         atlas.frames.push_back(SpriteFrame{
-            e.name,
+            s.name,
             uvRect,
-            {static_cast<float>(e.image->width), static_cast<float>(e.image->height)},
+            {static_cast<float>(s.image->width), static_cast<float>(s.image->height)},
             {static_cast<float>(e.srcRect.x),    static_cast<float>(e.srcRect.y)},
-            e.pivot,
+            s.pivot,
             false   // not rotated
         });
     }
@@ -260,4 +541,54 @@ AtlasBaker::Result AtlasBaker::pack(
     return Result{true, atlasImg, atlas};
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+// Bake cache  (public)
+// ─────────────────────────────────────────────────────────────────────────────
+
+uint64_t AtlasBaker::inputHash(
+    const std::vector<SpriteInput>& sprites,
+    Uint32 maxSize, Uint32 padding, bool trim,
+    TaskScheduler* scheduler
+) {
+    std::vector<uint64_t> imageHashes(sprites.size(), 0);
+    TaskScheduler::forRange(scheduler, sprites.size(), 16, [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            const Image* img = sprites[i].image.get();
+            if (!img) continue;
+            const Uint32 dims[3] = {img->width, img->height, img->channelCount};
+            uint64_t h = hashBytes(dims, sizeof(dims), 14695981039346656037ull);
+            imageHashes[i] = hashBytes(img->byteArray.data(), img->byteArray.size(), h);
+        }
+    });
+
+    const uint32_t settings[4] = {kCacheVersion, maxSize, padding, trim ? 1u : 0u};
+    uint64_t h = hashBytes(settings, sizeof(settings), 14695981039346656037ull);
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        const uint64_t nameSize = sprites[i].name.size();
+        h = hashBytes(&nameSize, sizeof(nameSize), h);
+        h = hashBytes(sprites[i].name.data(), sprites[i].name.size(), h);
+        h = hashBytes(&sprites[i].pivot, sizeof(sprites[i].pivot), h);
+        h = hashBytes(&imageHashes[i], sizeof(uint64_t), h);
+    }
+    return h;
+}
+
+AtlasBaker::Result AtlasBaker::packCached(
+    const std::string& cachePath,
+    const std::vector<SpriteInput>& sprites,
+    Uint32 maxSize,
+    Uint32 padding,
+    bool   trim,
+    TaskScheduler* scheduler
+) {
+    if (cachePath.empty()) return pack(sprites, maxSize, padding, trim, scheduler);
+
+    const uint64_t key = inputHash(sprites, maxSize, padding, trim, scheduler);
+    if (auto cached = readCache(cachePath, key, maxSize, sprites.size())) return std::move(*cached);
+
+    Result result = pack(sprites, maxSize, padding, trim, scheduler);
+    if (result.success) writeCache(cachePath, key, result);
+    return result;
+}
+
 } // namespace Vapor
@@ -4,10 +4,12 @@
 #include <Jolt/Jolt.h>
 
 #include <Jolt/Core/Factory.h>
+#include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Physics/Character/CharacterVirtual.h>
 #include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <algorithm>
 
 using namespace Vapor;
 
@@ -46,6 +48,7 @@ CharacterController::CharacterController(Physics3D* physics, const CharacterCont
     );
 
     character->SetListener(nullptr);// Can add custom listener later
+    character->SetCharacterVsCharacterCollision(physics->getCharacterCollision());
 
     // Set initial max speed
     maxSpeed = 5.0f;// Default movement speed
@@ -153,9 +156,25 @@ void CharacterController::setGravity(const glm::vec3& gravity) {
     currentGravity = gravity;
 }
 
+auto CharacterController::getStepReach(float deltaTime, const glm::vec3& gravity) const -> float {
+    // Bounding sphere of the capsule, the padding/predictive shell, the
+    // stair step up/down probes in update(), then the distance it can move.
+    float extent = std::max(settings.height * 0.5f, settings.radius) + settings.characterPadding
+                   + settings.predictiveContactDistance + 0.25f;
+    float speed = glm::length(getVelocity()) + glm::length(desiredHorizontalVelocity) + glm::length(gravity) * deltaTime;
+    return extent + speed * deltaTime;
+}
+
+void CharacterController::setCrowdIndex(Uint32 index) {
+    character->SetUserData(index);
+}
+
 void CharacterController::update(float deltaTime, const glm::vec3& gravity) {
+    update(deltaTime, gravity, *physics->getTempAllocator());
+}
+
+void CharacterController::update(float deltaTime, const glm::vec3& gravity, JPH::TempAllocator& tempAllocator) {
     auto* physicsSystem = physics->getPhysicsSystem();
-    auto* tempAllocator = physics->getTempAllocator();
 
     // Note: previousPosition should be set externally before the physics update loop
     // to handle multiple physics steps correctly
@@ -205,7 +224,7 @@ void CharacterController::update(float deltaTime, const glm::vec3& gravity) {
         layerFilter,
         {},// Body filter
         {},// Shape filter
-        *tempAllocator
+        tempAllocator
     );
 
     // Update current position after physics step
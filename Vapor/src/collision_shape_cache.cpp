@@ -0,0 +1,293 @@
+#include "collision_shape_cache.hpp"
+#include "graphics.hpp"
+#include "task_scheduler.hpp"
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Core/StreamWrapper.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <fmt/core.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace Vapor {
+
+struct CollisionShapeCache::Entry {
+    Kind kind = Kind::Mesh;
+    std::vector<Uint8> bytes; // Shape::SaveWithChildren output
+    JPH::ShapeRefC shape;     // live once built or restored
+};
+
+namespace {
+
+    constexpr char kShapesMagic[4] = { 'V', 'C', 'S', '1' };
+    constexpr Uint32 kShapesVersion = 1;
+    // Jolt's binary shape state isn't stable across releases.
+    constexpr Uint32 kJoltVersion = (JPH_VERSION_MAJOR << 16) | (JPH_VERSION_MINOR << 8) | JPH_VERSION_PATCH;
+    constexpr Uint32 kMaxEntryBytes = 256u << 20; // sanity bound against corrupt files
+
+    // Types are registered by the first Physics3D::init.
+    bool joltReady() {
+        return JPH::Factory::sInstance != nullptr;
+    }
+
+    Uint64 fnv1a64(const void* data, size_t n, Uint64 h) {
+        const auto* p = static_cast<const Uint8*>(data);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    JPH::ShapeRefC buildShape(
+        CollisionShapeCache::Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices
+    ) {
+        JPH::ShapeSettings::ShapeResult result;
+        if (kind == CollisionShapeCache::Kind::Mesh) {
+            JPH::VertexList joltVertices;
+            joltVertices.reserve(vertices.size());
+            for (const auto& v : vertices) {
+                joltVertices.push_back(JPH::Float3(v.x, v.y, v.z));
+            }
+            JPH::IndexedTriangleList joltTriangles;
+            joltTriangles.reserve(indices.size() / 3);
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                joltTriangles.push_back(JPH::IndexedTriangle(indices[i], indices[i + 1], indices[i + 2]));
+            }
+            JPH::MeshShapeSettings settings(joltVertices, joltTriangles);
+            settings.SetEmbedded();
+            result = settings.Create();
+        } else {
+            JPH::Array<JPH::Vec3> points;
+            points.reserve(vertices.size());
+            for (const auto& p : vertices) {
+                points.push_back(JPH::Vec3(p.x, p.y, p.z));
+            }
+            JPH::ConvexHullShapeSettings settings(points);
+            settings.SetEmbedded();
+            result = settings.Create();
+        }
+        if (result.HasError()) {
+            fmt::print(stderr, "CollisionShapeCache: shape build failed ({})\n", result.GetError().c_str());
+            return nullptr;
+        }
+        return result.Get();
+    }
+
+    std::vector<Uint8> saveShape(const JPH::Shape& shape) {
+        std::stringstream stream(std::ios::out | std::ios::in | std::ios::binary);
+        JPH::StreamOutWrapper out(stream);
+        JPH::Shape::ShapeToIDMap shapeMap;
+        JPH::Shape::MaterialToIDMap materialMap;
+        shape.SaveWithChildren(out, shapeMap, materialMap);
+        const std::string data = stream.str();
+        return std::vector<Uint8>(data.begin(), data.end());
+    }
+
+    JPH::ShapeRefC restoreShape(const std::vector<Uint8>& bytes) {
+        std::stringstream stream(std::string(bytes.begin(), bytes.end()), std::ios::in | std::ios::binary);
+        JPH::StreamInWrapper in(stream);
+        JPH::Shape::IDToShapeMap shapeMap;
+        JPH::Shape::IDToMaterialMap materialMap;
+        JPH::Shape::ShapeResult result = JPH::Shape::sRestoreWithChildren(in, shapeMap, materialMap);
+        if (result.HasError() || in.IsFailed()) return nullptr;
+        return result.Get();
+    }
+
+}// namespace
+
+CollisionShapeCache& CollisionShapeCache::instance() {
+    static CollisionShapeCache cache;
+    return cache;
+}
+
+CollisionShapeCache::CollisionShapeCache() = default;
+CollisionShapeCache::~CollisionShapeCache() = default;
+
+Uint64 CollisionShapeCache::hashGeometry(
+    Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices
+) {
+    Uint64 h = fnv1a64(&kind, sizeof(kind), 14695981039346656037ull);
+    const Uint64 counts[2] = { vertices.size(), kind == Kind::Mesh ? indices.size() : 0 };
+    h = fnv1a64(counts, sizeof(counts), h);
+    h = fnv1a64(vertices.data(), vertices.size() * sizeof(glm::vec3), h);
+    if (kind == Kind::Mesh) h = fnv1a64(indices.data(), indices.size() * sizeof(Uint32), h);
+    return h;
+}
+
+void CollisionShapeCache::gatherGeometry(
+    const std::vector<std::shared_ptr<Mesh>>& meshes, std::vector<glm::vec3>& vertices, std::vector<Uint32>& indices
+) {
+    vertices.clear();
+    indices.clear();
+    for (const auto& mesh : meshes) {
+        if (!mesh || mesh->primitiveMode != PrimitiveMode::TRIANGLES) continue;
+        const Uint32 base = static_cast<Uint32>(vertices.size());
+        for (const auto& v : mesh->vertices) vertices.push_back(v.position);
+        if (mesh->indices.empty()) {
+            for (Uint32 i = 0; i < mesh->vertices.size(); ++i) indices.push_back(base + i);
+        } else {
+            for (Uint32 i : mesh->indices) indices.push_back(base + i);
+        }
+    }
+}
+
+const JPH::Shape* CollisionShapeCache::acquire(
+    Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices
+) {
+    const Uint64 key = hashGeometry(kind, vertices, indices);
+    std::vector<Uint8> cooked;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (it->second->shape) return it->second->shape.GetPtr();
+            cooked = it->second->bytes;
+        }
+    }
+
+    // Restore/build outside the lock; if two threads race on one key, both
+    // produce an equivalent shape and the first one stored wins.
+    JPH::ShapeRefC shape = cooked.empty() ? nullptr : restoreShape(cooked);
+    std::vector<Uint8> bytes;
+    if (!shape) {
+        shape = buildShape(kind, vertices, indices);
+        if (!shape) return nullptr;
+        bytes = saveShape(*shape);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = entries[key];
+    if (!entry) {
+        entry = std::make_unique<Entry>();
+        entry->kind = kind;
+    }
+    if (entry->bytes.empty()) entry->bytes = std::move(bytes);
+    if (!entry->shape) entry->shape = shape;
+    return entry->shape.GetPtr();
+}
+
+Uint64 CollisionShapeCache::cook(Kind kind, const std::vector<glm::vec3>& vertices, const std::vector<Uint32>& indices) {
+    if (!joltReady() || vertices.empty()) return 0;
+    return acquire(kind, vertices, indices) ? hashGeometry(kind, vertices, indices) : 0;
+}
+
+void CollisionShapeCache::restoreAll(TaskScheduler* scheduler) {
+    if (!joltReady()) return;
+
+    std::vector<Entry*> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& [key, entry] : entries) {
+            if (!entry->shape && !entry->bytes.empty()) pending.push_back(entry.get());
+        }
+    }
+
+    auto restoreRange = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            JPH::ShapeRefC shape = restoreShape(pending[i]->bytes);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!pending[i]->shape) pending[i]->shape = shape;
+        }
+    };
+    const Uint32 count = static_cast<Uint32>(pending.size());
+    if (scheduler) scheduler->parallelFor(count, 1, restoreRange);
+    else restoreRange(0, count, 0);
+}
+
+bool CollisionShapeCache::save(const std::string& path, const std::vector<Uint64>& keys) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<const std::pair<const Uint64, std::unique_ptr<Entry>>*> toWrite;
+    for (Uint64 key : keys) {
+        auto it = entries.find(key);
+        if (it != entries.end() && !it->second->bytes.empty()) toWrite.push_back(&*it);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fmt::print(stderr, "CollisionShapeCache: cannot write '{}'\n", path);
+        return false;
+    }
+    const Uint32 count = static_cast<Uint32>(toWrite.size());
+    out.write(kShapesMagic, sizeof(kShapesMagic));
+    out.write(reinterpret_cast<const char*>(&kShapesVersion), sizeof(kShapesVersion));
+    out.write(reinterpret_cast<const char*>(&kJoltVersion), sizeof(kJoltVersion));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto* item : toWrite) {
+        const Entry& entry = *item->second;
+        const Uint32 size = static_cast<Uint32>(entry.bytes.size());
+        out.write(reinterpret_cast<const char*>(&item->first), sizeof(item->first));
+        out.write(reinterpret_cast<const char*>(&entry.kind), sizeof(entry.kind));
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(entry.bytes.data()), size);
+    }
+    return static_cast<bool>(out);
+}
+
+bool CollisionShapeCache::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[4] = {};
+    Uint32 version = 0, joltVersion = 0, count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&joltVersion), sizeof(joltVersion));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || std::memcmp(magic, kShapesMagic, sizeof(magic)) != 0 || version != kShapesVersion
+        || joltVersion != kJoltVersion) {
+        return false;
+    }
+
+    for (Uint32 i = 0; i < count; ++i) {
+        Uint64 key = 0;
+        Kind kind = Kind::Mesh;
+        Uint32 size = 0;
+        in.read(reinterpret_cast<char*>(&key), sizeof(key));
+        in.read(reinterpret_cast<char*>(&kind), sizeof(kind));
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!in || size > kMaxEntryBytes) {
+            fmt::print(stderr, "CollisionShapeCache: '{}' is truncated or corrupt\n", path);
+            return false;
+        }
+        std::vector<Uint8> bytes(size);
+        in.read(reinterpret_cast<char*>(bytes.data()), size);
+        if (!in) {
+            fmt::print(stderr, "CollisionShapeCache: '{}' is truncated or corrupt\n", path);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = entries[key];
+        if (!entry) {
+            entry = std::make_unique<Entry>();
+            entry->kind = kind;
+        }
+        if (entry->bytes.empty()) entry->bytes = std::move(bytes);
+    }
+    return true;
+}
+
+size_t CollisionShapeCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t CollisionShapeCache::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::erase_if(entries, [](const auto& item) {
+        const JPH::ShapeRefC& shape = item.second->shape;
+        return shape.GetPtr() != nullptr && shape->GetRefCount() == 1;
+    });
+}
+
+void CollisionShapeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
+} // namespace Vapor
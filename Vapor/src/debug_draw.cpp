@@ -1,4 +1,5 @@
 #include "debug_draw.hpp"
+#include <atomic>
 #include <cmath>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -9,94 +10,306 @@ namespace Vapor {
 
     static constexpr float kPi = glm::pi<float>();
 
+    static std::atomic<uint64_t> nextDebugDrawSerial{ 1 };
+
+    // Unit primitive line lists. `cap` only matters for the capsule: its
+    // hemispheres and the ends of its sides are pushed apart by the
+    // instance's stretch.
+    static std::vector<DebugShapeVertex> buildShapeLines(DebugShape shape, int segments) {
+        std::vector<DebugShapeVertex> lines;
+        auto line = [&](const glm::vec3& a, const glm::vec3& b, float capA = 0.0f, float capB = 0.0f) {
+            lines.push_back({ a, capA });
+            lines.push_back({ b, capB });
+        };
+        auto angle = [&](int i) { return (float(i) / segments) * 2.0f * kPi; };
+        // Circle of radius 1 in the XZ plane at height y
+        auto ring = [&](float y, float cap) {
+            for (int i = 0; i < segments; ++i) {
+                line(
+                    glm::vec3(std::cos(angle(i)), y, std::sin(angle(i))),
+                    glm::vec3(std::cos(angle(i + 1)), y, std::sin(angle(i + 1))),
+                    cap,
+                    cap
+                );
+            }
+        };
+        const glm::vec3 sides[4] = { { 0, 0, 1 }, { 0, 0, -1 }, { 1, 0, 0 }, { -1, 0, 0 } };
+
+        switch (shape) {
+        case DebugShape::Box: {
+            const glm::vec3 corners[8] = {
+                { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+                { -1, -1, 1 },  { 1, -1, 1 },  { 1, 1, 1 },  { -1, 1, 1 },
+            };
+            for (int i = 0; i < 4; ++i) {
+                line(corners[i], corners[(i + 1) % 4]);// Bottom face
+                line(corners[4 + i], corners[4 + (i + 1) % 4]);// Top face
+                line(corners[i], corners[4 + i]);// Vertical edges
+            }
+            break;
+        }
+        case DebugShape::Sphere:
+            // 3 circles (XY, XZ, YZ planes)
+            for (int i = 0; i < segments; ++i) {
+                const float c1 = std::cos(angle(i)), s1 = std::sin(angle(i));
+                const float c2 = std::cos(angle(i + 1)), s2 = std::sin(angle(i + 1));
+                line(glm::vec3(c1, s1, 0.0f), glm::vec3(c2, s2, 0.0f));
+                line(glm::vec3(c1, 0.0f, s1), glm::vec3(c2, 0.0f, s2));
+                line(glm::vec3(0.0f, c1, s1), glm::vec3(0.0f, c2, s2));
+            }
+            break;
+        case DebugShape::Capsule: {
+            ring(0.0f, 1.0f);
+            ring(0.0f, -1.0f);
+            // Hemisphere arcs, top and bottom
+            const int halfSegments = segments / 2;
+            for (int i = 0; i < halfSegments; ++i) {
+                const float a1 = (float(i) / halfSegments) * kPi * 0.5f;
+                const float a2 = (float(i + 1) / halfSegments) * kPi * 0.5f;
+                for (const glm::vec3& side : sides) {
+                    for (float cap : { 1.0f, -1.0f }) {
+                        line(
+                            side * std::cos(a1) + glm::vec3(0.0f, cap * std::sin(a1), 0.0f),
+                            side * std::cos(a2) + glm::vec3(0.0f, cap * std::sin(a2), 0.0f),
+                            cap,
+                            cap
+                        );
+                    }
+                }
+            }
+            // Vertical lines connecting hemispheres
+            for (const glm::vec3& side : sides) line(side, side, 1.0f, -1.0f);
+            break;
+        }
+        case DebugShape::Cylinder:
+            ring(1.0f, 0.0f);
+            ring(-1.0f, 0.0f);
+            for (int i = 0; i < 4; ++i) {
+                const glm::vec3 offset(std::cos(i * kPi * 0.5f), 0.0f, std::sin(i * kPi * 0.5f));
+                line(offset + glm::vec3(0, 1, 0), offset - glm::vec3(0, 1, 0));
+            }
+            break;
+        case DebugShape::Cone:
+            // Apex at the origin, base circle at y = 1
+            ring(1.0f, 0.0f);
+            for (int i = 0; i < 4; ++i) {
+                line(glm::vec3(0.0f), glm::vec3(std::cos(i * kPi * 0.5f), 1.0f, std::sin(i * kPi * 0.5f)));
+            }
+            break;
+        case DebugShape::Count:
+            break;
+        }
+        return lines;
+    }
+
+    // Rotation, then per-axis scale, then translation
+    static glm::mat4 makeTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        glm::mat4 transform = glm::mat4_cast(rotation);
+        transform[0] *= scale.x;
+        transform[1] *= scale.y;
+        transform[2] *= scale.z;
+        transform[3] = glm::vec4(position, 1.0f);
+        return transform;
+    }
+
+    const std::vector<DebugShapeVertex>& DebugDraw::getShapeLines(DebugShape shape) {
+        static const std::array<std::vector<DebugShapeVertex>, kDebugShapeCount> shapes = {
+            buildShapeLines(DebugShape::Box, 0),
+            buildShapeLines(DebugShape::Sphere, kSphereSegments),
+            buildShapeLines(DebugShape::Capsule, kShapeSegments),
+            buildShapeLines(DebugShape::Cylinder, kShapeSegments),
+            buildShapeLines(DebugShape::Cone, kShapeSegments),
+        };
+        return shapes[static_cast<size_t>(shape)];
+    }
+
+    glm::vec3 DebugDraw::transformShapeVertex(const DebugInstance& instance, const DebugShapeVertex& vertex) {
+        const glm::vec3 local = vertex.position + glm::vec3(0.0f, vertex.cap * instance.stretch, 0.0f);
+        return glm::vec3(instance.transform * glm::vec4(local, 1.0f));
+    }
+
+    void DebugDraw::Geometry::clear() {
+        lines.clear();
+        triangles.clear();
+        for (auto& shapeInstances : instances) shapeInstances.clear();
+    }
+
+    void DebugDraw::Geometry::appendTo(Geometry& out) const {
+        out.lines.insert(out.lines.end(), lines.begin(), lines.end());
+        out.triangles.insert(out.triangles.end(), triangles.begin(), triangles.end());
+        for (size_t i = 0; i < kDebugShapeCount; ++i) {
+            out.instances[i].insert(out.instances[i].end(), instances[i].begin(), instances[i].end());
+        }
+    }
+
+    void DebugDraw::Geometry::pushLine(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color) {
+        lines.push_back({ start, color });
+        lines.push_back({ end, color });
+    }
+
+    DebugDraw::DebugDraw() : serial(nextDebugDrawSerial.fetch_add(1, std::memory_order_relaxed)) {
+    }
+
+    DebugDraw::~DebugDraw() = default;
+
+    auto DebugDraw::threadBuffer() -> ThreadBuffer& {
+        // Producers usually feed a single DebugDraw, so remember the last one
+        // and skip the map and its lock
+        thread_local uint64_t cachedSerial = 0;
+        thread_local ThreadBuffer* cachedBuffer = nullptr;
+        if (cachedSerial == serial) {
+            return *cachedBuffer;
+        }
+
+        std::lock_guard lock(mutex);
+        auto& buffer = threadBuffers[std::this_thread::get_id()];
+        if (!buffer) {
+            buffer = std::make_unique<ThreadBuffer>();
+        }
+        cachedSerial = serial;
+        cachedBuffer = buffer.get();
+        return *buffer;
+    }
+
+    DebugDraw::Target::Target(DebugDraw& debugDraw) {
+        ThreadBuffer& buffer = debugDraw.threadBuffer();
+        lock = std::unique_lock(buffer.mutex);
+        geometry = buffer.recording ? buffer.recording.get() : &buffer.transient;
+    }
+
+    void DebugDraw::beginPersistent(uint64_t key, float lifetime) {
+        ThreadBuffer& buffer = threadBuffer();
+        if (key == 0) {
+            std::lock_guard lock(mutex);
+            key = nextAnonymousKey++;
+        }
+        std::lock_guard lock(buffer.mutex);
+        if (!buffer.recording) {
+            buffer.recording = std::make_unique<Geometry>();
+        }
+        buffer.recording->clear();
+        buffer.recordingKey = key;
+        buffer.recordingLifetime = lifetime;
+    }
+
+    void DebugDraw::endPersistent() {
+        ThreadBuffer& buffer = threadBuffer();
+        std::unique_ptr<Geometry> recorded;
+        {
+            std::lock_guard lock(buffer.mutex);
+            recorded = std::move(buffer.recording);
+        }
+        if (!recorded) return;
+
+        std::lock_guard lock(mutex);
+        Persistent& entry = persistent[buffer.recordingKey];
+        entry.content = std::move(*recorded);
+        entry.lifetime = buffer.recordingLifetime;
+        entry.expiresAt = -1.0;
+    }
+
+    void DebugDraw::removePersistent(uint64_t key) {
+        std::lock_guard lock(mutex);
+        persistent.erase(key);
+    }
+
+    void DebugDraw::clearPersistent() {
+        std::lock_guard lock(mutex);
+        persistent.clear();
+    }
+
+    size_t DebugDraw::getPersistentCount() const {
+        std::lock_guard lock(mutex);
+        return persistent.size();
+    }
+
+    void DebugDraw::flush(double time) {
+        std::lock_guard lock(mutex);
+        output.clear();
+        for (auto& [id, buffer] : threadBuffers) {
+            std::lock_guard bufferLock(buffer->mutex);
+            buffer->transient.appendTo(output);
+            buffer->transient.clear();
+        }
+        for (auto it = persistent.begin(); it != persistent.end();) {
+            Persistent& entry = it->second;
+            if (entry.expiresAt < 0.0) {
+                entry.expiresAt = time + entry.lifetime;// drawn at least once, even with a lifetime of zero
+            } else if (time >= entry.expiresAt) {
+                it = persistent.erase(it);
+                continue;
+            }
+            entry.content.appendTo(output);
+            ++it;
+        }
+    }
 
     void DebugDraw::clear() {
-        lineVertices.clear();
-        triangleVertices.clear();
+        std::lock_guard lock(mutex);
+        output.clear();
+        for (auto& [id, buffer] : threadBuffers) {
+            std::lock_guard bufferLock(buffer->mutex);
+            buffer->transient.clear();
+        }
+    }
+
+    size_t DebugDraw::getInstanceCount() const {
+        size_t count = 0;
+        for (const auto& shapeInstances : output.instances) count += shapeInstances.size();
+        return count;
     }
 
-    auto DebugDraw::rotatePoint(const glm::vec3& point, const glm::quat& rotation) const -> glm::vec3 {
-        return rotation * point;
+    bool DebugDraw::hasContent() const {
+        return !output.lines.empty() || !output.triangles.empty() || getInstanceCount() > 0;
+    }
+
+    void DebugDraw::addShape(DebugShape shape, const DebugInstance& instance, int segments, int defaultSegments) {
+        Target target(*this);
+        if (segments == defaultSegments) {
+            target->instances[static_cast<size_t>(shape)].push_back(instance);
+            return;
+        }
+        // No unit mesh at this resolution: expand it into lines instead
+        const auto lines = buildShapeLines(shape, segments);
+        for (const DebugShapeVertex& vertex : lines) {
+            target->lines.push_back({ transformShapeVertex(instance, vertex), instance.color });
+        }
     }
 
     void DebugDraw::addLine(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color) {
-        lineVertices.push_back({ start, color });
-        lineVertices.push_back({ end, color });
+        Target target(*this);
+        target->pushLine(start, end, color);
     }
 
     void DebugDraw::addTriangle(
         const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, const glm::vec4& color, bool wireframe
     ) {
+        Target target(*this);
         if (wireframe) {
-            addLine(v0, v1, color);
-            addLine(v1, v2, color);
-            addLine(v2, v0, color);
+            target->pushLine(v0, v1, color);
+            target->pushLine(v1, v2, color);
+            target->pushLine(v2, v0, color);
         } else {
-            triangleVertices.push_back({ v0, color });
-            triangleVertices.push_back({ v1, color });
-            triangleVertices.push_back({ v2, color });
+            target->triangles.push_back({ v0, color });
+            target->triangles.push_back({ v1, color });
+            target->triangles.push_back({ v2, color });
         }
     }
 
     void DebugDraw::addBox(
         const glm::vec3& center, const glm::vec3& halfExtents, const glm::quat& rotation, const glm::vec4& color
     ) {
-        // 8 corners of the box in local space
-        glm::vec3 corners[8] = {
-            glm::vec3(-halfExtents.x, -halfExtents.y, -halfExtents.z),
-            glm::vec3(halfExtents.x, -halfExtents.y, -halfExtents.z),
-            glm::vec3(halfExtents.x, halfExtents.y, -halfExtents.z),
-            glm::vec3(-halfExtents.x, halfExtents.y, -halfExtents.z),
-            glm::vec3(-halfExtents.x, -halfExtents.y, halfExtents.z),
-            glm::vec3(halfExtents.x, -halfExtents.y, halfExtents.z),
-            glm::vec3(halfExtents.x, halfExtents.y, halfExtents.z),
-            glm::vec3(-halfExtents.x, halfExtents.y, halfExtents.z),
-        };
-
-        // Transform corners to world space
-        for (int i = 0; i < 8; ++i) {
-            corners[i] = center + rotatePoint(corners[i], rotation);
-        }
-
-        // 12 edges of the box
-        // Bottom face
-        addLine(corners[0], corners[1], color);
-        addLine(corners[1], corners[2], color);
-        addLine(corners[2], corners[3], color);
-        addLine(corners[3], corners[0], color);
-        // Top face
-        addLine(corners[4], corners[5], color);
-        addLine(corners[5], corners[6], color);
-        addLine(corners[6], corners[7], color);
-        addLine(corners[7], corners[4], color);
-        // Vertical edges
-        addLine(corners[0], corners[4], color);
-        addLine(corners[1], corners[5], color);
-        addLine(corners[2], corners[6], color);
-        addLine(corners[3], corners[7], color);
+        DebugInstance instance;
+        instance.transform = makeTransform(center, rotation, halfExtents);
+        instance.color = color;
+        addShape(DebugShape::Box, instance, 0, 0);
     }
 
     void DebugDraw::addSphere(const glm::vec3& center, float radius, const glm::vec4& color, int segments) {
-        // Draw 3 circles (XY, XZ, YZ planes)
-        for (int i = 0; i < segments; ++i) {
-            float angle1 = (float(i) / segments) * 2.0f * kPi;
-            float angle2 = (float(i + 1) / segments) * 2.0f * kPi;
-
-            // XY plane (around Z axis)
-            glm::vec3 p1 = center + glm::vec3(std::cos(angle1), std::sin(angle1), 0.0f) * radius;
-            glm::vec3 p2 = center + glm::vec3(std::cos(angle2), std::sin(angle2), 0.0f) * radius;
-            addLine(p1, p2, color);
-
-            // XZ plane (around Y axis)
-            p1 = center + glm::vec3(std::cos(angle1), 0.0f, std::sin(angle1)) * radius;
-            p2 = center + glm::vec3(std::cos(angle2), 0.0f, std::sin(angle2)) * radius;
-            addLine(p1, p2, color);
-
-            // YZ plane (around X axis)
-            p1 = center + glm::vec3(0.0f, std::cos(angle1), std::sin(angle1)) * radius;
-            p2 = center + glm::vec3(0.0f, std::cos(angle2), std::sin(angle2)) * radius;
-            addLine(p1, p2, color);
-        }
+        DebugInstance instance;
+        instance.transform = makeTransform(center, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(radius));
+        instance.color = color;
+        addShape(DebugShape::Sphere, instance, segments, kSphereSegments);
     }
 
     void DebugDraw::addCapsule(
@@ -107,104 +320,13 @@ namespace Vapor {
         const glm::vec4& color,
         int segments
     ) {
-        // Local up direction (Y axis in local space)
-        glm::vec3 localUp = glm::vec3(0.0f, 1.0f, 0.0f);
-        glm::vec3 localRight = glm::vec3(1.0f, 0.0f, 0.0f);
-        glm::vec3 localForward = glm::vec3(0.0f, 0.0f, 1.0f);
-
-        // Transform to world space
-        glm::vec3 up = rotatePoint(localUp, rotation);
-        glm::vec3 right = rotatePoint(localRight, rotation);
-        glm::vec3 forward = rotatePoint(localForward, rotation);
-
-        // Top and bottom sphere centers
-        glm::vec3 topCenter = center + up * halfHeight;
-        glm::vec3 bottomCenter = center - up * halfHeight;
-
-        // Draw top hemisphere
-        for (int i = 0; i < segments; ++i) {
-            float angle1 = (float(i) / segments) * 2.0f * kPi;
-            float angle2 = (float(i + 1) / segments) * 2.0f * kPi;
-
-            // Horizontal circle at top
-            glm::vec3 p1 = topCenter + (right * std::cos(angle1) + forward * std::sin(angle1)) * radius;
-            glm::vec3 p2 = topCenter + (right * std::cos(angle2) + forward * std::sin(angle2)) * radius;
-            addLine(p1, p2, color);
-
-            // Horizontal circle at bottom
-            p1 = bottomCenter + (right * std::cos(angle1) + forward * std::sin(angle1)) * radius;
-            p2 = bottomCenter + (right * std::cos(angle2) + forward * std::sin(angle2)) * radius;
-            addLine(p1, p2, color);
-        }
-
-        // Draw hemisphere arcs (top)
-        int halfSegments = segments / 2;
-        for (int i = 0; i < halfSegments; ++i) {
-            float angle1 = (float(i) / halfSegments) * kPi * 0.5f;
-            float angle2 = (float(i + 1) / halfSegments) * kPi * 0.5f;
-
-            float h1 = std::sin(angle1) * radius;
-            float r1 = std::cos(angle1) * radius;
-            float h2 = std::sin(angle2) * radius;
-            float r2 = std::cos(angle2) * radius;
-
-            // Front arc
-            glm::vec3 p1 = topCenter + up * h1 + forward * r1;
-            glm::vec3 p2 = topCenter + up * h2 + forward * r2;
-            addLine(p1, p2, color);
-
-            // Back arc
-            p1 = topCenter + up * h1 - forward * r1;
-            p2 = topCenter + up * h2 - forward * r2;
-            addLine(p1, p2, color);
-
-            // Right arc
-            p1 = topCenter + up * h1 + right * r1;
-            p2 = topCenter + up * h2 + right * r2;
-            addLine(p1, p2, color);
-
-            // Left arc
-            p1 = topCenter + up * h1 - right * r1;
-            p2 = topCenter + up * h2 - right * r2;
-            addLine(p1, p2, color);
-        }
-
-        // Draw hemisphere arcs (bottom)
-        for (int i = 0; i < halfSegments; ++i) {
-            float angle1 = (float(i) / halfSegments) * kPi * 0.5f;
-            float angle2 = (float(i + 1) / halfSegments) * kPi * 0.5f;
-
-            float h1 = std::sin(angle1) * radius;
-            float r1 = std::cos(angle1) * radius;
-            float h2 = std::sin(angle2) * radius;
-            float r2 = std::cos(angle2) * radius;
-
-            // Front arc
-            glm::vec3 p1 = bottomCenter - up * h1 + forward * r1;
-            glm::vec3 p2 = bottomCenter - up * h2 + forward * r2;
-            addLine(p1, p2, color);
-
-            // Back arc
-            p1 = bottomCenter - up * h1 - forward * r1;
-            p2 = bottomCenter - up * h2 - forward * r2;
-            addLine(p1, p2, color);
-
-            // Right arc
-            p1 = bottomCenter - up * h1 + right * r1;
-            p2 = bottomCenter - up * h2 + right * r2;
-            addLine(p1, p2, color);
-
-            // Left arc
-            p1 = bottomCenter - up * h1 - right * r1;
-            p2 = bottomCenter - up * h2 - right * r2;
-            addLine(p1, p2, color);
-        }
-
-        // Vertical lines connecting hemispheres
-        addLine(topCenter + forward * radius, bottomCenter + forward * radius, color);
-        addLine(topCenter - forward * radius, bottomCenter - forward * radius, color);
-        addLine(topCenter + right * radius, bottomCenter + right * radius, color);
-        addLine(topCenter - right * radius, bottomCenter - right * radius, color);
+        // Uniformly scaled by the radius; the stretch moves the hemispheres
+        // out to +/- halfHeight
+        DebugInstance instance;
+        instance.transform = makeTransform(center, rotation, glm::vec3(radius));
+        instance.color = color;
+        instance.stretch = radius > 0.0f ? halfHeight / radius : 0.0f;
+        addShape(DebugShape::Capsule, instance, segments, kShapeSegments);
     }
 
     void DebugDraw::addCylinder(
@@ -215,34 +337,10 @@ namespace Vapor {
         const glm::vec4& color,
         int segments
     ) {
-        glm::vec3 up = rotatePoint(glm::vec3(0.0f, 1.0f, 0.0f), rotation);
-        glm::vec3 right = rotatePoint(glm::vec3(1.0f, 0.0f, 0.0f), rotation);
-        glm::vec3 forward = rotatePoint(glm::vec3(0.0f, 0.0f, 1.0f), rotation);
-
-        glm::vec3 topCenter = center + up * halfHeight;
-        glm::vec3 bottomCenter = center - up * halfHeight;
-
-        // Draw top and bottom circles
-        for (int i = 0; i < segments; ++i) {
-            float angle1 = (float(i) / segments) * 2.0f * kPi;
-            float angle2 = (float(i + 1) / segments) * 2.0f * kPi;
-
-            glm::vec3 offset1 = right * std::cos(angle1) * radius + forward * std::sin(angle1) * radius;
-            glm::vec3 offset2 = right * std::cos(angle2) * radius + forward * std::sin(angle2) * radius;
-
-            // Top circle
-            addLine(topCenter + offset1, topCenter + offset2, color);
-            // Bottom circle
-            addLine(bottomCenter + offset1, bottomCenter + offset2, color);
-        }
-
-        // Vertical lines
-        int verticalLines = 4;
-        for (int i = 0; i < verticalLines; ++i) {
-            float angle = (float(i) / verticalLines) * 2.0f * kPi;
-            glm::vec3 offset = right * std::cos(angle) * radius + forward * std::sin(angle) * radius;
-            addLine(topCenter + offset, bottomCenter + offset, color);
-        }
+        DebugInstance instance;
+        instance.transform = makeTransform(center, rotation, glm::vec3(radius, halfHeight, radius));
+        instance.color = color;
+        addShape(DebugShape::Cylinder, instance, segments, kShapeSegments);
     }
 
     void DebugDraw::addCone(
@@ -254,32 +352,21 @@ namespace Vapor {
         int segments
     ) {
         glm::vec3 dir = glm::normalize(direction);
-        glm::vec3 baseCenter = apex + dir * height;
 
         // Find perpendicular vectors
         glm::vec3 up = std::abs(dir.y) < 0.999f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
         glm::vec3 right = glm::normalize(glm::cross(up, dir));
         glm::vec3 forward = glm::cross(dir, right);
 
-        // Draw base circle and lines to apex
-        for (int i = 0; i < segments; ++i) {
-            float angle1 = (float(i) / segments) * 2.0f * kPi;
-            float angle2 = (float(i + 1) / segments) * 2.0f * kPi;
-
-            glm::vec3 p1 = baseCenter + right * std::cos(angle1) * radius + forward * std::sin(angle1) * radius;
-            glm::vec3 p2 = baseCenter + right * std::cos(angle2) * radius + forward * std::sin(angle2) * radius;
-
-            // Base circle
-            addLine(p1, p2, color);
-        }
-
-        // Lines from apex to base
-        int lineCount = 4;
-        for (int i = 0; i < lineCount; ++i) {
-            float angle = (float(i) / lineCount) * 2.0f * kPi;
-            glm::vec3 basePoint = baseCenter + right * std::cos(angle) * radius + forward * std::sin(angle) * radius;
-            addLine(apex, basePoint, color);
-        }
+        DebugInstance instance;
+        instance.transform = glm::mat4(
+            glm::vec4(right * radius, 0.0f),
+            glm::vec4(dir * height, 0.0f),
+            glm::vec4(forward * radius, 0.0f),
+            glm::vec4(apex, 1.0f)
+        );
+        instance.color = color;
+        addShape(DebugShape::Cone, instance, segments, kShapeSegments);
     }
 
     void DebugDraw::addArrow(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color, float headSize) {
@@ -289,8 +376,10 @@ namespace Vapor {
 
         dir = dir / length;
 
+        Target target(*this);
+
         // Main line
-        addLine(start, end, color);
+        target->pushLine(start, end, color);
 
         // Arrow head
         float headLength = length * headSize;
@@ -302,10 +391,10 @@ namespace Vapor {
 
         glm::vec3 headBase = end - dir * headLength;
 
-        addLine(end, headBase + right * headRadius, color);
-        addLine(end, headBase - right * headRadius, color);
-        addLine(end, headBase + forward * headRadius, color);
-        addLine(end, headBase - forward * headRadius, color);
+        target->pushLine(end, headBase + right * headRadius, color);
+        target->pushLine(end, headBase - right * headRadius, color);
+        target->pushLine(end, headBase + forward * headRadius, color);
+        target->pushLine(end, headBase - forward * headRadius, color);
     }
 
     void DebugDraw::addAABB(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color) {
@@ -329,23 +418,25 @@ namespace Vapor {
             worldCorners[i] = glm::vec3(world) / world.w;
         }
 
+        Target target(*this);
+
         // Near plane
-        addLine(worldCorners[0], worldCorners[1], color);
-        addLine(worldCorners[1], worldCorners[2], color);
-        addLine(worldCorners[2], worldCorners[3], color);
-        addLine(worldCorners[3], worldCorners[0], color);
+        target->pushLine(worldCorners[0], worldCorners[1], color);
+        target->pushLine(worldCorners[1], worldCorners[2], color);
+        target->pushLine(worldCorners[2], worldCorners[3], color);
+        target->pushLine(worldCorners[3], worldCorners[0], color);
 
         // Far plane
-        addLine(worldCorners[4], worldCorners[5], color);
-        addLine(worldCorners[5], worldCorners[6], color);
-        addLine(worldCorners[6], worldCorners[7], color);
-        addLine(worldCorners[7], worldCorners[4], color);
+        target->pushLine(worldCorners[4], worldCorners[5], color);
+        target->pushLine(worldCorners[5], worldCorners[6], color);
+        target->pushLine(worldCorners[6], worldCorners[7], color);
+        target->pushLine(worldCorners[7], worldCorners[4], color);
 
         // Connecting edges
-        addLine(worldCorners[0], worldCorners[4], color);
-        addLine(worldCorners[1], worldCorners[5], color);
-        addLine(worldCorners[2], worldCorners[6], color);
-        addLine(worldCorners[3], worldCorners[7], color);
+        target->pushLine(worldCorners[0], worldCorners[4], color);
+        target->pushLine(worldCorners[1], worldCorners[5], color);
+        target->pushLine(worldCorners[2], worldCorners[6], color);
+        target->pushLine(worldCorners[3], worldCorners[7], color);
     }
 
     void DebugDraw::addCircle(
@@ -357,13 +448,14 @@ namespace Vapor {
         glm::vec3 right = glm::normalize(glm::cross(up, n));
         glm::vec3 forward = glm::cross(n, right);
 
+        Target target(*this);
         for (int i = 0; i < segments; ++i) {
             float angle1 = (float(i) / segments) * 2.0f * kPi;
             float angle2 = (float(i + 1) / segments) * 2.0f * kPi;
 
             glm::vec3 p1 = center + right * std::cos(angle1) * radius + forward * std::sin(angle1) * radius;
             glm::vec3 p2 = center + right * std::cos(angle2) * radius + forward * std::sin(angle2) * radius;
-            addLine(p1, p2, color);
+            target->pushLine(p1, p2, color);
         }
     }
 
@@ -379,6 +471,7 @@ namespace Vapor {
         glm::vec3 n = glm::normalize(normal);
         glm::vec3 start = glm::normalize(startDir);
 
+        Target target(*this);
         for (int i = 0; i < segments; ++i) {
             float a1 = (float(i) / segments) * angle;
             float a2 = (float(i + 1) / segments) * angle;
@@ -388,15 +481,16 @@ namespace Vapor {
 
             glm::vec3 p1 = center + rot1 * start * radius;
             glm::vec3 p2 = center + rot2 * start * radius;
-            addLine(p1, p2, color);
+            target->pushLine(p1, p2, color);
         }
     }
 
     void DebugDraw::addCross(const glm::vec3& center, float size, const glm::vec4& color) {
         float half = size * 0.5f;
-        addLine(center - glm::vec3(half, 0, 0), center + glm::vec3(half, 0, 0), color);
-        addLine(center - glm::vec3(0, half, 0), center + glm::vec3(0, half, 0), color);
-        addLine(center - glm::vec3(0, 0, half), center + glm::vec3(0, 0, half), color);
+        Target target(*this);
+        target->pushLine(center - glm::vec3(half, 0, 0), center + glm::vec3(half, 0, 0), color);
+        target->pushLine(center - glm::vec3(0, half, 0), center + glm::vec3(0, half, 0), color);
+        target->pushLine(center - glm::vec3(0, 0, half), center + glm::vec3(0, 0, half), color);
     }
 
     void DebugDraw::addAxes(const glm::vec3& center, const glm::quat& rotation, float size) {
@@ -0,0 +1,275 @@
+#include "Vapor/dynamic_atlas.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace Vapor {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SkylineAllocator
+// ─────────────────────────────────────────────────────────────────────────────
+
+SkylineAllocator::SkylineAllocator(Uint32 width, Uint32 height)
+    : pageW(width), pageH(height) {
+    clear();
+}
+
+void SkylineAllocator::clear() {
+    nodes.assign(1, Node{0, 0, pageW});
+    used = 0;
+}
+
+bool SkylineAllocator::allocate(Uint32 width, Uint32 height, Uint32& outX, Uint32& outY) {
+    if (width == 0 || height == 0 || width > pageW || height > pageH) return false;
+
+    size_t bestIdx   = SIZE_MAX;
+    Uint32 bestY     = UINT32_MAX;
+    Uint64 bestWaste = UINT64_MAX;
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Uint32 x = nodes[i].x;
+        if (x + width > pageW) break;
+
+        // The rect rests on the highest node it spans.
+        Uint32 y = 0;
+        Uint32 covered = 0;
+        for (size_t j = i; covered < width; ++j) {
+            y = std::max(y, nodes[j].y);
+            covered += nodes[j].width;
+        }
+        if (y + height > pageH) continue;
+
+        Uint64 waste = 0;
+        covered = 0;
+        for (size_t j = i; covered < width; ++j) {
+            const Uint32 span = std::min(nodes[j].width, width - covered);
+            waste += Uint64(y - nodes[j].y) * span;
+            covered += span;
+        }
+        if (y < bestY || (y == bestY && waste < bestWaste)) {
+            bestIdx   = i;
+            bestY     = y;
+            bestWaste = waste;
+        }
+    }
+    if (bestIdx == SIZE_MAX) return false;
+
+    // New node on top of the rect; trim or drop the nodes it now covers.
+    const Uint32 x = nodes[bestIdx].x;
+    nodes.insert(nodes.begin() + static_cast<std::ptrdiff_t>(bestIdx), Node{x, bestY + height, width});
+    for (size_t i = bestIdx + 1; i < nodes.size();) {
+        const Uint32 end = x + width;
+        if (nodes[i].x >= end) break;
+        const Uint32 overlap = std::min(end - nodes[i].x, nodes[i].width);
+        if (overlap == nodes[i].width) {
+            nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            nodes[i].x += overlap;
+            nodes[i].width -= overlap;
+            break;
+        }
+    }
+    // Merge neighbours at the same height.
+    for (size_t i = 0; i + 1 < nodes.size();) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].width += nodes[i + 1].width;
+            nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        } else {
+            ++i;
+        }
+    }
+
+    used += Uint64(width) * height;
+    outX = x;
+    outY = bestY;
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// DynamicAtlas
+// ─────────────────────────────────────────────────────────────────────────────
+
+DynamicAtlas::DynamicAtlas(const DynamicAtlasDesc& atlasDesc)
+    : desc(atlasDesc) {
+    desc.channelCount = desc.channelCount == 1 ? 1 : 4;
+    desc.maxPages     = std::max(1u, desc.maxPages);
+}
+
+void DynamicAtlas::beginFrame() {
+    ++frame;
+}
+
+const DynamicAtlas::Region* DynamicAtlas::find(Uint64 key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) return nullptr;
+    it->second.lastUsedFrame = frame;
+    return &it->second.region;
+}
+
+const DynamicAtlas::Region* DynamicAtlas::insert(Uint64 key, Uint32 width, Uint32 height, const Uint8* texels) {
+    remove(key);
+    if (width == 0 || height == 0 || !texels) return nullptr;
+    const size_t pitch = size_t(width) * desc.channelCount;
+
+    Region region;
+    bool placed = false;
+    for (Uint32 p = 0; p < pages.size() && !placed; ++p)
+        placed = place(p, width, height, texels, pitch, region);
+    if (!placed && pages.size() < desc.maxPages)
+        placed = place(addPage(), width, height, texels, pitch, region);
+    if (!placed) {
+        // Full: repack the least recently used page, and if the survivors
+        // still leave no room, empty it.
+        const Uint32 victim = pickVictim();
+        if (victim == UINT32_MAX) return nullptr;
+        defragment(victim, false);
+        placed = place(victim, width, height, texels, pitch, region);
+        if (!placed) {
+            defragment(victim, true);
+            placed = place(victim, width, height, texels, pitch, region);
+        }
+        if (!placed) return nullptr;
+    }
+
+    ++stats.inserts;
+    Entry& entry = entries[key];
+    entry.region = region;
+    entry.lastUsedFrame = frame;
+    return &entry.region;
+}
+
+void DynamicAtlas::remove(Uint64 key) {
+    entries.erase(key);
+}
+
+bool DynamicAtlas::place(Uint32 pageIndex, Uint32 width, Uint32 height, const Uint8* texels, size_t srcPitch,
+                         Region& out) {
+    Page& page = pages[pageIndex];
+    const Uint32 pad = desc.padding;
+    Uint32 x = 0, y = 0;
+    if (!page.allocator.allocate(width + pad * 2, height + pad * 2, x, y)) return false;
+    x += pad;
+    y += pad;
+
+    const size_t ch = desc.channelCount;
+    for (Uint32 row = 0; row < height; ++row)
+        std::memcpy(&page.pixels[(size_t(y + row) * desc.pageSize + x) * ch], texels + row * srcPitch, width * ch);
+    if (!page.fullyDirty) page.dirty.push_back({x, y, width, height});
+
+    const float inv = 1.0f / static_cast<float>(desc.pageSize);
+    out.page   = pageIndex;
+    out.x      = x;
+    out.y      = y;
+    out.width  = width;
+    out.height = height;
+    out.uvRect = {x * inv, y * inv, (x + width) * inv, (y + height) * inv};
+    return true;
+}
+
+void DynamicAtlas::defragment(Uint32 pageIndex, bool evictAll) {
+    Page& page = pages[pageIndex];
+    ++stats.defrags;
+
+    // Survivors, tallest first (skyline packs those best), pulled out of the
+    // old pixels before the page is cleared.
+    std::vector<std::pair<Uint64, Entry*>> keep;
+    for (auto it = entries.begin(); it != entries.end();) {
+        Entry& entry = it->second;
+        if (entry.region.page != pageIndex) { ++it; continue; }
+        if (evictAll || entry.lastUsedFrame + desc.retainFrames < frame) {
+            ++stats.evictions;
+            it = entries.erase(it);
+            continue;
+        }
+        keep.emplace_back(it->first, &entry);
+        ++it;
+    }
+    std::sort(keep.begin(), keep.end(), [](const auto& a, const auto& b) {
+        return a.second->region.height != b.second->region.height
+            ? a.second->region.height > b.second->region.height
+            : a.first < b.first;
+    });
+
+    const size_t ch = desc.channelCount;
+    std::vector<Uint8> old;
+    old.swap(page.pixels);
+    page.pixels.assign(old.size(), 0);
+    page.allocator.clear();
+    page.dirty.clear();
+    page.fullyDirty = true;
+
+    for (auto& [key, entry] : keep) {
+        const Region from = entry->region;
+        const Uint8* src = &old[(size_t(from.y) * desc.pageSize + from.x) * ch];
+        if (!place(pageIndex, from.width, from.height, src, size_t(desc.pageSize) * ch, entry->region)) {
+            ++stats.evictions;
+            entries.erase(key);
+        }
+    }
+}
+
+Uint32 DynamicAtlas::pickVictim() const {
+    // Most recent use per page; a page used this frame is pinned.
+    std::vector<Uint64> newest(pages.size(), 0);
+    for (const auto& [key, entry] : entries)
+        newest[entry.region.page] = std::max(newest[entry.region.page], entry.lastUsedFrame);
+    Uint32 victim = UINT32_MAX;
+    for (Uint32 p = 0; p < pages.size(); ++p)
+        if (newest[p] < frame && (victim == UINT32_MAX || newest[p] < newest[victim])) victim = p;
+    return victim;
+}
+
+Uint32 DynamicAtlas::addPage() {
+    Page page;
+    page.allocator = SkylineAllocator(desc.pageSize, desc.pageSize);
+    page.pixels.assign(size_t(desc.pageSize) * desc.pageSize * desc.channelCount, 0);
+    pages.push_back(std::move(page));
+    return static_cast<Uint32>(pages.size() - 1);
+}
+
+void DynamicAtlas::flushUploads(const UploadFn& upload) {
+    const size_t ch = desc.channelCount;
+    for (Uint32 p = 0; p < pages.size(); ++p) {
+        Page& page = pages[p];
+        if (page.fullyDirty) {
+            upload(p, 0, 0, desc.pageSize, desc.pageSize, page.pixels.data(), page.pixels.size());
+            stats.uploadedBytes += page.pixels.size();
+        } else {
+            // Many small rects (a paragraph of new glyphs): one bounding
+            // upload beats dozens of tiny copies.
+            if (page.dirty.size() > 32) {
+                Rect bounds = page.dirty.front();
+                for (const Rect& r : page.dirty) {
+                    const Uint32 x1 = std::max(bounds.x + bounds.width, r.x + r.width);
+                    const Uint32 y1 = std::max(bounds.y + bounds.height, r.y + r.height);
+                    bounds.x = std::min(bounds.x, r.x);
+                    bounds.y = std::min(bounds.y, r.y);
+                    bounds.width = x1 - bounds.x;
+                    bounds.height = y1 - bounds.y;
+                }
+                page.dirty.assign(1, bounds);
+            }
+            for (const Rect& r : page.dirty) {
+                scratch.resize(size_t(r.width) * r.height * ch);
+                for (Uint32 row = 0; row < r.height; ++row)
+                    std::memcpy(&scratch[size_t(row) * r.width * ch],
+                                &page.pixels[(size_t(r.y + row) * desc.pageSize + r.x) * ch], r.width * ch);
+                upload(p, r.x, r.y, r.width, r.height, scratch.data(), scratch.size());
+                stats.uploadedBytes += scratch.size();
+            }
+        }
+        page.dirty.clear();
+        page.fullyDirty = false;
+    }
+}
+
+TextureHandle DynamicAtlas::getPageTexture(Uint32 page) const {
+    return page < pages.size() ? pages[page].texture : TextureHandle{};
+}
+
+void DynamicAtlas::setPageTexture(Uint32 page, TextureHandle texture) {
+    if (page < pages.size()) pages[page].texture = texture;
+}
+
+} // namespace Vapor
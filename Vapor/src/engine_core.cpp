@@ -137,6 +137,16 @@ namespace Vapor {
             _rmluiManager->Update(deltaTime);
         }
 
+        // Pick up assets added/removed on disk (ResHR workflow) about once a
+        // second while hot reload is on; otherwise the indexes stay fixed.
+        if (FileSystem::instance().isHotReloadEnabled()) {
+            _fileWatchTimer += deltaTime;
+            if (_fileWatchTimer >= 1.0f) {
+                _fileWatchTimer = 0.0f;
+                FileSystem::instance().pollChanges();
+            }
+        }
+
         // Future: Handle async task completion callbacks
         // Future: Manage render command buffer submission
         // Future: Coordinate physics-render synchronization
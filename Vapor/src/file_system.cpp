@@ -1,15 +1,45 @@
 #include "Vapor/file_system.hpp"
+#include "Vapor/vfs_archive.hpp"
 
 #include <SDL3/SDL_filesystem.h>
 #include <algorithm>
 #include <cctype>
 #include <filesystem>
 #include <fmt/core.h>
+#include <fstream>
+#include <mutex>
 #include <stdexcept>
 #include <unordered_set>
 
 using namespace Vapor;
 
+struct FileSystem::DirectoryIndex {
+    std::unordered_set<std::string> keys;// vfsLookupKey of every file and directory
+    std::vector<std::string> files;      // relative, '/'-separated, sorted; for list()
+    // Every directory walked, with its mtime at index time; for pollChanges().
+    std::vector<std::pair<std::string, std::filesystem::file_time_type>> directories;
+};
+
+namespace {
+
+std::filesystem::file_time_type directoryTime(const std::filesystem::path& dir) {
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(dir, ec);
+    return ec ? std::filesystem::file_time_type::min() : time;
+}
+
+bool readWholeFile(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    const std::streamsize size = file.tellg();
+    if (size < 0) return false;
+    out.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), size));
+}
+
+} // namespace
+
 FileSystem& FileSystem::instance() {
     static FileSystem fs;
     return fs;
@@ -37,32 +67,190 @@ void FileSystem::lazyInitialize() {
     if (!m_initialized) initialize();
 }
 
-void FileSystem::addSearchPath(std::string absolutePath, int priority) {
-    m_paths.push_back({ std::move(absolutePath), priority });
+void FileSystem::insertMount(SearchEntry entry) {
+    std::unique_lock lock(m_mutex);
+    m_paths.push_back(std::move(entry));
     std::stable_sort(m_paths.begin(), m_paths.end(), [](const SearchEntry& a, const SearchEntry& b) {
         return a.priority < b.priority;
     });
 }
 
+void FileSystem::addSearchPath(std::string absolutePath, int priority) {
+    insertMount({ std::move(absolutePath), priority, nullptr, nullptr });
+}
+
 void FileSystem::removeSearchPath(const std::string& absolutePath) {
+    std::unique_lock lock(m_mutex);
+    m_paths.erase(
+        std::remove_if(m_paths.begin(), m_paths.end(),
+            [&](const SearchEntry& e) { return !e.archive && e.absolutePath == absolutePath; }),
+        m_paths.end()
+    );
+}
+
+bool FileSystem::mountArchive(const std::string& archivePath, int priority) {
+    auto archive = VfsArchive::open(archivePath);
+    if (!archive) return false;
+    insertMount({ archivePath, priority, std::move(archive), nullptr });
+    return true;
+}
+
+void FileSystem::unmountArchive(const std::string& archivePath) {
+    std::unique_lock lock(m_mutex);
     m_paths.erase(
         std::remove_if(m_paths.begin(), m_paths.end(),
-            [&](const SearchEntry& e) { return e.absolutePath == absolutePath; }),
+            [&](const SearchEntry& e) { return e.archive && e.absolutePath == archivePath; }),
         m_paths.end()
     );
 }
 
+auto FileSystem::buildIndex(const std::string& root) -> std::shared_ptr<const DirectoryIndex> {
+    namespace fs = std::filesystem;
+    auto index = std::make_shared<DirectoryIndex>();
+    const fs::path rootDir(root);
+    // A missing root is watched too, so creating it later is picked up.
+    index->directories.emplace_back(root, directoryTime(rootDir));
+
+    std::error_code ec;
+    if (!fs::is_directory(rootDir, ec)) return index;
+    index->keys.insert(std::string());
+    fs::recursive_directory_iterator it(rootDir, fs::directory_options::skip_permission_denied, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        std::error_code dec;
+        const bool isDirectory = it->is_directory(dec);
+        if (!isDirectory && (!it->is_regular_file(dec) || dec)) continue;
+        std::string rel = it->path().lexically_relative(rootDir).generic_string();
+        index->keys.insert(vfsLookupKey(rel));
+        if (isDirectory) {
+            index->directories.emplace_back(it->path().string(), directoryTime(it->path()));
+        } else {
+            index->files.push_back(std::move(rel));
+        }
+    }
+    std::sort(index->files.begin(), index->files.end());
+    return index;
+}
+
+void FileSystem::prepare() {
+    lazyInitialize();
+    {
+        std::shared_lock lock(m_mutex);
+        if (std::none_of(m_paths.begin(), m_paths.end(),
+                         [](const SearchEntry& e) { return !e.archive && !e.index; })) {
+            return;
+        }
+    }
+    // Walk under the exclusive lock: concurrent first lookups need the same
+    // index anyway, and building it twice would double the stat storm.
+    std::unique_lock lock(m_mutex);
+    for (auto& entry : m_paths) {
+        if (!entry.archive && !entry.index) entry.index = buildIndex(entry.absolutePath);
+    }
+}
+
+void FileSystem::invalidate() {
+    std::unique_lock lock(m_mutex);
+    for (auto& entry : m_paths) entry.index = nullptr;
+}
+
+bool FileSystem::pollChanges() {
+    std::vector<std::string> changed;
+    {
+        std::shared_lock lock(m_mutex);
+        for (const auto& entry : m_paths) {
+            if (!entry.index) continue;
+            for (const auto& [dir, time] : entry.index->directories) {
+                if (directoryTime(dir) != time) {
+                    changed.push_back(entry.absolutePath);
+                    break;
+                }
+            }
+        }
+    }
+    if (changed.empty()) return false;
+    std::unique_lock lock(m_mutex);
+    for (auto& entry : m_paths) {
+        if (!entry.archive && std::find(changed.begin(), changed.end(), entry.absolutePath) != changed.end()) {
+            entry.index = nullptr;
+        }
+    }
+    return true;
+}
+
 std::optional<std::string> FileSystem::resolvePath(const std::string& relativePath) const {
-    const_cast<FileSystem*>(this)->lazyInitialize();
+    const_cast<FileSystem*>(this)->prepare();
+    const auto normalized = normalizeVfsPath(relativePath);
+    std::shared_lock lock(m_mutex);
     for (const auto& entry : m_paths) {
+        if (entry.archive) continue;
         std::filesystem::path full = std::filesystem::path(entry.absolutePath) / relativePath;
-        if (std::filesystem::exists(full)) {
+        // Absolute or root-escaping paths aren't in any index (nor is a mount
+        // added or invalidated since prepare()); stat those.
+        const bool found = normalized && entry.index ? entry.index->keys.count(vfsLookupKey(*normalized)) > 0
+                                                     : std::filesystem::exists(full);
+        if (found) {
             return full.string();
         }
     }
     return std::nullopt;
 }
 
+bool FileSystem::exists(const std::string& relativePath) const {
+    const auto normalized = normalizeVfsPath(relativePath);
+    if (!normalized) return resolvePath(relativePath).has_value();
+    const_cast<FileSystem*>(this)->prepare();
+    const std::string key = vfsLookupKey(*normalized);
+    std::shared_lock lock(m_mutex);
+    for (const auto& entry : m_paths) {
+        const bool found = entry.archive ? entry.archive->find(*normalized) || entry.archive->hasDirectory(*normalized)
+                           : entry.index ? entry.index->keys.count(key) > 0
+                                         : std::filesystem::exists(std::filesystem::path(entry.absolutePath) / *normalized);
+        if (found) return true;
+    }
+    return false;
+}
+
+std::optional<FileLocation> FileSystem::locate(const std::string& relativePath) const {
+    const auto normalized = normalizeVfsPath(relativePath);
+    if (!normalized) {
+        auto osPath = resolvePath(relativePath);
+        if (!osPath) return std::nullopt;
+        FileLocation location;
+        location.osPath = std::move(*osPath);
+        return location;
+    }
+
+    const_cast<FileSystem*>(this)->prepare();
+    const std::string key = vfsLookupKey(*normalized);
+    std::shared_lock lock(m_mutex);
+    for (const auto& entry : m_paths) {
+        if (entry.archive) {
+            if (const VfsArchive::Entry* packed = entry.archive->find(*normalized)) {
+                // The shared_ptr keeps the entry alive past the lock.
+                return FileLocation{ entry.archive->getPath(), packed->offset, packed->storedSize, entry.archive,
+                                     packed };
+            }
+        } else {
+            const auto full = std::filesystem::path(entry.absolutePath) / relativePath;
+            if (entry.index ? entry.index->keys.count(key) > 0 : std::filesystem::exists(full)) {
+                FileLocation location;
+                location.osPath = full.string();
+                return location;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::vector<uint8_t>> FileSystem::readFile(const std::string& relativePath) const {
+    const auto location = locate(relativePath);
+    if (!location) return std::nullopt;
+    if (location->archive) return location->archive->read(*location->entry);
+    std::vector<uint8_t> bytes;
+    if (!readWholeFile(location->osPath, bytes)) return std::nullopt;
+    return bytes;
+}
+
 std::string FileSystem::resolvePathOrThrow(const std::string& relativePath) const {
     auto result = resolvePath(relativePath);
     if (!result) {
@@ -74,7 +262,6 @@ std::string FileSystem::resolvePathOrThrow(const std::string& relativePath) cons
 std::vector<std::string>
     FileSystem::list(const std::string& relativeDir, const std::string& extensions, int maxDepth) const {
     namespace fs = std::filesystem;
-    const_cast<FileSystem*>(this)->lazyInitialize();
 
     // Parse the ';'/','-separated extension filter into a lowercase set (no dots).
     std::vector<std::string> exts;
@@ -100,25 +287,41 @@ std::vector<std::string>
         return std::find(exts.begin(), exts.end(), e) != exts.end();
     };
 
-    // Merge across every search path (so DLC/patch models list too), de-duped by
-    // the relative path — the same key resolvePath / loadModel expect back.
+    // Merge across every search path and archive (so DLC/patch models list
+    // too), de-duped by the relative path — the same key resolvePath /
+    // loadModel expect back. Each mount's file list is sorted, so the
+    // directory is one contiguous range starting at its prefix.
     std::vector<std::string> out;
     std::unordered_set<std::string> seen;
+    const auto normalizedDir = normalizeVfsPath(relativeDir);
+    if (!normalizedDir) return out;
+    const std::string prefix = normalizedDir->empty() ? std::string() : *normalizedDir + "/";
+    auto collect = [&](const std::string& path) {
+        if (path.compare(0, prefix.size(), prefix) != 0) return false;
+        const std::string sub = path.substr(prefix.size());
+        const int depth = static_cast<int>(std::count(sub.begin(), sub.end(), '/'));
+        if (maxDepth >= 0 && depth > maxDepth) return true;
+        const size_t slash = sub.find_last_of('/');
+        if (!matches(slash == std::string::npos ? sub : sub.substr(slash + 1))) return true;
+        // Relative to the search-path root: "<relativeDir>/<subpath>",
+        // forward-slashed so it round-trips through resolvePath on Windows.
+        std::string rel = (fs::path(relativeDir) / sub).generic_string();
+        if (seen.insert(rel).second) out.push_back(std::move(rel));
+        return true;
+    };
+
+    const_cast<FileSystem*>(this)->prepare();
+    std::shared_lock lock(m_mutex);
     for (const auto& entry : m_paths) {
-        const fs::path rootDir = fs::path(entry.absolutePath) / relativeDir;
-        std::error_code ec;
-        if (!fs::is_directory(rootDir, ec)) continue;
-        fs::recursive_directory_iterator it(rootDir, fs::directory_options::skip_permission_denied, ec), end;
-        for (; !ec && it != end; it.increment(ec)) {
-            std::error_code dec;
-            if (maxDepth >= 0 && it.depth() >= maxDepth && it->is_directory(dec)) it.disable_recursion_pending();
-            if (!it->is_regular_file(dec) || dec) continue;
-            if (!matches(it->path().filename().string())) continue;
-            // Relative to the search-path root: "<relativeDir>/<subpath>",
-            // forward-slashed so it round-trips through resolvePath on Windows.
-            const std::string rel =
-                (fs::path(relativeDir) / it->path().lexically_relative(rootDir)).generic_string();
-            if (seen.insert(rel).second) out.push_back(rel);
+        if (entry.archive) {
+            const auto& entries = entry.archive->getEntries();
+            auto it = std::lower_bound(entries.begin(), entries.end(), prefix,
+                                       [](const VfsArchive::Entry& e, const std::string& p) { return e.path < p; });
+            for (; it != entries.end() && collect(it->path); ++it) {}
+        } else if (entry.index) {
+            const auto& files = entry.index->files;
+            auto it = std::lower_bound(files.begin(), files.end(), prefix);
+            for (; it != files.end() && collect(*it); ++it) {}
         }
     }
     std::sort(out.begin(), out.end());
@@ -9,6 +9,9 @@
 #include <Jolt/Physics/Collision/Shape/Shape.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace Vapor;
 
 // Template: Water volume
@@ -37,8 +40,7 @@ auto FluidVolumeSettings::createOilVolume(const glm::vec3& position, const glm::
     return settings;
 }
 
-FluidVolume::FluidVolume(Physics3D* physics, const FluidVolumeSettings& settings)
-  : physics(physics), settings(settings) {
+FluidVolume::FluidVolume(const FluidVolumeSettings& settings) : settings(settings) {
 }
 
 FluidVolume::~FluidVolume() {
@@ -55,90 +57,59 @@ auto FluidVolume::isPointInFluid(const glm::vec3& point) const -> bool {
            && std::abs(localPoint.z) <= settings.dimensions.z;
 }
 
-auto FluidVolume::isBodyInFluid(const JPH::BodyID& bodyID) const -> bool {
-    auto* bodyInterface = physics->getBodyInterface();
+auto FluidVolume::isBodyInFluid(Physics3D& physics, const JPH::BodyID& bodyID) const -> bool {
+    auto* bodyInterface = physics.getBodyInterface();
     JPH::RVec3 bodyPos = bodyInterface->GetPosition(bodyID);
     glm::vec3 pos(bodyPos.GetX(), bodyPos.GetY(), bodyPos.GetZ());
     return isPointInFluid(pos);
 }
 
-auto FluidVolume::calculateSubmergedRatio(const JPH::BodyID& bodyID) const -> float {
-    auto* bodyInterface = physics->getBodyInterface();
-    auto* physicsSystem = physics->getPhysicsSystem();
-
-    JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
-    if (!lock.Succeeded()) return 0.0f;
-
-    const JPH::Body& body = lock.GetBody();
-    JPH::AABox worldBounds = body.GetWorldSpaceBounds();
-
-    // Get fluid bounds in world space
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), settings.position) * glm::mat4_cast(settings.rotation);
-    glm::vec3 fluidMin = settings.position - settings.dimensions;
-    glm::vec3 fluidMax = settings.position + settings.dimensions;
-
-    // Convert to Jolt AABox
-    JPH::AABox fluidBounds(
-        JPH::Vec3(fluidMin.x, fluidMin.y, fluidMin.z), JPH::Vec3(fluidMax.x, fluidMax.y, fluidMax.z)
-    );
-
-    // Calculate intersection volume
-    JPH::AABox intersection = worldBounds.Intersect(fluidBounds);
-    if (intersection.IsValid()) {
-        JPH::Vec3 intersectionSize = intersection.GetSize();
-        float intersectionVolume = intersectionSize.GetX() * intersectionSize.GetY() * intersectionSize.GetZ();
-
-        JPH::Vec3 bodySize = worldBounds.GetSize();
-        float bodyVolume = bodySize.GetX() * bodySize.GetY() * bodySize.GetZ();
-
-        if (bodyVolume > 0.0f) {
-            return glm::clamp(intersectionVolume / bodyVolume, 0.0f, 1.0f);
-        }
+auto FluidVolume::submergedFraction(const JPH::Body& body, bool clipSurface) const -> float {
+    // Corners of the body's local bounds, taken into the volume's frame
+    // where the fluid is the box [-dimensions, dimensions].
+    const JPH::AABox bounds = body.GetShape()->GetLocalBounds();
+    const JPH::RMat44 com = body.GetCenterOfMassTransform();
+    const glm::quat toLocal = glm::inverse(settings.rotation);
+    glm::vec3 lo(std::numeric_limits<float>::max());
+    glm::vec3 hi(-std::numeric_limits<float>::max());
+    for (int corner = 0; corner < 8; ++corner) {
+        JPH::Vec3 c(
+            (corner & 1) ? bounds.mMax.GetX() : bounds.mMin.GetX(),
+            (corner & 2) ? bounds.mMax.GetY() : bounds.mMin.GetY(),
+            (corner & 4) ? bounds.mMax.GetZ() : bounds.mMin.GetZ()
+        );
+        JPH::RVec3 world = com * c;
+        glm::vec3 local = toLocal * (glm::vec3(world.GetX(), world.GetY(), world.GetZ()) - settings.position);
+        lo = glm::min(lo, local);
+        hi = glm::max(hi, local);
     }
 
-    return 0.0f;
+    // Clip against every face (or all but the top one) axis by axis.
+    float fraction = 1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        float clipMin = std::max(lo[axis], -settings.dimensions[axis]);
+        float clipMax = (axis == 1 && !clipSurface) ? hi[axis] : std::min(hi[axis], settings.dimensions[axis]);
+        if (clipMax < clipMin) return 0.0f;
+        float extent = hi[axis] - lo[axis];
+        if (extent > 0.0f) fraction *= (clipMax - clipMin) / extent;
+    }
+    return glm::clamp(fraction, 0.0f, 1.0f);
 }
 
-auto FluidVolume::getSubmergedVolume(const JPH::BodyID& bodyID) const -> float {
-    auto* bodyInterface = physics->getBodyInterface();
-    auto* physicsSystem = physics->getPhysicsSystem();
-
-    JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
+auto FluidVolume::calculateSubmergedRatio(Physics3D& physics, const JPH::BodyID& bodyID) const -> float {
+    JPH::BodyLockRead lock(physics.getPhysicsSystem()->GetBodyLockInterface(), bodyID);
     if (!lock.Succeeded()) return 0.0f;
-
-    const JPH::Body& body = lock.GetBody();
-    JPH::AABox worldBounds = body.GetWorldSpaceBounds();
-
-    JPH::Vec3 bodySize = worldBounds.GetSize();
-    float bodyVolume = bodySize.GetX() * bodySize.GetY() * bodySize.GetZ();
-
-    float submergedRatio = calculateSubmergedRatio(bodyID);
-    return bodyVolume * submergedRatio;
+    return submergedFraction(lock.GetBody(), true);
 }
 
-auto FluidVolume::calculateBuoyancyForce(const JPH::BodyID& bodyID, float submergedVolume) const -> glm::vec3 {
-    if (submergedVolume <= 0.0f) return glm::vec3(0.0f);
-
-    // Archimedes' principle: F = ρ * V * g
-    // Where ρ is fluid density, V is displaced volume, g is gravity
-    glm::vec3 gravity = physics->getGravity();
-    float buoyancyMagnitude = settings.density * submergedVolume * glm::length(gravity);
-
-    // Buoyancy acts opposite to gravity
-    glm::vec3 buoyancyDirection = -glm::normalize(gravity);
-    return buoyancyDirection * buoyancyMagnitude;
-}
-
-auto FluidVolume::calculateDragForce(const JPH::BodyID& bodyID, const glm::vec3& velocity) const -> glm::vec3 {
-    if (glm::length(velocity) < 0.001f) return glm::vec3(0.0f);
-
-    // Drag force: F = -k * v²
-    // Simplified drag model using linear drag coefficient
-    float velocityMagnitude = glm::length(velocity);
-    glm::vec3 dragDirection = -glm::normalize(velocity);
-
-    float dragMagnitude = settings.linearDragCoefficient * velocityMagnitude * velocityMagnitude;
-    return dragDirection * dragMagnitude;
+auto FluidVolume::getSubmergedVolume(Physics3D& physics, const JPH::BodyID& bodyID) const -> float {
+    float bodyVolume = 0.0f;
+    {
+        JPH::BodyLockRead lock(physics.getPhysicsSystem()->GetBodyLockInterface(), bodyID);
+        if (!lock.Succeeded()) return 0.0f;
+        bodyVolume = lock.GetBody().GetShape()->GetVolume();
+    }
+    return bodyVolume * calculateSubmergedRatio(physics, bodyID);
 }
 
 auto FluidVolume::getFluidVelocityAt(const glm::vec3& position) const -> glm::vec3 {
@@ -171,57 +142,45 @@ void FluidVolume::setRotation(const glm::quat& rotation) {
     settings.rotation = rotation;
 }
 
-void FluidVolume::applyForcesToBodies(float deltaTime) {
-    auto* bodyInterface = physics->getBodyInterface();
-    auto* physicsSystem = physics->getPhysicsSystem();
-
-    // Get all active bodies
-    JPH::BodyIDVector activeBodyIDs;
-    physicsSystem->GetActiveBodies(JPH::EBodyType::RigidBody, activeBodyIDs);
-
-    for (const JPH::BodyID& bodyID : activeBodyIDs) {
-        // Check if body is in fluid
-        float submergedRatio = calculateSubmergedRatio(bodyID);
-        if (submergedRatio <= 0.0f) continue;
-
-        JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
-        if (!lock.Succeeded()) continue;
-
-        const JPH::Body& body = lock.GetBody();
-
-        // Skip static bodies
-        if (body.GetMotionType() != JPH::EMotionType::Dynamic) continue;
-
-        // Calculate submerged volume
-        float submergedVolume = getSubmergedVolume(bodyID);
-
-        // Apply buoyancy force
-        glm::vec3 buoyancyForce = calculateBuoyancyForce(bodyID, submergedVolume);
-        if (glm::length(buoyancyForce) > 0.0f) {
-            bodyInterface->AddForce(bodyID, JPH::Vec3(buoyancyForce.x, buoyancyForce.y, buoyancyForce.z));
-        }
-
-        // Apply drag forces
-        JPH::Vec3 linearVel = body.GetLinearVelocity();
-        glm::vec3 bodyVelocity(linearVel.GetX(), linearVel.GetY(), linearVel.GetZ());
-
-        // Relative velocity (body velocity - fluid flow velocity)
-        glm::vec3 relativeVelocity = bodyVelocity - settings.flowVelocity;
-
-        glm::vec3 dragForce = calculateDragForce(bodyID, relativeVelocity);
-        dragForce *= submergedRatio;// Scale drag by submerged ratio
-
-        if (glm::length(dragForce) > 0.0f) {
-            bodyInterface->AddForce(bodyID, JPH::Vec3(dragForce.x, dragForce.y, dragForce.z));
-        }
-
-        // Apply angular drag
-        JPH::Vec3 angularVel = body.GetAngularVelocity();
-        glm::vec3 angularVelocity(angularVel.GetX(), angularVel.GetY(), angularVel.GetZ());
-
-        if (glm::length(angularVelocity) > 0.001f) {
-            glm::vec3 angularDrag = -angularVelocity * settings.angularDragCoefficient * submergedRatio;
-            bodyInterface->AddTorque(bodyID, JPH::Vec3(angularDrag.x, angularDrag.y, angularDrag.z));
-        }
+void FluidVolume::getWorldBounds(glm::vec3& outMin, glm::vec3& outMax) const {
+    // Extent of a rotated box along each world axis: |R| * halfExtents.
+    glm::mat3 r = glm::mat3_cast(settings.rotation);
+    glm::vec3 extent(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        extent += glm::abs(r[axis]) * settings.dimensions[axis];
     }
+    outMin = settings.position - extent;
+    outMax = settings.position + extent;
+}
+
+auto FluidVolume::applyBuoyancy(JPH::Body& body, const glm::vec3& gravity, float deltaTime) const -> bool {
+    if (body.GetMotionType() != JPH::EMotionType::Dynamic) return false;
+
+    // The broadphase only tested the world AABB: a body can still be outside
+    // the rotated box, or below its bottom face.
+    float inside = submergedFraction(body, false);
+    if (inside <= 0.0f) return false;
+
+    // Jolt's buoyancy factor is fluid density / body density (1 = neutral).
+    // Jolt only clips against the surface plane, so the part of the body
+    // outside the other faces is taken off by scaling with `inside`.
+    float inverseMass = body.GetMotionProperties()->GetInverseMass();
+    float bodyVolume = body.GetShape()->GetVolume();
+    if (inverseMass <= 0.0f || bodyVolume <= 0.0f) return false;
+    float buoyancy = settings.density * bodyVolume * inverseMass * inside;
+
+    glm::vec3 up = settings.rotation * glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 surface = settings.position + up * settings.dimensions.y;
+    glm::vec3 flow = getFluidVelocityAt(surface);
+
+    return body.ApplyBuoyancyImpulse(
+        JPH::RVec3(surface.x, surface.y, surface.z),
+        JPH::Vec3(up.x, up.y, up.z),
+        buoyancy,
+        settings.linearDragCoefficient * inside,
+        settings.angularDragCoefficient * inside,
+        JPH::Vec3(flow.x, flow.y, flow.z),
+        JPH::Vec3(gravity.x, gravity.y, gravity.z),
+        deltaTime
+    );
 }
@@ -3,12 +3,47 @@
 
 #include "Vapor/file_system.hpp"
 #include "Vapor/font_manager.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <fmt/format.h>
 #include <fstream>
+#include <string_view>
 
 using namespace Vapor;
 
+struct FontManager::FontSource {
+    std::vector<unsigned char> data;// stbtt_fontinfo points into this
+    stbtt_fontinfo info{};
+    float scale = 0.0f;
+};
+
+namespace {
+
+Uint64 glyphKey(Uint32 fontID, int codepoint) {
+    return (Uint64(fontID) << 32) | static_cast<Uint32>(codepoint);
+}
+
+Uint64 layoutKey(Uint32 fontID, float scale, const std::string& text) {
+    Uint32 scaleBits;
+    std::memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    const Uint64 fontAndScale = (Uint64(fontID) << 32) | scaleBits;
+    return std::hash<std::string_view>{}(text) ^ (fontAndScale * 0x9E3779B97F4A7C15ull);
+}
+
+void applyRegion(Glyph& glyph, const DynamicAtlas::Region& region) {
+    glyph.u0 = region.uvRect.x;
+    glyph.v0 = region.uvRect.y;
+    glyph.u1 = region.uvRect.z;
+    glyph.v1 = region.uvRect.w;
+    glyph.atlasPage = region.page;
+}
+
+}// namespace
+
+FontManager::FontManager() = default;
+FontManager::~FontManager() = default;
+
 void FontManager::initialize(MTL::Device* device) {
     m_device = device;
 }
@@ -46,6 +81,14 @@ auto FontManager::loadFont(const std::string& filename, float baseSize, int firs
         return FontHandle{};
     }
 
+    // Keep the font around for glyphs outside the baked range
+    auto source = std::make_unique<FontSource>();
+    source->data = std::move(fontData);
+    if (stbtt_InitFont(&source->info, source->data.data(), 0)) {
+        source->scale = stbtt_ScaleForPixelHeight(&source->info, baseSize);
+        m_sources[handle.rid] = std::move(source);
+    }
+
     fmt::print(
         "[FontManager] Loaded font: {} (size: {}, atlas: {}x{})\n",
         path,
@@ -62,8 +105,12 @@ void FontManager::unloadFont(FontHandle handle) {
 
     auto it = m_fonts.find(handle.rid);
     if (it != m_fonts.end()) {
+        for (const auto& [codepoint, glyph] : it->second.dynamicGlyphs)
+            m_glyphAtlas.remove(glyphKey(handle.rid, codepoint));
         m_fonts.erase(it);
     }
+    std::erase_if(m_layouts, [&](const auto& entry) { return entry.second.fontID == handle.rid; });
+    m_sources.erase(handle.rid);
 
     auto atlasIt = m_atlasData.find(handle.rid);
     if (atlasIt != m_atlasData.end()) {
@@ -83,30 +130,200 @@ auto FontManager::getFontTexture(FontHandle handle) -> TextureHandle {
 }
 
 auto FontManager::measureText(FontHandle handle, const std::string& text, float scale) -> glm::vec2 {
+    const TextLayout* layout = layoutText(handle, text, scale);
+    return layout ? layout->size : glm::vec2(0.0f);
+}
+
+auto FontManager::layoutText(FontHandle handle, const std::string& text, float scale) -> const TextLayout* {
     Font* font = getFont(handle);
-    if (!font) return glm::vec2(0.0f);
+    if (!font) return nullptr;
 
+    CachedLayout& cached = m_layouts[layoutKey(handle.rid, scale, text)];
+    cached.lastUsedFrame = m_frame;
+    if (cached.fontID == handle.rid && cached.scale == scale && cached.text == text) {
+        // Touching the atlas entries also pins them for this frame
+        bool valid = true;
+        for (Uint64 key : cached.atlasKeys) {
+            valid = m_glyphAtlas.find(key) != nullptr && valid;
+        }
+        if (valid && cached.atlasGeneration == m_glyphAtlas.generation()) return &cached.layout;
+    }
+
+    // New string (or a hash collision, which simply replaces the entry)
+    cached.fontID = handle.rid;
+    cached.scale = scale;
+    cached.text = text;
+    const Uint64 missesBefore = m_glyphAtlasMisses;
+    buildLayout(handle.rid, *font, text, scale, cached.layout, cached.atlasKeys);
+    // A glyph that didn't fit the atlas this frame: lay out again next time
+    cached.atlasGeneration = m_glyphAtlasMisses == missesBefore ? m_glyphAtlas.generation() : UINT64_MAX;
+    return &cached.layout;
+}
+
+void FontManager::buildLayout(
+    Uint32 fontID, Font& font, const std::string& text, float scale, TextLayout& out, std::vector<Uint64>& atlasKeys
+) {
+    out.quads.clear();
+    out.quads.reserve(text.size());
+    out.usesGlyphAtlas = false;
+    atlasKeys.clear();
+
+    float cursorX = 0.0f;
+    float cursorY = 0.0f;
     float width = 0.0f;
     float maxHeight = 0.0f;
 
-    for (char c : text) {
-        auto it = font->glyphs.find(static_cast<int>(c));
-        if (it != font->glyphs.end()) {
-            width += it->second.advance * scale;
-            float h = it->second.height * scale;
-            if (h > maxHeight) maxHeight = h;
+    for (size_t i = 0; i < text.size();) {
+        const int codepoint = nextCodepoint(text, i);
+        if (codepoint == '\n') {
+            cursorX = 0.0f;
+            cursorY += font.lineHeight * scale;
+            continue;
+        }
+        const Glyph* glyph = findGlyph(fontID, font, codepoint);
+        if (!glyph) continue;
+
+        width += glyph->advance * scale;
+        maxHeight = std::max(maxHeight, glyph->height * scale);
+
+        if (glyph->width > 0.0f && glyph->height > 0.0f) {
+            // yOffset is relative to the baseline, which sits ascent below
+            // the top of the line
+            const float x0 = cursorX + glyph->xOffset * scale;
+            const float y0 = cursorY + (glyph->yOffset + font.ascent) * scale;
+            out.quads.push_back({
+                glm::vec4(x0, y0, x0 + glyph->width * scale, y0 + glyph->height * scale),
+                glm::vec4(glyph->u0, glyph->v0, glyph->u1, glyph->v1),
+                glyph->atlasPage,
+            });
+            if (glyph->atlasPage != Glyph::kBakedAtlas) {
+                out.usesGlyphAtlas = true;
+                atlasKeys.push_back(glyphKey(fontID, codepoint));
+            }
         }
+        cursorX += glyph->advance * scale;
     }
 
-    return glm::vec2(width, maxHeight > 0 ? maxHeight : font->lineHeight * scale);
+    std::sort(atlasKeys.begin(), atlasKeys.end());
+    atlasKeys.erase(std::unique(atlasKeys.begin(), atlasKeys.end()), atlasKeys.end());
+    out.size = glm::vec2(width, maxHeight > 0 ? maxHeight : font.lineHeight * scale);
+}
+
+void FontManager::beginFrame() {
+    ++m_frame;
+    m_glyphAtlas.beginFrame();
+
+    // Strings that change every frame (counters, timers) leave a layout
+    // behind each frame; sweep the unused ones now and then.
+    constexpr Uint64 kSweepInterval = 64;
+    constexpr Uint64 kRetainFrames = 240;
+    if (m_frame % kSweepInterval == 0) {
+        std::erase_if(m_layouts, [&](const auto& entry) { return entry.second.lastUsedFrame + kRetainFrames < m_frame; });
+    }
 }
 
 auto FontManager::getGlyph(FontHandle handle, int codepoint) -> const Glyph* {
     Font* font = getFont(handle);
-    if (!font) return nullptr;
+    return font ? findGlyph(handle.rid, *font, codepoint) : nullptr;
+}
+
+auto FontManager::findGlyph(Uint32 fontID, Font& font, int codepoint) -> const Glyph* {
+    if (codepoint >= 0 && codepoint < Font::kFlatGlyphCount && font.hasFlatGlyph[codepoint]) {
+        return &font.flatGlyphs[codepoint];
+    }
+
+    auto it = font.glyphs.find(codepoint);
+    if (it != font.glyphs.end()) return &it->second;
+
+    auto dyn = font.dynamicGlyphs.find(codepoint);
+    if (dyn != font.dynamicGlyphs.end()) {
+        Glyph& glyph = dyn->second;
+        if (glyph.width <= 0.0f || glyph.height <= 0.0f) return &glyph;// blank: nothing in the atlas
+        if (const auto* region = m_glyphAtlas.find(glyphKey(fontID, codepoint))) {
+            applyRegion(glyph, *region);
+            return &glyph;
+        }
+        // Evicted from the atlas since: rasterize again
+    }
+    return rasterizeGlyph(fontID, font, codepoint);
+}
+
+auto FontManager::rasterizeGlyph(Uint32 fontID, Font& font, int codepoint) -> const Glyph* {
+    auto srcIt = m_sources.find(fontID);
+    if (srcIt == m_sources.end()) return nullptr;
+    FontSource& source = *srcIt->second;
+
+    const int glyphIndex = stbtt_FindGlyphIndex(&source.info, codepoint);
+    if (glyphIndex == 0) return nullptr;// not in this font
+
+    int advance, lsb;
+    stbtt_GetGlyphHMetrics(&source.info, glyphIndex, &advance, &lsb);
+    int x0, y0, x1, y1;
+    stbtt_GetGlyphBitmapBox(&source.info, glyphIndex, source.scale, source.scale, &x0, &y0, &x1, &y1);
+    const int glyphWidth = x1 - x0;
+    const int glyphHeight = y1 - y0;
+
+    Glyph& glyph = font.dynamicGlyphs[codepoint];
+    glyph = Glyph{};
+    glyph.xOffset = static_cast<float>(x0);
+    glyph.yOffset = static_cast<float>(y0);
+    glyph.width = static_cast<float>(glyphWidth);
+    glyph.height = static_cast<float>(glyphHeight);
+    glyph.advance = advance * source.scale;
+    if (glyphWidth <= 0 || glyphHeight <= 0) return &glyph;
+
+    // Same texel layout as the baked atlas: white, coverage in alpha
+    std::vector<unsigned char> coverage(size_t(glyphWidth) * glyphHeight);
+    stbtt_MakeGlyphBitmap(
+        &source.info, coverage.data(), glyphWidth, glyphHeight, glyphWidth, source.scale, source.scale, glyphIndex
+    );
+    std::vector<Uint8> rgba(coverage.size() * 4, 255);
+    for (size_t i = 0; i < coverage.size(); i++) {
+        rgba[i * 4 + 3] = coverage[i];
+    }
 
-    auto it = font->glyphs.find(codepoint);
-    return (it != font->glyphs.end()) ? &it->second : nullptr;
+    const auto* region = m_glyphAtlas.insert(glyphKey(fontID, codepoint), glyphWidth, glyphHeight, rgba.data());
+    if (!region) {
+        // Atlas full of glyphs pinned this frame; try again next frame
+        font.dynamicGlyphs.erase(codepoint);
+        ++m_glyphAtlasMisses;
+        return nullptr;
+    }
+    applyRegion(glyph, *region);
+    return &glyph;
+}
+
+int FontManager::nextCodepoint(std::string_view text, size_t& offset) {
+    constexpr int kReplacement = 0xFFFD;
+    const auto lead = static_cast<unsigned char>(text[offset++]);
+    if (lead < 0x80) return lead;
+
+    int length = 0;
+    int codepoint = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1;
+        codepoint = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2;
+        codepoint = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3;
+        codepoint = lead & 0x07;
+    } else {
+        return kReplacement;
+    }
+    if (offset + length > text.size()) return kReplacement;
+    for (int i = 0; i < length; i++) {
+        const auto next = static_cast<unsigned char>(text[offset + i]);
+        if ((next & 0xC0) != 0x80) return kReplacement;
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    offset += length;
+    // Overlong forms, surrogates and values past U+10FFFF
+    static constexpr int kMinForLength[4] = { 0, 0x80, 0x800, 0x10000 };
+    if (codepoint < kMinForLength[length] || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+        return kReplacement;
+    return codepoint;
 }
 
 void FontManager::setFontTextureHandle(FontHandle fontHandle, TextureHandle texHandle) {
@@ -206,6 +423,10 @@ auto FontManager::bakeFontAtlas(Font& font, const unsigned char* fontData, float
         glyph.advance = advance * scale;
 
         font.glyphs[codepoint] = glyph;
+        if (codepoint >= 0 && codepoint < Font::kFlatGlyphCount) {
+            font.flatGlyphs[codepoint] = glyph;
+            font.hasFlatGlyph.set(codepoint);
+        }
 
         // Update position
         x += glyphWidth + padding;
@@ -101,6 +101,35 @@ namespace Vapor {
         }
     }
 
+    auto InputManager::captureFrame() const -> InputFrame {
+        auto toMask = [](const std::unordered_set<InputAction>& actions) {
+            uint32_t mask = 0;
+            for (InputAction action : actions) {
+                if (action != InputAction::UNKNOWN) mask |= 1u << static_cast<uint32_t>(action);
+            }
+            return mask;
+        };
+        InputFrame frame;
+        frame.held = toMask(currentState.heldActions);
+        frame.pressed = toMask(currentState.pressedActions);
+        frame.released = toMask(currentState.releasedActions);
+        frame.mousePosition = currMousePosition;
+        return frame;
+    }
+
+    void InputManager::applyFrame(const InputFrame& frame) {
+        auto fromMask = [](uint32_t mask, std::unordered_set<InputAction>& actions) {
+            actions.clear();
+            for (uint32_t i = 0; i < static_cast<uint32_t>(InputAction::UNKNOWN); ++i) {
+                if (mask & (1u << i)) actions.insert(static_cast<InputAction>(i));
+            }
+        };
+        fromMask(frame.held, currentState.heldActions);
+        fromMask(frame.pressed, currentState.pressedActions);
+        fromMask(frame.released, currentState.releasedActions);
+        currMousePosition = frame.mousePosition;
+    }
+
     void InputManager::mapKey(SDL_Scancode key, InputAction action) {
         keyToAction[key] = action;
     }
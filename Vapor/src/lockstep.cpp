@@ -0,0 +1,232 @@
+#include "lockstep.hpp"
+#include "components.hpp"
+#include "rng.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fmt/core.h>
+#include <fstream>
+
+namespace Vapor {
+
+    namespace {
+
+        constexpr char kLogMagic[4] = { 'V', 'I', 'N', 'L' };
+        constexpr uint32_t kLogVersion = 1;
+        constexpr uint64_t kMaxTicks = 1ull << 32;// sanity bound against corrupt headers
+
+        void writeVarint(std::ofstream& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.put(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.put(static_cast<char>(value));
+        }
+
+        bool readVarint(std::ifstream& in, uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                int byte = in.get();
+                if (byte == EOF) return false;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        template<typename T> void writePod(std::ofstream& out, const T& value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T> bool readPod(std::ifstream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+    }// namespace
+
+    // ── LockstepClock ────────────────────────────────────────────────────────
+
+    LockstepClock::LockstepClock(uint32_t tickRate) : m_tickRate(std::max(tickRate, 1u)) {
+    }
+
+    uint32_t LockstepClock::accumulate(uint64_t elapsedNs, uint32_t maxTicks) {
+        // Past maxTicks + 1 ticks everything is dropped anyway; the clamp
+        // keeps the scaled bank from overflowing.
+        const uint64_t maxElapsedNs = ((uint64_t(maxTicks) + 1) * kNsPerSecond + m_tickRate - 1) / m_tickRate;
+        m_banked += std::min(elapsedNs, maxElapsedNs) * m_tickRate;
+        uint64_t due = m_banked / kNsPerSecond;
+        if (due > maxTicks) {
+            due = maxTicks;
+            m_banked = due * kNsPerSecond;// drop the backlog
+        }
+        m_banked -= due * kNsPerSecond;
+        return static_cast<uint32_t>(due);
+    }
+
+    float LockstepClock::getAlpha() const {
+        return static_cast<float>(static_cast<double>(m_banked) / kNsPerSecond);
+    }
+
+    void LockstepClock::reset(uint64_t tick) {
+        m_tick = tick;
+        m_banked = 0;
+    }
+
+    // ── InputLog ─────────────────────────────────────────────────────────────
+
+    void InputLog::begin(uint32_t tickRate, uint64_t seed) {
+        m_changes.clear();
+        m_hashes.clear();
+        m_tickRate = tickRate;
+        m_seed = seed;
+        RngStreams::instance().reseed(seed);
+    }
+
+    void InputLog::record(const InputFrame& frame, uint64_t stateHash) {
+        const uint64_t tick = m_hashes.size();
+        // Tick 0 is always stored so frameAt() has a base to fall back on, and
+        // so is every frame with edges (they last exactly one tick).
+        if (m_changes.empty() || frame.pressed || frame.released || !(m_changes.back().frame == frame)) {
+            m_changes.push_back({ tick, frame });
+        }
+        m_hashes.push_back(stateHash);
+    }
+
+    auto InputLog::frameAt(uint64_t tick) const -> InputFrame {
+        // Last change at or before `tick`.
+        auto it = std::upper_bound(
+            m_changes.begin(), m_changes.end(), tick, [](uint64_t t, const Change& c) { return t < c.tick; }
+        );
+        if (it == m_changes.begin()) return {};
+        InputFrame frame = std::prev(it)->frame;
+        // Edges belong to the tick they were recorded on; a held-over frame has none.
+        if (std::prev(it)->tick != tick) frame.pressed = frame.released = 0;
+        return frame;
+    }
+
+    bool InputLog::save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            fmt::print(stderr, "InputLog: cannot write '{}'\n", path);
+            return false;
+        }
+        out.write(kLogMagic, sizeof(kLogMagic));
+        writePod(out, kLogVersion);
+        writePod(out, m_tickRate);
+        writePod(out, m_seed);
+        writePod(out, static_cast<uint64_t>(m_hashes.size()));
+        writePod(out, static_cast<uint64_t>(m_changes.size()));
+        uint64_t prevTick = 0;
+        for (const auto& change : m_changes) {
+            writeVarint(out, change.tick - prevTick);
+            prevTick = change.tick;
+            writePod(out, change.frame.held);
+            writePod(out, change.frame.pressed);
+            writePod(out, change.frame.released);
+            writePod(out, change.frame.mousePosition.x);
+            writePod(out, change.frame.mousePosition.y);
+        }
+        out.write(reinterpret_cast<const char*>(m_hashes.data()), m_hashes.size() * sizeof(uint64_t));
+        return static_cast<bool>(out);
+    }
+
+    bool InputLog::load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        char magic[4] = {};
+        uint32_t version = 0;
+        uint64_t tickCount = 0, changeCount = 0;
+        in.read(magic, sizeof(magic));
+        if (!readPod(in, version) || std::memcmp(magic, kLogMagic, sizeof(magic)) != 0 || version != kLogVersion) {
+            fmt::print(stderr, "InputLog: '{}' is not an input log (or an older version)\n", path);
+            return false;
+        }
+        uint32_t tickRate = 0;
+        uint64_t seed = 0;
+        if (!readPod(in, tickRate) || !readPod(in, seed) || !readPod(in, tickCount) || !readPod(in, changeCount)
+            || changeCount > tickCount || tickCount > kMaxTicks) {
+            fmt::print(stderr, "InputLog: '{}' has a corrupt header\n", path);
+            return false;
+        }
+
+        std::vector<Change> changes(changeCount);
+        uint64_t tick = 0;
+        for (auto& change : changes) {
+            uint64_t delta = 0;
+            bool ok = readVarint(in, delta) && readPod(in, change.frame.held) && readPod(in, change.frame.pressed)
+                      && readPod(in, change.frame.released) && readPod(in, change.frame.mousePosition.x)
+                      && readPod(in, change.frame.mousePosition.y);
+            tick += delta;
+            if (!ok || tick >= tickCount) {
+                fmt::print(stderr, "InputLog: '{}' is truncated or corrupt\n", path);
+                return false;
+            }
+            change.tick = tick;
+        }
+        std::vector<uint64_t> hashes(tickCount);
+        if (!in.read(reinterpret_cast<char*>(hashes.data()), tickCount * sizeof(uint64_t))) {
+            fmt::print(stderr, "InputLog: '{}' is truncated or corrupt\n", path);
+            return false;
+        }
+
+        m_changes = std::move(changes);
+        m_hashes = std::move(hashes);
+        m_tickRate = tickRate;
+        m_seed = seed;
+        return true;
+    }
+
+    // ── Replay ───────────────────────────────────────────────────────────────
+
+    ReplayResult replayInputLog(
+        const InputLog& log, InputManager& input, const LockstepTick& tick, const LockstepHash& hash, bool stopAtDesync
+    ) {
+        ReplayResult result;
+        RngStreams::instance().reseed(log.getSeed());
+        const float dt = 1.0f / static_cast<float>(log.getTickRate());
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t t = 0; t < log.getTickCount(); ++t) {
+            input.update(dt);
+            input.applyFrame(log.frameAt(t));
+            tick(t, dt);
+            ++result.ticks;
+
+            const uint64_t actual = hash();
+            if (actual != log.hashAt(t) && result.ok()) {
+                result.firstDesync = t;
+                result.expectedHash = log.hashAt(t);
+                result.actualHash = actual;
+                fmt::print(stderr, "replay: desync at tick {} (expected {:016x}, got {:016x})\n", t,
+                           result.expectedHash, actual);
+                if (stopAtDesync) break;
+            }
+        }
+        result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hashTransforms(const entt::registry& registry, uint64_t hash) {
+        auto view = registry.view<const TransformComponent>();
+        for (auto entity : view) {
+            const auto& t = view.get<const TransformComponent>(entity);
+            const uint32_t id = static_cast<uint32_t>(entity);
+            hash = hashBytes(&id, sizeof(id), hash);
+            hash = hashBytes(&t.position, sizeof(t.position), hash);
+            hash = hashBytes(&t.rotation, sizeof(t.rotation), hash);
+            hash = hashBytes(&t.scale, sizeof(t.scale), hash);
+        }
+        return hash;
+    }
+
+}// namespace Vapor
@@ -9,14 +9,418 @@
 #include "meshopt/clusterlod.h"
 
 #include "meshlet_builder.hpp"
+#include "task_scheduler.hpp"
 
 #include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <fmt/core.h>
+#include <glm/gtc/packing.hpp>
+#include <numeric>
 #include <vector>
 
 using namespace Vapor;
 
-void MeshletBuilder::build(Mesh& mesh) {
+namespace {
+
+// uv and normal are read as one 5-float attribute stream starting at uv.x.
+static_assert(offsetof(VertexData, normal) == offsetof(VertexData, uv) + sizeof(glm::vec2),
+              "MeshletBuilder reads uv + normal as one contiguous attribute stream");
+
+// Attribute weights for meshopt_simplifyWithAttributes: uv.xy, normal.xyz.
+constexpr float kAttributeWeights[] = { 0.5f, 0.5f, 0.5f, 0.5f, 0.5f };
+constexpr unsigned int kUvProtectMask = (1u << 0) | (1u << 1);
+
+clodBounds toClodBounds(const meshopt_Bounds& mb, float error) {
+    clodBounds b;
+    b.center[0] = mb.center[0];
+    b.center[1] = mb.center[1];
+    b.center[2] = mb.center[2];
+    b.radius = mb.radius;
+    b.error = error;
+    return b;
+}
+
+// Sphere + backface cone from the cluster geometry (one meshopt call serves both).
+meshopt_Bounds clusterGeometryBounds(const clodMesh& mesh, const std::vector<unsigned int>& indices) {
+    return meshopt_computeClusterBounds(indices.data(), indices.size(), mesh.vertex_positions, mesh.vertex_count,
+                                        mesh.vertex_positions_stride);
+}
+
+// Simplify + re-clusterize result of one group, computed off-thread and
+// published in group order so group ids match a serial bake.
+struct GroupResult {
+    clodBounds bounds;
+    bool terminal = false;
+    std::vector<clod::Cluster> split;
+    std::vector<meshopt_Bounds> splitCones;
+};
+
+// Appends one clod group's clusters to the meshlet output; returns its group id.
+int emitGroup(MeshletData& md, std::vector<clodBounds>& groupSimplified, const clodConfig& config,
+              const std::vector<clod::Cluster>& clusters, const std::vector<meshopt_Bounds>& cones,
+              const std::vector<int>& group, const clodBounds& simplified, int depth) {
+    const int groupId = static_cast<int>(groupSimplified.size());
+    groupSimplified.push_back(simplified);
+    md.lodLevelCount = std::max<Uint32>(md.lodLevelCount, static_cast<Uint32>(depth) + 1);
+
+    for (int ci : group) {
+        const clod::Cluster& c = clusters[ci];
+        const meshopt_Bounds& mb = cones[ci];
+
+        // Meshlet-local indexing straight into the output tails:
+        // meshletVertices[triangles[k]] == indices[k].
+        const size_t vertexOffset = md.meshletVertices.size();
+        const size_t triangleOffset = md.meshletTriangles.size();
+        md.meshletVertices.resize(vertexOffset + c.indices.size());
+        md.meshletTriangles.resize(triangleOffset + c.indices.size());
+        const size_t uniq = clodLocalIndices(&md.meshletVertices[vertexOffset], &md.meshletTriangles[triangleOffset],
+                                             c.indices.data(), c.indices.size());
+        md.meshletVertices.resize(vertexOffset + uniq);
+
+        Meshlet ml;
+        ml.vertexOffset   = static_cast<Uint32>(vertexOffset);
+        ml.triangleOffset = static_cast<Uint32>(triangleOffset);
+        ml.vertexCount    = static_cast<Uint32>(uniq);
+        ml.triangleCount  = static_cast<Uint32>(c.indices.size() / 3);
+
+        // Same rule as clod::outputGroup: simplified clusters carry the
+        // group-merged sphere unless precise bounds were asked for.
+        const clodBounds cb = (config.optimize_bounds && c.refined != -1) ? toClodBounds(mb, c.bounds.error) : c.bounds;
+
+        MeshletBounds b;
+        b.cullSphere     = glm::vec4(cb.center[0], cb.center[1], cb.center[2], cb.radius);
+        b.coneApex       = glm::vec4(mb.cone_apex[0], mb.cone_apex[1], mb.cone_apex[2], 0.0f);
+        b.coneAxisCutoff = glm::vec4(mb.cone_axis[0], mb.cone_axis[1], mb.cone_axis[2], mb.cone_cutoff);
+
+        // Two-sphere LOD cut. parent = this group's simplified step (coarser).
+        b.parentSphere = glm::vec4(simplified.center[0], simplified.center[1], simplified.center[2], simplified.radius);
+        b.parentError  = simplified.error;
+        b.group   = groupId;
+        b.refined = c.refined;
+        b.depth   = depth;
+        // lod sphere/error come from the finer group (filled in a second pass);
+        // original geometry (refined < 0) is exact.
+        if (c.refined < 0) {
+            b.lodSphere = b.cullSphere;
+            b.lodError  = 0.0f;
+        }
+
+        md.bounds.push_back(b);
+        md.meshlets.push_back(ml);
+    }
+    return groupId;
+}
+
+// clodBuild with the per-group work of each DAG level fanned out over the
+// scheduler. Levels stay sequential (each partitions the previous level's
+// output); partition + boundary locking and the output stay serial, so the
+// result is identical with or without a scheduler. Mirrors clodBuild in the
+// vendored clusterlod.h — re-sync when the pin moves (see meshopt/VENDOR.md).
+void bakeClusterDag(const clodConfig& config, const clodMesh& mesh, TaskScheduler* scheduler, MeshletData& md,
+                    std::vector<clodBounds>& groupSimplified) {
+    std::vector<unsigned char> locks(mesh.vertex_count);
+
+    // Position-only remap so clusters sharing a position (across seams) connect.
+    std::vector<unsigned int> remap(mesh.vertex_count);
+    meshopt_generatePositionRemap(remap.data(), mesh.vertex_positions, mesh.vertex_count, mesh.vertex_positions_stride);
+
+    // Protect bits on attribute seams for permissive simplification.
+    if (mesh.attribute_protect_mask) {
+        const size_t maxAttributes = mesh.vertex_attributes_stride / sizeof(float);
+        for (size_t i = 0; i < mesh.vertex_count; ++i) {
+            const unsigned int r = remap[i];
+            for (size_t j = 0; j < maxAttributes; ++j)
+                if (r != i && (mesh.attribute_protect_mask & (1u << j)) &&
+                    mesh.vertex_attributes[i * maxAttributes + j] != mesh.vertex_attributes[r * maxAttributes + j])
+                    locks[i] |= meshopt_SimplifyVertex_Protect;
+        }
+    }
+
+    std::vector<clod::Cluster> clusters = clod::clusterize(config, mesh, mesh.indices, mesh.index_count);
+    std::vector<meshopt_Bounds> cones(clusters.size());
+
+    // Precise bounds for the original clusters; later ones use group-merged bounds.
+    TaskScheduler::forRange(scheduler, clusters.size(), 64, [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            cones[i] = clusterGeometryBounds(mesh, clusters[i].indices);
+            clusters[i].bounds = toClodBounds(cones[i], 0.0f);
+        }
+    });
+
+    std::vector<int> pending(clusters.size());
+    std::iota(pending.begin(), pending.end(), 0);
+
+    // One merge buffer per worker, reused across groups and levels.
+    std::vector<std::vector<unsigned int>> merged(scheduler ? scheduler->getNumThreads() : 1);
+    std::vector<GroupResult> results;
+
+    int depth = 0;
+    while (pending.size() > 1) {
+        std::vector<std::vector<int>> groups = clod::partition(config, mesh, clusters, pending, remap);
+        pending.clear();
+
+        // Lock group boundaries so simplified groups stay crack-free.
+        clod::lockBoundary(locks, groups, clusters, remap, mesh.vertex_lock);
+
+        // Groups only read clusters/locks here; nothing is published until below.
+        results.clear();
+        results.resize(groups.size());
+        TaskScheduler::forRange(scheduler, groups.size(), 1, [&](Uint32 begin, Uint32 end, Uint32 thread) {
+            std::vector<unsigned int>& indices = merged[thread];
+            for (Uint32 g = begin; g < end; ++g) {
+                GroupResult& r = results[g];
+
+                indices.clear();
+                for (int ci : groups[g])
+                    indices.insert(indices.end(), clusters[ci].indices.begin(), clusters[ci].indices.end());
+                const size_t targetSize = size_t((indices.size() / 3) * config.simplify_ratio) * 3;
+
+                // Merged bounds keep bounds/error monotone up the DAG.
+                r.bounds = clod::mergeGroups(clusters, groups[g]);
+
+                float error = 0.0f;
+                std::vector<unsigned int> simplified = clod::simplify(config, mesh, indices, locks, targetSize, &error);
+                if (simplified.size() > indices.size() * config.simplify_threshold) {
+                    r.bounds.error = FLT_MAX;   // stuck: terminal group
+                    r.terminal = true;
+                    continue;
+                }
+                r.bounds.error = std::max(r.bounds.error * config.simplify_error_merge_previous, error) +
+                                 error * config.simplify_error_merge_additive;
+
+                r.split = clod::clusterize(config, mesh, simplified.data(), simplified.size());
+                r.splitCones.resize(r.split.size());
+                for (size_t k = 0; k < r.split.size(); ++k)
+                    r.splitCones[k] = clusterGeometryBounds(mesh, r.split[k].indices);
+            }
+        });
+
+        for (size_t g = 0; g < groups.size(); ++g) {
+            GroupResult& r = results[g];
+            const int refined = emitGroup(md, groupSimplified, config, clusters, cones, groups[g], r.bounds, depth);
+            if (r.terminal) continue;
+
+            // The group's clusters are replaced by the split; drop their indices.
+            for (int ci : groups[g]) clusters[ci].indices = std::vector<unsigned int>();
+
+            for (size_t k = 0; k < r.split.size(); ++k) {
+                clod::Cluster& cluster = r.split[k];
+                cluster.refined = refined;
+                cluster.bounds = r.bounds;
+                clusters.push_back(std::move(cluster));
+                cones.push_back(r.splitCones[k]);
+                pending.push_back(static_cast<int>(clusters.size()) - 1);
+            }
+        }
+        ++depth;
+    }
+
+    if (!pending.empty()) {
+        clodBounds bounds = clusters[pending[0]].bounds;
+        bounds.error = FLT_MAX;   // terminal group
+        emitGroup(md, groupSimplified, config, clusters, cones, pending, bounds, depth);
+    }
+}
+
+// Octahedral unit-vector mapping onto [-1, 1]^2.
+glm::vec2 octEncode(const glm::vec3& n) {
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 == 0.0f) return glm::vec2(0.0f);
+    glm::vec2 e(n.x / l1, n.y / l1);
+    if (n.z < 0.0f) {
+        e = glm::vec2((1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return e;
+}
+
+glm::vec3 octDecode(const glm::vec2& e) {
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    const float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+Uint64 toUnorm(float v, int bits) {
+    const float maxQ = float((1u << bits) - 1);
+    return static_cast<Uint64>(std::lround((std::clamp(v, -1.0f, 1.0f) * 0.5f + 0.5f) * maxQ));
+}
+
+float fromUnorm(Uint64 q, int bits) {
+    const float maxQ = float((1u << bits) - 1);
+    return float(q) / maxQ * 2.0f - 1.0f;
+}
+
+// PackedMeshletVertex::frame bit layout.
+constexpr int kNormalBits = 12;
+constexpr int kTangentBits = 11;
+constexpr int kTangentShift = 2 * kNormalBits;
+constexpr int kSignShift = kTangentShift + 2 * kTangentBits;
+
+// Smallest e with 2^e >= x, for x > 0.
+int ceilExponent(double x) {
+    int e = 0;
+    return std::frexp(x, &e) == 0.5 ? e - 1 : e;
+}
+
+// Home meshlet of each vertex: the first meshlet that references it, whose
+// grid the packed vertex is stored on. UINT32_MAX = referenced by none.
+std::vector<Uint32> homeMeshlets(const MeshletData& md, size_t vertexCount) {
+    std::vector<Uint32> home(vertexCount, UINT32_MAX);
+    for (size_t i = 0; i < md.meshlets.size(); ++i) {
+        const Meshlet& m = md.meshlets[i];
+        for (Uint32 k = 0; k < m.vertexCount; ++k) {
+            const Uint32 v = md.meshletVertices[m.vertexOffset + k];
+            if (v < vertexCount && home[v] == UINT32_MAX) home[v] = static_cast<Uint32>(i);
+        }
+    }
+    return home;
+}
+
+}// namespace
+
+PackedMeshletVertex MeshletBuilder::encodeVertex(const VertexData& vertex, const MeshletQuantization& grid) {
+    PackedMeshletVertex p;
+    for (int i = 0; i < 3; ++i) {
+        const double q = std::round(std::ldexp(double(vertex.position[i]), -grid.stepExponent)) - grid.origin[i];
+        p.position[i] = static_cast<Uint16>(std::clamp(q, 0.0, 65535.0));
+    }
+    p.uv[0] = glm::packHalf1x16(vertex.uv.x);
+    p.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+    const glm::vec2 n = octEncode(vertex.normal);
+    const glm::vec2 t = octEncode(glm::vec3(vertex.tangent));
+    const Uint64 frame = toUnorm(n.x, kNormalBits) | toUnorm(n.y, kNormalBits) << kNormalBits |
+                         toUnorm(t.x, kTangentBits) << kTangentShift |
+                         toUnorm(t.y, kTangentBits) << (kTangentShift + kTangentBits) |
+                         Uint64(vertex.tangent.w < 0.0f ? 1 : 0) << kSignShift;
+    p.frame[0] = static_cast<Uint16>(frame);
+    p.frame[1] = static_cast<Uint16>(frame >> 16);
+    p.frame[2] = static_cast<Uint16>(frame >> 32);
+    return p;
+}
+
+VertexData MeshletBuilder::decodeVertex(const PackedMeshletVertex& packed, const MeshletQuantization& grid) {
+    VertexData v{};
+    for (int i = 0; i < 3; ++i)
+        v.position[i] = static_cast<float>(std::ldexp(double(grid.origin[i]) + packed.position[i], grid.stepExponent));
+    v.uv = glm::vec2(glm::unpackHalf1x16(packed.uv[0]), glm::unpackHalf1x16(packed.uv[1]));
+
+    const Uint64 frame = Uint64(packed.frame[0]) | Uint64(packed.frame[1]) << 16 | Uint64(packed.frame[2]) << 32;
+    auto field = [&](int shift, int bits) { return (frame >> shift) & ((Uint64(1) << bits) - 1); };
+    v.normal = octDecode(glm::vec2(fromUnorm(field(0, kNormalBits), kNormalBits),
+                                   fromUnorm(field(kNormalBits, kNormalBits), kNormalBits)));
+    const glm::vec3 t = octDecode(glm::vec2(fromUnorm(field(kTangentShift, kTangentBits), kTangentBits),
+                                            fromUnorm(field(kTangentShift + kTangentBits, kTangentBits), kTangentBits)));
+    v.tangent = glm::vec4(t, field(kSignShift, 1) ? -1.0f : 1.0f);
+    return v;
+}
+
+void MeshletBuilder::compress(Mesh& mesh) {
+    MeshletData& md = mesh.meshletData;
+    md.clearPacked();
+    if (!md.isBuilt()) return;
+    const std::vector<Uint32> home = homeMeshlets(md, mesh.vertices.size());
+    if (std::find(home.begin(), home.end(), UINT32_MAX) != home.end()) return;// a vertex no meshlet can carry
+
+    // Grids never go finer than float resolution over the mesh (2^-23 of its
+    // largest coordinate), so every grid point is an exact float and the
+    // origins fit 32 bits.
+    float maxAbs = 0.0f;
+    for (const VertexData& v : mesh.vertices)
+        for (int i = 0; i < 3; ++i) maxAbs = std::max(maxAbs, std::abs(v.position[i]));
+    const double minStep = maxAbs > 0.0f ? std::ldexp(double(maxAbs), -23) : 1.0;
+
+    // Each meshlet starts on the finest step that spans its cull box in 15
+    // bits, leaving the other half of the u16 range for vertices snapped to a
+    // coarser meshlet's grid. A vertex lives on the coarsest grid among the
+    // meshlets that reference it; a meshlet those snaps push past 16 bits
+    // coarsens and the pass repeats. The coarsest meshlet never moves, so
+    // this settles.
+    const size_t meshletCount = md.meshlets.size();
+    std::vector<int> exponents(meshletCount);
+    for (size_t i = 0; i < meshletCount; ++i)
+        exponents[i] = ceilExponent(std::max(2.0 * md.bounds[i].cullSphere.w / 32767.0, minStep));
+    std::vector<int> vertexExponents(mesh.vertices.size());
+    auto snapped = [&](Uint32 v, int axis, int exponent) {
+        const int e = vertexExponents[v];
+        return std::ldexp(std::round(std::ldexp(double(mesh.vertices[v].position[axis]), -e)), e - exponent);
+    };
+    md.quantization.resize(meshletCount);
+    for (bool grew = true; grew;) {
+        grew = false;
+        std::fill(vertexExponents.begin(), vertexExponents.end(), INT_MIN);
+        for (size_t i = 0; i < meshletCount; ++i) {
+            const Meshlet& m = md.meshlets[i];
+            for (Uint32 k = 0; k < m.vertexCount; ++k) {
+                int& e = vertexExponents[md.meshletVertices[m.vertexOffset + k]];
+                e = std::max(e, exponents[i]);
+            }
+        }
+        for (size_t i = 0; i < meshletCount; ++i) {
+            const Meshlet& m = md.meshlets[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                double lo = DBL_MAX, hi = -DBL_MAX;
+                for (Uint32 k = 0; k < m.vertexCount; ++k) {
+                    const double q = snapped(md.meshletVertices[m.vertexOffset + k], axis, exponents[i]);
+                    lo = std::min(lo, q);
+                    hi = std::max(hi, q);
+                }
+                if (hi - lo > 65535.0) {
+                    ++exponents[i];
+                    grew = true;
+                    break;
+                }
+                md.quantization[i].origin[axis] = m.vertexCount > 0 ? static_cast<Sint32>(lo) : 0;
+            }
+            md.quantization[i].stepExponent = exponents[i];
+        }
+    }
+
+    // Store each vertex on its home meshlet's grid. Every other meshlet
+    // referencing it holds the same grid point, so this decode is the one
+    // all of them would produce.
+    md.packedVertices.resize(mesh.vertices.size());
+    for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+        VertexData vertex = mesh.vertices[v];
+        for (int axis = 0; axis < 3; ++axis)
+            vertex.position[axis] = static_cast<float>(snapped(static_cast<Uint32>(v), axis, 0));
+        const MeshletQuantization& grid = md.quantization[home[v]];
+        md.packedVertices[v] = encodeVertex(vertex, grid);
+        mesh.vertices[v] = decodeVertex(md.packedVertices[v], grid);
+    }
+}
+
+void MeshletBuilder::decompress(Mesh& mesh) {
+    MeshletData& md = mesh.meshletData;
+    if (!md.isCompressed()) return;
+
+    const std::vector<Uint32> home = homeMeshlets(md, md.packedVertices.size());
+    mesh.vertices.assign(md.packedVertices.size(), VertexData{});
+    for (size_t v = 0; v < mesh.vertices.size(); ++v)
+        if (home[v] < md.quantization.size()) mesh.vertices[v] = decodeVertex(md.packedVertices[v], md.quantization[home[v]]);
+    md.clearPacked();
+}
+
+void MeshletBuilder::Report::accumulate(const Report& other) {
+    if (levels.size() < other.levels.size()) levels.resize(other.levels.size());
+    for (size_t i = 0; i < other.levels.size(); ++i) {
+        levels[i].clusters += other.levels[i].clusters;
+        levels[i].triangles += other.levels[i].triangles;
+        levels[i].maxLodError = std::max(levels[i].maxLodError, other.levels[i].maxLodError);
+    }
+    milliseconds += other.milliseconds;
+}
+
+void MeshletBuilder::build(Mesh& mesh, TaskScheduler* scheduler, Report* report) {
+    const auto start = std::chrono::steady_clock::now();
     mesh.meshletData.clear();
+    if (report) *report = Report{};
     if (mesh.indices.empty() || mesh.vertices.empty()) return;
     // clusterlod needs triangle lists.
     if (mesh.primitiveMode != PrimitiveMode::TRIANGLES) return;
@@ -29,8 +433,14 @@ void MeshletBuilder::build(Mesh& mesh) {
     // interleaved position stream.
     cm.vertex_positions = &mesh.vertices[0].position.x;
     cm.vertex_positions_stride = sizeof(VertexData);
-    // No attribute-aware simplification for now (positions only); attribute
-    // weights + protect mask are a later refinement for UV/normal seams.
+    // Attribute-aware simplification over uv + normal, so shading and texture
+    // seams survive the coarser levels. The default config simplifies
+    // permissively, which needs the protect mask to keep UV seams from tearing.
+    cm.vertex_attributes = &mesh.vertices[0].uv.x;
+    cm.vertex_attributes_stride = sizeof(VertexData);
+    cm.attribute_weights = kAttributeWeights;
+    cm.attribute_count = sizeof(kAttributeWeights) / sizeof(kAttributeWeights[0]);
+    cm.attribute_protect_mask = kUvProtectMask;
 
     clodConfig config = clodDefaultConfig(MAX_MESHLET_TRIANGLES);
     config.max_vertices = MAX_MESHLET_VERTICES;
@@ -47,58 +457,7 @@ void MeshletBuilder::build(Mesh& mesh) {
 
     MeshletData& md = mesh.meshletData;
     std::vector<clodBounds> groupSimplified;  // indexed by clod group id
-
-    auto onGroup = [&](clodGroup group, const clodCluster* clusters, size_t count) -> int {
-        const int groupId = static_cast<int>(groupSimplified.size());
-        groupSimplified.push_back(group.simplified);
-        md.lodLevelCount = std::max<Uint32>(md.lodLevelCount, static_cast<Uint32>(group.depth) + 1);
-
-        for (size_t i = 0; i < count; ++i) {
-            const clodCluster& c = clusters[i];
-
-            // Meshlet-local indexing: meshletVertices[triangles[k]] == indices[k].
-            std::vector<unsigned int> lv(c.index_count);
-            std::vector<unsigned char> lt(c.index_count);
-            const size_t uniq = clodLocalIndices(lv.data(), lt.data(), c.indices, c.index_count);
-
-            Meshlet ml;
-            ml.vertexOffset   = static_cast<Uint32>(md.meshletVertices.size());
-            ml.triangleOffset = static_cast<Uint32>(md.meshletTriangles.size());
-            ml.vertexCount    = static_cast<Uint32>(uniq);
-            ml.triangleCount  = static_cast<Uint32>(c.index_count / 3);
-            md.meshletVertices.insert(md.meshletVertices.end(), lv.begin(), lv.begin() + uniq);
-            md.meshletTriangles.insert(md.meshletTriangles.end(), lt.begin(), lt.end());
-
-            MeshletBounds b;
-            b.cullSphere = glm::vec4(c.bounds.center[0], c.bounds.center[1], c.bounds.center[2], c.bounds.radius);
-
-            // Backface cone from the cluster geometry.
-            meshopt_Bounds mb = meshopt_computeClusterBounds(
-                c.indices, c.index_count, cm.vertex_positions, cm.vertex_count, cm.vertex_positions_stride);
-            b.coneApex       = glm::vec4(mb.cone_apex[0], mb.cone_apex[1], mb.cone_apex[2], 0.0f);
-            b.coneAxisCutoff = glm::vec4(mb.cone_axis[0], mb.cone_axis[1], mb.cone_axis[2], mb.cone_cutoff);
-
-            // Two-sphere LOD cut. parent = this group's simplified step (coarser).
-            b.parentSphere = glm::vec4(group.simplified.center[0], group.simplified.center[1],
-                                       group.simplified.center[2], group.simplified.radius);
-            b.parentError  = group.simplified.error;
-            b.group   = groupId;
-            b.refined = c.refined;
-            b.depth   = group.depth;
-            // lod sphere/error come from the finer group (filled in a second pass);
-            // original geometry (refined < 0) is exact.
-            if (c.refined < 0) {
-                b.lodSphere = b.cullSphere;
-                b.lodError  = 0.0f;
-            }
-
-            md.bounds.push_back(b);
-            md.meshlets.push_back(ml);
-        }
-        return groupId;
-    };
-
-    clodBuild(config, cm, onGroup);
+    bakeClusterDag(config, cm, scheduler, md, groupSimplified);
 
     // Second pass: the finer group referenced by `refined` is known now.
     for (MeshletBounds& b : md.bounds) {
@@ -108,4 +467,38 @@ void MeshletBuilder::build(Mesh& mesh) {
             b.lodError  = s.error;
         }
     }
+
+    if (report) {
+        report->levels.resize(md.lodLevelCount);
+        for (size_t i = 0; i < md.meshlets.size(); ++i) {
+            Report::Level& level = report->levels[md.bounds[i].depth];
+            level.clusters += 1;
+            level.triangles += md.meshlets[i].triangleCount;
+            level.maxLodError = std::max(level.maxLodError, md.bounds[i].lodError);
+        }
+        report->milliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void MeshletBuilder::buildAll(const std::vector<std::shared_ptr<Mesh>>& meshes, TaskScheduler* scheduler) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Report> reports(meshes.size());
+    TaskScheduler::forRange(scheduler, meshes.size(), 1, [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i)
+            if (meshes[i]) build(*meshes[i], scheduler, &reports[i]);
+    });
+
+    Report total;
+    for (const Report& r : reports) total.accumulate(r);
+    if (total.levels.empty()) return;
+
+    const double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("meshlet bake: {} meshes, {} levels, {:.1f} ms ({:.1f} ms summed)\n",
+               meshes.size(), total.levels.size(), wall, total.milliseconds);
+    for (size_t i = 0; i < total.levels.size(); ++i) {
+        const Report::Level& level = total.levels[i];
+        fmt::print("  L{}: {} clusters, {} tris, max lod error {:.4g}\n",
+                   i, level.clusters, level.triangles, level.maxLodError);
+    }
 }
@@ -0,0 +1,177 @@
+#include "meshlet_cull.hpp"
+#include "camera.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+
+namespace Vapor {
+
+namespace {
+
+constexpr Uint32 L = MeshletCullBounds::LANES;
+
+// The lane math below follows the shader's expression order (glm's mat * vec
+// and normalize/distance) so borderline clusters land on the same side.
+struct Affine {
+    float m[4][3];  // columns 0..3, rows xyz
+
+    explicit Affine(const glm::mat4& model) {
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 3; ++r) m[c][r] = model[c][r];
+    }
+    float point(int r, float x, float y, float z) const {
+        return (m[0][r] * x + m[1][r] * y) + (m[2][r] * z + m[3][r]);
+    }
+    float vector(int r, float x, float y, float z) const {
+        return m[0][r] * x + m[1][r] * y + m[2][r] * z;
+    }
+};
+
+// projectError() of the task shader, for one lane.
+inline float projectError(const Affine& a, const MeshletCullView& view, float maxScale, float projHalf,
+                          float x, float y, float z, float radius, float error) {
+    const float dx = a.point(0, x, y, z) - view.position.x;
+    const float dy = a.point(1, x, y, z) - view.position.y;
+    const float dz = a.point(2, x, y, z) - view.position.z;
+    const float dist = std::sqrt(dx * dx + dy * dy + dz * dz) - radius * maxScale;
+    return error * maxScale / std::max(dist, view.nearPlane) * projHalf;
+}
+
+template<typename T>
+void padTo(std::vector<T>& v, size_t n, T value) {
+    v.resize(n, value);
+}
+
+} // namespace
+
+MeshletCullView MeshletCullView::fromCamera(Camera& camera, float errorThreshold) {
+    MeshletCullView view;
+    view.frustumPlanes = camera.getFrustumPlanes();
+    view.position = camera.getEye();
+    view.nearPlane = camera.near();
+    view.projScale = camera.getProjMatrix()[1][1];
+    view.errorThreshold = errorThreshold;
+    return view;
+}
+
+void MeshletCullBounds::build(const std::vector<MeshletBounds>& bounds) {
+    count = static_cast<Uint32>(bounds.size());
+    const size_t padded = (bounds.size() + L - 1) / L * L;
+
+    for (auto* v : { &cullX, &cullY, &cullZ, &cullR, &apexX, &apexY, &apexZ, &axisX, &axisY, &axisZ, &cutoff,
+                     &lodX, &lodY, &lodZ, &lodR, &lodError, &parentX, &parentY, &parentZ, &parentR, &parentError }) {
+        v->clear();
+        v->reserve(padded);
+    }
+    original.clear();
+    original.reserve(padded);
+
+    for (const MeshletBounds& b : bounds) {
+        cullX.push_back(b.cullSphere.x); cullY.push_back(b.cullSphere.y);
+        cullZ.push_back(b.cullSphere.z); cullR.push_back(b.cullSphere.w);
+        apexX.push_back(b.coneApex.x); apexY.push_back(b.coneApex.y); apexZ.push_back(b.coneApex.z);
+        axisX.push_back(b.coneAxisCutoff.x); axisY.push_back(b.coneAxisCutoff.y);
+        axisZ.push_back(b.coneAxisCutoff.z); cutoff.push_back(b.coneAxisCutoff.w);
+        lodX.push_back(b.lodSphere.x); lodY.push_back(b.lodSphere.y);
+        lodZ.push_back(b.lodSphere.z); lodR.push_back(b.lodSphere.w);
+        lodError.push_back(b.lodError);
+        parentX.push_back(b.parentSphere.x); parentY.push_back(b.parentSphere.y);
+        parentZ.push_back(b.parentSphere.z); parentR.push_back(b.parentSphere.w);
+        parentError.push_back(b.parentError);
+        original.push_back(b.refined < 0 ? 1 : 0);
+    }
+
+    // Padding lanes are never emitted; keep them finite and cone-less.
+    for (auto* v : { &cullX, &cullY, &cullZ, &cullR, &apexX, &apexY, &apexZ, &axisX, &axisY, &axisZ,
+                     &lodX, &lodY, &lodZ, &lodR, &lodError, &parentX, &parentY, &parentZ, &parentR, &parentError })
+        padTo(*v, padded, 0.0f);
+    padTo(cutoff, padded, 1.0f);
+    padTo(original, padded, Uint8(1));
+}
+
+Uint32 cullMeshlets(const MeshletCullBounds& bounds, const glm::mat4& model, const MeshletCullView& view,
+                    std::vector<Uint32>& out, Uint32 meshletOffset, MeshletCullStats* stats) {
+    const size_t first = out.size();
+    if (stats) stats->tested += bounds.count;
+
+    // Debug bypass: a negative threshold emits everything (mirror of the shaders).
+    if (view.errorThreshold < 0.0f) {
+        for (Uint32 i = 0; i < bounds.count; ++i) out.push_back(meshletOffset + i);
+        if (stats) stats->selected += bounds.count;
+        return bounds.count;
+    }
+
+    const Affine a(model);
+    const float maxScale = std::max(glm::length(glm::vec3(model[0])),
+                                    std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    const float projHalf = view.projScale * 0.5f;
+    const float threshold = view.errorThreshold;
+
+    Uint32 frustumCulled = 0, coneCulled = 0, lodRejected = 0;
+    for (Uint32 base = 0; base < bounds.count; base += L) {
+        Uint8 inFrustum[L], facing[L], onCut[L];
+
+        for (Uint32 l = 0; l < L; ++l) {
+            const Uint32 i = base + l;
+
+            // Frustum: world-space sphere vs the camera planes.
+            const float wx = a.point(0, bounds.cullX[i], bounds.cullY[i], bounds.cullZ[i]);
+            const float wy = a.point(1, bounds.cullX[i], bounds.cullY[i], bounds.cullZ[i]);
+            const float wz = a.point(2, bounds.cullX[i], bounds.cullY[i], bounds.cullZ[i]);
+            const float wr = bounds.cullR[i] * maxScale;
+            bool visible = true;
+            for (const glm::vec4& p : view.frustumPlanes)
+                visible &= !(p.x * wx + p.y * wy + p.z * wz + p.w < -wr);
+            inFrustum[l] = visible;
+
+            // Backface cone (meshopt): culled when the whole cluster faces away.
+            const float ax = a.point(0, bounds.apexX[i], bounds.apexY[i], bounds.apexZ[i]) - view.position.x;
+            const float ay = a.point(1, bounds.apexX[i], bounds.apexY[i], bounds.apexZ[i]) - view.position.y;
+            const float az = a.point(2, bounds.apexX[i], bounds.apexY[i], bounds.apexZ[i]) - view.position.z;
+            const float nx = a.vector(0, bounds.axisX[i], bounds.axisY[i], bounds.axisZ[i]);
+            const float ny = a.vector(1, bounds.axisX[i], bounds.axisY[i], bounds.axisZ[i]);
+            const float nz = a.vector(2, bounds.axisX[i], bounds.axisY[i], bounds.axisZ[i]);
+            const float invA = 1.0f / std::sqrt(ax * ax + ay * ay + az * az);
+            const float invN = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+            const float cosView = (ax * invA) * (nx * invN) + (ay * invA) * (ny * invN) + (az * invA) * (nz * invN);
+            facing[l] = !(bounds.cutoff[i] < 1.0f && cosView >= bounds.cutoff[i]);
+
+            // Two-sphere LOD cut: parent too coarse AND this cluster fine enough.
+            const float parent = projectError(a, view, maxScale, projHalf, bounds.parentX[i], bounds.parentY[i],
+                                              bounds.parentZ[i], bounds.parentR[i], bounds.parentError[i]);
+            const float self = projectError(a, view, maxScale, projHalf, bounds.lodX[i], bounds.lodY[i],
+                                            bounds.lodZ[i], bounds.lodR[i], bounds.lodError[i]);
+            onCut[l] = (parent > threshold) & (bounds.original[i] | (self <= threshold));
+        }
+
+        const Uint32 lanes = std::min(L, bounds.count - base);
+        for (Uint32 l = 0; l < lanes; ++l) {
+            if (!inFrustum[l]) { ++frustumCulled; continue; }
+            if (!facing[l]) { ++coneCulled; continue; }
+            if (!onCut[l]) { ++lodRejected; continue; }
+            out.push_back(meshletOffset + base + l);
+        }
+    }
+
+    const Uint32 selected = static_cast<Uint32>(out.size() - first);
+    if (stats) {
+        stats->frustumCulled += frustumCulled;
+        stats->coneCulled += coneCulled;
+        stats->lodRejected += lodRejected;
+        stats->selected += selected;
+    }
+    return selected;
+}
+
+void appendMeshletTriangles(const MeshletData& data, const Uint32* meshlets, size_t count,
+                            std::vector<Uint32>& indices) {
+    for (size_t i = 0; i < count; ++i) {
+        const Meshlet& m = data.meshlets[meshlets[i]];
+        const Uint32* verts = &data.meshletVertices[m.vertexOffset];
+        const Uint8* tris = &data.meshletTriangles[m.triangleOffset];
+        for (Uint32 k = 0; k < m.triangleCount * 3; ++k) indices.push_back(verts[tris[k]]);
+    }
+}
+
+} // namespace Vapor
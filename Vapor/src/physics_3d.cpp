@@ -1,6 +1,7 @@
 #include "physics_3d.hpp"
 #include "Vapor/components.hpp"
 #include "character_controller.hpp"
+#include "collision_shape_cache.hpp"
 #include "fluid_volume.hpp"
 #include "jolt_enki_job_system.hpp"
 #include "physics_debug_renderer.hpp"
@@ -15,11 +16,15 @@
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyFilter.h>
 #include <Jolt/Physics/Body/BodyLockInterface.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuery.h>
 #include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Character/CharacterVirtual.h>
 #include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
 #include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
 #include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
@@ -30,12 +35,15 @@
 #include <Jolt/Physics/EActivation.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/StateRecorder.h>
 #include <Jolt/RegisterTypes.h>
 #include <SDL3/SDL_stdinc.h>
 #include <fmt/core.h>
 #include <algorithm>
+#include <cstring>
 #include <thread>
 #include <mutex>
+#include <optional>
 
 using namespace Vapor;
 
@@ -161,7 +169,7 @@ public:
 
 class MyContactListener : public JPH::ContactListener {
 public:
-    // Store raw Jolt BodyIDs; Physics3D::process() converts to BodyHandles via bodyIDToRid
+    // Store raw Jolt BodyIDs; Physics3D::process() converts them via getBodyHandle
     struct RawCollisionEvent {
         JPH::BodyID id1;
         JPH::BodyID id2;
@@ -217,6 +225,111 @@ public:
 
     virtual void OnBodyDeactivated(const JPH::BodyID& inBodyID, Uint64 inBodyUserData) override {
         // fmt::print("A body went to sleep\n");
+        // Remembered so the batched sync still writes the pose a body fell asleep at.
+        queue(inBodyID);
+    }
+
+    explicit MyBodyActivationListener(Uint32 maxBodies) : queued(maxBodies, UINT32_MAX) {}
+
+    // Bodies whose pose must reach the scene although they may not be on the
+    // active list: fell asleep, created, teleported. One entry per body index,
+    // so the queue stays bounded however long nobody syncs.
+    void queue(const JPH::BodyID& id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Uint32& entry = queued[id.GetIndex()];
+        if (entry == UINT32_MAX) queuedIndices.push_back(id.GetIndex());
+        entry = id.GetIndexAndSequenceNumber();
+    }
+
+    // Moves everything queued since the last call into `out` (as BodyIDs).
+    void take(std::vector<Uint32>& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        out.clear();
+        for (Uint32 index : queuedIndices) {
+            out.push_back(queued[index]);
+            queued[index] = UINT32_MAX;
+        }
+        queuedIndices.clear();
+    }
+
+private:
+    std::mutex mutex; // callbacks may come from job threads
+    std::vector<Uint32> queued; // per body index: BodyID, UINT32_MAX = none
+    std::vector<Uint32> queuedIndices;
+};
+
+// Unit query shapes; batched queries scale them instead of building a shape per call.
+struct SceneQueryShapes {
+    JPH::Ref<JPH::SphereShape> sphere = new JPH::SphereShape(1.0f);
+    JPH::Ref<JPH::BoxShape> box = new JPH::BoxShape(JPH::Vec3::sReplicate(1.0f), 0.0f);
+};
+
+// Character-vs-character collision for parallel updates. Each step the
+// characters are split into groups whose reach (shape + padding + motion)
+// can't overlap another group's, so a character only ever tests the members
+// of its own group. Groups update on different workers; members of a group
+// update serially, so no character is read while another thread moves it.
+// A character's CharacterVirtual user data is its index for the step.
+struct CharacterCrowd : public JPH::CharacterVsCharacterCollision {
+    std::vector<const JPH::CharacterVirtual*> characters;
+    std::vector<Uint32> groupOf;    // character index -> group
+    std::vector<Uint32> groupStart; // group -> first entry in members (+ end sentinel)
+    std::vector<Uint32> members;    // character indices, grouped
+
+    std::span<const Uint32> groupMembers(const JPH::CharacterVirtual* character) const {
+        const Uint64 index = character->GetUserData();
+        if (index >= groupOf.size() || characters[index] != character) return {};
+        const Uint32 group = groupOf[index];
+        return { members.data() + groupStart[group], groupStart[group + 1] - groupStart[group] };
+    }
+
+    // Same as JPH::CharacterVsCharacterCollisionSimple, restricted to the group.
+    void CollideCharacter(
+        const JPH::CharacterVirtual* inCharacter,
+        JPH::RMat44Arg inCenterOfMassTransform,
+        const JPH::CollideShapeSettings& inCollideShapeSettings,
+        JPH::RVec3Arg inBaseOffset,
+        JPH::CollideShapeCollector& ioCollector
+    ) const override {
+        JPH::Mat44 transform1 = inCenterOfMassTransform.PostTranslated(-inBaseOffset).ToMat44();
+        JPH::CollideShapeSettings settings = inCollideShapeSettings;
+        for (Uint32 index : groupMembers(inCharacter)) {
+            const JPH::CharacterVirtual* c = characters[index];
+            if (c == inCharacter) continue;
+            if (ioCollector.ShouldEarlyOut()) break;
+            ioCollector.SetUserData(reinterpret_cast<JPH::uint64>(c));
+            JPH::Mat44 transform2 = c->GetCenterOfMassTransform().PostTranslated(-inBaseOffset).ToMat44();
+            settings.mMaxSeparationDistance = inCollideShapeSettings.mMaxSeparationDistance + c->GetCharacterPadding();
+            JPH::CollisionDispatch::sCollideShapeVsShape(
+                inCharacter->GetShape(), c->GetShape(), JPH::Vec3::sOne(), JPH::Vec3::sOne(), transform1, transform2,
+                JPH::SubShapeIDCreator(), JPH::SubShapeIDCreator(), settings, ioCollector
+            );
+        }
+        ioCollector.SetUserData(0);
+    }
+
+    void CastCharacter(
+        const JPH::CharacterVirtual* inCharacter,
+        JPH::RMat44Arg inCenterOfMassTransform,
+        JPH::Vec3Arg inDirection,
+        const JPH::ShapeCastSettings& inShapeCastSettings,
+        JPH::RVec3Arg inBaseOffset,
+        JPH::CastShapeCollector& ioCollector
+    ) const override {
+        JPH::Mat44 transform1 = inCenterOfMassTransform.PostTranslated(-inBaseOffset).ToMat44();
+        JPH::ShapeCast shapeCast(inCharacter->GetShape(), JPH::Vec3::sOne(), transform1, inDirection);
+        for (Uint32 index : groupMembers(inCharacter)) {
+            const JPH::CharacterVirtual* c = characters[index];
+            if (c == inCharacter) continue;
+            if (ioCollector.ShouldEarlyOut()) break;
+            ioCollector.SetUserData(reinterpret_cast<JPH::uint64>(c));
+            JPH::Mat44 transform2 = c->GetCenterOfMassTransform().PostTranslated(-inBaseOffset).ToMat44();
+            JPH::CollisionDispatch::sCastShapeVsShapeWorldSpace(
+                shapeCast, inShapeCastSettings, c->GetShape(), JPH::Vec3::sOne(), {}, transform2,
+                JPH::SubShapeIDCreator(), JPH::SubShapeIDCreator(), ioCollector
+            );
+        }
+        ioCollector.SetUserData(0);
     }
 };
 
@@ -253,7 +366,14 @@ void Physics3D::init(Vapor::TaskScheduler& taskScheduler, std::shared_ptr<Vapor:
     }
     sPhysicsInstances++;
 
+    this->taskScheduler = &taskScheduler;
     tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(10 * 1024 * 1024);
+    // TempAllocatorImpl is single-threaded: one per worker for character updates.
+    characterAllocators.clear();
+    for (Uint32 i = 0; i < taskScheduler.getNumThreads(); ++i) {
+        characterAllocators.push_back(std::make_unique<JPH::TempAllocatorImpl>(2 * 1024 * 1024));
+    }
+    characterCrowd = std::make_unique<CharacterCrowd>();
 
     jobSystem = std::make_unique<JPH::JobSystemThreadPool>(
         JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1
@@ -276,14 +396,18 @@ void Physics3D::init(Vapor::TaskScheduler& taskScheduler, std::shared_ptr<Vapor:
         *objectVsBroadphaseLayerFilter.get(),
         *objectVsObjectLayerFilter.get()
     );
+    previousPoses.assign(cMaxBodies, BodyPose{});
+    syncEntities.assign(cMaxBodies, entt::null);
+    syncRegistry = nullptr;
 
-    bodyActivationListener = std::make_unique<MyBodyActivationListener>();
+    bodyActivationListener = std::make_unique<MyBodyActivationListener>(cMaxBodies);
     physicsSystem->SetBodyActivationListener(bodyActivationListener.get());
 
     contactListener = std::make_unique<MyContactListener>();
     physicsSystem->SetContactListener(contactListener.get());
 
     bodyInterface = &physicsSystem->GetBodyInterface();
+    queryShapes = std::make_unique<SceneQueryShapes>();
 
     physicsSystem->SetGravity(JPH::Vec3(0.0f, -9.81f, 0.0f));
 
@@ -291,6 +415,7 @@ void Physics3D::init(Vapor::TaskScheduler& taskScheduler, std::shared_ptr<Vapor:
         debugRenderer = std::make_unique<Vapor::PhysicsDebugRenderer>();
         debugRenderer->setPhysicsSystem(this);
         debugRenderer->setDebugDraw(debugDraw);
+        debugRenderer->setTaskScheduler(&taskScheduler);
         debugRenderer->setEnabled(debugDrawEnabled);
     }
 
@@ -305,12 +430,26 @@ void Physics3D::deinit() {
         return;
     }
 
-    for (auto& body : bodies) {
-        if (bodyInterface->IsAdded(body.second)) bodyInterface->RemoveBody(body.second);
-        bodyInterface->DestroyBody(body.second);
+    for (const auto& slot : bodySlots) {
+        if (slot.bodyID == JPH::BodyID::cInvalidBodyID) continue;
+        JPH::BodyID id(slot.bodyID);
+        if (bodyInterface->IsAdded(id)) bodyInterface->RemoveBody(id);
+        bodyInterface->DestroyBody(id);
     }
-    bodies.clear();
+    bodySlots.clear();
+    ridByBodyIndex.clear();
+    freeBodySlot = UINT32_MAX;
 
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex);
+        deferredQueries.clear();
+    }
+    queryShapes.reset();
+    previousPoses.clear();
+    syncEntities.clear();
+    syncRegistry = nullptr;
+    characterAllocators.clear();
+    characterCrowd.reset();
     tempAllocator.reset();
     jobSystem.reset();// Physics3D owns this
     physicsSystem.reset();
@@ -320,10 +459,15 @@ void Physics3D::deinit() {
     timeAccum = 0.0f;
     step = 0;
 
+    // Cached shapes must be released while Jolt is still up, not at static
+    // destruction; with other systems alive, only the unused ones go.
     sPhysicsInstances--;
+    if (sPhysicsInstances == 0) CollisionShapeCache::instance().clear();
+    else CollisionShapeCache::instance().trim();
 
     characterControllers.clear();
     vehicleControllers.clear();
+    fluidVolumes.clear();
 
     isInitialized = false;
 }
@@ -350,7 +494,162 @@ void Physics3D::unregisterVehicleController(VehicleController* ctrl) {
     );
 }
 
+void Physics3D::registerFluidVolume(std::shared_ptr<FluidVolume> volume) {
+    if (volume) fluidVolumes.push_back(std::move(volume));
+}
+
+void Physics3D::unregisterFluidVolume(const FluidVolume* volume) {
+    std::erase_if(fluidVolumes, [volume](const std::shared_ptr<FluidVolume>& v) { return v.get() == volume; });
+}
+
+void Physics3D::applyFluidBuoyancy(float dt) {
+    if (fluidVolumes.empty()) return;
+
+    // Only bodies the broadphase finds in a volume's bounds are touched,
+    // instead of testing every active body against every volume.
+    const JPH::BroadPhaseQuery& broadPhase = physicsSystem->GetBroadPhaseQuery();
+    JPH::SpecifiedBroadPhaseLayerFilter movingLayer(BroadPhaseLayers::moving);
+    JPH::SpecifiedObjectLayerFilter movingObjects(Layers::moving);
+    JPH::AllHitCollisionCollector<JPH::CollideShapeBodyCollector> collector;
+
+    fluidContacts.clear();
+    for (Uint32 v = 0; v < fluidVolumes.size(); ++v) {
+        glm::vec3 min, max;
+        fluidVolumes[v]->getWorldBounds(min, max);
+        collector.Reset();
+        broadPhase.CollideAABox(
+            JPH::AABox(JPH::Vec3(min.x, min.y, min.z), JPH::Vec3(max.x, max.y, max.z)), collector, movingLayer, movingObjects
+        );
+        for (const JPH::BodyID& id : collector.mHits) {
+            fluidContacts.push_back({ id.GetIndexAndSequenceNumber(), v });
+        }
+    }
+    if (fluidContacts.empty()) return;
+
+    // One group per body, so a body inside overlapping volumes is only ever
+    // written by one worker (and in volume order, which keeps it deterministic).
+    std::sort(fluidContacts.begin(), fluidContacts.end(), [](const FluidContact& a, const FluidContact& b) {
+        return a.body != b.body ? a.body < b.body : a.volume < b.volume;
+    });
+    fluidContactGroups.clear();
+    for (Uint32 i = 0; i < fluidContacts.size(); ++i) {
+        if (i == 0 || fluidContacts[i].body != fluidContacts[i - 1].body) fluidContactGroups.push_back(i);
+    }
+    fluidContactGroups.push_back(static_cast<Uint32>(fluidContacts.size()));
+
+    const JPH::BodyLockInterface& locks = physicsSystem->GetBodyLockInterfaceNoLock();
+    const glm::vec3 gravity = getGravity();
+    auto applyRange = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 g = begin; g < end; ++g) {
+            const Uint32 first = fluidContactGroups[g], last = fluidContactGroups[g + 1];
+            JPH::BodyLockWrite lock(locks, JPH::BodyID(fluidContacts[first].body));
+            if (!lock.Succeeded()) continue;
+            JPH::Body& body = lock.GetBody();
+            if (!body.IsActive()) continue; // sleeping bodies are at rest in the fluid
+            for (Uint32 c = first; c < last; ++c) {
+                fluidVolumes[fluidContacts[c].volume]->applyBuoyancy(body, gravity, dt);
+            }
+        }
+    };
+    constexpr Uint32 BUOYANCY_CHUNK = 64;
+    const Uint32 groupCount = static_cast<Uint32>(fluidContactGroups.size() - 1);
+    if (taskScheduler) taskScheduler->parallelFor(groupCount, BUOYANCY_CHUNK, applyRange);
+    else applyRange(0, groupCount, 0);
+}
+
+void Physics3D::updateCharacters(float dt) {
+    const Uint32 count = static_cast<Uint32>(characterControllers.size());
+    if (count == 0) return;
+    const glm::vec3 gravity = getGravity();
+    auto& crowd = *characterCrowd;
+
+    // Reach of each character this step, as an AABB.
+    std::vector<glm::vec3>& reachMin = characterReachMin;
+    std::vector<glm::vec3>& reachMax = characterReachMax;
+    reachMin.resize(count);
+    reachMax.resize(count);
+    crowd.characters.resize(count);
+    for (Uint32 i = 0; i < count; ++i) {
+        auto* ctrl = characterControllers[i];
+        ctrl->setCrowdIndex(i);
+        crowd.characters[i] = ctrl->getCharacter();
+        const glm::vec3 center = ctrl->getPosition();
+        const float radius = ctrl->getStepReach(dt, gravity);
+        reachMin[i] = center - radius;
+        reachMax[i] = center + radius;
+    }
+
+    // Union overlapping reaches (sweep and prune along x).
+    std::vector<Uint32>& parent = characterParent;
+    parent.resize(count);
+    for (Uint32 i = 0; i < count; ++i) parent[i] = i;
+    auto find = [&](Uint32 i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    std::vector<Uint32>& order = characterOrder;
+    order.resize(count);
+    for (Uint32 i = 0; i < count; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](Uint32 a, Uint32 b) { return reachMin[a].x < reachMin[b].x; });
+    for (Uint32 a = 0; a < count; ++a) {
+        const Uint32 i = order[a];
+        for (Uint32 b = a + 1; b < count && reachMin[order[b]].x <= reachMax[i].x; ++b) {
+            const Uint32 j = order[b];
+            if (reachMin[j].y > reachMax[i].y || reachMax[j].y < reachMin[i].y || reachMin[j].z > reachMax[i].z
+                || reachMax[j].z < reachMin[i].z) {
+                continue;
+            }
+            Uint32 rootA = find(i), rootB = find(j);
+            if (rootA != rootB) parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    // Compact roots into dense group ids; members keep controller order.
+    crowd.groupOf.assign(count, UINT32_MAX);
+    Uint32 groupCount = 0;
+    for (Uint32 i = 0; i < count; ++i) {
+        Uint32 root = find(i);
+        if (crowd.groupOf[root] == UINT32_MAX) crowd.groupOf[root] = groupCount++;
+        crowd.groupOf[i] = crowd.groupOf[root];
+    }
+    crowd.groupStart.assign(groupCount + 1, 0);
+    for (Uint32 i = 0; i < count; ++i) crowd.groupStart[crowd.groupOf[i] + 1]++;
+    for (Uint32 g = 0; g < groupCount; ++g) crowd.groupStart[g + 1] += crowd.groupStart[g];
+    crowd.members.resize(count);
+    std::vector<Uint32>& cursor = characterParent; // union-find done; reuse
+    cursor.assign(crowd.groupStart.begin(), crowd.groupStart.end() - 1);
+    for (Uint32 i = 0; i < count; ++i) crowd.members[cursor[crowd.groupOf[i]]++] = i;
+
+    constexpr Uint32 CHARACTER_CHUNK = 8; // groups per task
+    auto updateRange = [&](Uint32 begin, Uint32 end, Uint32 thread) {
+        JPH::TempAllocator& allocator = *characterAllocators[thread];
+        for (Uint32 g = begin; g < end; ++g) {
+            for (Uint32 m = crowd.groupStart[g]; m < crowd.groupStart[g + 1]; ++m) {
+                characterControllers[crowd.members[m]]->update(dt, gravity, allocator);
+            }
+        }
+    };
+    // Lockstep runs serially: characters of different groups can still push
+    // the same dynamic body, and impulse order must not depend on scheduling.
+    if (taskScheduler && !lockstep) taskScheduler->parallelFor(groupCount, CHARACTER_CHUNK, updateRange);
+    else updateRange(0, groupCount, 0);
+
+    // Outside this step the groups are stale (controllers may be destroyed):
+    // a lone update() then sees no other characters, as before.
+    crowd.groupOf.clear();
+}
+
+auto Physics3D::getCharacterCollision() -> JPH::CharacterVsCharacterCollision* {
+    return characterCrowd.get();
+}
+
 void Physics3D::attach(entt::registry& reg) {
+    // Removing a rigidbody (destroying its entity, or a registry.clear() such
+    // as a snapshot restore) destroys its Jolt body. The system is stashed in
+    // the registry context so the static callback can reach it.
+    reg.ctx().insert_or_assign<Physics3D*>(this);
+    reg.on_destroy<Vapor::RigidbodyComponent>().connect<&Physics3D::onRigidbodyDestroyed>();
+
     reg.on_destroy<Vapor::CharacterBodyComponent>().connect<[](entt::registry& r, entt::entity e) {
         auto& comp = r.get<Vapor::CharacterBodyComponent>(e);
         if (comp.controller) {
@@ -374,6 +673,13 @@ void Physics3D::attach(entt::registry& reg) {
     }>();
 }
 
+void Physics3D::onRigidbodyDestroyed(entt::registry& reg, entt::entity entity) {
+    auto* self = reg.ctx().find<Physics3D*>();
+    if (!self || !*self) return;
+    // Stale or already-destroyed handles resolve to no body and are ignored.
+    (*self)->destroyBody(reg.get<Vapor::RigidbodyComponent>(entity).body);
+}
+
 void Physics3D::process(entt::registry& reg, float dt) {
     if (!isInitialized) return;
 
@@ -429,7 +735,9 @@ void Physics3D::process(entt::registry& reg, float dt) {
         }
     }
 
-    // 4. Fixed-step physics
+    // 4. Fixed-step physics. Driver input only changes per frame; the vehicle
+    // constraints themselves step inside PhysicsSystem::Update (step listeners).
+    for (auto* ctrl : vehicleControllers) ctrl->update(FIXED_TIME_STEP);
     for (auto* ctrl : characterControllers) {
         ctrl->storePreviousPosition();
     }
@@ -437,12 +745,15 @@ void Physics3D::process(entt::registry& reg, float dt) {
     timeAccum += dt;
     constexpr int MAX_PHYSICS_STEPS_PER_FRAME = 4;
     int stepsThisFrame = 0;
+    if (lockstep) timeAccum = FIXED_TIME_STEP; // one step per call, whatever dt was
     while (timeAccum >= FIXED_TIME_STEP && stepsThisFrame < MAX_PHYSICS_STEPS_PER_FRAME) {
         ++step;
         ++stepsThisFrame;
-        for (auto* ctrl : vehicleControllers) ctrl->update(FIXED_TIME_STEP);
-        for (auto* ctrl : characterControllers) ctrl->update(FIXED_TIME_STEP, getGravity());
+        updateCharacters(FIXED_TIME_STEP);
+        applyFluidBuoyancy(FIXED_TIME_STEP);
+        capturePreviousPoses();
         physicsSystem->Update(FIXED_TIME_STEP, 1, tempAllocator.get(), jobSystem.get());
+        if (stepHashingEnabled) recordStepHash();
         timeAccum -= FIXED_TIME_STEP;
     }
     if (timeAccum > FIXED_TIME_STEP * MAX_PHYSICS_STEPS_PER_FRAME) {
@@ -452,6 +763,7 @@ void Physics3D::process(entt::registry& reg, float dt) {
     if (debugDrawEnabled && debugRenderer) {
         debugRenderer->update();
     }
+    resolveDeferredQueries();
 
     // 5. Drain collision/trigger events
     auto* listener = static_cast<MyContactListener*>(contactListener.get());
@@ -467,12 +779,7 @@ void Physics3D::process(entt::registry& reg, float dt) {
         pendingTriggerEvents.clear();
 
         for (auto& raw : rawEvents) {
-            Uint32 ridA = UINT32_MAX, ridB = UINT32_MAX;
-            auto itA = bodyIDToRid.find(raw.id1.GetIndexAndSequenceNumber());
-            auto itB = bodyIDToRid.find(raw.id2.GetIndexAndSequenceNumber());
-            if (itA != bodyIDToRid.end()) ridA = itA->second;
-            if (itB != bodyIDToRid.end()) ridB = itB->second;
-            BodyHandle ha{ ridA }, hb{ ridB };
+            BodyHandle ha = getBodyHandle(raw.id1), hb = getBodyHandle(raw.id2);
 
             if (raw.isTrigger) {
                 pendingTriggerEvents.push_back({ ha, hb, raw.isEnter });
@@ -489,7 +796,7 @@ void Physics3D::process(entt::registry& reg, float dt) {
             auto& comp = view.get<Vapor::CharacterBodyComponent>(entity);
             if (!comp.controller) continue;
             auto& t = view.get<Vapor::TransformComponent>(entity);
-            t.position = comp.controller->getPosition();
+            t.position = comp.controller->getInterpolatedPosition(std::min(getInterpolationAlpha(), 1.0f));
             t.isDirty  = true;
         }
     }
@@ -508,29 +815,174 @@ void Physics3D::process(entt::registry& reg, float dt) {
     }
 
     // 8. Sync dynamic RigidbodyComponent positions/rotations → TransformComponent
-    {
-        auto view = reg.view<Vapor::RigidbodyComponent, Vapor::TransformComponent>();
-        for (auto entity : view) {
-            auto& rb = view.get<Vapor::RigidbodyComponent>(entity);
-            if (!rb.syncFromPhysics) continue;
-            if (!rb.body.valid()) continue;
+    syncFromPhysics(reg);
+}
 
-            auto it = bodies.find(rb.body.rid);
-            if (it == bodies.end()) continue;
+void Physics3D::refreshSyncEntities(entt::registry& reg) {
+    auto& rigidbodies = reg.storage<Vapor::RigidbodyComponent>();
+    if (!syncEntitiesDirty && syncRegistry == &reg && syncRigidbodyCount == rigidbodies.size()) return;
 
-            JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), it->second);
-            if (!lock.Succeeded()) continue;
+    std::fill(syncEntities.begin(), syncEntities.end(), entt::entity{ entt::null });
+    for (auto [entity, rb] : rigidbodies.each()) {
+        const JPH::BodyID id = getBodyID(rb.body);
+        if (!id.IsInvalid() && id.GetIndex() < syncEntities.size()) syncEntities[id.GetIndex()] = entity;
+    }
+    syncRegistry = &reg;
+    syncRigidbodyCount = rigidbodies.size();
+    syncEntitiesDirty = false;
+}
 
-            const JPH::Body& body = lock.GetBody();
-            if (body.GetMotionType() != JPH::EMotionType::Dynamic) continue;
+void Physics3D::queueSync(const JPH::BodyID& bodyID) {
+    static_cast<MyBodyActivationListener*>(bodyActivationListener.get())->queue(bodyID);
+}
 
-            auto& t = view.get<Vapor::TransformComponent>(entity);
-            auto pos = body.GetPosition();
-            auto rot = body.GetRotation();
+void Physics3D::syncFromPhysics(entt::registry& reg) {
+    if (!isInitialized) return;
+    // Bodies that fell asleep, were created or were teleported since the last
+    // sync aren't necessarily on the active list, but their pose still has to
+    // reach the scene once.
+    static_cast<MyBodyActivationListener*>(bodyActivationListener.get())->take(syncPending);
+    const bool syncAll = syncAllNext;
+    syncAllNext = false;
+    const Uint32 activeCount = physicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+    if (!syncAll && activeCount == 0 && syncPending.empty()) return;
+
+    refreshSyncEntities(reg);
+    const JPH::BodyInterface& noLock = physicsSystem->GetBodyInterfaceNoLock();
+
+    // Work list: the sleeping extras first (snapped), then Jolt's active
+    // bodies (interpolated). Extras that are awake again are left to the
+    // active list, so no body (and no transform) appears twice.
+    syncBodies.clear();
+    if (syncAll) {
+        for (Uint32 index = 0; index < syncEntities.size(); ++index) {
+            if (syncEntities[index] == entt::null) continue;
+            const JPH::BodyID id = getBodyID(BodyHandle{ ridByBodyIndex[index] });
+            if (!id.IsInvalid()) syncBodies.push_back(id);
+        }
+    } else {
+        for (Uint32 raw : syncPending) {
+            const JPH::BodyID id(raw);
+            if (getBodyHandle(id).valid() && !noLock.IsActive(id)) syncBodies.push_back(id);
+        }
+    }
+    const Uint32 firstActive = static_cast<Uint32>(syncBodies.size());
+    if (!syncAll) {
+        const JPH::BodyID* active = physicsSystem->GetActiveBodiesUnsafe(JPH::EBodyType::RigidBody);
+        syncBodies.insert(syncBodies.end(), active, active + activeCount);
+    }
+
+    // Storage lookups are read-only, so workers can share them; each body
+    // maps to at most one entity, hence one TransformComponent per item.
+    auto& rigidbodies = reg.storage<Vapor::RigidbodyComponent>();
+    auto& transforms = reg.storage<Vapor::TransformComponent>();
+    auto syncChunk = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            const JPH::BodyID id = syncBodies[i];
+            const entt::entity entity = syncEntities[id.GetIndex()];
+            if (entity == entt::null || !rigidbodies.contains(entity) || !transforms.contains(entity)) continue;
+            const auto& rb = rigidbodies.get(entity);
+            if (!rb.syncFromPhysics || getBodyID(rb.body) != id) continue;
+            if (noLock.GetMotionType(id) != JPH::EMotionType::Dynamic) continue;
+
+            JPH::RVec3 pos;
+            JPH::Quat rot;
+            noLock.GetPositionAndRotation(id, pos, rot);
+            auto& t = transforms.get(entity);
             t.position = glm::vec3(pos.GetX(), pos.GetY(), pos.GetZ());
             t.rotation = glm::quat(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ());
+            // Sleeping bodies won't be synced again: leave them on their final pose.
+            if (i >= firstActive && rb.interpolate) interpolatePose(id, t.position, t.rotation);
             t.isDirty  = true;
         }
+    };
+    constexpr Uint32 SYNC_CHUNK = 512;
+    const Uint32 count = static_cast<Uint32>(syncBodies.size());
+    if (taskScheduler) taskScheduler->parallelFor(count, SYNC_CHUNK, syncChunk);
+    else syncChunk(0, count, 0);
+}
+
+void Physics3D::capturePreviousPoses() {
+    const Uint32 count = physicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+    if (count == 0) return;
+
+    // Each active body owns its slot, so the copy splits freely across workers.
+    const JPH::BodyID* active = physicsSystem->GetActiveBodiesUnsafe(JPH::EBodyType::RigidBody);
+    const JPH::BodyInterface& noLock = physicsSystem->GetBodyInterfaceNoLock();
+    auto captureRange = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            JPH::RVec3 pos;
+            JPH::Quat rot;
+            noLock.GetPositionAndRotation(active[i], pos, rot);
+            BodyPose& pose = previousPoses[active[i].GetIndex()];
+            pose.position = glm::vec3(pos.GetX(), pos.GetY(), pos.GetZ());
+            pose.rotation = glm::quat(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ());
+            pose.step = step;
+        }
+    };
+    constexpr Uint32 CAPTURE_CHUNK = 1024;
+    if (taskScheduler) taskScheduler->parallelFor(count, CAPTURE_CHUNK, captureRange);
+    else captureRange(0, count, 0);
+}
+
+void Physics3D::resetPreviousPose(const JPH::BodyID& bodyID) {
+    if (bodyID.GetIndex() < previousPoses.size()) previousPoses[bodyID.GetIndex()].step = UINT32_MAX;
+}
+
+bool Physics3D::interpolatePose(const JPH::BodyID& bodyID, glm::vec3& position, glm::quat& rotation) const {
+    // Only valid when captured right before the latest step; otherwise keep the latest pose.
+    if (bodyID.GetIndex() >= previousPoses.size()) return false;
+    const BodyPose& previous = previousPoses[bodyID.GetIndex()];
+    if (previous.step != step) return false;
+
+    // Clamped: a frame that hit MAX_PHYSICS_STEPS_PER_FRAME can leave alpha > 1.
+    const float alpha = std::min(getInterpolationAlpha(), 1.0f);
+    position = glm::mix(previous.position, position, alpha);
+    rotation = glm::slerp(previous.rotation, rotation, alpha);
+    return true;
+}
+
+auto Physics3D::getInterpolatedPosition(BodyHandle handle) const -> glm::vec3 {
+    glm::vec3 position = getPosition(handle);
+    glm::quat rotation = getRotation(handle);
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (!bodyID.IsInvalid() && bodyInterface->IsActive(bodyID)) interpolatePose(bodyID, position, rotation);
+    return position;
+}
+
+auto Physics3D::getInterpolatedRotation(BodyHandle handle) const -> glm::quat {
+    glm::vec3 position = getPosition(handle);
+    glm::quat rotation = getRotation(handle);
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (!bodyID.IsInvalid() && bodyInterface->IsActive(bodyID)) interpolatePose(bodyID, position, rotation);
+    return rotation;
+}
+
+void Physics3D::syncToPhysics(entt::registry& reg) {
+    if (!isInitialized) return;
+
+    // Writes stay serial: moving a body updates the broadphase, which the
+    // lock-free interface doesn't guard against concurrent writers.
+    JPH::BodyInterface& noLock = physicsSystem->GetBodyInterfaceNoLock();
+    auto view = reg.view<Vapor::RigidbodyComponent, Vapor::TransformComponent>();
+    for (auto entity : view) {
+        auto& rb = view.get<Vapor::RigidbodyComponent>(entity);
+        if (!rb.syncToPhysics || !rb.body.valid()) continue;
+
+        const JPH::BodyID id = getBodyID(rb.body);
+        if (id.IsInvalid()) continue;
+        const JPH::EMotionType motionType = noLock.GetMotionType(id);
+        if (motionType != JPH::EMotionType::Kinematic && motionType != JPH::EMotionType::Static) continue;
+
+        // Static bodies never simulate, so waking them would only cost a
+        // pass through the active list.
+        const auto& t = view.get<Vapor::TransformComponent>(entity);
+        noLock.SetPositionAndRotationWhenChanged(
+            id,
+            JPH::RVec3(t.position.x, t.position.y, t.position.z),
+            JPH::Quat(t.rotation.x, t.rotation.y, t.rotation.z, t.rotation.w),
+            motionType == JPH::EMotionType::Static ? JPH::EActivation::DontActivate : JPH::EActivation::Activate
+        );
     }
 }
 
@@ -542,23 +994,29 @@ void Physics3D::process(float dt) {
         ctrl->storePreviousPosition();
     }
 
+    // Driver input; the vehicle constraints step inside PhysicsSystem::Update
+    for (auto* ctrl : vehicleControllers) {
+        ctrl->update(FIXED_TIME_STEP);
+    }
+
     constexpr int MAX_PHYSICS_STEPS_PER_FRAME = 4;
     int stepsThisFrame = 0;
+    if (lockstep) timeAccum = FIXED_TIME_STEP; // one step per call, whatever dt was
     while (timeAccum >= FIXED_TIME_STEP && stepsThisFrame < MAX_PHYSICS_STEPS_PER_FRAME) {
         ++step;
         ++stepsThisFrame;
 
-        // Update vehicle controllers BEFORE physics step (Jolt requirement)
-        for (auto* ctrl : vehicleControllers) {
-            ctrl->update(FIXED_TIME_STEP);
-        }
-
         // Update character controllers BEFORE physics step (Jolt requirement)
-        for (auto* ctrl : characterControllers) {
-            ctrl->update(FIXED_TIME_STEP, getGravity());
-        }
+        updateCharacters(FIXED_TIME_STEP);
+
+        // Buoyancy/drag impulses for bodies inside fluid volumes
+        applyFluidBuoyancy(FIXED_TIME_STEP);
+
+        // Pose before this step, for render interpolation
+        capturePreviousPoses();
 
         physicsSystem->Update(FIXED_TIME_STEP, 1, tempAllocator.get(), jobSystem.get());
+        if (stepHashingEnabled) recordStepHash();
 
         timeAccum -= FIXED_TIME_STEP;
     }
@@ -569,6 +1027,7 @@ void Physics3D::process(float dt) {
     if (debugDrawEnabled && debugRenderer) {
         debugRenderer->update();
     }
+    resolveDeferredQueries();
 
     // Drain raw contact events from listener and convert to ECS BodyHandle events
     auto* listener = static_cast<MyContactListener*>(contactListener.get());
@@ -584,12 +1043,7 @@ void Physics3D::process(float dt) {
         pendingTriggerEvents.clear();
 
         for (auto& raw : rawEvents) {
-            Uint32 ridA = UINT32_MAX, ridB = UINT32_MAX;
-            auto itA = bodyIDToRid.find(raw.id1.GetIndexAndSequenceNumber());
-            auto itB = bodyIDToRid.find(raw.id2.GetIndexAndSequenceNumber());
-            if (itA != bodyIDToRid.end()) ridA = itA->second;
-            if (itB != bodyIDToRid.end()) ridB = itB->second;
-            BodyHandle ha{ ridA }, hb{ ridB };
+            BodyHandle ha = getBodyHandle(raw.id1), hb = getBodyHandle(raw.id2);
 
             if (raw.isTrigger) {
                 pendingTriggerEvents.push_back({ ha, hb, raw.isEnter });
@@ -635,10 +1089,7 @@ auto Physics3D::createSphereBody(
     if (!body) {
         throw std::runtime_error("Failed to create body");
     }
-    bodies[nextBodyID] = body->GetID();
-    bodyIDToRid[body->GetID().GetIndexAndSequenceNumber()] = nextBodyID;
-
-    return BodyHandle{ nextBodyID++ };
+    return registerBody(body->GetID());
 }
 
 auto Physics3D::createBoxBody(
@@ -663,27 +1114,28 @@ auto Physics3D::createBoxBody(
     if (!body) {
         throw std::runtime_error("Failed to create body");
     }
-    bodies[nextBodyID] = body->GetID();
-    bodyIDToRid[body->GetID().GetIndexAndSequenceNumber()] = nextBodyID;
-
-    return BodyHandle{ nextBodyID++ };
+    return registerBody(body->GetID());
 }
 
 void Physics3D::addBody(BodyHandle handle, bool activate) {
-    auto id = bodies.at(handle.rid);
+    JPH::BodyID id = getBodyID(handle);
+    if (id.IsInvalid()) return;
+    resetPreviousPose(id); // the slot may hold a destroyed body's pose
     bodyInterface->AddBody(id, activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
 }
 
 void Physics3D::removeBody(BodyHandle handle) {
-    auto id = bodies.at(handle.rid);
+    JPH::BodyID id = getBodyID(handle);
+    if (id.IsInvalid()) return;
     bodyInterface->RemoveBody(id);
 }
 
 void Physics3D::destroyBody(BodyHandle handle) {
-    auto id = bodies.at(handle.rid);
+    JPH::BodyID id = getBodyID(handle);
+    if (id.IsInvalid()) return;
     if (bodyInterface->IsAdded(id)) bodyInterface->RemoveBody(id);
     bodyInterface->DestroyBody(id);
-    bodies.erase(handle.rid);
+    releaseBody(handle);
 }
 
 auto Physics3D::raycast(const glm::vec3& from, const glm::vec3& to, RaycastHit& hit, BodyHandle ignoreBody) -> bool {
@@ -691,14 +1143,14 @@ auto Physics3D::raycast(const glm::vec3& from, const glm::vec3& to, RaycastHit&
     JPH::RayCastResult result;
 
     bool hasHit = false;
-    if (ignoreBody.valid() && bodies.find(ignoreBody.rid) != bodies.end()) {
-        JPH::BodyID ignoreID = bodies.at(ignoreBody.rid);
+    if (JPH::BodyID ignoreID = getBodyID(ignoreBody); !ignoreID.IsInvalid()) {
         JPH::IgnoreSingleBodyFilter bodyFilter(ignoreID);
         hasHit = physicsSystem->GetNarrowPhaseQuery().CastRay(ray, result, {}, {}, bodyFilter);
     } else {
         hasHit = physicsSystem->GetNarrowPhaseQuery().CastRay(ray, result);
     }
 
+    hit.hasHit = hasHit;
     if (hasHit) {
         JPH::BodyID hitBodyID = result.mBodyID;
         JPH::RVec3 hitPoint = ray.GetPointOnRay(result.mFraction);
@@ -737,9 +1189,9 @@ auto Physics3D::getGravity() const -> glm::vec3 {
 
 // ====== 力與力矩 ======
 void Physics3D::applyForce(BodyHandle handle, const glm::vec3& force, const glm::vec3& relativePos) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::Vec3 joltForce(force.x, force.y, force.z);
 
     if (glm::length(relativePos) > 0.0001f) {
@@ -751,25 +1203,25 @@ void Physics3D::applyForce(BodyHandle handle, const glm::vec3& force, const glm:
 }
 
 void Physics3D::applyCentralForce(BodyHandle handle, const glm::vec3& force) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::Vec3 joltForce(force.x, force.y, force.z);
     bodyInterface->AddForce(bodyID, joltForce);
 }
 
 void Physics3D::applyTorque(BodyHandle handle, const glm::vec3& torque) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::Vec3 joltTorque(torque.x, torque.y, torque.z);
     bodyInterface->AddTorque(bodyID, joltTorque);
 }
 
 void Physics3D::applyImpulse(BodyHandle handle, const glm::vec3& impulse, const glm::vec3& relativePos) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::Vec3 joltImpulse(impulse.x, impulse.y, impulse.z);
 
     if (glm::length(relativePos) > 0.0001f) {
@@ -781,57 +1233,57 @@ void Physics3D::applyImpulse(BodyHandle handle, const glm::vec3& impulse, const
 }
 
 void Physics3D::applyCentralImpulse(BodyHandle handle, const glm::vec3& impulse) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::Vec3 joltImpulse(impulse.x, impulse.y, impulse.z);
     bodyInterface->AddImpulse(bodyID, joltImpulse);
 }
 
 void Physics3D::applyAngularImpulse(BodyHandle handle, const glm::vec3& angularImpulse) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::Vec3 joltAngularImpulse(angularImpulse.x, angularImpulse.y, angularImpulse.z);
     bodyInterface->AddAngularImpulse(bodyID, joltAngularImpulse);
 }
 
 // ====== 速度控制 ======
 void Physics3D::setLinearVelocity(BodyHandle handle, const glm::vec3& vel) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->SetLinearVelocity(bodyID, JPH::Vec3(vel.x, vel.y, vel.z));
 }
 
 auto Physics3D::getLinearVelocity(BodyHandle handle) const -> glm::vec3 {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return glm::vec3(0.0f);
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return glm::vec3(0.0f);
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::Vec3 vel = bodyInterface->GetLinearVelocity(bodyID);
     return glm::vec3(vel.GetX(), vel.GetY(), vel.GetZ());
 }
 
 void Physics3D::setAngularVelocity(BodyHandle handle, const glm::vec3& vel) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->SetAngularVelocity(bodyID, JPH::Vec3(vel.x, vel.y, vel.z));
 }
 
 auto Physics3D::getAngularVelocity(BodyHandle handle) const -> glm::vec3 {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return glm::vec3(0.0f);
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return glm::vec3(0.0f);
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::Vec3 vel = bodyInterface->GetAngularVelocity(bodyID);
     return glm::vec3(vel.GetX(), vel.GetY(), vel.GetZ());
 }
 
 // ====== 物理屬性 ======
 void Physics3D::setMass(BodyHandle handle, float mass) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         JPH::Body& body = lock.GetBody();
@@ -842,9 +1294,9 @@ void Physics3D::setMass(BodyHandle handle, float mass) {
 }
 
 auto Physics3D::getMass(BodyHandle handle) const -> float {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 0.0f;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 0.0f;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         const JPH::Body& body = lock.GetBody();
@@ -856,37 +1308,37 @@ auto Physics3D::getMass(BodyHandle handle) const -> float {
 }
 
 void Physics3D::setFriction(BodyHandle handle, float friction) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->SetFriction(bodyID, friction);
 }
 
 auto Physics3D::getFriction(BodyHandle handle) const -> float {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 0.0f;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 0.0f;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     return bodyInterface->GetFriction(bodyID);
 }
 
 void Physics3D::setRestitution(BodyHandle handle, float restitution) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->SetRestitution(bodyID, restitution);
 }
 
 auto Physics3D::getRestitution(BodyHandle handle) const -> float {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 0.0f;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 0.0f;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     return bodyInterface->GetRestitution(bodyID);
 }
 
 void Physics3D::setLinearDamping(BodyHandle handle, float damping) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         JPH::Body& body = lock.GetBody();
@@ -897,9 +1349,9 @@ void Physics3D::setLinearDamping(BodyHandle handle, float damping) {
 }
 
 auto Physics3D::getLinearDamping(BodyHandle handle) const -> float {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 0.0f;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 0.0f;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         const JPH::Body& body = lock.GetBody();
@@ -911,9 +1363,9 @@ auto Physics3D::getLinearDamping(BodyHandle handle) const -> float {
 }
 
 void Physics3D::setAngularDamping(BodyHandle handle, float damping) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         JPH::Body& body = lock.GetBody();
@@ -924,9 +1376,9 @@ void Physics3D::setAngularDamping(BodyHandle handle, float damping) {
 }
 
 auto Physics3D::getAngularDamping(BodyHandle handle) const -> float {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 0.0f;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 0.0f;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         const JPH::Body& body = lock.GetBody();
@@ -939,16 +1391,16 @@ auto Physics3D::getAngularDamping(BodyHandle handle) const -> float {
 
 // ====== 運動狀態 ======
 void Physics3D::setMotionType(BodyHandle handle, BodyMotionType type) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->SetMotionType(bodyID, convertMotionType(type), JPH::EActivation::Activate);
 }
 
 auto Physics3D::getMotionType(BodyHandle handle) const -> BodyMotionType {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return BodyMotionType::Static;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return BodyMotionType::Static;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::EMotionType motionType = bodyInterface->GetMotionType(bodyID);
 
     switch (motionType) {
@@ -964,9 +1416,9 @@ auto Physics3D::getMotionType(BodyHandle handle) const -> BodyMotionType {
 }
 
 void Physics3D::setGravityFactor(BodyHandle handle, float factor) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         JPH::Body& body = lock.GetBody();
@@ -977,9 +1429,9 @@ void Physics3D::setGravityFactor(BodyHandle handle, float factor) {
 }
 
 auto Physics3D::getGravityFactor(BodyHandle handle) const -> float {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 1.0f;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 1.0f;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyID);
     if (lock.Succeeded()) {
         const JPH::Body& body = lock.GetBody();
@@ -992,54 +1444,58 @@ auto Physics3D::getGravityFactor(BodyHandle handle) const -> float {
 
 // ====== 啟用/停用 ======
 void Physics3D::activateBody(BodyHandle handle) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->ActivateBody(bodyID);
 }
 
 void Physics3D::deactivateBody(BodyHandle handle) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->DeactivateBody(bodyID);
 }
 
 auto Physics3D::isActive(BodyHandle handle) const -> bool {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return false;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return false;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     return bodyInterface->IsActive(bodyID);
 }
 
 // ====== 位置與旋轉 ======
 auto Physics3D::getPosition(BodyHandle handle) const -> glm::vec3 {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return glm::vec3(0.0f);
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return glm::vec3(0.0f);
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::RVec3 pos = bodyInterface->GetPosition(bodyID);
     return glm::vec3(pos.GetX(), pos.GetY(), pos.GetZ());
 }
 
 void Physics3D::setPosition(BodyHandle handle, const glm::vec3& position) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
+    resetPreviousPose(bodyID); // teleport: don't blend across it
+    queueSync(bodyID);
     bodyInterface->SetPosition(bodyID, JPH::RVec3(position.x, position.y, position.z), JPH::EActivation::Activate);
 }
 
 auto Physics3D::getRotation(BodyHandle handle) const -> glm::quat {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return glm::quat(1, 0, 0, 0);
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return glm::quat(1, 0, 0, 0);
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     JPH::Quat rot = bodyInterface->GetRotation(bodyID);
     return glm::quat(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ());
 }
 
 void Physics3D::setRotation(BodyHandle handle, const glm::quat& rotation) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
+    resetPreviousPose(bodyID);
+    queueSync(bodyID);
     bodyInterface->SetRotation(
         bodyID, JPH::Quat(rotation.x, rotation.y, rotation.z, rotation.w), JPH::EActivation::Activate
     );
@@ -1047,16 +1503,16 @@ void Physics3D::setRotation(BodyHandle handle, const glm::quat& rotation) {
 
 // ====== UserData 管理 ======
 void Physics3D::setBodyUserData(BodyHandle handle, Uint64 userData) {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return;
 
-    JPH::BodyID bodyID = bodies[handle.rid];
     bodyInterface->SetUserData(bodyID, userData);
 }
 
 auto Physics3D::getBodyUserData(BodyHandle handle) const -> Uint64 {
-    if (!handle.valid() || bodies.find(handle.rid) == bodies.end()) return 0;
+    JPH::BodyID bodyID = getBodyID(handle);
+    if (bodyID.IsInvalid()) return 0;
 
-    JPH::BodyID bodyID = bodies.at(handle.rid);
     return bodyInterface->GetUserData(bodyID);
 }
 
@@ -1084,10 +1540,7 @@ auto Physics3D::createCapsuleBody(
     if (!body) {
         throw std::runtime_error("Failed to create capsule body");
     }
-    bodies[nextBodyID] = body->GetID();
-    bodyIDToRid[body->GetID().GetIndexAndSequenceNumber()] = nextBodyID;
-
-    return BodyHandle{ nextBodyID++ };
+    return registerBody(body->GetID());
 }
 
 auto Physics3D::createCylinderBody(
@@ -1113,10 +1566,7 @@ auto Physics3D::createCylinderBody(
     if (!body) {
         throw std::runtime_error("Failed to create cylinder body");
     }
-    bodies[nextBodyID] = body->GetID();
-    bodyIDToRid[body->GetID().GetIndexAndSequenceNumber()] = nextBodyID;
-
-    return BodyHandle{ nextBodyID++ };
+    return registerBody(body->GetID());
 }
 
 auto Physics3D::createMeshBody(
@@ -1126,32 +1576,11 @@ auto Physics3D::createMeshBody(
     const glm::quat& rotation,
     BodyMotionType motionType
 ) -> BodyHandle {
-    // Convert vertices to Jolt format
-    JPH::VertexList joltVertices;
-    joltVertices.reserve(vertices.size());
-    for (const auto& v : vertices) {
-        joltVertices.push_back(JPH::Float3(v.x, v.y, v.z));
-    }
-
-    // Convert indices to Jolt format (triangles)
-    JPH::IndexedTriangleList joltTriangles;
-    joltTriangles.reserve(indices.size() / 3);
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        JPH::IndexedTriangle triangle;
-        triangle.mIdx[0] = indices[i];
-        triangle.mIdx[1] = indices[i + 1];
-        triangle.mIdx[2] = indices[i + 2];
-        joltTriangles.push_back(triangle);
-    }
-
-    // Create mesh shape
-    JPH::MeshShapeSettings shapeSettings(joltVertices, joltTriangles);
-    shapeSettings.SetEmbedded();
-    JPH::ShapeSettings::ShapeResult shapeResult = shapeSettings.Create();
-    if (shapeResult.HasError()) {
+    // Built once per unique geometry (or restored from the scene cook)
+    JPH::ShapeRefC shape = CollisionShapeCache::instance().acquire(CollisionShapeCache::Kind::Mesh, vertices, indices);
+    if (!shape) {
         throw std::runtime_error("Failed to create mesh shape");
     }
-    JPH::ShapeRefC shape = shapeResult.Get();
 
     // Mesh bodies are usually static
     JPH::BodyCreationSettings bodySettings(
@@ -1166,10 +1595,7 @@ auto Physics3D::createMeshBody(
     if (!body) {
         throw std::runtime_error("Failed to create mesh body");
     }
-    bodies[nextBodyID] = body->GetID();
-    bodyIDToRid[body->GetID().GetIndexAndSequenceNumber()] = nextBodyID;
-
-    return BodyHandle{ nextBodyID++ };
+    return registerBody(body->GetID());
 }
 
 auto Physics3D::createConvexHullBody(
@@ -1178,21 +1604,10 @@ auto Physics3D::createConvexHullBody(
     const glm::quat& rotation,
     BodyMotionType motionType
 ) -> BodyHandle {
-    // Convert points to Jolt format
-    JPH::Array<JPH::Vec3> joltPoints;
-    joltPoints.reserve(points.size());
-    for (const auto& p : points) {
-        joltPoints.push_back(JPH::Vec3(p.x, p.y, p.z));
-    }
-
-    // Create convex hull shape
-    JPH::ConvexHullShapeSettings shapeSettings(joltPoints);
-    shapeSettings.SetEmbedded();
-    JPH::ShapeSettings::ShapeResult shapeResult = shapeSettings.Create();
-    if (shapeResult.HasError()) {
+    JPH::ShapeRefC shape = CollisionShapeCache::instance().acquire(CollisionShapeCache::Kind::ConvexHull, points, {});
+    if (!shape) {
         throw std::runtime_error("Failed to create convex hull shape");
     }
-    JPH::ShapeRefC shape = shapeResult.Get();
 
     JPH::BodyCreationSettings bodySettings(
         shape,
@@ -1206,10 +1621,7 @@ auto Physics3D::createConvexHullBody(
     if (!body) {
         throw std::runtime_error("Failed to create convex hull body");
     }
-    bodies[nextBodyID] = body->GetID();
-    bodyIDToRid[body->GetID().GetIndexAndSequenceNumber()] = nextBodyID;
-
-    return BodyHandle{ nextBodyID++ };
+    return registerBody(body->GetID());
 }
 
 // ====== Trigger 創建方法 ======
@@ -1364,19 +1776,13 @@ auto Physics3D::overlapSphere(const glm::vec3& center, float radius) -> OverlapR
     for (const auto& hit : collector.mHits) {
         JPH::BodyID hitBodyID = hit.mBodyID2;
 
-        // Find the BodyHandle
-        for (const auto& [handleID, bodyID] : bodies) {
-            if (bodyID == hitBodyID) {
-                BodyHandle handle{ handleID };
-                result.bodies.push_back(handle);
+        BodyHandle handle = getBodyHandle(hitBodyID);
+        if (!handle.valid()) continue;
+        result.bodies.push_back(handle);
 
-                // Get Node from UserData
-                Uint64 userData = bodyInterface->GetUserData(hitBodyID);
-                if (userData != 0) {
-                    result.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
-                }
-                break;
-            }
+        Uint64 userData = bodyInterface->GetUserData(hitBodyID);
+        if (userData != 0) {
+            result.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
         }
     }
 
@@ -1406,17 +1812,13 @@ auto Physics3D::overlapBox(const glm::vec3& center, const glm::vec3& halfExtents
     for (const auto& hit : collector.mHits) {
         JPH::BodyID hitBodyID = hit.mBodyID2;
 
-        for (const auto& [handleID, bodyID] : bodies) {
-            if (bodyID == hitBodyID) {
-                BodyHandle handle{ handleID };
-                result.bodies.push_back(handle);
+        BodyHandle handle = getBodyHandle(hitBodyID);
+        if (!handle.valid()) continue;
+        result.bodies.push_back(handle);
 
-                Uint64 userData = bodyInterface->GetUserData(hitBodyID);
-                if (userData != 0) {
-                    result.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
-                }
-                break;
-            }
+        Uint64 userData = bodyInterface->GetUserData(hitBodyID);
+        if (userData != 0) {
+            result.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
         }
     }
 
@@ -1465,26 +1867,415 @@ auto Physics3D::overlapCapsule(const glm::vec3& point1, const glm::vec3& point2,
     for (const auto& hit : collector.mHits) {
         JPH::BodyID hitBodyID = hit.mBodyID2;
 
-        for (const auto& [handleID, bodyID] : bodies) {
-            if (bodyID == hitBodyID) {
-                BodyHandle handle{ handleID };
-                result.bodies.push_back(handle);
+        BodyHandle handle = getBodyHandle(hitBodyID);
+        if (!handle.valid()) continue;
+        result.bodies.push_back(handle);
+
+        Uint64 userData = bodyInterface->GetUserData(hitBodyID);
+        if (userData != 0) {
+            result.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
+        }
+    }
+
+    return result;
+}
+
+// ====== 批次查詢 ======
+namespace {
+
+// Rays are cheap; smaller chunks would spend more on scheduling than on casting.
+constexpr Uint32 QUERY_CHUNK = 32;
+
+template<typename Func> void runQueries(Vapor::TaskScheduler* scheduler, Uint32 count, Func&& func) {
+    if (scheduler) scheduler->parallelFor(count, QUERY_CHUNK, func);
+    else func(0u, count, 0u);
+}
+
+void fillQueryHit(
+    RaycastHit& hit,
+    JPH::BodyID bodyID,
+    JPH::RVec3Arg point,
+    JPH::Vec3Arg normal,
+    float fraction,
+    float length,
+    BodyHandle body,
+    const JPH::BodyInterface& noLock
+) {
+    hit.hasHit = true;
+    hit.point = glm::vec3(point.GetX(), point.GetY(), point.GetZ());
+    hit.normal = glm::vec3(normal.GetX(), normal.GetY(), normal.GetZ());
+    hit.hitFraction = fraction;
+    hit.hitDistance = fraction * length;
+
+    hit.body = body;
+    Uint64 userData = noLock.GetUserData(bodyID);
+    hit.entity = userData != 0 ? static_cast<entt::entity>(static_cast<Uint32>(userData)) : entt::null;
+}
+
+} // namespace
+
+void Physics3D::castRays(std::span<const RayQuery> queries, std::span<RaycastHit> hits) {
+    if (!isInitialized) return;
+
+    const JPH::NarrowPhaseQuery& query = physicsSystem->GetNarrowPhaseQueryNoLock();
+    const JPH::BodyLockInterface& locks = physicsSystem->GetBodyLockInterfaceNoLock();
+    const JPH::BodyInterface& noLock = physicsSystem->GetBodyInterfaceNoLock();
+
+    auto castRange = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            const RayQuery& q = queries[i];
+            RaycastHit& hit = hits[i];
+            hit = RaycastHit{};
+
+            const glm::vec3 delta = q.to - q.from;
+            JPH::RRayCast ray(JPH::RVec3(q.from.x, q.from.y, q.from.z), JPH::Vec3(delta.x, delta.y, delta.z));
+            JPH::RayCastResult result;
+            JPH::IgnoreSingleBodyFilter bodyFilter(getBodyID(q.ignoreBody));
+            if (!query.CastRay(ray, result, {}, {}, bodyFilter)) continue;
+
+            const JPH::RVec3 point = ray.GetPointOnRay(result.mFraction);
+            JPH::Vec3 normal = JPH::Vec3::sAxisY();
+            {
+                JPH::BodyLockRead lock(locks, result.mBodyID);
+                if (lock.Succeeded()) normal = lock.GetBody().GetWorldSpaceSurfaceNormal(result.mSubShapeID2, point);
+            }
+            fillQueryHit(
+                hit, result.mBodyID, point, normal, result.mFraction, glm::length(delta), getBodyHandle(result.mBodyID),
+                noLock
+            );
+        }
+    };
+    runQueries(taskScheduler, static_cast<Uint32>(std::min(queries.size(), hits.size())), castRange);
+}
 
-                Uint64 userData = bodyInterface->GetUserData(hitBodyID);
+void Physics3D::castSpheres(std::span<const SweepQuery> queries, std::span<RaycastHit> hits) {
+    if (!isInitialized) return;
+
+    const JPH::NarrowPhaseQuery& query = physicsSystem->GetNarrowPhaseQueryNoLock();
+    const JPH::BodyInterface& noLock = physicsSystem->GetBodyInterfaceNoLock();
+    const JPH::Shape* sphere = queryShapes->sphere.GetPtr();
+
+    auto castRange = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            const SweepQuery& q = queries[i];
+            RaycastHit& hit = hits[i];
+            hit = RaycastHit{};
+
+            const glm::vec3 delta = q.to - q.from;
+            const JPH::RVec3 start(q.from.x, q.from.y, q.from.z);
+            JPH::RShapeCast cast(
+                sphere, JPH::Vec3::sReplicate(q.radius), JPH::RMat44::sTranslation(start), JPH::Vec3(delta.x, delta.y, delta.z)
+            );
+            JPH::ShapeCastSettings settings;
+            JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+            JPH::IgnoreSingleBodyFilter bodyFilter(getBodyID(q.ignoreBody));
+            // Results are relative to the base offset; using the start keeps precision local.
+            query.CastShape(cast, settings, start, collector, {}, {}, bodyFilter);
+            if (!collector.HadHit()) continue;
+
+            const JPH::ShapeCastResult& result = collector.mHit;
+            const JPH::RVec3 point = start + result.mContactPointOn2;
+            const JPH::Vec3 normal = -result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sAxisY());
+            fillQueryHit(
+                hit, result.mBodyID2, point, normal, result.mFraction, glm::length(delta), getBodyHandle(result.mBodyID2),
+                noLock
+            );
+        }
+    };
+    runQueries(taskScheduler, static_cast<Uint32>(std::min(queries.size(), hits.size())), castRange);
+}
+
+void Physics3D::overlap(std::span<const OverlapQuery> queries, std::span<OverlapResult> results) {
+    if (!isInitialized) return;
+
+    const JPH::NarrowPhaseQuery& query = physicsSystem->GetNarrowPhaseQueryNoLock();
+    const JPH::BodyInterface& noLock = physicsSystem->GetBodyInterfaceNoLock();
+
+    auto collideRange = [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            const OverlapQuery& q = queries[i];
+            OverlapResult& out = results[i];
+            out.bodies.clear();
+            out.entities.clear();
+
+            // Capsules only scale uniformly, so each one gets its own shape;
+            // a capsule without a segment is the unit sphere.
+            const JPH::Shape* shape = queryShapes->sphere.GetPtr();
+            JPH::Vec3 scale = JPH::Vec3::sReplicate(q.radius);
+            std::optional<JPH::CapsuleShape> capsule;
+            if (q.shape == OverlapQuery::Shape::Box) {
+                shape = queryShapes->box.GetPtr();
+                scale = JPH::Vec3(q.halfExtents.x, q.halfExtents.y, q.halfExtents.z);
+            } else if (q.shape == OverlapQuery::Shape::Capsule && q.halfHeight > 0.001f) {
+                capsule.emplace(q.halfHeight, q.radius);
+                capsule->SetEmbedded();
+                shape = &*capsule;
+                scale = JPH::Vec3::sReplicate(1.0f);
+            }
+            const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation(
+                JPH::Quat(q.rotation.x, q.rotation.y, q.rotation.z, q.rotation.w),
+                JPH::RVec3(q.center.x, q.center.y, q.center.z)
+            );
+
+            JPH::CollideShapeSettings settings;
+            JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+            query.CollideShape(shape, scale, transform, settings, JPH::RVec3::sZero(), collector);
+
+            for (const auto& hit : collector.mHits) {
+                const BodyHandle handle = getBodyHandle(hit.mBodyID2);
+                if (!handle.valid()) continue;
+                // Compound/mesh bodies report one hit per sub-shape.
+                if (std::find(out.bodies.begin(), out.bodies.end(), handle) != out.bodies.end()) continue;
+                out.bodies.push_back(handle);
+
+                Uint64 userData = noLock.GetUserData(hit.mBodyID2);
                 if (userData != 0) {
-                    result.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
+                    out.entities.push_back(static_cast<entt::entity>(static_cast<Uint32>(userData)));
                 }
-                break;
             }
         }
+    };
+    runQueries(taskScheduler, static_cast<Uint32>(std::min(queries.size(), results.size())), collideRange);
+}
+
+void Physics3D::executeQueries(SceneQueryBatch& batch) {
+    batch.rayHits.resize(batch.rays.size());
+    batch.sweepHits.resize(batch.sweeps.size());
+    batch.overlapResults.resize(batch.overlaps.size());
+    castRays(batch.rays, batch.rayHits);
+    castSpheres(batch.sweeps, batch.sweepHits);
+    overlap(batch.overlaps, batch.overlapResults);
+    batch.resolved.store(true, std::memory_order_release);
+}
+
+void Physics3D::deferQueries(SceneQueryBatch& batch) {
+    batch.resolved.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(deferredMutex);
+    deferredQueries.push_back(&batch);
+}
+
+void Physics3D::resolveDeferredQueries() {
+    std::vector<SceneQueryBatch*> pending;
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex);
+        pending.swap(deferredQueries);
     }
+    for (auto* batch : pending) {
+        executeQueries(*batch);
+    }
+}
 
-    return result;
+// ====== 狀態快照 ======
+namespace {
+
+// StateRecorder over a flat byte buffer: writes append to a caller-owned
+// vector (reused between saves), reads walk a read-only span.
+class BufferStateRecorder final : public JPH::StateRecorder {
+public:
+    explicit BufferStateRecorder(std::vector<Uint8>& out) : out(&out) {
+    }
+    BufferStateRecorder(const Uint8* data, size_t size) : in(data), inSize(size) {
+    }
+
+    void WriteBytes(const void* inData, size_t inNumBytes) override {
+        const auto* bytes = static_cast<const Uint8*>(inData);
+        out->insert(out->end(), bytes, bytes + inNumBytes);
+    }
+    void ReadBytes(void* outData, size_t inNumBytes) override {
+        if (inNumBytes > inSize - readPos) {
+            failed = true;
+            std::memset(outData, 0, inNumBytes);
+            return;
+        }
+        std::memcpy(outData, in + readPos, inNumBytes);
+        readPos += inNumBytes;
+    }
+    bool IsEOF() const override {
+        return readPos >= inSize;
+    }
+    bool IsFailed() const override {
+        return failed;
+    }
+
+private:
+    std::vector<Uint8>* out = nullptr;
+    const Uint8* in = nullptr;
+    size_t inSize = 0;
+    size_t readPos = 0;
+    bool failed = false;
+};
+
+class ActiveBodiesFilter final : public JPH::StateRecorderFilter {
+public:
+    bool ShouldSaveBody(const JPH::Body& inBody) const override {
+        return inBody.IsActive();
+    }
+};
+
+} // namespace
+
+void Physics3D::saveState(PhysicsSnapshot& snapshot, PhysicsSnapshotMode mode) {
+    if (!isInitialized) return;
+
+    snapshot.data.clear();
+    snapshot.mode = mode;
+    snapshot.step = step;
+    snapshot.timeAccum = timeAccum;
+
+    BufferStateRecorder recorder(snapshot.data);
+    ActiveBodiesFilter activeOnly;
+    physicsSystem->SaveState(
+        recorder, JPH::EStateRecorderState::All, mode == PhysicsSnapshotMode::ActiveBodies ? &activeOnly : nullptr
+    );
+}
+
+bool Physics3D::restoreState(const PhysicsSnapshot& snapshot) {
+    if (!isInitialized || snapshot.empty()) return false;
+
+    BufferStateRecorder recorder(snapshot.data.data(), snapshot.data.size());
+    if (!physicsSystem->RestoreState(recorder) || recorder.IsFailed()) {
+        fmt::print(stderr, "Physics3D: failed to restore snapshot of step {}\n", snapshot.step);
+        return false;
+    }
+
+    step = snapshot.step;
+    timeAccum = snapshot.timeAccum;
+    JPH::Vec3 gravity = physicsSystem->GetGravity();
+    currentGravity = glm::vec3(gravity.GetX(), gravity.GetY(), gravity.GetZ());
+
+    // Restored bodies jumped: don't interpolate across it, and rewrite every
+    // dynamic transform next sync, including bodies that are asleep now.
+    for (BodyPose& pose : previousPoses) pose.step = UINT32_MAX;
+    syncAllNext = true;
+    return true;
+}
+
+auto Physics3D::hashState() -> Uint64 {
+    if (!isInitialized) return 0;
+
+    hashScratch.clear();
+    BufferStateRecorder recorder(hashScratch);
+    physicsSystem->SaveState(recorder);
+
+    Uint64 hash = 14695981039346656037ull; // FNV-1a
+    for (Uint8 byte : hashScratch) {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void Physics3D::setStepHashingEnabled(bool enabled, Uint32 window) {
+    stepHashingEnabled = enabled;
+    if (!enabled) return;
+    window = std::max(window, 1u);
+    if (window != stepHashes.size()) {
+        // Keep the newest hashes that still fit.
+        std::vector<PhysicsStepHash> kept = getStepHashes();
+        const size_t keep = std::min<size_t>(kept.size(), window);
+        stepHashes.assign(window, {});
+        std::copy(kept.end() - keep, kept.end(), stepHashes.begin());
+        stepHashCount = static_cast<Uint32>(keep);
+        stepHashHead = stepHashCount % window;
+    }
+}
+
+void Physics3D::recordStepHash() {
+    stepHashes[stepHashHead] = { step, hashState() };
+    stepHashHead = (stepHashHead + 1) % static_cast<Uint32>(stepHashes.size());
+    stepHashCount = std::min(stepHashCount + 1, static_cast<Uint32>(stepHashes.size()));
+}
+
+auto Physics3D::getStepHashes() const -> std::vector<PhysicsStepHash> {
+    std::vector<PhysicsStepHash> hashes;
+    hashes.reserve(stepHashCount);
+    const Uint32 window = static_cast<Uint32>(stepHashes.size());
+    for (Uint32 i = 0; i < stepHashCount; ++i) {
+        hashes.push_back(stepHashes[(stepHashHead + window - stepHashCount + i) % window]);
+    }
+    return hashes;
+}
+
+auto Physics3D::getStepHash(Uint32 atStep, Uint64& hash) const -> bool {
+    // Steps are recorded in order, usually consecutively: try the slot the
+    // step would be in, then fall back to a scan of the window.
+    const Uint32 window = static_cast<Uint32>(stepHashes.size());
+    if (stepHashCount == 0) return false;
+    const Uint32 newest = stepHashes[(stepHashHead + window - 1) % window].step;
+    if (atStep <= newest && newest - atStep < stepHashCount) {
+        const PhysicsStepHash& entry = stepHashes[(stepHashHead + window - 1 - (newest - atStep)) % window];
+        if (entry.step == atStep) {
+            hash = entry.hash;
+            return true;
+        }
+    }
+    for (Uint32 i = 0; i < stepHashCount; ++i) {
+        const PhysicsStepHash& entry = stepHashes[(stepHashHead + window - 1 - i) % window];
+        if (entry.step == atStep) {
+            hash = entry.hash;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ====== Handle 表 ======
+auto Physics3D::registerBody(const JPH::BodyID& bodyID) -> BodyHandle {
+    Uint32 index;
+    if (freeBodySlot != UINT32_MAX) {
+        index = freeBodySlot;
+        freeBodySlot = bodySlots[index].nextFree;
+    } else {
+        index = static_cast<Uint32>(bodySlots.size());
+        bodySlots.push_back({});
+    }
+    BodySlot& slot = bodySlots[index];
+    slot.bodyID = bodyID.GetIndexAndSequenceNumber();
+    slot.nextFree = UINT32_MAX;
+
+    const BodyHandle handle{ (slot.generation << BODY_INDEX_BITS) | index };
+    if (bodyID.GetIndex() >= ridByBodyIndex.size()) ridByBodyIndex.resize(bodyID.GetIndex() + 1, UINT32_MAX);
+    ridByBodyIndex[bodyID.GetIndex()] = handle.rid;
+    // A body created asleep (or never activated) still syncs its pose once.
+    queueSync(bodyID);
+    syncEntitiesDirty = true;
+    return handle;
+}
+
+void Physics3D::releaseBody(BodyHandle handle) {
+    const Uint32 index = handle.rid & BODY_INDEX_MASK;
+    BodySlot& slot = bodySlots[index];
+    const JPH::BodyID bodyID(slot.bodyID);
+    if (ridByBodyIndex[bodyID.GetIndex()] == handle.rid) ridByBodyIndex[bodyID.GetIndex()] = UINT32_MAX;
+
+    // Bumping the generation is what turns every outstanding copy of the
+    // handle stale; the slot itself is reused LIFO.
+    slot.bodyID = JPH::BodyID::cInvalidBodyID;
+    slot.generation = (slot.generation + 1) & BODY_GENERATION_MASK;
+    slot.nextFree = freeBodySlot;
+    freeBodySlot = index;
+    syncEntitiesDirty = true;
 }
 
 auto Physics3D::getBodyID(BodyHandle handle) const -> JPH::BodyID {
-    auto it = bodies.find(handle.rid);
-    return it != bodies.end() ? it->second : JPH::BodyID();
+    const Uint32 index = handle.rid & BODY_INDEX_MASK;
+    if (!handle.valid() || index >= bodySlots.size()) return JPH::BodyID();
+    const BodySlot& slot = bodySlots[index];
+    if (slot.generation != handle.rid >> BODY_INDEX_BITS) return JPH::BodyID();
+    return JPH::BodyID(slot.bodyID);
+}
+
+auto Physics3D::getBodyHandle(const JPH::BodyID& bodyID) const -> BodyHandle {
+    if (bodyID.IsInvalid() || bodyID.GetIndex() >= ridByBodyIndex.size()) return BodyHandle{};
+    const Uint32 rid = ridByBodyIndex[bodyID.GetIndex()];
+    // Jolt reuses body indices too: match the sequence number via the slot.
+    if (rid == UINT32_MAX || bodySlots[rid & BODY_INDEX_MASK].bodyID != bodyID.GetIndexAndSequenceNumber()) {
+        return BodyHandle{};
+    }
+    return BodyHandle{ rid };
+}
+
+bool Physics3D::isValid(BodyHandle handle) const {
+    return !getBodyID(handle).IsInvalid();
 }
 
 void Physics3D::setDebugEnabled(bool enabled) {
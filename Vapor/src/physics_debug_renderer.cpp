@@ -1,4 +1,5 @@
 #include "physics_debug_renderer.hpp"
+#include "task_scheduler.hpp"
 #include <Jolt/Jolt.h>
 
 #include <Jolt/Physics/Body/Body.h>
@@ -15,6 +16,7 @@
 #include <Jolt/Physics/Collision/Shape/Shape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <bit>
 #include <memory>
 #include <vector>
 
@@ -22,17 +24,45 @@ using namespace Vapor;
 
 namespace Vapor {
 
+    // Order-independent hash input for one ID
+    static Uint64 mixBits(Uint64 x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
     PhysicsDebugRenderer::PhysicsDebugRenderer() = default;
-    PhysicsDebugRenderer::~PhysicsDebugRenderer() = default;
+
+    PhysicsDebugRenderer::~PhysicsDebugRenderer() {
+        removeStaticLayer();
+    }
 
     void PhysicsDebugRenderer::setPhysicsSystem(Physics3D* physics) {
         this->physics = physics;
+        staticSignature = 0;
     }
 
     void PhysicsDebugRenderer::setDebugDraw(std::shared_ptr<DebugDraw> debugDraw) {
+        removeStaticLayer();
         this->debugDraw = debugDraw;
     }
 
+    void PhysicsDebugRenderer::setEnabled(bool enabled) {
+        this->enabled = enabled;
+        if (!enabled) {
+            removeStaticLayer();
+        }
+    }
+
+    void PhysicsDebugRenderer::removeStaticLayer() {
+        if (debugDraw) {
+            debugDraw->removePersistent(staticLayerKey());
+        }
+        staticSignature = 0;
+    }
+
     void PhysicsDebugRenderer::update() {
         if (!enabled || !physics || !debugDraw) {
             return;
@@ -49,50 +79,91 @@ namespace Vapor {
         JPH::BodyIDVector bodyIDs;
         physicsSystem->GetBodies(bodyIDs);
 
-        // Draw each body
-        for (const JPH::BodyID& bodyID : bodyIDs) {
-            JPH::BodyLockRead lock(bodyLockInterface, bodyID);
-            if (!lock.Succeeded()) {
-                continue;
+        // Draw moving bodies in parallel; DebugDraw records per thread.
+        // Static ones are only collected.
+        staticBodies.resize(taskScheduler ? taskScheduler->getNumThreads() : 1);
+        for (auto& ids : staticBodies) ids.clear();
+        auto drawRange = [&](Uint32 begin, Uint32 end, Uint32 threadIndex) {
+            for (Uint32 i = begin; i < end; ++i) {
+                JPH::BodyLockRead lock(bodyLockInterface, bodyIDs[i]);
+                if (!lock.Succeeded()) {
+                    continue;
+                }
+                const JPH::Body& body = lock.GetBody();
+                if (body.IsStatic()) {
+                    staticBodies[threadIndex].push_back(bodyIDs[i].GetIndexAndSequenceNumber());
+                    continue;
+                }
+                visitBody(body);
             }
-
-            const JPH::Body& body = lock.GetBody();
-
-            // Skip triggers if not configured to draw them
-            if (body.IsSensor() && !config.drawTriggers) {
-                continue;
+        };
+        constexpr Uint32 BODY_CHUNK = 64;
+        const Uint32 bodyCount = static_cast<Uint32>(bodyIDs.size());
+        if (taskScheduler) taskScheduler->parallelFor(bodyCount, BODY_CHUNK, drawRange);
+        else drawRange(0, bodyCount, 0);
+
+        // Re-record the static layer only when its bodies or the config changed
+        Uint64 signature = mixBits(
+            Uint64(config.drawBodies) | Uint64(config.drawTriggers) << 1 | Uint64(config.drawBoundingBoxes) << 2
+            | Uint64(config.colorByState) << 3
+        );
+        for (int c = 0; c < 4; ++c) {
+            signature += mixBits(Uint64(std::bit_cast<Uint32>(config.defaultColor[c])) + (Uint64(c + 1) << 32));
+        }
+        for (const auto& ids : staticBodies) {
+            for (Uint32 id : ids) signature += mixBits(id);
+        }
+        signature |= 1;// 0 means "not recorded"
+        if (signature == staticSignature) {
+            return;
+        }
+        staticSignature = signature;
+
+        debugDraw->beginPersistent(staticLayerKey());
+        for (const auto& ids : staticBodies) {
+            for (Uint32 id : ids) {
+                JPH::BodyLockRead lock(bodyLockInterface, JPH::BodyID(id));
+                if (lock.Succeeded()) {
+                    visitBody(lock.GetBody());
+                }
             }
+        }
+        debugDraw->endPersistent();
+    }
 
-            // Skip regular bodies if not configured to draw them
-            if (!body.IsSensor() && !config.drawBodies) {
-                continue;
-            }
+    void PhysicsDebugRenderer::visitBody(const JPH::Body& body) {
+        // Skip triggers if not configured to draw them
+        if (body.IsSensor() && !config.drawTriggers) {
+            return;
+        }
 
-            glm::vec4 color = getBodyColor(body);
-            drawBody(body, color);
+        // Skip regular bodies if not configured to draw them
+        if (!body.IsSensor() && !config.drawBodies) {
+            return;
+        }
 
-            // Draw velocity vector if enabled
-            if (config.drawVelocities && body.GetMotionType() == JPH::EMotionType::Dynamic) {
-                JPH::RVec3 pos = body.GetPosition();
-                JPH::Vec3 vel = body.GetLinearVelocity();
+        glm::vec4 color = getBodyColor(body);
+        drawBody(body, color);
 
-                glm::vec3 position(pos.GetX(), pos.GetY(), pos.GetZ());
-                glm::vec3 velocity(vel.GetX(), vel.GetY(), vel.GetZ());
+        // Draw velocity vector if enabled
+        if (config.drawVelocities && body.GetMotionType() == JPH::EMotionType::Dynamic) {
+            JPH::RVec3 pos = body.GetPosition();
+            JPH::Vec3 vel = body.GetLinearVelocity();
 
-                if (glm::length(velocity) > 0.01f) {
-                    debugDraw->addArrow(
-                        position, position + velocity * config.velocityScale, DebugColors::Yellow, 0.2f
-                    );
-                }
-            }
+            glm::vec3 position(pos.GetX(), pos.GetY(), pos.GetZ());
+            glm::vec3 velocity(vel.GetX(), vel.GetY(), vel.GetZ());
 
-            // Draw center of mass if enabled
-            if (config.drawCenterOfMass && body.GetMotionType() == JPH::EMotionType::Dynamic) {
-                JPH::RVec3 com = body.GetCenterOfMassPosition();
-                glm::vec3 centerOfMass(com.GetX(), com.GetY(), com.GetZ());
-                debugDraw->addCross(centerOfMass, 0.1f, DebugColors::Magenta);
+            if (glm::length(velocity) > 0.01f) {
+                debugDraw->addArrow(position, position + velocity * config.velocityScale, DebugColors::Yellow, 0.2f);
             }
         }
+
+        // Draw center of mass if enabled
+        if (config.drawCenterOfMass && body.GetMotionType() == JPH::EMotionType::Dynamic) {
+            JPH::RVec3 com = body.GetCenterOfMassPosition();
+            glm::vec3 centerOfMass(com.GetX(), com.GetY(), com.GetZ());
+            debugDraw->addCross(centerOfMass, 0.1f, DebugColors::Magenta);
+        }
     }
 
     void PhysicsDebugRenderer::drawBody(const JPH::Body& body, const glm::vec4& color) {
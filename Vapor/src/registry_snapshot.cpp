@@ -0,0 +1,155 @@
+#include "registry_snapshot.hpp"
+#include "scene_blueprint.hpp"
+
+#include <fmt/core.h>
+#include <fstream>
+#include <unordered_map>
+
+namespace Vapor {
+
+namespace {
+
+    constexpr char kSnapshotMagic[4] = { 'V', 'R', 'S', '1' };
+    constexpr uint32_t kSnapshotVersion = 1;
+
+    struct ColumnHeader {
+        uint32_t id = 0;
+        uint32_t layout = 0;
+        uint64_t size = 0;
+    };
+
+}// namespace
+
+// Layout:
+//   magic 'VRS1', u32 version, u32 entityCount, entity[entityCount],
+//   u32 columnCount, then per column: u32 id, u32 layout, u64 byteSize, payload.
+// Byte sizes let a reader skip columns it doesn't know.
+void captureRegistry(const entt::registry& registry, RegistrySnapshot& snapshot) {
+    snapshot.bytes.clear();
+    SnapshotWriter out(snapshot.bytes);
+    out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+    out.pod(kSnapshotVersion);
+
+    const size_t countAt = out.size();
+    uint32_t entityCount = 0;
+    out.pod(entityCount);
+    if (const auto* entities = registry.storage<entt::entity>()) {
+        for (const auto [entity] : entities->each()) {
+            out.pod(entity);
+            ++entityCount;
+        }
+    }
+    out.patch(countAt, entityCount);
+    snapshot.entityCount = entityCount;
+
+    const auto& columns = BlueprintComponents::instance().getSnapshotColumns();
+    out.pod(static_cast<uint32_t>(columns.size()));
+    for (const auto& column : columns) {
+        out.pod(column.id);
+        out.pod(column.layout);
+        const size_t sizeAt = out.size();
+        out.pod(uint64_t{ 0 });
+        column.save(registry, out);
+        out.patch(sizeAt, static_cast<uint64_t>(out.size() - sizeAt - sizeof(uint64_t)));
+    }
+}
+
+bool restoreRegistry(entt::registry& registry, const RegistrySnapshot& snapshot) {
+    SnapshotReader in(snapshot.bytes.data(), snapshot.bytes.size());
+    char magic[4] = {};
+    uint32_t version = 0, entityCount = 0;
+    in.read(magic, sizeof(magic));
+    in.pod(version);
+    in.pod(entityCount);
+    if (in.failed() || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 || version != kSnapshotVersion
+        || static_cast<uint64_t>(entityCount) * sizeof(entt::entity) > in.remaining()) {
+        fmt::print(stderr, "restoreRegistry: not a registry snapshot (or an older version)\n");
+        return false;
+    }
+    std::vector<entt::entity> entities(entityCount);
+    in.read(entities.data(), entityCount * sizeof(entt::entity));
+
+    // Validate the column framing before touching the registry, so a
+    // truncated snapshot is rejected without wiping the scene.
+    uint32_t columnCount = 0;
+    in.pod(columnCount);
+    std::vector<std::pair<ColumnHeader, SnapshotReader>> payloads;
+    payloads.reserve(columnCount);
+    for (uint32_t i = 0; i < columnCount && !in.failed(); ++i) {
+        ColumnHeader header;
+        in.pod(header.id);
+        in.pod(header.layout);
+        in.pod(header.size);
+        if (header.size > in.remaining()) in.fail();
+        if (in.failed()) break;
+        const uint8_t* payload = snapshot.bytes.data() + (snapshot.bytes.size() - in.remaining());
+        payloads.emplace_back(header, SnapshotReader(payload, header.size));
+        in.skip(header.size);
+    }
+    if (in.failed()) {
+        fmt::print(stderr, "restoreRegistry: snapshot is truncated or corrupt\n");
+        return false;
+    }
+
+    std::unordered_map<uint32_t, const SnapshotColumn*> known;
+    for (const auto& column : BlueprintComponents::instance().getSnapshotColumns()) known[column.id] = &column;
+
+    // Destroy hooks fire here, as for any other scene teardown: with
+    // Physics3D::attach every live rigidbody's Jolt body is destroyed, including
+    // those of entities created after the snapshot.
+    registry.clear();
+    for (const entt::entity entity : entities) {
+        if (registry.create(entity) != entity) {
+            fmt::print(stderr, "restoreRegistry: entity {} is duplicated in the snapshot\n",
+                       entt::to_integral(entity));
+            return false;
+        }
+    }
+
+    for (auto& [header, payload] : payloads) {
+        const auto it = known.find(header.id);
+        if (it == known.end()) {
+            fmt::print(stderr, "restoreRegistry: unknown column {:08x} skipped\n", header.id);
+            continue;
+        }
+        const SnapshotColumn& column = *it->second;
+        if (column.layout != header.layout) {
+            fmt::print(stderr, "restoreRegistry: '{}' changed layout since the snapshot; skipped\n", column.name);
+            continue;
+        }
+        if (!column.load(registry, payload) || payload.remaining() != 0) {
+            fmt::print(stderr, "restoreRegistry: column '{}' is corrupt\n", column.name);
+            return false;
+        }
+        if (column.restored) column.restored(registry);
+    }
+    return true;
+}
+
+bool RegistrySnapshot::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fmt::print(stderr, "RegistrySnapshot: cannot write '{}'\n", path);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+bool RegistrySnapshot::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+    const std::streamsize size = in.tellg();
+    in.seekg(0);
+    std::vector<uint8_t> data(static_cast<size_t>(std::max<std::streamsize>(size, 0)));
+    if (!in.read(reinterpret_cast<char*>(data.data()), size)) return false;
+
+    // Only the entity count is read here; restoreRegistry validates the rest.
+    uint32_t count = 0;
+    if (data.size() >= 12) std::memcpy(&count, data.data() + 8, sizeof(count));
+    bytes = std::move(data);
+    entityCount = count;
+    return true;
+}
+
+}// namespace Vapor
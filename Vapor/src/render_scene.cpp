@@ -1,5 +1,6 @@
 #include "render_scene.hpp"
 #include "fluid_volume.hpp"
+#include "physics_3d.hpp"
 
 using namespace Vapor;
 
@@ -25,7 +26,8 @@ void RenderScene::addMesh(std::shared_ptr<Mesh> mesh, const glm::mat4& transform
 
 auto RenderScene::createFluidVolume(Physics3D* physics, const FluidVolumeSettings& settings)
     -> std::shared_ptr<FluidVolume> {
-    auto fluidVolume = std::make_shared<FluidVolume>(physics, settings);
+    auto fluidVolume = std::make_shared<FluidVolume>(settings);
+    if (physics) physics->registerFluidVolume(fluidVolume);
     fluidVolumes.push_back(fluidVolume);
     return fluidVolume;
 }
@@ -1,5 +1,6 @@
 #include "renderer.hpp"
 #include "meshlet_builder.hpp"  // runtime meshlet fallback in registerMesh
+#include "texture_cook.hpp"   // CPU decode of cooked textures the device can't sample
 #include "stats_log.hpp"
 #include "voxel_world.hpp"
 #include "rhi_vulkan.hpp"
@@ -20,6 +21,7 @@
 #include <fmt/core.h>
 #include <map>
 #include <algorithm>
+#include <bit>
 #include <cstring>
 #include <cstdlib>
 #include <random>
@@ -1041,6 +1043,7 @@ void Renderer::beginFrame(const CameraRenderData& camera) {
     }
     batch2D.nextFrame();
     batch3D.nextFrame();
+    if (fontManager) fontManager->beginFrame();
 
     // Begin RHI frame (get drawable, create command buffer). The Vulkan
     // backend recreates an out-of-date/resized swapchain here.
@@ -1380,7 +1383,8 @@ void Renderer::setupDefaultRenderGraph() {
     // are disabled on the 2D pipeline).
     renderGraph.addPass("Canvas2D",
         [](Renderer& r) {
-            if (r.batch2D.quadCount == 0 || !r.colorRT.isValid() || !r.depthStencilRT.isValid()) return;
+            if ((r.batch2D.quadCount == 0 && r.batch2D.sprites.empty()) ||
+                !r.colorRT.isValid() || !r.depthStencilRT.isValid()) return;
             RenderPassDesc rp;
             rp.name = "Canvas2D";
             rp.colorAttachments.push_back(r.colorRT);
@@ -1480,6 +1484,8 @@ void Renderer::endFrame() {
     // Disable auto-flushing until next beginFrame
     batch2D.canAutoFlush = false;
     batch3D.canAutoFlush = false;
+    // Sprites the Canvas2D pass didn't draw (no colorRT yet) don't pile up
+    batch2D.clearSprites();
 
     // Process screenshot request (before ending frame so command buffer is still active)
     if (screenshotRequested) {
@@ -7706,24 +7712,47 @@ TextureId Renderer::getOrCreateTexture(const std::shared_ptr<Vapor::Image>& imag
         return it->second;
     }
 
-    // Create new texture with a full mip chain. Native (renderer_metal.cpp
+    // Cooked scene images (TextureCook) arrive block-compressed with their
+    // whole mip chain. A device without that compression family gets them
+    // decoded back to RGBA8 here — correct, just without the VRAM savings.
+    std::shared_ptr<Vapor::Image> source = image;
+    if (!isPixelFormatSupported(rhi->getCapabilities(), image->format)) {
+        auto decoded = std::make_shared<Vapor::Image>(*image);
+        if (!TextureCook::decompress(*decoded)) {
+            return defaultWhiteTexture;
+        }
+        source = std::move(decoded);
+    }
+    const bool hasStoredMips = source->mipLevels > 1 || isCompressedPixelFormat(source->format);
+
+    // Otherwise create a full mip chain. Native (renderer_metal.cpp
     // createTexture) sizes material textures to calculateMipmapLevelCount =
     // floor(log2(max(w,h))) + 1 and blits the chain with generateMipmaps; the
     // RHI path previously left mipLevels at 1, so minified surfaces sampled
     // only the base level and shimmered/aliased. Match native exactly.
-    Uint32 mipLevels = static_cast<Uint32>(
-        std::floor(std::log2(std::max(image->width, image->height)))) + 1u;
+    Uint32 mipLevels = hasStoredMips ? std::max(1u, source->mipLevels)
+                                     : static_cast<Uint32>(std::floor(std::log2(std::max(source->width, source->height)))) + 1u;
     TextureDesc texDesc;
-    texDesc.width = image->width;
-    texDesc.height = image->height;
-    texDesc.format = PixelFormat::RGBA8_UNORM;
+    texDesc.width = source->width;
+    texDesc.height = source->height;
+    texDesc.format = hasStoredMips ? source->format : PixelFormat::RGBA8_UNORM;
     texDesc.usage = TextureUsage::Sampled;
     texDesc.mipLevels = mipLevels;
     TextureHandle texHandle = rhi->createTexture(texDesc);
 
-    if (!image->byteArray.empty()) {
+    if (hasStoredMips) {
+        // Levels are packed back to back, level 0 first.
+        size_t offset = 0;
+        for (Uint32 level = 0; level < mipLevels; ++level) {
+            const size_t levelSize = pixelFormatLevelSize(texDesc.format, std::max(1u, source->width >> level),
+                                                          std::max(1u, source->height >> level));
+            if (offset + levelSize > source->byteArray.size()) break;
+            rhi->updateTexture(texHandle, source->byteArray.data() + offset, levelSize, level, 0);
+            offset += levelSize;
+        }
+    } else {
         // Uploads the base level (mip 0); generateMipmaps fills the rest.
-        rhi->updateTexture(texHandle, image->byteArray.data(), image->byteArray.size());
+        rhi->updateTexture(texHandle, source->byteArray.data(), source->byteArray.size());
         if (mipLevels > 1) {
             rhi->generateMipmaps(texHandle);
         }
@@ -7734,7 +7763,7 @@ TextureId Renderer::getOrCreateTexture(const std::shared_ptr<Vapor::Image>& imag
     tex.sampler = defaultSampler;
     tex.width = image->width;
     tex.height = image->height;
-    tex.format = PixelFormat::RGBA8_UNORM;
+    tex.format = texDesc.format;
 
     TextureId id = static_cast<TextureId>(textures.size());
     textures.push_back(tex);
@@ -9262,6 +9291,7 @@ void Renderer::drawCpuTimingsImGui() {
 void Renderer::initBatchRendering() {
     // Initialize batch2D
     batch2D.init(rhi.get(), backend, false, textures[defaultWhiteTexture].handle, defaultSampler);
+    batch2D.initSprites(rhi.get(), capabilities.bindlessTextures);
 
     // Initialize batch3D
     batch3D.init(rhi.get(), backend, true, textures[defaultWhiteTexture].handle, defaultSampler);
@@ -9270,10 +9300,18 @@ void Renderer::initBatchRendering() {
 void Renderer::shutdownBatchRendering() {
     batch2D.shutdown(rhi.get());
     batch3D.shutdown(rhi.get());
+    if (fontManager) {
+        DynamicAtlas& glyphAtlas = fontManager->getGlyphAtlas();
+        for (Uint32 page = 0; page < glyphAtlas.pageCount(); ++page) {
+            TextureHandle texture = glyphAtlas.getPageTexture(page);
+            if (texture.isValid()) rhi->destroyTexture(texture);
+            glyphAtlas.setPageTexture(page, {});
+        }
+    }
 }
 
 void Renderer::flush2D() {
-    if (batch2D.quadCount > 0) {
+    if (batch2D.quadCount > 0 || !batch2D.sprites.empty()) {
         // 2D canvas coordinates are LOGICAL window units, like the native
         // Metal CanvasPass (SDL_GetWindowSize). On high-DPI displays the
         // swapchain is larger than the window; projecting with the swapchain
@@ -9332,12 +9370,15 @@ void Renderer::drawQuad2D(
     const glm::vec4& tintColor,
     int entityID
 ) {
-    // TODO: custom tex coords are not applied yet
     batch2D.setTexture(texture);
-    batch2D.addQuad(transform, tintColor, entityID);
+    batch2D.addQuad(transform, texCoords, tintColor, entityID);
     batch2D.setTexture(TextureHandle{});
 }
 
+void Renderer::drawSprites2D(std::span<const SpriteDraw2D> sprites) {
+    batch2D.addSprites(sprites);
+}
+
 // 3D Quad drawing implementations
 void Renderer::drawQuad3D(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color) {
     batch3D.addQuad(position, size, color);
@@ -9600,49 +9641,47 @@ void Renderer::drawText2D(
         }
     }
 
-    // Draw each character as a textured quad, all in the atlas segment (the
-    // segment texture is what flush() samples — without this the glyphs land
-    // in the previous segment and render as solid blocks).
-    batch2D.setTexture(fontTexture);
-
-    float cursorX = position.x;
-    float cursorY = position.y;
-
-    for (char c : text) {
-        if (c == '\n') {
-            cursorX = position.x;
-            cursorY += fontData->lineHeight * scale;
-            continue;
+    // Laid out once per (font, scale, text) and reused across frames. Glyphs
+    // outside the baked range were rasterized into the glyph atlas by the
+    // layout and must be uploaded before any quad uses them.
+    const TextLayout* layout = fontManager->layoutText(font, text, scale);
+    if (!layout || layout->quads.empty()) return;
+    if (layout->usesGlyphAtlas) uploadDynamicAtlas(fontManager->getGlyphAtlas());
+
+    // Each run of quads sharing an atlas page goes into that texture's
+    // segment as one contiguous span (the segment texture is what flush()
+    // samples — without this the glyphs land in the previous segment and
+    // render as solid blocks).
+    const TextLayout::Quad* quads = layout->quads.data();
+    const size_t quadCount = layout->quads.size();
+    for (size_t runStart = 0; runStart < quadCount;) {
+        const Uint32 page = quads[runStart].atlasPage;
+        size_t runEnd = runStart + 1;
+        while (runEnd < quadCount && quads[runEnd].atlasPage == page) runEnd++;
+
+        batch2D.setTexture(page == Glyph::kBakedAtlas ? fontTexture
+                                                      : fontManager->getGlyphAtlas().getPageTexture(page));
+        while (runStart < runEnd) {
+            std::span<Vertex2D> span = batch2D.appendQuads(static_cast<uint32_t>(runEnd - runStart));
+            if (span.empty()) break;// batch full and can't flush
+            Vertex2D* v = span.data();
+            for (size_t q = 0; q < span.size() / 4; ++q, v += 4) {
+                const TextLayout::Quad& quad = quads[runStart + q];
+                const float x0 = position.x + quad.rect.x, y0 = position.y + quad.rect.y;
+                const float x1 = position.x + quad.rect.z, y1 = position.y + quad.rect.w;
+                v[0].position = glm::vec3(x0, y0, 0.0f);
+                v[1].position = glm::vec3(x1, y0, 0.0f);
+                v[2].position = glm::vec3(x1, y1, 0.0f);
+                v[3].position = glm::vec3(x0, y1, 0.0f);
+                v[0].texCoord = glm::vec2(quad.uv.x, quad.uv.y);
+                v[1].texCoord = glm::vec2(quad.uv.z, quad.uv.y);
+                v[2].texCoord = glm::vec2(quad.uv.z, quad.uv.w);
+                v[3].texCoord = glm::vec2(quad.uv.x, quad.uv.w);
+                v[0].color = v[1].color = v[2].color = v[3].color = color;
+            }
+            runStart += span.size() / 4;
         }
-
-        const Glyph* glyph = fontManager->getGlyph(font, static_cast<int>(c));
-        if (!glyph) continue;
-
-        // Glyph quad position: yOffset is relative to the baseline, which sits
-        // ascent below the caller's top-of-line position (matches the native
-        // Metal renderer).
-        float xPos = cursorX + glyph->xOffset * scale;
-        float yPos = cursorY + (glyph->yOffset + fontData->ascent) * scale;
-        float width = glyph->width * scale;
-        float height = glyph->height * scale;
-
-        // Build transform matrix for this glyph
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(xPos + width * 0.5f, yPos + height * 0.5f, 0.0f));
-        transform = glm::scale(transform, glm::vec3(width, height, 1.0f));
-
-        // UV coordinates from glyph
-        glm::vec2 texCoords[4] = {
-            glm::vec2(glyph->u0, glyph->v0),
-            glm::vec2(glyph->u1, glyph->v0),
-            glm::vec2(glyph->u1, glyph->v1),
-            glm::vec2(glyph->u0, glyph->v1)
-        };
-
-        // Draw the glyph quad with texture coordinates
-        batch2D.addQuad(transform, texCoords, color);
-
-        // Advance cursor
-        cursorX += glyph->advance * scale;
+        runStart = runEnd;
     }
 
     batch2D.setTexture(TextureHandle{});
@@ -9678,12 +9717,13 @@ void Renderer::drawText3D(
         }
     }
 
+    std::vector<std::pair<int, Glyph>> glyphs = resolveGlyphs(font, text);
+
     // Calculate text width for centering
     float textWidth = 0.0f;
-    for (char c : text) {
-        const Glyph* glyph = fontManager->getGlyph(font, static_cast<int>(c));
-        if (glyph) {
-            textWidth += glyph->advance * scale;
+    for (const auto& [codepoint, glyph] : glyphs) {
+        if (codepoint != '\n') {
+            textWidth += glyph.advance * scale;
         }
     }
 
@@ -9694,19 +9734,26 @@ void Renderer::drawText3D(
 
     // Draw each character as a billboard, all in the atlas texture segment.
     batch3D.setTexture(fontTexture);
+    TextureHandle currentTexture = fontTexture;
 
     float cursorX = -textWidth * 0.5f; // Center the text
     float cursorY = 0.0f;
 
-    for (char c : text) {
-        if (c == '\n') {
+    for (const auto& [codepoint, glyphData] : glyphs) {
+        if (codepoint == '\n') {
             cursorX = -textWidth * 0.5f;
             cursorY -= fontData->lineHeight * scale;
             continue;
         }
 
-        const Glyph* glyph = fontManager->getGlyph(font, static_cast<int>(c));
-        if (!glyph) continue;
+        const Glyph* glyph = &glyphData;
+        if (glyph->width > 0.0f && glyph->height > 0.0f) {
+            TextureHandle texture = glyphTexture(*glyph, fontTexture);
+            if (texture.id != currentTexture.id) {
+                batch3D.setTexture(texture);
+                currentTexture = texture;
+            }
+        }
 
         // Calculate glyph position in billboard space
         float xOffset = glyph->xOffset * scale;
@@ -9747,6 +9794,44 @@ void Renderer::drawText3D(
     batch3D.setTexture(TextureHandle{});
 }
 
+std::vector<std::pair<int, Glyph>> Renderer::resolveGlyphs(FontHandle font, const std::string& text) {
+    // Copies: getGlyph rewrites a dynamic glyph's UVs on every lookup.
+    std::vector<std::pair<int, Glyph>> glyphs;
+    glyphs.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        const int codepoint = FontManager::nextCodepoint(text, i);
+        if (codepoint == '\n') {
+            glyphs.emplace_back(codepoint, Glyph{});
+        } else if (const Glyph* glyph = fontManager->getGlyph(font, codepoint)) {
+            glyphs.emplace_back(codepoint, *glyph);
+        }
+    }
+    uploadDynamicAtlas(fontManager->getGlyphAtlas());
+    return glyphs;
+}
+
+TextureHandle Renderer::glyphTexture(const Glyph& glyph, TextureHandle fontTexture) const {
+    return glyph.atlasPage == Glyph::kBakedAtlas ? fontTexture
+                                                 : fontManager->getGlyphAtlas().getPageTexture(glyph.atlasPage);
+}
+
+void Renderer::uploadDynamicAtlas(DynamicAtlas& atlas) {
+    const DynamicAtlasDesc& desc = atlas.getDesc();
+    for (Uint32 page = 0; page < atlas.pageCount(); ++page) {
+        if (atlas.getPageTexture(page).isValid()) continue;
+        TextureDesc texDesc;
+        texDesc.width = desc.pageSize;
+        texDesc.height = desc.pageSize;
+        texDesc.format = desc.channelCount == 1 ? PixelFormat::R8_UNORM : PixelFormat::RGBA8_UNORM;
+        texDesc.usage = TextureUsage::Sampled;
+        atlas.setPageTexture(page, rhi->createTexture(texDesc));
+    }
+    atlas.flushUploads([&](Uint32 page, Uint32 x, Uint32 y, Uint32 width, Uint32 height, const Uint8* texels,
+                           size_t size) {
+        rhi->updateTextureRegion(atlas.getPageTexture(page), texels, size, x, y, width, height, 0);
+    });
+}
+
 glm::vec2 Renderer::measureText(FontHandle font, const std::string& text, float scale) {
     if (fontManager) {
         return fontManager->measureText(font, text, scale);
@@ -10252,6 +10337,155 @@ void Renderer::BatchRenderer::init(RHI* rhi, GraphicsBackend backend, bool is3D,
     fmt::print("BatchRenderer initialized ({} mode)\n", is3D ? "3D" : "2D");
 }
 
+void Renderer::BatchRenderer::initSprites(RHI* rhi, bool bindlessTextures) {
+    std::string vertShaderCode;
+    std::string fragShaderCode;
+    std::string bindlessFragShaderCode;
+    if (rhiBackend == GraphicsBackend::Vulkan) {
+        vertShaderCode = readFile("shaders/RHISprite.vert.spv");
+        fragShaderCode = readFile("shaders/RHISprite.frag.spv");
+        if (bindlessTextures) bindlessFragShaderCode = readFile("shaders/RHISpriteBindless.frag.spv");
+    } else if (rhiBackend == GraphicsBackend::Metal) {
+        vertShaderCode = readFile("shaders/2d_batch.metal");
+        fragShaderCode = vertShaderCode;
+        if (bindlessTextures) bindlessFragShaderCode = vertShaderCode;
+    }
+    if (vertShaderCode.empty() || fragShaderCode.empty()) {
+        fmt::print("Warning: Failed to load sprite shaders\n");
+        return;
+    }
+    const bool metal = rhiBackend == GraphicsBackend::Metal;
+
+    ShaderDesc vertShaderDesc;
+    vertShaderDesc.stage = ShaderStage::Vertex;
+    vertShaderDesc.code = vertShaderCode.data();
+    vertShaderDesc.codeSize = vertShaderCode.size();
+    vertShaderDesc.entryPoint = metal ? "sprite_vertex" : "main";
+    spriteVertexShader = rhi->createShader(vertShaderDesc);
+
+    ShaderDesc fragShaderDesc;
+    fragShaderDesc.stage = ShaderStage::Fragment;
+    fragShaderDesc.code = fragShaderCode.data();
+    fragShaderDesc.codeSize = fragShaderCode.size();
+    fragShaderDesc.entryPoint = metal ? "sprite_fragment" : "main";
+    spriteFragmentShader = rhi->createShader(fragShaderDesc);
+
+    // Same state as the quad pipeline, but no vertex input: the vertex shader
+    // reads the SpriteInstance buffer by instance index.
+    PipelineDesc pipelineDesc;
+    pipelineDesc.vertexShader = spriteVertexShader;
+    pipelineDesc.fragmentShader = spriteFragmentShader;
+    pipelineDesc.vertexLayout.stride = 0;
+    pipelineDesc.vertexLayout.attributes = {};
+    pipelineDesc.topology = PrimitiveTopology::TriangleList;
+    pipelineDesc.blendMode = BlendMode::AlphaBlend;
+    pipelineDesc.depthTest = false;
+    pipelineDesc.depthWrite = false;
+    pipelineDesc.cullMode = CullMode::None;
+    pipelineDesc.colorAttachmentFormats = { PixelFormat::RGBA16_FLOAT };
+    pipelineDesc.hasDepthAttachment = true;
+    pipelineDesc.depthAttachmentFormat = PixelFormat::Depth32Float;
+    spritePipeline = rhi->createPipeline(pipelineDesc);
+
+    // Bindless twin: textures from the sprite table (Metal argument table at
+    // fragment buffer(0); Vulkan set 3), so a frame's sprites are one draw.
+    if (!bindlessFragShaderCode.empty()) {
+        ShaderDesc bfd = fragShaderDesc;
+        bfd.code = bindlessFragShaderCode.data();
+        bfd.codeSize = bindlessFragShaderCode.size();
+        bfd.entryPoint = metal ? "sprite_fragment_bindless" : "main";
+        spriteFragmentShaderBindless = rhi->createShader(bfd);
+        spriteTextureTable = rhi->createTextureArgumentTable(
+            spriteFragmentShaderBindless, /*bufferIndex=*/0, SpriteBatch::kMaxTextures, /*texturesPerEntry=*/1);
+        if (spriteTextureTable.isValid()) {
+            PipelineDesc bDesc = pipelineDesc;
+            bDesc.fragmentShader = spriteFragmentShaderBindless;
+            spritePipelineBindless = rhi->createPipeline(bDesc);
+        }
+    }
+
+    fmt::print("Sprite batching initialized ({})\n",
+               spritePipelineBindless.isValid() ? "bindless" : "per-texture draws");
+}
+
+void Renderer::BatchRenderer::addSprites(std::span<const SpriteDraw2D> spriteDraws) {
+    const int run = static_cast<int>(sprites.beginRun());
+    if (segments.empty() || segments.back().spriteRun != run) {
+        segments.push_back({ TextureHandle{}, quadCount, 0, run });
+    }
+    sprites.add(spriteDraws);
+}
+
+void Renderer::BatchRenderer::clearSprites() {
+    sprites.clear();
+    std::erase_if(segments, [](const Segment& seg) { return seg.spriteRun >= 0; });
+}
+
+bool Renderer::BatchRenderer::uploadSprites(RHI* rhi) {
+    if (sprites.empty() || !spritePipeline.isValid()) return false;
+
+    const bool bindless = spritePipelineBindless.isValid();
+    sprites.build(bindless);
+    const std::vector<SpriteInstance>& instances = sprites.getInstances();
+
+    // Every run goes up in one update, into this frame's slot (grown
+    // to the next power of two when it no longer fits).
+    const size_t bytes = instances.size() * sizeof(SpriteInstance);
+    BufferHandle& buffer = spriteBufferSlots[slotIndex];
+    if (spriteBufferSizes[slotIndex] < bytes) {
+        if (buffer.isValid()) rhi->destroyBuffer(buffer);
+        BufferDesc desc;
+        desc.size = std::bit_ceil(std::max<size_t>(bytes, 4096 * sizeof(SpriteInstance)));
+        desc.usage = BufferUsage::Storage;
+        desc.memoryUsage = MemoryUsage::CPUtoGPU;
+        buffer = rhi->createBuffer(desc);
+        spriteBufferSizes[slotIndex] = buffer.isValid() ? desc.size : 0;
+        if (!buffer.isValid()) return false;
+    }
+    rhi->updateBuffer(buffer, instances.data(), 0, bytes);
+
+    // Write table slots first used since the last flush. Slots are sticky, so
+    // none of these is read by a frame still in flight.
+    if (sprites.usesTextureTable()) {
+        const std::vector<TextureHandle>& tableTextures = sprites.getTableTextures();
+        for (; spriteTableWritten < tableTextures.size(); ++spriteTableWritten) {
+            const TextureHandle texture = tableTextures[spriteTableWritten];
+            rhi->writeTextureArgumentTable(spriteTextureTable, spriteTableWritten, 0,
+                                           texture.isValid() ? texture : whiteTexture);
+        }
+    }
+    totalQuads += static_cast<uint32_t>(instances.size());
+    return true;
+}
+
+void Renderer::BatchRenderer::drawSpriteRun(RHI* rhi, const glm::mat4& viewProj, uint32_t run, size_t& cursor) {
+    // Draws are sorted by run; runs whose sprites were all dropped have none.
+    const std::vector<SpriteBatch::Draw>& draws = sprites.getDraws();
+    while (cursor < draws.size() && draws[cursor].run < run) ++cursor;
+    if (cursor == draws.size() || draws[cursor].run != run) return;
+
+    rhi->bindPipeline(sprites.usesTextureTable() ? spritePipelineBindless : spritePipeline);
+    if (sprites.usesTextureTable()) rhi->bindTextureArgumentTable(spriteTextureTable);
+    // Same binding contract as the quads: Metal uniforms at buffer(1), Vulkan
+    // push constants; instances at vertex buffer(0) / set 0 binding 0.
+    rhi->setVertexBytes(&viewProj, sizeof(glm::mat4), rhiBackend == GraphicsBackend::Metal ? 1 : 0);
+    rhi->setVertexBuffer(0, spriteBufferSlots[slotIndex], 0, sprites.getInstances().size() * sizeof(SpriteInstance));
+    rhi->bindIndexBuffer(indexBuffer, 0);
+
+    for (; cursor < draws.size() && draws[cursor].run == run; ++cursor) {
+        const SpriteBatch::Draw& draw = draws[cursor];
+        if (!sprites.usesTextureTable()) {
+            TextureHandle tex = draw.texture.isValid() ? draw.texture : whiteTexture;
+            if (tex.isValid() && sampler.isValid()) {
+                rhi->setTexture(0, 0, tex, sampler);
+            }
+        }
+        // Six indices of quad 0 (vertex ids 0..3), one instance per sprite
+        rhi->drawIndexed(6, draw.instanceCount, 0, 0, draw.firstInstance);
+        drawCalls++;
+    }
+}
+
 void Renderer::BatchRenderer::nextFrame() {
     slotIndex = (slotIndex + 1) % kSlots;
     vertexBuffer = vertexBufferSlots[slotIndex];
@@ -10265,6 +10499,13 @@ void Renderer::BatchRenderer::shutdown(RHI* rhi) {
         }
     }
     vertexBuffer = {};
+    for (uint32_t i = 0; i < kSlots; i++) {
+        if (spriteBufferSlots[i].isValid()) {
+            rhi->destroyBuffer(spriteBufferSlots[i]);
+            spriteBufferSlots[i] = {};
+            spriteBufferSizes[i] = 0;
+        }
+    }
     if (indexBuffer.isValid()) {
         rhi->destroyBuffer(indexBuffer);
     }
@@ -10277,6 +10518,23 @@ void Renderer::BatchRenderer::shutdown(RHI* rhi) {
     if (fragmentShader.isValid()) {
         rhi->destroyShader(fragmentShader);
     }
+    // spriteTextureTable, like the material table, lives until the RHI
+    // shuts down (its descriptor pool / argument buffer go with it).
+    if (spritePipeline.isValid()) {
+        rhi->destroyPipeline(spritePipeline);
+    }
+    if (spritePipelineBindless.isValid()) {
+        rhi->destroyPipeline(spritePipelineBindless);
+    }
+    if (spriteVertexShader.isValid()) {
+        rhi->destroyShader(spriteVertexShader);
+    }
+    if (spriteFragmentShader.isValid()) {
+        rhi->destroyShader(spriteFragmentShader);
+    }
+    if (spriteFragmentShaderBindless.isValid()) {
+        rhi->destroyShader(spriteFragmentShaderBindless);
+    }
 }
 
 void Renderer::BatchRenderer::beginBatch(RHI* rhi, const glm::mat4& viewProj) {
@@ -10286,33 +10544,52 @@ void Renderer::BatchRenderer::beginBatch(RHI* rhi, const glm::mat4& viewProj) {
 }
 
 void Renderer::BatchRenderer::flush(RHI* rhi, const glm::mat4& viewProj, PipelineHandle overridePipeline) {
-    if (quadCount == 0) return;
+    if (quadCount == 0 && sprites.empty()) return;
 
     // Upload vertex data
-    rhi->updateBuffer(vertexBuffer, vertices.data(), 0, sizeof(Vertex2D) * vertices.size());
-
-    // Bind pipeline (override = the swapchain/UI variant)
-    rhi->bindPipeline(overridePipeline.isValid() ? overridePipeline : pipeline);
-
-    // View-projection: 2d_batch.metal declares vertices at buffer(0) and the
-    // uniforms at buffer(1) — sending the matrix to index 0 on Metal left
-    // buffer(1) UNBOUND (the vertex-buffer bind below overwrote index 0), so
-    // every batch draw read an unbound buffer: repeated GPU faults until the
-    // OS ignored the whole queue. Vulkan's contract is push constants [0,64)
-    // + vertex input binding 0 — separate namespaces, so index 0 for both.
-    if (rhiBackend == GraphicsBackend::Metal) {
-        rhi->setVertexBytes(&viewProj, sizeof(glm::mat4), 1);
-    } else {
-        rhi->setVertexBytes(&viewProj, sizeof(glm::mat4), 0);
-    }
+    if (quadCount > 0) {
+        rhi->updateBuffer(vertexBuffer, vertices.data(), 0, sizeof(Vertex2D) * vertices.size());
+    }
+    const bool drawSprites = uploadSprites(rhi);
+
+    // Quad state is bound before the first quad segment and again after
+    // each sprite run, which binds its own.
+    bool quadStateBound = false;
+    auto bindQuadState = [&] {
+        // Bind pipeline (override = the swapchain/UI variant)
+        rhi->bindPipeline(overridePipeline.isValid() ? overridePipeline : pipeline);
+
+        // View-projection: 2d_batch.metal declares vertices at buffer(0) and the
+        // uniforms at buffer(1) — sending the matrix to index 0 on Metal left
+        // buffer(1) UNBOUND (the vertex-buffer bind below overwrote index 0), so
+        // every batch draw read an unbound buffer: repeated GPU faults until the
+        // OS ignored the whole queue. Vulkan's contract is push constants [0,64)
+        // + vertex input binding 0 — separate namespaces, so index 0 for both.
+        if (rhiBackend == GraphicsBackend::Metal) {
+            rhi->setVertexBytes(&viewProj, sizeof(glm::mat4), 1);
+        } else {
+            rhi->setVertexBytes(&viewProj, sizeof(glm::mat4), 0);
+        }
 
-    // Bind vertex and index buffers
-    rhi->bindVertexBuffer(vertexBuffer, 0, 0);
-    rhi->bindIndexBuffer(indexBuffer, 0);
+        // Bind vertex and index buffers
+        rhi->bindVertexBuffer(vertexBuffer, 0, 0);
+        rhi->bindIndexBuffer(indexBuffer, 0);
+        quadStateBound = true;
+    };
 
-    // One draw per texture segment (6 indices per quad, shared vertex data)
+    // Segments in submission order: one draw per texture segment (6 indices
+    // per quad, shared vertex data), sprite runs where they were issued
+    size_t spriteCursor = 0;
     for (const Segment& seg : segments) {
+        if (seg.spriteRun >= 0) {
+            if (drawSprites) {
+                drawSpriteRun(rhi, viewProj, static_cast<uint32_t>(seg.spriteRun), spriteCursor);
+                quadStateBound = false;
+            }
+            continue;
+        }
         if (seg.quadCount == 0) continue;
+        if (!quadStateBound) bindQuadState();
         TextureHandle tex = seg.texture.isValid() ? seg.texture : whiteTexture;
         if (tex.isValid() && sampler.isValid()) {
             rhi->setTexture(0, 0, tex, sampler);
@@ -10331,16 +10608,34 @@ void Renderer::BatchRenderer::reset() {
     indices.clear();
     quadCount = 0;
     segments.clear();
+    sprites.clear();
 }
 
 // Extend the current texture segment (or open a new one) to cover the quad
 // that is about to be added.
-void Renderer::BatchRenderer::accountQuadSegment() {
+void Renderer::BatchRenderer::accountQuadSegment(uint32_t count) {
     TextureHandle want = pendingTexture.isValid() ? pendingTexture : whiteTexture;
-    if (segments.empty() || segments.back().texture.id != want.id) {
+    if (segments.empty() || segments.back().spriteRun >= 0 || segments.back().texture.id != want.id) {
         segments.push_back({ want, quadCount, 0 });
     }
-    segments.back().quadCount++;
+    segments.back().quadCount += count;
+}
+
+std::span<Renderer::Vertex2D> Renderer::BatchRenderer::appendQuads(uint32_t count) {
+    if (quadCount + count > MaxQuads && quadCount > 0 && canAutoFlush && currentRHI) {
+        flush(currentRHI, currentViewProj);
+    }
+    count = std::min(count, MaxQuads - quadCount);
+    if (count == 0) return {};
+
+    // One resize for the whole run; the defaults are what addQuad writes
+    // for everything but position / color / texCoord.
+    const size_t first = vertices.size();
+    vertices.resize(first + size_t(count) * 4, Vertex2D{ glm::vec3(0.0f), glm::vec4(1.0f), glm::vec2(0.0f), 0.0f, -1 });
+
+    accountQuadSegment(count);
+    quadCount += count;
+    return std::span<Vertex2D>(vertices.data() + first, size_t(count) * 4);
 }
 
 void Renderer::BatchRenderer::setTexture(TextureHandle texture) {
@@ -8,6 +8,7 @@
 #include "debug_draw.hpp"
 #include "graphics_mesh.hpp"
 #include "renderer_metal.hpp"
+#include "texture_cook.hpp"
 
 #include <SDL3/SDL_stdinc.h>
 #include <SDL3/SDL_timer.h>
@@ -2474,32 +2475,59 @@ public:
     void execute() override {
         auto& r = *renderer;
 
-        // Skip if no debug draw data
-        if (!r.debugDraw || !r.debugDraw->hasContent()) {
+        if (!r.debugDraw) {
             return;
         }
 
-        const auto& lineVertices = r.debugDraw->getLineVertices();
-        if (lineVertices.empty()) {
+        // Gather what every producer thread recorded this frame, plus the
+        // persistent geometry
+        r.debugDraw->flush(static_cast<double>(SDL_GetTicks()) / 1000.0);
+        if (!r.debugDraw->hasContent()) {
             return;
         }
 
-        // Get or create vertex buffer for this frame
-        auto& vertexBuffer = r.debugDrawVertexBuffers[r.currentFrameInFlight];
+        const auto& lineVertices = r.debugDraw->getLineVertices();
+        const bool drawInstances = r.debugDrawInstancePipeline && r.debugDraw->getInstanceCount() > 0;
+        if (lineVertices.empty() && !drawInstances) {
+            return;
+        }
 
-        // Calculate required buffer size
-        size_t requiredSize = lineVertices.size() * sizeof(Vapor::DebugVertex);
+        // Grow a per-frame buffer to fit and upload into it
+        auto reserve = [&](NS::SharedPtr<MTL::Buffer>& buffer, size_t requiredSize) {
+            if (!buffer || buffer->length() < requiredSize) {
+                // Allocate with some extra space to avoid frequent reallocations
+                size_t allocSize = std::max(requiredSize, size_t(64 * 1024));// Min 64KB
+                buffer = NS::TransferPtr(r.device->newBuffer(allocSize, MTL::ResourceStorageModeShared));
+            }
+        };
+        auto upload = [](MTL::Buffer* buffer, const void* data, size_t size, size_t offset) {
+            memcpy(static_cast<char*>(buffer->contents()) + offset, data, size);
+            buffer->didModifyRange(NS::Range(offset, size));
+        };
 
-        // Reallocate buffer if needed
-        if (!vertexBuffer || vertexBuffer->length() < requiredSize) {
-            // Allocate with some extra space to avoid frequent reallocations
-            size_t allocSize = std::max(requiredSize, size_t(64 * 1024));// Min 64KB
-            vertexBuffer = NS::TransferPtr(r.device->newBuffer(allocSize, MTL::ResourceStorageModeShared));
+        // Upload vertex data
+        auto& vertexBuffer = r.debugDrawVertexBuffers[r.currentFrameInFlight];
+        if (!lineVertices.empty()) {
+            size_t requiredSize = lineVertices.size() * sizeof(Vapor::DebugVertex);
+            reserve(vertexBuffer, requiredSize);
+            upload(vertexBuffer.get(), lineVertices.data(), requiredSize, 0);
         }
 
-        // Upload vertex data
-        memcpy(vertexBuffer->contents(), lineVertices.data(), requiredSize);
-        vertexBuffer->didModifyRange(NS::Range(0, requiredSize));
+        // Upload instances, all shapes back to back
+        auto& instanceBuffer = r.debugDrawInstanceBuffers[r.currentFrameInFlight];
+        std::array<size_t, Vapor::kDebugShapeCount> instanceOffsets{};
+        if (drawInstances) {
+            reserve(instanceBuffer, r.debugDraw->getInstanceCount() * sizeof(Vapor::DebugInstance));
+            size_t offset = 0;
+            for (size_t shape = 0; shape < Vapor::kDebugShapeCount; ++shape) {
+                const auto& instances = r.debugDraw->getInstances(static_cast<Vapor::DebugShape>(shape));
+                instanceOffsets[shape] = offset;
+                if (instances.empty()) continue;
+                size_t size = instances.size() * sizeof(Vapor::DebugInstance);
+                upload(instanceBuffer.get(), instances.data(), size, offset);
+                offset += size;
+            }
+        }
 
         // Create render pass descriptor
         auto passDesc = NS::TransferPtr(MTL::RenderPassDescriptor::renderPassDescriptor());
@@ -2524,21 +2552,37 @@ public:
                                    0.0, 1.0 };
         encoder->setViewport(viewport);
 
-        // Set pipeline and depth state
-        encoder->setRenderPipelineState(r.debugDrawPipeline.get());
+        // Set depth state
         encoder->setDepthStencilState(r.debugDrawDepthStencilState.get());
         encoder->setCullMode(MTL::CullModeNone);
-
-        // Set vertex buffer
-        encoder->setVertexBuffer(vertexBuffer.get(), 0, 0);
         encoder->setVertexBuffer(r.cameraDataBuffers[r.currentFrameInFlight].get(), 0, 1);
 
         // Draw lines
-        encoder->drawPrimitives(MTL::PrimitiveTypeLine, NS::UInteger(0), NS::UInteger(lineVertices.size()));
+        if (!lineVertices.empty()) {
+            encoder->setRenderPipelineState(r.debugDrawPipeline.get());
+            encoder->setVertexBuffer(vertexBuffer.get(), 0, 0);
+            encoder->drawPrimitives(MTL::PrimitiveTypeLine, NS::UInteger(0), NS::UInteger(lineVertices.size()));
+        }
 
-        encoder->endEncoding();
+        // Draw each shape's instances over its unit line list
+        if (drawInstances) {
+            encoder->setRenderPipelineState(r.debugDrawInstancePipeline.get());
+            encoder->setVertexBuffer(r.debugDrawShapeBuffer.get(), 0, 0);
+            encoder->setVertexBuffer(instanceBuffer.get(), 0, 2);
+            for (size_t shape = 0; shape < Vapor::kDebugShapeCount; ++shape) {
+                const auto& instances = r.debugDraw->getInstances(static_cast<Vapor::DebugShape>(shape));
+                if (instances.empty()) continue;
+                encoder->setVertexBufferOffset(instanceOffsets[shape], 2);
+                encoder->drawPrimitives(
+                    MTL::PrimitiveTypeLine,
+                    NS::UInteger(r.debugDrawShapeStart[shape]),
+                    NS::UInteger(r.debugDrawShapeCount[shape]),
+                    NS::UInteger(instances.size())
+                );
+            }
+        }
 
-        r.debugDraw->clear();
+        encoder->endEncoding();
     }
 };
 
@@ -3506,7 +3550,21 @@ auto Renderer_Metal::createResources() -> void {
                 );
             }
 
+            // Same state, instanced unit primitives
+            auto instanceFuncName =
+                NS::String::string("debug_instance_vertex", NS::StringEncoding::UTF8StringEncoding);
+            auto instanceMain = library->newFunction(instanceFuncName);
+            pipelineDesc->setVertexFunction(instanceMain);
+            debugDrawInstancePipeline = NS::TransferPtr(device->newRenderPipelineState(pipelineDesc, &error));
+            if (!debugDrawInstancePipeline) {
+                fmt::print(
+                    "Warning: Could not create debug draw instance pipeline: {}\n",
+                    error ? error->localizedDescription()->utf8String() : "unknown error"
+                );
+            }
+
             pipelineDesc->release();
+            instanceMain->release();
             vertexMain->release();
             fragmentMain->release();
             library->release();
@@ -3524,6 +3582,24 @@ auto Renderer_Metal::createResources() -> void {
         for (auto& buffer : debugDrawVertexBuffers) {
             buffer = nullptr;// Will be allocated on demand
         }
+        debugDrawInstanceBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& buffer : debugDrawInstanceBuffers) {
+            buffer = nullptr;// Will be allocated on demand
+        }
+
+        // Unit primitives shared by every debug shape instance
+        std::vector<Vapor::DebugShapeVertex> shapeVertices;
+        for (size_t shape = 0; shape < Vapor::kDebugShapeCount; ++shape) {
+            const auto& lines = Vapor::DebugDraw::getShapeLines(static_cast<Vapor::DebugShape>(shape));
+            debugDrawShapeStart[shape] = static_cast<Uint32>(shapeVertices.size());
+            debugDrawShapeCount[shape] = static_cast<Uint32>(lines.size());
+            shapeVertices.insert(shapeVertices.end(), lines.begin(), lines.end());
+        }
+        debugDrawShapeBuffer = NS::TransferPtr(device->newBuffer(
+            shapeVertices.data(),
+            shapeVertices.size() * sizeof(Vapor::DebugShapeVertex),
+            MTL::ResourceStorageModeShared
+        ));
     }
 
     // Create 2D batch rendering pipeline
@@ -5351,6 +5427,7 @@ void Renderer_Metal::endFrame() {
 
     frameNumber++;
     currentFrameInFlight = (currentFrameInFlight + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_fontManager.beginFrame();
     currentCommandBuffer = nullptr;
     currentDrawable = nullptr;
 }
@@ -6505,6 +6582,59 @@ auto Renderer_Metal::createComputePipeline(const std::string& filename, const st
 }
 
 auto Renderer_Metal::createTexture(const std::shared_ptr<Image>& img) -> TextureHandle {
+    if (img && (img->mipLevels > 1 || isCompressedPixelFormat(img->format))) {
+        // Cooked scene image (TextureCook): upload its stored mip chain level
+        // by level instead of blitting one. Decode to RGBA8 first when this
+        // GPU can't sample the block format.
+        RHICapabilities caps;
+        caps.textureCompressionBC = device->supportsBCTextureCompression();
+        caps.textureCompressionASTC = device->supportsFamily(MTL::GPUFamilyApple2);
+        std::shared_ptr<Image> source = img;
+        if (!isPixelFormatSupported(caps, img->format)) {
+            auto decoded = std::make_shared<Image>(*img);
+            if (!TextureCook::decompress(*decoded)) {
+                throw std::runtime_error(fmt::format("Failed to decode cooked texture at {}!\n", img->uri));
+            }
+            source = std::move(decoded);
+        }
+        MTL::PixelFormat pixelFormat = MTL::PixelFormat::PixelFormatRGBA8Unorm;
+        switch (source->format) {
+        case PixelFormat::BC1_RGBA_UNORM: pixelFormat = MTL::PixelFormatBC1_RGBA; break;
+        case PixelFormat::BC5_UNORM: pixelFormat = MTL::PixelFormatBC5_RGUnorm; break;
+        case PixelFormat::BC7_UNORM: pixelFormat = MTL::PixelFormatBC7_RGBAUnorm; break;
+        case PixelFormat::ASTC_4x4_UNORM: pixelFormat = MTL::PixelFormatASTC_4x4_LDR; break;
+        default: break;
+        }
+        const Uint32 numLevels = std::max(1u, source->mipLevels);
+
+        auto textureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
+        textureDesc->setPixelFormat(pixelFormat);
+        textureDesc->setTextureType(MTL::TextureType::TextureType2D);
+        textureDesc->setWidth(NS::UInteger(source->width));
+        textureDesc->setHeight(NS::UInteger(source->height));
+        textureDesc->setMipmapLevelCount(numLevels);
+        textureDesc->setSampleCount(1);
+        textureDesc->setStorageMode(MTL::StorageMode::StorageModeManaged);
+        textureDesc->setUsage(MTL::ResourceUsageSample | MTL::ResourceUsageRead);
+
+        auto texture = NS::TransferPtr(device->newTexture(textureDesc.get()));
+        size_t offset = 0;
+        for (Uint32 level = 0; level < numLevels; ++level) {
+            const Uint32 w = std::max(1u, source->width >> level);
+            const Uint32 h = std::max(1u, source->height >> level);
+            const size_t levelSize = pixelFormatLevelSize(source->format, w, h);
+            if (offset + levelSize > source->byteArray.size()) break;
+            texture->replaceRegion(
+                MTL::Region(0, 0, 0, w, h, 1), level, source->byteArray.data() + offset,
+                pixelFormatRowPitch(source->format, w)
+            );
+            offset += levelSize;
+        }
+
+        textures[nextTextureID] = texture;
+
+        return TextureHandle{ nextTextureID++ };
+    }
     if (img) {
         MTL::PixelFormat pixelFormat = MTL::PixelFormat::PixelFormatRGBA8Unorm;
         switch (img->channelCount) {
@@ -7205,37 +7335,38 @@ void Renderer_Metal::drawText2D(
     Font* font = m_fontManager.getFont(fontHandle);
     if (!font || font->textureHandle.id == UINT32_MAX) return;
 
-    float cursorX = position.x;
-    float cursorY = position.y;
-
-    for (char c : text) {
-        const Glyph* glyph = m_fontManager.getGlyph(fontHandle, static_cast<int>(c));
-        if (!glyph) continue;
-
-        float drawX = cursorX + glyph->xOffset * scale;
-        float drawY = cursorY + glyph->yOffset * scale + font->ascent * scale;
-        float drawW = glyph->width * scale;
-        float drawH = glyph->height * scale;
-
-        if (drawW > 0 && drawH > 0) {
-            // Adjust for centered quad rendering (batchQuadPositions uses -0.5 to 0.5)
-            float finalX = drawX + drawW * 0.5f;
-            float finalY = drawY + drawH * 0.5f;
-
-            // Create UV coordinates for this glyph
-            glm::vec2 uvs[4] = {
-                { glyph->u0, glyph->v0 },// top-left
-                { glyph->u1, glyph->v0 },// top-right
-                { glyph->u1, glyph->v1 },// bottom-right
-                { glyph->u0, glyph->v1 }// bottom-left
-            };
-
-            glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(finalX, finalY, 0.0f));
-            transform = glm::scale(transform, glm::vec3(drawW, drawH, 1.0f));
-            drawQuad2D(transform, font->textureHandle, uvs, color);
+    // Cached across frames; upload whatever glyphs the layout rasterized.
+    const TextLayout* layout = m_fontManager.layoutText(fontHandle, text, scale);
+    if (!layout || layout->quads.empty()) return;
+    if (layout->usesGlyphAtlas) uploadDynamicAtlas(m_fontManager.getGlyphAtlas());
+
+    // One span per run of quads on the same atlas page
+    const TextLayout::Quad* quads = layout->quads.data();
+    const size_t quadCount = layout->quads.size();
+    for (size_t runStart = 0; runStart < quadCount;) {
+        const Uint32 page = quads[runStart].atlasPage;
+        size_t runEnd = runStart + 1;
+        while (runEnd < quadCount && quads[runEnd].atlasPage == page) runEnd++;
+
+        const TextureHandle texture =
+            page == Glyph::kBakedAtlas ? font->textureHandle : m_fontManager.getGlyphAtlas().getPageTexture(page);
+        std::span<Batch2DVertex> span = appendBatch2DQuads(texture, static_cast<Uint32>(runEnd - runStart));
+        Batch2DVertex* v = span.data();
+        for (size_t q = 0; q < span.size() / 4; ++q, v += 4) {
+            const TextLayout::Quad& quad = quads[runStart + q];
+            const float x0 = position.x + quad.rect.x, y0 = position.y + quad.rect.y;
+            const float x1 = position.x + quad.rect.z, y1 = position.y + quad.rect.w;
+            v[0].position = glm::vec3(x0, y0, 0.0f);
+            v[1].position = glm::vec3(x1, y0, 0.0f);
+            v[2].position = glm::vec3(x1, y1, 0.0f);
+            v[3].position = glm::vec3(x0, y1, 0.0f);
+            v[0].uv = glm::vec2(quad.uv.x, quad.uv.y);
+            v[1].uv = glm::vec2(quad.uv.z, quad.uv.y);
+            v[2].uv = glm::vec2(quad.uv.z, quad.uv.w);
+            v[3].uv = glm::vec2(quad.uv.x, quad.uv.w);
+            v[0].color = v[1].color = v[2].color = v[3].color = color;
         }
-
-        cursorX += glyph->advance * scale;
+        runStart = runEnd;
     }
 }
 
@@ -7249,9 +7380,9 @@ void Renderer_Metal::drawText3D(
     // The text will be rendered as billboards facing the camera
     float cursorX = 0.0f;
 
-    for (char c : text) {
-        const Glyph* glyph = m_fontManager.getGlyph(fontHandle, static_cast<int>(c));
-        if (!glyph) continue;
+    const std::vector<Glyph> glyphs = resolveGlyphs(fontHandle, text);
+    for (const Glyph& glyphData : glyphs) {
+        const Glyph* glyph = &glyphData;
 
         float drawX = cursorX + glyph->xOffset * scale;
         float drawY = glyph->yOffset * scale + font->ascent * scale;
@@ -7275,13 +7406,59 @@ void Renderer_Metal::drawText3D(
             glm::mat4 transform = glm::translate(glm::mat4(1.0f), worldPosition);
             transform = glm::translate(transform, glm::vec3(finalX, finalY, 0.0f));
             transform = glm::scale(transform, glm::vec3(drawW, drawH, 1.0f));
-            drawQuad3D(transform, font->textureHandle, uvs, color);
+            drawQuad3D(transform, glyphTexture(*glyph, font->textureHandle), uvs, color);
         }
 
         cursorX += glyph->advance * scale;
     }
 }
 
+// UTF-8 decode + glyph lookup for one string, uploading any glyphs it
+// rasterized into the glyph atlas. Copies: getGlyph rewrites a dynamic
+// glyph's UVs on every lookup.
+auto Renderer_Metal::resolveGlyphs(FontHandle fontHandle, const std::string& text) -> std::vector<Glyph> {
+    std::vector<Glyph> glyphs;
+    glyphs.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        if (const Glyph* glyph = m_fontManager.getGlyph(fontHandle, FontManager::nextCodepoint(text, i))) {
+            glyphs.push_back(*glyph);
+        }
+    }
+    uploadDynamicAtlas(m_fontManager.getGlyphAtlas());
+    return glyphs;
+}
+
+auto Renderer_Metal::glyphTexture(const Glyph& glyph, TextureHandle fontTexture) const -> TextureHandle {
+    return glyph.atlasPage == Glyph::kBakedAtlas ? fontTexture
+                                                 : m_fontManager.getGlyphAtlas().getPageTexture(glyph.atlasPage);
+}
+
+void Renderer_Metal::uploadDynamicAtlas(DynamicAtlas& atlas) {
+    const DynamicAtlasDesc& desc = atlas.getDesc();
+    for (Uint32 page = 0; page < atlas.pageCount(); ++page) {
+        if (atlas.getPageTexture(page).isValid()) continue;
+        auto textureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
+        textureDesc->setPixelFormat(
+            desc.channelCount == 1 ? MTL::PixelFormat::PixelFormatR8Unorm : MTL::PixelFormat::PixelFormatRGBA8Unorm
+        );
+        textureDesc->setTextureType(MTL::TextureType::TextureType2D);
+        textureDesc->setWidth(NS::UInteger(desc.pageSize));
+        textureDesc->setHeight(NS::UInteger(desc.pageSize));
+        textureDesc->setMipmapLevelCount(1);
+        textureDesc->setSampleCount(1);
+        textureDesc->setStorageMode(MTL::StorageMode::StorageModeManaged);
+        textureDesc->setUsage(MTL::ResourceUsageSample | MTL::ResourceUsageRead);
+        textures[nextTextureID] = NS::TransferPtr(device->newTexture(textureDesc.get()));
+        atlas.setPageTexture(page, TextureHandle{ nextTextureID++ });
+    }
+    atlas.flushUploads([&](Uint32 page, Uint32 x, Uint32 y, Uint32 width, Uint32 height, const Uint8* texels,
+                           size_t size) {
+        auto it = textures.find(atlas.getPageTexture(page).id);
+        if (it == textures.end()) return;
+        it->second->replaceRegion(MTL::Region(x, y, 0, width, height, 1), 0, texels, width * desc.channelCount);
+    });
+}
+
 auto Renderer_Metal::measureText(FontHandle fontHandle, const std::string& text, float scale) -> glm::vec2 {
     return m_fontManager.measureText(fontHandle, text, scale);
 }
@@ -7490,6 +7667,43 @@ void Renderer_Metal::drawQuad2D(
     batch2DStats.quadCount++;
 }
 
+auto Renderer_Metal::appendBatch2DQuads(TextureHandle texture, Uint32 count) -> std::span<Batch2DVertex> {
+    beginBatch2D();// Auto-start batch
+    const auto indexCount = static_cast<Uint32>(batch2DIndices.size());
+    count = indexCount >= BatchMaxIndices ? 0 : std::min(count, (BatchMaxIndices - indexCount) / 6);
+    if (count == 0) return {};// Batch full
+
+    float textureIndex =
+        findOrAddTextureSlot(batch2DTextureSlots, batch2DTextureSlotIndex, texture, batch2DWhiteTextureHandle);
+    if (textureIndex < 0.0f) {
+        splitBatch2D();
+        textureIndex = findOrAddTextureSlot(
+            batch2DTextureSlots, batch2DTextureSlotIndex, texture, batch2DWhiteTextureHandle
+        );
+    }
+
+    const auto vertexOffset = static_cast<Uint32>(batch2DVertices.size());
+    Batch2DVertex vertex;
+    vertex.texIndex = textureIndex;
+    vertex.entityID = -1.0f;
+    batch2DVertices.resize(vertexOffset + size_t(count) * 4, vertex);
+
+    batch2DIndices.resize(batch2DIndices.size() + size_t(count) * 6);
+    Uint32* indices = batch2DIndices.data() + batch2DIndices.size() - size_t(count) * 6;
+    for (Uint32 q = 0; q < count; q++, indices += 6) {
+        const Uint32 base = vertexOffset + q * 4;
+        indices[0] = base + 0;
+        indices[1] = base + 1;
+        indices[2] = base + 2;
+        indices[3] = base + 2;
+        indices[4] = base + 3;
+        indices[5] = base + 0;
+    }
+
+    batch2DStats.quadCount += count;
+    return std::span<Batch2DVertex>(batch2DVertices.data() + vertexOffset, size_t(count) * 4);
+}
+
 void Renderer_Metal::drawRotatedQuad2D(
     const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color
 ) {
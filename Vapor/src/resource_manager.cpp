@@ -1,6 +1,8 @@
 #include "resource_manager.hpp"
 #include "asset_manager.hpp"
+#include "stats_log.hpp"
 #include <SDL3/SDL.h>
+#include <algorithm>
 #include <fmt/core.h>
 #include <tracy/Tracy.hpp>
 
@@ -8,32 +10,112 @@ using namespace Vapor;
 
 namespace Vapor {
 
+    namespace {
+
+        // Heap bytes a loaded resource keeps alive. Capacities, not sizes: what
+        // the allocator actually handed out is what the budget is about.
+        template<typename V> size_t vectorBytes(const std::vector<V>& v) {
+            return v.capacity() * sizeof(V);
+        }
+
+        size_t estimateBytes(const std::string& text) {
+            return sizeof(std::string) + text.capacity();
+        }
+
+        size_t estimateBytes(const Image& image) {
+            return sizeof(Image) + image.uri.capacity() + vectorBytes(image.byteArray);
+        }
+
+        size_t estimateBytes(const Mesh& mesh) {
+            const MeshletData& m = mesh.meshletData;
+            return sizeof(Mesh) + vectorBytes(mesh.vertices) + vectorBytes(mesh.indices) + vectorBytes(m.meshlets)
+                   + vectorBytes(m.meshletVertices) + vectorBytes(m.meshletTriangles) + vectorBytes(m.bounds)
+                   + vectorBytes(m.packedVertices) + vectorBytes(m.quantization);
+        }
+
+        // Meshes and images shared with another cache entry are counted by
+        // both; the estimate errs towards evicting early.
+        size_t estimateBytes(const Vapor::SceneBlueprint& scene) {
+            size_t bytes = sizeof(Vapor::SceneBlueprint) + vectorBytes(scene.entities) + vectorBytes(scene.lights)
+                           + vectorBytes(scene.materials) * 2;
+            for (const auto& entity : scene.entities) {
+                bytes += entity.name.capacity() + entity.source.capacity() + entity.prefab.capacity()
+                         + entity.componentsJson.capacity() + vectorBytes(entity.meshes) + vectorBytes(entity.lights)
+                         + vectorBytes(entity.components);
+            }
+            for (const auto& mesh : scene.meshes) {
+                if (mesh) bytes += estimateBytes(*mesh);
+            }
+            for (const auto& image : scene.images) {
+                if (image) bytes += estimateBytes(*image);
+            }
+            return bytes;
+        }
+
+        bool loadsBefore(LoadPriority a, uint64_t seqA, LoadPriority b, uint64_t seqB) {
+            return a != b ? a > b : seqA < seqB;
+        }
+
+        // Set on an AsyncIo thread that got an external-thread slot, i.e. may
+        // submit its decodes to the scheduler.
+        thread_local bool t_ioThreadRegistered = false;
+
+    }// namespace
+
     ResourceManager::ResourceManager(TaskScheduler& scheduler) : m_scheduler(scheduler) {
+        StatsLog::get().addSource("RES", [this](StatLine& s) {
+            const auto stats = getCacheStats();
+            s.add("memKB", getMemoryUsage() / 1024);
+            s.add("budgetKB", getMemoryBudget() / 1024);
+            s.add("img", getImageCacheSize());
+            s.add("scene", getSceneCacheSize());
+            s.add("mesh", getMeshCacheSize());
+            s.add("text", getTextCacheSize());
+            s.add("hit", stats.hits - m_reportedStats.hits);
+            s.add("miss", stats.misses - m_reportedStats.misses);
+            s.add("evict", stats.evictions - m_reportedStats.evictions);
+            s.add("evictKB", (stats.evictedBytes - m_reportedStats.evictedBytes) / 1024);
+            s.add("loads", getActiveLoadCount());
+            m_reportedStats = stats;
+        });
+
+        AsyncIo::Config io;
+        io.onThreadStart = [this]() { t_ioThreadRegistered = m_scheduler.registerExternalThread(); };
+        io.onThreadExit = [this]() {
+            if (t_ioThreadRegistered) m_scheduler.deregisterExternalThread();
+            t_ioThreadRegistered = false;
+        };
+        m_io = std::make_unique<AsyncIo>(std::move(io));
     }
 
     ResourceManager::~ResourceManager() {
         waitForAll();
+        StatsLog::get().removeSource("RES");
     }
 
     // === Image Loading ===
 
     auto ResourceManager::loadImage(
-        const std::string& path, LoadMode mode, std::function<void(std::shared_ptr<Image>)> onComplete
+        const std::string& path, LoadMode mode, std::function<void(std::shared_ptr<Image>)> onComplete, LoadPriority priority
     ) -> std::shared_ptr<Resource<Image>> {
 
+        ByteLoader<Image> bytes{
+            [path]() { return FileSystem::instance().locate(path); },
+            [path](std::vector<uint8_t>& encoded) { return AssetManager::decodeImage(path, encoded.data(), encoded.size()); },
+        };
         return loadResource<Image>(
-            path, m_imageCache, [path]() -> auto { return loadImageInternal(path); }, mode, onComplete
+            path, m_imageCache, [path]() -> auto { return loadImageInternal(path); }, mode, onComplete, priority, std::move(bytes)
         );
     }
 
     // === Scene Loading ===
 
     auto ResourceManager::loadScene(
-        const std::string& path, LoadMode mode, std::function<void(std::shared_ptr<Vapor::SceneBlueprint>)> onComplete
+        const std::string& path, LoadMode mode, std::function<void(std::shared_ptr<Vapor::SceneBlueprint>)> onComplete, LoadPriority priority
     ) -> std::shared_ptr<Resource<Vapor::SceneBlueprint>> {
 
         return loadResource<Vapor::SceneBlueprint>(
-            path, m_sceneCache, [path]() -> auto { return loadSceneInternal(path); }, mode, onComplete
+            path, m_sceneCache, [path]() -> auto { return loadSceneInternal(path); }, mode, onComplete, priority, {}
         );
     }
 
@@ -43,7 +125,8 @@ namespace Vapor {
         const std::string& path,
         const std::string& mtlBasedir,
         LoadMode mode,
-        std::function<void(std::shared_ptr<Mesh>)> onComplete
+        std::function<void(std::shared_ptr<Mesh>)> onComplete,
+        LoadPriority priority
     ) -> std::shared_ptr<Resource<Mesh>> {
 
         return loadResource<Mesh>(
@@ -51,22 +134,29 @@ namespace Vapor {
             m_meshCache,
             [path, mtlBasedir]() -> auto { return loadMeshInternal(path, mtlBasedir); },
             mode,
-            onComplete
+            onComplete,
+            priority,
+            {}
         );
     }
 
     // === Text Loading ===
 
     auto ResourceManager::loadText(
-        const std::string& path, LoadMode mode, std::function<void(std::shared_ptr<std::string>)> onComplete
+        const std::string& path, LoadMode mode, std::function<void(std::shared_ptr<std::string>)> onComplete, LoadPriority priority
     ) -> std::shared_ptr<Resource<std::string>> {
 
+        // Blocking read: text files are small enough that the hop through the
+        // I/O thread costs more than the read, and completions keep strict
+        // priority order.
         return loadResource<std::string>(
             path,
             m_textCache,
             [path]() -> std::shared_ptr<std::string> { return loadTextInternal(path); },
             mode,
-            onComplete
+            onComplete,
+            priority,
+            {}
         );
     }
 
@@ -111,10 +201,102 @@ namespace Vapor {
         return m_textCache.size();
     }
 
+    // === Memory Budget ===
+
+    void ResourceManager::setMemoryBudget(size_t bytes) {
+        m_memoryBudget.store(bytes);
+        trimCaches();
+    }
+
+    auto ResourceManager::getMemoryBudget() const -> size_t {
+        return m_memoryBudget.load();
+    }
+
+    void ResourceManager::setImageCacheBudget(size_t bytes) {
+        m_imageCache.setBudget(bytes);
+        m_imageCache.trim();
+    }
+
+    void ResourceManager::setSceneCacheBudget(size_t bytes) {
+        m_sceneCache.setBudget(bytes);
+        m_sceneCache.trim();
+    }
+
+    void ResourceManager::setMeshCacheBudget(size_t bytes) {
+        m_meshCache.setBudget(bytes);
+        m_meshCache.trim();
+    }
+
+    void ResourceManager::setTextCacheBudget(size_t bytes) {
+        m_textCache.setBudget(bytes);
+        m_textCache.trim();
+    }
+
+    auto ResourceManager::getMemoryUsage() const -> size_t {
+        return getImageMemoryUsage() + getSceneMemoryUsage() + getMeshMemoryUsage() + getTextMemoryUsage();
+    }
+
+    auto ResourceManager::getImageMemoryUsage() const -> size_t {
+        return m_imageCache.getMemoryUsage();
+    }
+
+    auto ResourceManager::getSceneMemoryUsage() const -> size_t {
+        return m_sceneCache.getMemoryUsage();
+    }
+
+    auto ResourceManager::getMeshMemoryUsage() const -> size_t {
+        return m_meshCache.getMemoryUsage();
+    }
+
+    auto ResourceManager::getTextMemoryUsage() const -> size_t {
+        return m_textCache.getMemoryUsage();
+    }
+
+    void ResourceManager::trimCaches() {
+        ResourceCacheBase* caches[] = { &m_imageCache, &m_sceneCache, &m_meshCache, &m_textCache };
+        for (ResourceCacheBase* cache : caches) cache->trim();
+
+        const size_t budget = m_memoryBudget.load();
+        if (budget == 0) return;
+        // Global LRU: evict whichever cache holds the least recently used
+        // evictable entry, one entry at a time.
+        while (getMemoryUsage() > budget) {
+            ResourceCacheBase* oldest = nullptr;
+            uint64_t oldestTick = UINT64_MAX;
+            for (ResourceCacheBase* cache : caches) {
+                const uint64_t tick = cache->getOldestEvictableTick();
+                if (tick < oldestTick) {
+                    oldestTick = tick;
+                    oldest = cache;
+                }
+            }
+            if (!oldest || !oldest->evictOldest()) break;
+        }
+    }
+
+    auto ResourceManager::getCacheStats() const -> ResourceCacheBase::Stats {
+        ResourceCacheBase::Stats total;
+        const ResourceCacheBase* caches[] = { &m_imageCache, &m_sceneCache, &m_meshCache, &m_textCache };
+        for (const ResourceCacheBase* cache : caches) {
+            const auto stats = cache->getStats();
+            total.hits += stats.hits;
+            total.misses += stats.misses;
+            total.evictions += stats.evictions;
+            total.evictedBytes += stats.evictedBytes;
+        }
+        return total;
+    }
+
     // === Task Management ===
 
     void ResourceManager::waitForAll() {
-        m_scheduler.waitForAll();
+        // A read completing after the scheduler drained submits its decode
+        // afterwards, so go round until nothing is left in either.
+        do {
+            m_scheduler.waitForAll();
+            m_io->waitIdle();
+            m_scheduler.waitForAll();
+        } while (m_activeLoads.load() > 0);
     }
 
     auto ResourceManager::hasPendingLoads() const -> bool {
@@ -125,6 +307,70 @@ namespace Vapor {
         return m_activeLoads.load();
     }
 
+    // === Load Queue ===
+
+    void ResourceManager::enqueueLoad(const void* resource, std::function<void()> run, LoadPriority priority) {
+        m_activeLoads++;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            auto job = std::make_shared<PendingLoad>(PendingLoad{ std::move(run), priority, resource });
+            m_queuedByResource[resource] = job;
+            m_loadQueue.push_back({ priority, m_loadSequence++, std::move(job) });
+            std::push_heap(m_loadQueue.begin(), m_loadQueue.end(), [](const QueuedLoad& a, const QueuedLoad& b) {
+                return loadsBefore(b.priority, b.sequence, a.priority, a.sequence);
+            });
+        }
+        m_scheduler.submitTask([this]() { runNextLoad(); });
+    }
+
+    void ResourceManager::promoteLoad(const void* resource, LoadPriority priority) {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            auto it = m_queuedByResource.find(resource);
+            if (it == m_queuedByResource.end() || it->second->priority >= priority) return;
+            it->second->priority = priority;
+            m_loadQueue.push_back({ priority, m_loadSequence++, it->second });
+            std::push_heap(m_loadQueue.begin(), m_loadQueue.end(), [](const QueuedLoad& a, const QueuedLoad& b) {
+                return loadsBefore(b.priority, b.sequence, a.priority, a.sequence);
+            });
+        }
+        // One task per heap node; the one popping the stale node finds it
+        // taken and returns.
+        m_scheduler.submitTask([this]() { runNextLoad(); });
+    }
+
+    void ResourceManager::runNextLoad() {
+        std::shared_ptr<PendingLoad> job;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            while (!m_loadQueue.empty() && !job) {
+                std::pop_heap(m_loadQueue.begin(), m_loadQueue.end(), [](const QueuedLoad& a, const QueuedLoad& b) {
+                    return loadsBefore(b.priority, b.sequence, a.priority, a.sequence);
+                });
+                std::shared_ptr<PendingLoad> next = std::move(m_loadQueue.back().job);
+                m_loadQueue.pop_back();
+                if (next->taken) continue;
+                next->taken = true;
+                m_queuedByResource.erase(next->resource);
+                job = std::move(next);
+            }
+        }
+        if (!job) return;
+        job->run();// calls finishLoad(), possibly later from a decode task
+    }
+
+    void ResourceManager::finishLoad() {
+        m_activeLoads--;
+    }
+
+    void ResourceManager::dispatchDecode(std::function<void()> work) {
+        if (t_ioThreadRegistered) {
+            m_scheduler.submitTask(std::move(work));
+        } else {
+            work();
+        }
+    }
+
     // === Internal Loading Functions ===
 
     auto ResourceManager::loadImageInternal(const std::string& path) -> std::shared_ptr<Image> {
@@ -158,7 +404,13 @@ namespace Vapor {
         ZoneScoped;
         ZoneName(path.c_str(), path.size());
 
-        // Use SDL3 to load file content
+        // Through the VFS, so packed archives serve text and shader sources.
+        if (auto bytes = FileSystem::instance().readFile(path)) {
+            return std::make_shared<std::string>(bytes->begin(), bytes->end());
+        }
+
+        // Not under any mount (e.g. a path relative to the working directory):
+        // read it from disk directly.
         size_t dataSize = 0;
         void* data = SDL_LoadFile(path.c_str(), &dataSize);
         if (!data) {
@@ -179,53 +431,94 @@ namespace Vapor {
         ResourceCache<T>& cache,
         std::function<std::shared_ptr<T>()> loader,
         LoadMode mode,
-        std::function<void(std::shared_ptr<T>)> onComplete
+        std::function<void(std::shared_ptr<T>)> onComplete,
+        LoadPriority priority,
+        ByteLoader<T> byteLoader
     ) -> std::shared_ptr<Resource<T>> {
 
-        // Check cache first
-        auto cached = cache.get(path);
-        if (cached) {
-            if (onComplete) {
-                cached->setCallback(onComplete);
-            }
-            return cached;
-        }
-
-        // Create new resource
-        auto resource = std::make_shared<Resource<T>>(path);
-        resource->setLoading();
-
+        // One locked get-or-create: of any number of concurrent requests for
+        // a path, exactly one creates the entry and loads it; the rest share the
+        // Loading resource and subscribe to its completion.
+        const ResourceKey key(path);
+        auto acquired = cache.acquire(key);
+        std::shared_ptr<Resource<T>> resource = std::move(acquired.first);
         if (onComplete) {
-            resource->setCallback(onComplete);
+            resource->addCallback(std::move(onComplete));
+        }
+        if (!acquired.second) {
+            // Still queued: a more urgent request moves it up. A sync caller
+            // is about to block on it, so that counts as High.
+            if (resource->isLoading()) {
+                promoteLoad(resource.get(), mode == LoadMode::Sync ? LoadPriority::High : priority);
+            }
+            return resource;
         }
 
-        // Add to cache immediately (even though loading)
-        cache.put(path, resource);
-
-        if (mode == LoadMode::Sync) {
-            // Synchronous loading
+        // Record the size before publishing (so a callback that checks the
+        // budget sees it), then trim with the new entry counted.
+        auto load = [this, &cache, path, hash = key.hash](
+                        const std::shared_ptr<Resource<T>>& resource, const std::function<std::shared_ptr<T>()>& produce
+                    ) {
             try {
-                auto data = loader();
+                auto data = produce();
+                cache.setSize(ResourceKey(path, hash), resource, data ? estimateBytes(*data) : 0);
                 resource->setData(data);
             } catch (const std::exception& e) {
                 resource->setFailed(e.what());
                 fmt::print("Failed to load resource {}: {}\n", path, e.what());
             }
+            trimCaches();
+        };
+
+        if (mode == LoadMode::Sync) {
+            // Synchronous loading
+            load(resource, loader);
+        } else if (!byteLoader.locate) {
+            // Asynchronous loading; the queue holds the only strong reference
+            // besides the cache, so a queued entry is never evictable.
+            enqueueLoad(
+                resource.get(),
+                [this, load, loader, resource]() {
+                    load(resource, loader);
+                    finishLoad();
+                },
+                priority
+            );
         } else {
-            // Asynchronous loading
-            m_activeLoads++;
-
-            m_scheduler.submitTask([this, resource, path, loader]() -> auto {
-                try {
-                    auto data = loader();
-                    resource->setData(data);
-                } catch (const std::exception& e) {
-                    resource->setFailed(e.what());
-                    fmt::print("Failed to load resource {}: {}\n", path, e.what());
+            // Read on the I/O thread, decode on a worker. A path that can't be
+            // located or read goes to the blocking loader, which reports the
+            // error the same way a synchronous load would.
+            auto read = [this, load, loader, byteLoader, resource]() {
+                std::optional<FileLocation> location = byteLoader.locate();
+                if (!location) {
+                    load(resource, loader);
+                    finishLoad();
+                    return;
                 }
-
-                m_activeLoads--;
-            });
+                IoRequest request{ location->osPath, location->offset, location->size };
+                m_io->read(
+                    std::move(request),
+                    [this, load, loader, byteLoader, resource, location = std::move(*location)](
+                        std::optional<std::vector<uint8_t>> bytes
+                    ) mutable {
+                        auto decode = [this, load, loader, byteLoader, resource, location, bytes = std::move(bytes)](
+                                      ) mutable {
+                            ZoneScopedN("ResourceManager::decode");
+                            if (bytes && location.archive) {
+                                bytes = location.archive->decode(*location.entry, std::move(*bytes));
+                            }
+                            if (bytes) {
+                                load(resource, [&]() { return byteLoader.decode(*bytes); });
+                            } else {
+                                load(resource, loader);
+                            }
+                            finishLoad();
+                        };
+                        dispatchDecode(std::move(decode));
+                    }
+                );
+            };
+            enqueueLoad(resource.get(), std::move(read), priority);
         }
 
         return resource;
@@ -233,16 +526,16 @@ namespace Vapor {
 
     // Explicit template instantiations
     template std::shared_ptr<Resource<Image>> ResourceManager::
-        loadResource(const std::string&, ResourceCache<Image>&, std::function<std::shared_ptr<Image>()>, LoadMode, std::function<void(std::shared_ptr<Image>)>);
+        loadResource(const std::string&, ResourceCache<Image>&, std::function<std::shared_ptr<Image>()>, LoadMode, std::function<void(std::shared_ptr<Image>)>, LoadPriority, ByteLoader<Image>);
 
     template std::shared_ptr<Resource<Vapor::SceneBlueprint>> ResourceManager::
-        loadResource(const std::string&, ResourceCache<Vapor::SceneBlueprint>&, std::function<std::shared_ptr<Vapor::SceneBlueprint>()>, LoadMode, std::function<void(std::shared_ptr<Vapor::SceneBlueprint>)>);
+        loadResource(const std::string&, ResourceCache<Vapor::SceneBlueprint>&, std::function<std::shared_ptr<Vapor::SceneBlueprint>()>, LoadMode, std::function<void(std::shared_ptr<Vapor::SceneBlueprint>)>, LoadPriority, ByteLoader<Vapor::SceneBlueprint>);
 
     template std::shared_ptr<Resource<Mesh>> ResourceManager::
-        loadResource(const std::string&, ResourceCache<Mesh>&, std::function<std::shared_ptr<Mesh>()>, LoadMode, std::function<void(std::shared_ptr<Mesh>)>);
+        loadResource(const std::string&, ResourceCache<Mesh>&, std::function<std::shared_ptr<Mesh>()>, LoadMode, std::function<void(std::shared_ptr<Mesh>)>, LoadPriority, ByteLoader<Mesh>);
 
     template std::shared_ptr<Resource<std::string>> ResourceManager::
-        loadResource(const std::string&, ResourceCache<std::string>&, std::function<std::shared_ptr<std::string>()>, LoadMode, std::function<void(std::shared_ptr<std::string>)>);
+        loadResource(const std::string&, ResourceCache<std::string>&, std::function<std::shared_ptr<std::string>()>, LoadMode, std::function<void(std::shared_ptr<std::string>)>, LoadPriority, ByteLoader<std::string>);
 
     // === Atlas Management ===
 
@@ -310,9 +603,10 @@ namespace Vapor {
         Renderer* renderer,
         Uint32 maxSize,
         Uint32 padding,
-        bool trim
+        bool trim,
+        const std::string& cachePath
     ) {
-        auto result = AtlasBaker::pack(sprites, maxSize, padding, trim);
+        auto result = AtlasBaker::packCached(cachePath, sprites, maxSize, padding, trim, &m_scheduler);
         if (!result.success || !result.atlasImage) return AtlasHandle{};
 
         result.atlas.texture = renderer->createTexture(result.atlasImage);
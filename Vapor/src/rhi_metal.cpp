@@ -131,6 +131,9 @@ bool RHI_Metal::initialize(SDL_Window* window) {
                                           device->supportsFamily(MTL::GPUFamilyMac2);
     // Bindless texture tables ride on Tier-2 argument buffers — same families.
     capabilities.bindlessTextures = capabilities.indirectCommandBuffers;
+    // BC on Macs (Apple silicon included); ASTC on every Apple GPU family.
+    capabilities.textureCompressionBC = device->supportsBCTextureCompression();
+    capabilities.textureCompressionASTC = device->supportsFamily(MTL::GPUFamilyApple2);
 
     // Backend telemetry: one grouped "[MTL]" line per --stats interval. Metal is
     // unified memory, so these counts (plus RSS) are the leak-hunt signal.
@@ -527,7 +530,8 @@ TextureHandle RHI_Metal::createTexture(const TextureDesc& desc) {
         desc.depth,
         desc.mipLevels,
         pixelFormatBytesPerPixel(desc.format),
-        convertPixelFormat(desc.format)
+        convertPixelFormat(desc.format),
+        desc.format
     };
 
     return TextureHandle{id};
@@ -562,6 +566,7 @@ TextureHandle RHI_Metal::createTextureView(const TextureViewDesc& desc) {
     r.mipLevels = 1;
     r.bytesPerPixel = it->second.bytesPerPixel;
     r.format = src->pixelFormat();  // the view keeps the source's format
+    r.pixelFormat = it->second.pixelFormat;
     textures[id] = r;
     return TextureHandle{id};
 }
@@ -1018,8 +1023,9 @@ void RHI_Metal::updateTexture(TextureHandle handle, const void* data, size_t siz
     // 3D volumes upload all their depth slices in one call; 2D textures have
     // depth 1 so this stays a single-slice copy for them.
     Uint32 mipDepth = std::max(1u, texRes.depth >> mipLevel);
-    Uint32 bytesPerRow = mipWidth * texRes.bytesPerPixel;
-    Uint32 bytesPerImage = bytesPerRow * mipHeight;
+    // Compressed formats are addressed in rows of 4x4 blocks.
+    Uint32 bytesPerRow = pixelFormatRowPitch(texRes.pixelFormat, mipWidth);
+    Uint32 bytesPerImage = Uint32(pixelFormatLevelSize(texRes.pixelFormat, mipWidth, mipHeight));
 
     if (texture->storageMode() == MTL::StorageModePrivate) {
         // GPU-only texture: copy through the staging ring into the batched
@@ -1039,6 +1045,33 @@ void RHI_Metal::updateTexture(TextureHandle handle, const void* data, size_t siz
     }
 }
 
+void RHI_Metal::updateTextureRegion(TextureHandle handle, const void* data, size_t size,
+                                    Uint32 x, Uint32 y, Uint32 width, Uint32 height, Uint32 mipLevel) {
+    auto it = textures.find(handle.id);
+    if (it == textures.end()) {
+        return;
+    }
+
+    const TextureResource& texRes = it->second;
+    MTL::Texture* texture = texRes.texture.get();
+    if (x + width > std::max(1u, texRes.width >> mipLevel) || y + height > std::max(1u, texRes.height >> mipLevel)) {
+        return;
+    }
+    Uint32 bytesPerRow = pixelFormatRowPitch(texRes.pixelFormat, width);
+
+    if (texture->storageMode() == MTL::StorageModePrivate) {
+        size_t srcOffset;
+        MTL::Buffer* srcBuf = stageData(data, size, srcOffset);
+        ensureUploadBlit()->copyFromBuffer(
+            srcBuf, srcOffset, bytesPerRow, 0,
+            MTL::Size::Make(width, height, 1),
+            texture, 0, mipLevel, MTL::Origin::Make(x, y, 0));
+    } else {
+        MTL::Region region(x, y, 0, width, height, 1);
+        texture->replaceRegion(region, mipLevel, 0, data, bytesPerRow, 0);
+    }
+}
+
 void RHI_Metal::generateMipmaps(TextureHandle handle) {
     auto it = textures.find(handle.id);
     if (it == textures.end()) {
@@ -2082,6 +2115,10 @@ MTL::PixelFormat RHI_Metal::convertPixelFormat(PixelFormat format) {
         case PixelFormat::RGB32_FLOAT: return MTL::PixelFormatRGBA32Float;
         case PixelFormat::Depth32Float: return MTL::PixelFormatDepth32Float;
         case PixelFormat::Depth24Stencil8: return MTL::PixelFormatDepth24Unorm_Stencil8;
+        case PixelFormat::BC1_RGBA_UNORM: return MTL::PixelFormatBC1_RGBA;
+        case PixelFormat::BC5_UNORM: return MTL::PixelFormatBC5_RGUnorm;
+        case PixelFormat::BC7_UNORM: return MTL::PixelFormatBC7_RGBAUnorm;
+        case PixelFormat::ASTC_4x4_UNORM: return MTL::PixelFormatASTC_4x4_LDR;
         default: return MTL::PixelFormatRGBA8Unorm;
     }
 }
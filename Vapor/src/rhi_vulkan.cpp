@@ -1649,7 +1649,24 @@ void RHI_Vulkan::updateTexture(TextureHandle handle, const void* data, size_t si
     Uint32 mipHeight = std::max(1u, tex.height >> mipLevel);
     // 3D volumes upload every depth slice in one call (depth is 1 for 2D)
     Uint32 mipDepth = std::max(1u, tex.depth >> mipLevel);
+    copyToTexture(tex, data, size, mipLevel, arrayLayer, {0, 0, 0}, {mipWidth, mipHeight, mipDepth});
+}
 
+void RHI_Vulkan::updateTextureRegion(TextureHandle handle, const void* data, size_t size,
+                                     Uint32 x, Uint32 y, Uint32 width, Uint32 height, Uint32 mipLevel) {
+    auto it = textures.find(handle.id);
+    if (it == textures.end()) {
+        return;
+    }
+    TextureResource& tex = it->second;
+    if (x + width > std::max(1u, tex.width >> mipLevel) || y + height > std::max(1u, tex.height >> mipLevel)) {
+        return;
+    }
+    copyToTexture(tex, data, size, mipLevel, 0, {static_cast<int32_t>(x), static_cast<int32_t>(y), 0}, {width, height, 1});
+}
+
+void RHI_Vulkan::copyToTexture(TextureResource& tex, const void* data, size_t size, Uint32 mipLevel,
+                               Uint32 arrayLayer, VkOffset3D offset, VkExtent3D extent) {
     // Stage through the ring (or a dedicated buffer when oversize) into the
     // batched upload stream
     VkDeviceSize srcOffset;
@@ -1693,8 +1710,8 @@ void RHI_Vulkan::updateTexture(TextureHandle handle, const void* data, size_t si
     region.imageSubresource.mipLevel = mipLevel;
     region.imageSubresource.baseArrayLayer = arrayLayer;
     region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {mipWidth, mipHeight, mipDepth};
+    region.imageOffset = offset;
+    region.imageExtent = extent;
     vkCmdCopyBufferToImage(cmd, srcBuffer, tex.image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
@@ -2810,6 +2827,16 @@ void RHI_Vulkan::createLogicalDevice() {
             deviceFeatures.multiDrawIndirect = VK_TRUE;
             capabilities.multiDrawIndirect = true;
         }
+        // Block-compressed sampling (cooked scene textures); the renderer
+        // decodes on the CPU for whichever family is missing.
+        if (supportedFeatures.textureCompressionBC) {
+            deviceFeatures.textureCompressionBC = VK_TRUE;
+            capabilities.textureCompressionBC = true;
+        }
+        if (supportedFeatures.textureCompressionASTC_LDR) {
+            deviceFeatures.textureCompressionASTC_LDR = VK_TRUE;
+            capabilities.textureCompressionASTC = true;
+        }
     }
 
     VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
@@ -3238,6 +3265,10 @@ VkFormat RHI_Vulkan::convertPixelFormat(PixelFormat format) {
         case PixelFormat::RGB32_FLOAT: return VK_FORMAT_R32G32B32_SFLOAT;
         case PixelFormat::Depth32Float: return VK_FORMAT_D32_SFLOAT;
         case PixelFormat::Depth24Stencil8: return VK_FORMAT_D24_UNORM_S8_UINT;
+        case PixelFormat::BC1_RGBA_UNORM: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case PixelFormat::BC5_UNORM: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case PixelFormat::BC7_UNORM: return VK_FORMAT_BC7_UNORM_BLOCK;
+        case PixelFormat::ASTC_4x4_UNORM: return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
         default: return VK_FORMAT_R8G8B8A8_UNORM;
     }
 }
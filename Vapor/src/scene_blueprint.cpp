@@ -2,12 +2,15 @@
 
 #include "asset_manager.hpp"
 #include "asset_serializer.hpp"
+#include "collision_shape_cache.hpp"
 #include "components.hpp"
+#include "engine_core.hpp"
 #include "file_system.hpp"
 #include "fsm.hpp"
 #include "mesh_builder.hpp"
 #include "meshlet_builder.hpp"
 #include "render_scene.hpp"
+#include "texture_cook.hpp"
 
 #include <algorithm>
 #include <cstdint>
@@ -19,6 +22,7 @@
 #include <glm/matrix.hpp>
 #include <nlohmann/json.hpp>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace Vapor;
@@ -101,6 +105,9 @@ static LightBlueprint parseLight(const json& j) {
 BlueprintComponents& BlueprintComponents::instance() {
     static BlueprintComponents registry = [] {
         BlueprintComponents r;
+        // Snapshot-only columns: always-present engine state with no JSON key.
+        r.registerSnapshot<NameComponent>("name");
+        r.registerSnapshot<TransformComponent>("transform");
         r.registerComponent<InactiveComponent>("inactive");
         r.registerComponent<SunComponent>("sun");
         r.registerComponent<MoonComponent>("moon");
@@ -133,6 +140,7 @@ BlueprintComponents& BlueprintComponents::instance() {
             w.lightningIntensity    = j.value("lightningIntensity", w.lightningIntensity);
             reg.emplace_or_replace<WeatherComponent>(e, w);
         });
+        r.registerSnapshot<WeatherComponent>("weather");
         // precipitation: hand-written for the string-authored kind.
         r.registerApplier("precipitation", [](entt::registry& reg, entt::entity e, const nlohmann::json& j) {
             PrecipitationComponent p;
@@ -143,6 +151,7 @@ BlueprintComponents& BlueprintComponents::instance() {
             p.followHeight = j.value("followHeight", p.followHeight);
             reg.emplace_or_replace<PrecipitationComponent>(e, p);
         });
+        r.registerSnapshot<PrecipitationComponent>("precipitation");
         r.registerComponent<LightningComponent>("lightning");
         r.registerComponent<VirtualCameraComponent>("virtualCamera");
         r.registerComponent<FlyCameraComponent>("flyCamera");
@@ -184,12 +193,14 @@ BlueprintComponents& BlueprintComponents::instance() {
             }
             reg.emplace_or_replace<Shape2DComponent>(e, shape);
         });
+        r.registerSnapshot<Shape2DComponent>("shape2D");
 
         // Physics: data-only here — no live Jolt body is created. The app's
         // body-create system observes {Rigidbody, Transform, Collider} with an
         // invalid BodyHandle and creates/registers the body reactively.
         r.registerComponent<BoxColliderComponent>("boxCollider");
         r.registerComponent<SphereColliderComponent>("sphereCollider");
+        r.registerComponent<MeshColliderComponent>("meshCollider");
         r.registerApplier("rigidbody", [](entt::registry& reg, entt::entity e, const nlohmann::json& j) {
             RigidbodyComponent rb;
             const std::string motion = j.value("motionType", "dynamic");
@@ -198,8 +209,15 @@ BlueprintComponents& BlueprintComponents::instance() {
                                                     : BodyMotionType::Dynamic;
             rb.syncToPhysics = j.value("syncToPhysics", rb.syncToPhysics);
             rb.syncFromPhysics = j.value("syncFromPhysics", rb.syncFromPhysics);
+            rb.interpolate = j.value("interpolate", rb.interpolate);
             reg.emplace_or_replace<RigidbodyComponent>(e, rb);
         });
+        // Restored handles name bodies the snapshot didn't capture (destroyed
+        // by the clear, or never rolled back): drop them so the body-create
+        // system builds fresh bodies at the restored transforms.
+        r.registerSnapshot<RigidbodyComponent>("rigidbody", [](entt::registry& reg) {
+            reg.view<RigidbodyComponent>().each([](RigidbodyComponent& rb) { rb.body = BodyHandle{}; });
+        });
 
         // FSM: states/transitions authored by name; actions stay out of the
         // data entirely — FSMSystem emits FSMStateChangeEvent and reaction
@@ -342,6 +360,8 @@ SceneBlueprint parseSceneBlueprint(const std::string& jsonText, const std::strin
         return bp;
     }
     bp.name = root.value("name", nameHint);
+    if (const auto cook = root.find("cook"); cook != root.end() && cook->is_object())
+        bp.compressMeshlets = cook->value("compressMeshlets", false);
     if (root.contains("materials")) {
         for (const auto& m : root.at("materials"))
             parseMaterial(m, bp);
@@ -374,6 +394,32 @@ void appendBlueprint(SceneBlueprint& dst, SceneBlueprint&& sub, int parentIndex)
     std::move(sub.images.begin(), sub.images.end(), std::back_inserter(dst.images));
     std::move(sub.lights.begin(), sub.lights.end(), std::back_inserter(dst.lights));
     std::move(sub.sources.begin(), sub.sources.end(), std::back_inserter(dst.sources));
+    if (sub.componentsRevision != dst.componentsRevision) dst.componentsRevision = 0;
+}
+
+// ── Component records ────────────────────────────────────────────────────────
+
+static void resolveEntityComponents(const EntityBlueprint& e, std::vector<ComponentRecord>& out) {
+    out.clear();
+    if (e.componentsJson.empty()) return;
+    const json components = json::parse(e.componentsJson, /*cb=*/nullptr, /*allow_exceptions=*/false);
+    if (!components.is_object()) return;
+    const auto& appliers = BlueprintComponents::instance();
+    out.reserve(components.size());
+    for (const auto& [key, value] : components.items()) {
+        const uint32_t index = appliers.find(key);
+        if (index == BlueprintComponents::npos) {
+            fmt::print(stderr, "blueprint: no applier registered for component '{}' (entity '{}')\n", key, e.name);
+            continue;
+        }
+        out.push_back({ index, appliers.decode(index, value) });
+    }
+}
+
+void resolveComponents(SceneBlueprint& blueprint) {
+    for (auto& e : blueprint.entities)
+        resolveEntityComponents(e, e.components);
+    blueprint.componentsRevision = BlueprintComponents::instance().getRevision();
 }
 
 // ── Scene cook (.vscene) ─────────────────────────────────────────────────────
@@ -386,7 +432,7 @@ void appendBlueprint(SceneBlueprint& dst, SceneBlueprint&& sub, int parentIndex)
 namespace {
 
     constexpr char kCookMagic[4] = { 'V', 'B', 'P', '1' };
-    constexpr uint32_t kCookVersion = 2;  // v2: meshlet bake config (regularize + sloppy factor)
+    constexpr uint32_t kCookVersion = 3;  // v2: meshlet bake config (regularize + sloppy factor); v3: .vtex textures
 
     uint64_t fnv1a64(const void* data, size_t n, uint64_t h) {
         const auto* p = static_cast<const uint8_t*>(data);
@@ -420,15 +466,102 @@ namespace {
         return p.string();
     }
 
-    SceneBlueprint tryLoadCook(const std::string& cookPath, const std::string& jsonText) {
+    // Cooked collision shapes ride next to the .vscene: Jolt binary state,
+    // restored on a cook hit instead of rebuilding each BVH/hull.
+    std::string shapesPathFor(const std::string& resolvedJsonPath) {
+        std::filesystem::path p(resolvedJsonPath);
+        p.replace_extension(".vshapes");
+        return p.string();
+    }
+
+    // Cooked textures (mips + block compression) ride next to the .vscene too,
+    // so the blueprint body stays small and the levels can be read on their own.
+    std::string texturesPathFor(const std::string& resolvedJsonPath) {
+        std::filesystem::path p(resolvedJsonPath);
+        p.replace_extension(".vtex");
+        return p.string();
+    }
+
+    // Mip + block-compress every image the scene's materials use, in parallel
+    // on the scheduler. The usage comes from the material slot; an image bound
+    // to several kinds of slot cooks for the strictest (Normal, then Color,
+    // then Data). bp.images is rewritten first to one entry per image, nulls
+    // dropped and material-only images appended — the exact order the
+    // serializer assigns image IDs in — so .vtex keys match on reload.
+    void cookSceneTextures(SceneBlueprint& bp, TaskScheduler* scheduler) {
+        std::vector<std::shared_ptr<Image>> images;
+        std::unordered_map<const Image*, TextureCookUsage> usages;
+        auto add = [&](const std::shared_ptr<Image>& img) {
+            if (img && usages.emplace(img.get(), TextureCookUsage::Color).second) images.push_back(img);
+        };
+        for (const auto& img : bp.images) add(img);
+        for (const auto& mat : bp.materials) {
+            if (!mat) continue;
+            for (const auto* slot : { &mat->albedoMap, &mat->normalMap, &mat->metallicMap, &mat->roughnessMap,
+                                      &mat->occlusionMap, &mat->emissiveMap, &mat->displacementMap })
+                add(*slot);
+        }
+        bp.images = std::move(images);
+
+        std::unordered_set<const Image*> normal, color;
+        for (const auto& mat : bp.materials) {
+            if (!mat) continue;
+            if (mat->normalMap) normal.insert(mat->normalMap.get());
+            for (const auto* slot : { &mat->albedoMap, &mat->emissiveMap })
+                if (*slot) color.insert(slot->get());
+            for (const auto* slot : { &mat->metallicMap, &mat->roughnessMap, &mat->occlusionMap, &mat->displacementMap })
+                if (*slot) usages[slot->get()] = TextureCookUsage::Data;
+        }
+        std::vector<TextureCook::Job> jobs;
+        for (const auto& img : bp.images) {
+            auto usage = usages[img.get()];
+            if (color.count(img.get())) usage = TextureCookUsage::Color;
+            if (normal.count(img.get())) usage = TextureCookUsage::Normal;
+            jobs.push_back({ img, usage });
+        }
+        TextureCook::cookAll(jobs, {}, scheduler);
+    }
+
+    // Pre-builds the shape of every "meshCollider" entity from the same
+    // geometry BodyCreateSystem will gather from its MeshRendererComponent.
+    // Needs Jolt initialized (Physics3D::init); otherwise nothing is cooked and
+    // bodies build their shapes at creation as before.
+    void cookCollisionShapes(const std::string& shapesPath, const SceneBlueprint& bp) {
+        auto& cache = CollisionShapeCache::instance();
+        std::vector<Uint64> keys;
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        std::vector<glm::vec3> vertices;
+        std::vector<Uint32> indices;
+        for (const auto& e : bp.entities) {
+            if (e.componentsJson.find("\"meshCollider\"") == std::string::npos) continue;
+            const json components = json::parse(e.componentsJson, /*cb=*/nullptr, /*allow_exceptions=*/false);
+            const auto it = components.find("meshCollider");
+            if (it == components.end() || !it->is_object()) continue;
+
+            meshes.clear();
+            for (int index : e.meshes)
+                if (index >= 0 && index < static_cast<int>(bp.meshes.size())) meshes.push_back(bp.meshes[index]);
+            CollisionShapeCache::gatherGeometry(meshes, vertices, indices);
+            if (vertices.empty()) continue;
+            const auto kind = it->value("convex", false) ? CollisionShapeCache::Kind::ConvexHull
+                                                          : CollisionShapeCache::Kind::Mesh;
+            if (Uint64 key = cache.cook(kind, vertices, indices)) keys.push_back(key);
+        }
+        if (!keys.empty()) cache.save(shapesPath, keys);
+    }
+
+    SceneBlueprint tryLoadCook(const std::string& cookPath, const std::string& texturesPath,
+                               const std::string& jsonText) {
         std::ifstream in(cookPath, std::ios::binary);
         if (!in.is_open()) return {};
         char magic[4] = {};
         uint32_t version = 0;
         uint64_t storedHash = 0;
+        uint8_t externalTextures = 0;
         in.read(magic, sizeof(magic));
         in.read(reinterpret_cast<char*>(&version), sizeof(version));
         in.read(reinterpret_cast<char*>(&storedHash), sizeof(storedHash));
+        in.read(reinterpret_cast<char*>(&externalTextures), sizeof(externalTextures));
         if (!in || std::memcmp(magic, kCookMagic, sizeof(magic)) != 0 || version != kCookVersion) return {};
 
         SceneBlueprint cooked;
@@ -443,24 +576,40 @@ namespace {
         // Freshness: the cooked blueprint carries the source list it was built
         // from; recompute the hash over the CURRENT files and compare.
         if (computeSourceHash(jsonText, cooked.sources) != storedHash) return {};
+        // The cooked texels live in the .vtex; one that's missing or from
+        // another cook is a miss like any stale input.
+        if (externalTextures && !TextureCook::readContainer(texturesPath, cooked.images, storedHash)) {
+            fmt::print(stderr, "scene cook: textures '{}' missing or stale; re-cooking\n", texturesPath);
+            return {};
+        }
         return cooked;
     }
 
-    void writeCook(const std::string& cookPath, const SceneBlueprint& bp, uint64_t hash) {
+    // With externalTextures, cooked images are serialized without their
+    // texels (already written to the .vtex).
+    void writeCook(const std::string& cookPath, SceneBlueprint& bp, uint64_t hash, bool externalTextures) {
         std::ofstream out(cookPath, std::ios::binary | std::ios::trunc);
         if (!out.is_open()) {
             fmt::print(stderr, "scene cook: cannot write '{}'\n", cookPath);
             return;
         }
+        const uint8_t external = externalTextures ? 1 : 0;
         out.write(kCookMagic, sizeof(kCookMagic));
         out.write(reinterpret_cast<const char*>(&kCookVersion), sizeof(kCookVersion));
         out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+        out.write(reinterpret_cast<const char*>(&external), sizeof(external));
+
+        std::vector<std::vector<Uint8>> texels(bp.images.size());
+        for (size_t i = 0; externalTextures && i < bp.images.size(); ++i)
+            if (bp.images[i] && TextureCook::isCooked(*bp.images[i])) texels[i].swap(bp.images[i]->byteArray);
         try {
             cereal::BinaryOutputArchive archive(out);
             AssetSerializer::serializeBlueprint(archive, bp);
         } catch (const std::exception& e) {
             fmt::print(stderr, "scene cook: serialize failed for '{}' ({})\n", cookPath, e.what());
         }
+        for (size_t i = 0; i < texels.size(); ++i)
+            if (!texels[i].empty()) texels[i].swap(bp.images[i]->byteArray);
     }
 
 }// namespace
@@ -468,20 +617,33 @@ namespace {
 // ── Load + expand ────────────────────────────────────────────────────────────
 
 SceneBlueprint loadSceneBlueprint(const std::string& path) {
-    auto resolved = FileSystem::instance().resolvePath(path);
-    if (!resolved) {
+    // Through the VFS, so a build that ships only the packed archive loads
+    // scenes too. Cook artifacts live next to a loose source file; a scene
+    // served from an archive is parsed and expanded on every load.
+    auto& fileSystem = FileSystem::instance();
+    const auto location = fileSystem.locate(path);
+    const auto bytes = location ? fileSystem.readFile(path) : std::nullopt;
+    if (!bytes) {
         fmt::print(stderr, "loadSceneBlueprint: '{}' not found in any search path\n", path);
         return {};
     }
-    std::ifstream file(*resolved, std::ios::binary);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    const std::string text = buffer.str();
+    const std::string text(bytes->begin(), bytes->end());
+    const bool cookable = !location->archive;
+    const std::string& sourcePath = location->osPath;
 
     // Cook fast path: hash-guarded, so a stale artifact can never be replayed.
-    const std::string cookPath = cookPathFor(*resolved);
-    if (SceneBlueprint cooked = tryLoadCook(cookPath, text); cooked.ok) {
+    const std::string cookPath = cookable ? cookPathFor(sourcePath) : std::string();
+    const std::string texturesPath = cookable ? texturesPathFor(sourcePath) : std::string();
+    if (SceneBlueprint cooked = cookable ? tryLoadCook(cookPath, texturesPath, text) : SceneBlueprint{}; cooked.ok) {
         fmt::print("loadSceneBlueprint '{}': cook hit ({} entities)\n", path, cooked.entities.size());
+        // Shapes no body uses any more (e.g. the previous scene's) go before
+        // this scene's are merged in.
+        auto& shapes = CollisionShapeCache::instance();
+        shapes.trim();
+        if (shapes.load(shapesPathFor(sourcePath))) {
+            EngineCore* engine = EngineCore::Get();
+            shapes.restoreAll(engine ? &engine->getTaskScheduler() : nullptr);
+        }
         return cooked;
     }
 
@@ -538,13 +700,33 @@ SceneBlueprint loadSceneBlueprint(const std::string& path) {
     // Bake meshlets + cluster-LOD per mesh (offline) so the mesh-shader path gets
     // them straight from the cook — otherwise Renderer::registerMesh rebuilds them
     // on every load. No-op for empty / non-triangle meshes; the result rides the
-    // .vscene via the shared (de)serializeMesh meshletData fields.
-    for (auto& m : bp.meshes) {
-        if (m) MeshletBuilder::build(*m);
+    // .vscene via the shared (de)serializeMesh meshletData fields. Meshes (and
+    // the groups inside each DAG level) bake in parallel on the engine scheduler.
+    EngineCore* engine = EngineCore::Get();
+    TaskScheduler* scheduler = engine ? &engine->getTaskScheduler() : nullptr;
+    MeshletBuilder::buildAll(bp.meshes, scheduler);
+    // Opt-in: the cook stores the packed vertices and the loader decodes them.
+    // compress leaves the decoded vertices in the mesh, so this run's render
+    // and collision geometry match what a cook hit loads.
+    if (bp.compressMeshlets)
+        for (const auto& mesh : bp.meshes)
+            if (mesh) MeshletBuilder::compress(*mesh);
+
+    // Cook material textures to GPU-ready mip chains (BC5 normals, BC7 color
+    // and data) so the renderer uploads them as-is instead of shipping RGBA8
+    // and running generateMipmaps on every load.
+    cookSceneTextures(bp, scheduler);
+
+    // Write the cook so the next load skips parsing, model decode and the
+    // texture cook entirely.
+    if (cookable) {
+        const uint64_t hash = computeSourceHash(text, bp.sources);
+        const bool externalTextures = TextureCook::writeContainer(texturesPath, bp.images, hash);
+        writeCook(cookPath, bp, hash, externalTextures);
+        cookCollisionShapes(shapesPathFor(sourcePath), bp);
     }
-
-    // Write the cook so the next load skips parsing and model decode entirely.
-    writeCook(cookPath, bp, computeSourceHash(text, bp.sources));
+    for (const auto& mesh : bp.meshes)
+        if (mesh) mesh->meshletData.clearPacked();
     return bp;
 }
 
@@ -725,17 +907,34 @@ entt::entity instantiate(
             if (!blueprint.entities[i].name.empty()) nameScope.emplace(blueprint.entities[i].name, created[i]);
         const detail::EntityNameScopeGuard scopeGuard(&nameScope);
 
+        const auto& appliers = BlueprintComponents::instance();
+        const bool resolved = blueprint.componentsRevision == appliers.getRevision();
+        std::vector<std::vector<ComponentRecord>> local;
+        if (!resolved) {
+            local.resize(blueprint.entities.size());
+            for (size_t i = 0; i < blueprint.entities.size(); ++i)
+                resolveEntityComponents(blueprint.entities[i], local[i]);
+        }
+
+        // Group the batch's records by applier, then emplace one group at a time.
+        std::vector<std::vector<entt::entity>> groupEntities(appliers.size());
+        std::vector<std::vector<const void*>> groupValues(appliers.size());
         for (size_t i = 0; i < blueprint.entities.size(); ++i) {
-            const EntityBlueprint& e = blueprint.entities[i];
-            if (e.componentsJson.empty()) continue;
-            const json components = json::parse(e.componentsJson, /*cb=*/nullptr, /*allow_exceptions=*/false);
-            if (!components.is_object()) continue;
-            for (const auto& [key, value] : components.items()) {
-                if (!BlueprintComponents::instance().apply(key, registry, created[i], value))
-                    fmt::print(stderr, "instantiate: no applier registered for component '{}' (entity '{}')\n",
-                               key, e.name);
+            for (const ComponentRecord& record : resolved ? blueprint.entities[i].components : local[i]) {
+                groupEntities[record.applier].push_back(created[i]);
+                groupValues[record.applier].push_back(record.value.get());
             }
         }
+        // Name order, as each entity's keys were applied before batching (JSON
+        // objects iterate sorted), so appliers that look at a sibling
+        // component still see it.
+        std::vector<uint32_t> order;
+        for (uint32_t a = 0; a < groupEntities.size(); ++a)
+            if (!groupEntities[a].empty()) order.push_back(a);
+        std::sort(order.begin(), order.end(),
+                  [&](uint32_t l, uint32_t r) { return appliers.getName(l) < appliers.getName(r); });
+        for (uint32_t a : order)
+            appliers.emplace(a, registry, groupEntities[a], groupValues[a]);
     }
 
     return root;
@@ -0,0 +1,155 @@
+#include "Vapor/sprite_batch.hpp"
+
+#include <algorithm>
+
+namespace Vapor {
+
+namespace {
+
+// Signed sort field → 16 biased bits, so negative layers sort first.
+Uint64 sortField(int value) {
+    return static_cast<Uint64>(std::clamp(value, -32768, 32767) + 32768);
+}
+
+}  // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Submission
+// ─────────────────────────────────────────────────────────────────────────────
+
+Uint32 SpriteBatch::textureKey(TextureHandle texture) {
+    if (texture.id == lastTextureId && lastTextureKey != kNoTexture) return lastTextureKey;
+
+    Uint32 key = kNoTexture;
+    if (auto it = textureSlots.find(texture.id); it != textureSlots.end()) {
+        key = it->second;
+    } else if (tableTextures.size() < kMaxTextures) {
+        key = static_cast<Uint32>(tableTextures.size());
+        textureSlots.emplace(texture.id, key);
+        tableTextures.push_back(texture);
+    } else if (auto ot = overflowSlots.find(texture.id); ot != overflowSlots.end()) {
+        key = ot->second;
+    } else if (kMaxTextures + overflowTextures.size() <= 0xFFFF) {
+        key = kMaxTextures + static_cast<Uint32>(overflowTextures.size());
+        overflowSlots.emplace(texture.id, key);
+        overflowTextures.push_back(texture);
+    }
+    lastTextureId  = texture.id;
+    lastTextureKey = key;
+    return key;
+}
+
+TextureHandle SpriteBatch::keyTexture(Uint32 key) const {
+    return key < kMaxTextures ? tableTextures[key] : overflowTextures[key - kMaxTextures];
+}
+
+void SpriteBatch::add(const SpriteDraw2D& sprite) {
+    const Uint32 texture = textureKey(sprite.texture);
+    if (texture == kNoTexture) return;
+
+    SpriteInstance& instance = pending.emplace_back();
+    instance.axes         = glm::vec4(sprite.axisX, sprite.axisY);
+    instance.origin       = glm::vec4(sprite.origin, 1.0f);
+    instance.uvRect       = sprite.uvRect;
+    instance.color        = sprite.tint;
+    instance.textureIndex = texture;
+    instance.entityID     = sprite.entityID;
+    instance._pad[0] = instance._pad[1] = 0;
+
+    keys.push_back(Uint64(run) << 48 | sortField(sprite.layer) << 32 | sortField(sprite.order) << 16 | texture);
+}
+
+void SpriteBatch::add(std::span<const SpriteDraw2D> sprites) {
+    pending.reserve(pending.size() + sprites.size());
+    keys.reserve(keys.size() + sprites.size());
+    for (const SpriteDraw2D& sprite : sprites) add(sprite);
+}
+
+Uint32 SpriteBatch::beginRun() {
+    if (run < kMaxRun) ++run;
+    return run;
+}
+
+void SpriteBatch::clear() {
+    pending.clear();
+    keys.clear();
+    sorted.clear();
+    draws.clear();
+    tableDraws = false;
+    run = 0;
+    overflowSlots.clear();
+    overflowTextures.clear();
+    lastTextureId  = UINT32_MAX;
+    lastTextureKey = kNoTexture;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Build
+// ─────────────────────────────────────────────────────────────────────────────
+
+// LSD radix sort of keys (8-bit digits) carrying each sprite's index along.
+// Leaves the sorted keys in `sortedKeys` and the permutation in `indices`.
+void SpriteBatch::sortKeys() {
+    const Uint32 n = static_cast<Uint32>(keys.size());
+    sortedKeys.assign(keys.begin(), keys.end());
+    indices.resize(n);
+    for (Uint32 i = 0; i < n; ++i) indices[i] = i;
+    if (n < 2) return;
+
+    // All digit histograms in one read of the keys
+    Uint32 counts[kKeyBytes][256] = {};
+    for (Uint64 key : sortedKeys) {
+        for (Uint32 b = 0; b < kKeyBytes; ++b) counts[b][(key >> (b * 8)) & 0xFF]++;
+    }
+
+    keyScratch.resize(n);
+    indexScratch.resize(n);
+    for (Uint32 b = 0; b < kKeyBytes; ++b) {
+        const Uint32 shift = b * 8;
+        Uint32* count = counts[b];
+        // Every key has the same digit here (e.g. a single layer): the pass
+        // would be an identity permutation.
+        if (count[(sortedKeys[0] >> shift) & 0xFF] == n) continue;
+
+        Uint32 offset = 0;
+        for (Uint32 d = 0; d < 256; ++d) {
+            const Uint32 c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (Uint32 i = 0; i < n; ++i) {
+            const Uint32 dst = count[(sortedKeys[i] >> shift) & 0xFF]++;
+            keyScratch[dst]   = sortedKeys[i];
+            indexScratch[dst] = indices[i];
+        }
+        sortedKeys.swap(keyScratch);
+        indices.swap(indexScratch);
+    }
+}
+
+void SpriteBatch::build(bool bindless) {
+    sorted.clear();
+    draws.clear();
+    tableDraws = bindless && overflowTextures.empty();
+    if (pending.empty()) return;
+
+    sortKeys();
+
+    const Uint32 n = static_cast<Uint32>(pending.size());
+    sorted.resize(n);
+    for (Uint32 i = 0; i < n; ++i) sorted[i] = pending[indices[i]];
+
+    // A draw never spans runs; without the table it also ends at each
+    // texture change.
+    const Uint64 splitMask = tableDraws ? ~Uint64(0) << 48 : ~Uint64(0) << 48 | 0xFFFF;
+    for (Uint32 i = 0; i < n; ++i) {
+        const Uint64 key = sortedKeys[i];
+        if (i == 0 || (key & splitMask) != (sortedKeys[i - 1] & splitMask)) {
+            const TextureHandle texture = tableDraws ? TextureHandle{} : keyTexture(static_cast<Uint32>(key & 0xFFFF));
+            draws.push_back({i, 0, texture, static_cast<Uint32>(key >> 48)});
+        }
+        draws.back().instanceCount++;
+    }
+}
+
+}  // namespace Vapor
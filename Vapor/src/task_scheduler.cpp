@@ -31,10 +31,21 @@ namespace Vapor {
             }
         }
 
-        m_scheduler->Initialize(numThreads);
+        enki::TaskSchedulerConfig config;
+        config.numTaskThreadsToCreate = numThreads - 1;// the calling thread is one of them
+        config.numExternalTaskThreads = kMaxExternalThreads;
+        m_scheduler->Initialize(config);
         m_initialized = true;
     }
 
+    bool TaskScheduler::registerExternalThread() {
+        return m_initialized && m_scheduler->RegisterExternalTaskThread();
+    }
+
+    void TaskScheduler::deregisterExternalThread() {
+        if (m_initialized) m_scheduler->DeRegisterExternalTaskThread();
+    }
+
     void TaskScheduler::shutdown() {
         if (!m_initialized) {
             return;
@@ -0,0 +1,1012 @@
+#include "texture_cook.hpp"
+#include "task_scheduler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fmt/core.h>
+#include <fstream>
+#include <optional>
+
+#ifdef VAPOR_HAS_ASTCENC
+#include <astcenc.h>
+#endif
+
+using namespace Vapor;
+
+namespace {
+
+// ── Mip generation ───────────────────────────────────────────────────────────
+// Levels are filtered in float from the previous float level (never from
+// re-quantized bytes). Color is filtered in linear light, normals as unit
+// vectors (renormalized after every level), data as stored.
+
+struct FloatImage {
+    Uint32 width = 0;
+    Uint32 height = 0;
+    std::vector<float> texels;// RGBA
+};
+
+float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float c) {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& srgbDecodeTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> t{};
+        for (int i = 0; i < 256; ++i) t[i] = srgbToLinear(i / 255.0f);
+        return t;
+    }();
+    return table;
+}
+
+FloatImage toFloat(const std::vector<Uint8>& rgba, Uint32 width, Uint32 height, TextureCookUsage usage) {
+    FloatImage image{ width, height, std::vector<float>(rgba.size()) };
+    const auto& srgb = srgbDecodeTable();
+    for (size_t i = 0; i < rgba.size(); ++i) {
+        const bool alpha = (i & 3) == 3;
+        const float unorm = rgba[i] / 255.0f;
+        if (alpha || usage == TextureCookUsage::Data) image.texels[i] = unorm;
+        else if (usage == TextureCookUsage::Color) image.texels[i] = srgb[rgba[i]];
+        else image.texels[i] = unorm * 2.0f - 1.0f;
+    }
+    return image;
+}
+
+Uint8 toUnorm8(float v) {
+    return static_cast<Uint8>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+std::vector<Uint8> toBytes(const FloatImage& image, TextureCookUsage usage) {
+    std::vector<Uint8> rgba(image.texels.size());
+    for (size_t i = 0; i < rgba.size(); ++i) {
+        const float v = image.texels[i];
+        const bool alpha = (i & 3) == 3;
+        if (alpha || usage == TextureCookUsage::Data) rgba[i] = toUnorm8(v);
+        else if (usage == TextureCookUsage::Color) rgba[i] = toUnorm8(linearToSrgb(std::max(v, 0.0f)));
+        else rgba[i] = toUnorm8(v * 0.5f + 0.5f);
+    }
+    return rgba;
+}
+
+struct Tap {
+    Uint32 index;
+    float weight;
+};
+
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 20; ++k) {
+        const double f = x / (2.0 * k);
+        term *= f * f;
+        sum += term;
+    }
+    return sum;
+}
+
+// Source taps of every destination texel along one axis, weights normalized.
+std::vector<std::vector<Tap>> buildTaps(Uint32 srcSize, Uint32 dstSize, MipFilter filter) {
+    std::vector<std::vector<Tap>> taps(dstSize);
+    const float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+    if (srcSize == dstSize) {
+        for (Uint32 i = 0; i < dstSize; ++i) taps[i].push_back({ i, 1.0f });
+        return taps;
+    }
+    // Kaiser: sinc windowed over +-2 destination texels (8 source taps at a
+    // 2:1 reduction); alpha 4 trades a little ringing for sharpness.
+    constexpr float kKaiserWidth = 2.0f;
+    constexpr double kKaiserAlpha = 4.0;
+    constexpr float kPi = 3.14159265358979f;
+    const double i0Alpha = besselI0(kKaiserAlpha);
+    const float radius = filter == MipFilter::Box ? scale * 0.5f : scale * kKaiserWidth;
+
+    for (Uint32 i = 0; i < dstSize; ++i) {
+        const float center = (static_cast<float>(i) + 0.5f) * scale;
+        const int first = static_cast<int>(std::floor(center - radius));
+        const int last = static_cast<int>(std::ceil(center + radius));
+        float total = 0.0f;
+        for (int j = first; j < last; ++j) {
+            float weight;
+            if (filter == MipFilter::Box) {
+                // Overlap of source texel [j, j+1) with the footprint.
+                weight = std::min(static_cast<float>(j + 1), center + radius) -
+                         std::max(static_cast<float>(j), center - radius);
+            } else {
+                const float u = (static_cast<float>(j) + 0.5f - center) / scale;
+                if (std::abs(u) >= kKaiserWidth) continue;
+                const float x = kPi * u;
+                const float sinc = std::abs(x) < 1e-5f ? 1.0f : std::sin(x) / x;
+                const float r = u / kKaiserWidth;
+                const float window = static_cast<float>(besselI0(kKaiserAlpha * std::sqrt(1.0 - r * r)) / i0Alpha);
+                weight = sinc * window;
+            }
+            if (weight == 0.0f) continue;
+            const Uint32 index = static_cast<Uint32>(std::clamp(j, 0, static_cast<int>(srcSize) - 1));
+            taps[i].push_back({ index, weight });
+            total += weight;
+        }
+        for (Tap& tap : taps[i]) tap.weight /= total;
+    }
+    return taps;
+}
+
+FloatImage downsample(const FloatImage& src, TextureCookUsage usage, MipFilter filter) {
+    const Uint32 dstW = std::max(1u, src.width >> 1);
+    const Uint32 dstH = std::max(1u, src.height >> 1);
+    const auto tapsX = buildTaps(src.width, dstW, filter);
+    const auto tapsY = buildTaps(src.height, dstH, filter);
+
+    // Separable: rows first into dstW x srcH, then columns.
+    std::vector<float> rows(size_t(dstW) * src.height * 4, 0.0f);
+    for (Uint32 y = 0; y < src.height; ++y) {
+        const float* srcRow = &src.texels[size_t(y) * src.width * 4];
+        float* dstRow = &rows[size_t(y) * dstW * 4];
+        for (Uint32 x = 0; x < dstW; ++x)
+            for (const Tap& tap : tapsX[x])
+                for (int c = 0; c < 4; ++c) dstRow[x * 4 + c] += srcRow[tap.index * 4 + c] * tap.weight;
+    }
+    FloatImage dst{ dstW, dstH, std::vector<float>(size_t(dstW) * dstH * 4, 0.0f) };
+    for (Uint32 y = 0; y < dstH; ++y) {
+        float* dstRow = &dst.texels[size_t(y) * dstW * 4];
+        for (const Tap& tap : tapsY[y]) {
+            const float* srcRow = &rows[size_t(tap.index) * dstW * 4];
+            for (Uint32 i = 0; i < dstW * 4; ++i) dstRow[i] += srcRow[i] * tap.weight;
+        }
+    }
+
+    // Kaiser rings past the input range; clamp so the overshoot doesn't feed
+    // the next level. Normals go back to unit length.
+    for (size_t i = 0; i < dst.texels.size(); i += 4) {
+        float* t = &dst.texels[i];
+        if (usage == TextureCookUsage::Normal) {
+            const float len = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+            if (len > 1e-6f) {
+                t[0] /= len;
+                t[1] /= len;
+                t[2] /= len;
+            } else {
+                t[0] = 0.0f;
+                t[1] = 0.0f;
+                t[2] = 1.0f;
+            }
+        } else {
+            for (int c = 0; c < 3; ++c) t[c] = std::clamp(t[c], 0.0f, 1.0f);
+        }
+        t[3] = std::clamp(t[3], 0.0f, 1.0f);
+    }
+    return dst;
+}
+
+// ── Block codecs ─────────────────────────────────────────────────────────────
+// A block is 16 RGBA8 texels, row-major. Edge blocks replicate the last
+// row / column so the padding never drags the endpoints.
+
+using Block = std::array<Uint8, 64>;
+
+Block loadBlock(const Uint8* rgba, Uint32 width, Uint32 height, Uint32 bx, Uint32 by) {
+    Block block;
+    for (Uint32 y = 0; y < 4; ++y) {
+        const Uint32 sy = std::min(by * 4 + y, height - 1);
+        for (Uint32 x = 0; x < 4; ++x) {
+            const Uint32 sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(&block[(y * 4 + x) * 4], &rgba[(size_t(sy) * width + sx) * 4], 4);
+        }
+    }
+    return block;
+}
+
+void storeBlock(const Block& block, Uint8* rgba, Uint32 width, Uint32 height, Uint32 bx, Uint32 by) {
+    for (Uint32 y = 0; y < 4 && by * 4 + y < height; ++y)
+        for (Uint32 x = 0; x < 4 && bx * 4 + x < width; ++x)
+            std::memcpy(&rgba[(size_t(by * 4 + y) * width + bx * 4 + x) * 4], &block[(y * 4 + x) * 4], 4);
+}
+
+// Principal axis of the block's first `channels` channels (power iteration on
+// the covariance), plus the mean. Degenerate blocks get a zero axis.
+template<int N>
+void principalAxis(const Block& block, std::array<float, N>& mean, std::array<float, N>& axis) {
+    mean.fill(0.0f);
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < N; ++c) mean[c] += block[i * 4 + c];
+    for (float& m : mean) m /= 16.0f;
+
+    float cov[N][N] = {};
+    for (int i = 0; i < 16; ++i)
+        for (int a = 0; a < N; ++a)
+            for (int b = 0; b < N; ++b)
+                cov[a][b] += (block[i * 4 + a] - mean[a]) * (block[i * 4 + b] - mean[b]);
+
+    axis.fill(1.0f);
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        std::array<float, N> next{};
+        for (int a = 0; a < N; ++a)
+            for (int b = 0; b < N; ++b) next[a] += cov[a][b] * axis[b];
+        float len = 0.0f;
+        for (float v : next) len += v * v;
+        len = std::sqrt(len);
+        if (len < 1e-6f) {
+            axis.fill(0.0f);
+            return;
+        }
+        for (int a = 0; a < N; ++a) axis[a] = next[a] / len;
+    }
+}
+
+// Endpoints spanning the block's extent along the principal axis.
+template<int N>
+void axisEndpoints(const Block& block, std::array<float, N>& e0, std::array<float, N>& e1) {
+    std::array<float, N> mean, axis;
+    principalAxis<N>(block, mean, axis);
+    float tMin = 0.0f, tMax = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        float t = 0.0f;
+        for (int c = 0; c < N; ++c) t += (block[i * 4 + c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    for (int c = 0; c < N; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    }
+}
+
+// Least-squares endpoints for fixed interpolation weights t (0 = e0, 1 = e1).
+// Leaves e0 / e1 alone when the weights are degenerate (all equal).
+template<int N>
+void refitEndpoints(const Block& block, const float t[16], std::array<float, N>& e0, std::array<float, N>& e1) {
+    float a = 0.0f, b = 0.0f, c = 0.0f;
+    std::array<float, N> x0{}, x1{};
+    for (int i = 0; i < 16; ++i) {
+        const float s = 1.0f - t[i];
+        a += s * s;
+        b += s * t[i];
+        c += t[i] * t[i];
+        for (int ch = 0; ch < N; ++ch) {
+            x0[ch] += s * block[i * 4 + ch];
+            x1[ch] += t[i] * block[i * 4 + ch];
+        }
+    }
+    const float det = a * c - b * b;
+    if (std::abs(det) < 1e-4f) return;
+    for (int ch = 0; ch < N; ++ch) {
+        e0[ch] = std::clamp((c * x0[ch] - b * x1[ch]) / det, 0.0f, 255.0f);
+        e1[ch] = std::clamp((a * x1[ch] - b * x0[ch]) / det, 0.0f, 255.0f);
+    }
+}
+
+// BC1: two RGB565 endpoints + 2-bit indices. Always emits 4-color mode
+// (color0 > color1); callers only pick BC1 for opaque images.
+Uint16 packRgb565(const std::array<float, 3>& c) {
+    const int r = static_cast<int>(std::lround(c[0] * 31.0f / 255.0f));
+    const int g = static_cast<int>(std::lround(c[1] * 63.0f / 255.0f));
+    const int b = static_cast<int>(std::lround(c[2] * 31.0f / 255.0f));
+    return static_cast<Uint16>((r << 11) | (g << 5) | b);
+}
+
+std::array<int, 3> unpackRgb565(Uint16 v) {
+    const int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+}
+
+void bc1Palette(Uint16 c0, Uint16 c1, std::array<std::array<int, 4>, 4>& palette) {
+    const auto a = unpackRgb565(c0), b = unpackRgb565(c1);
+    for (int ch = 0; ch < 3; ++ch) {
+        palette[0][ch] = a[ch];
+        palette[1][ch] = b[ch];
+        if (c0 > c1) {
+            palette[2][ch] = (2 * a[ch] + b[ch]) / 3;
+            palette[3][ch] = (a[ch] + 2 * b[ch]) / 3;
+        } else {
+            palette[2][ch] = (a[ch] + b[ch]) / 2;
+            palette[3][ch] = 0;
+        }
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = c0 > c1 ? 255 : 0;
+}
+
+void encodeBC1(const Block& block, Uint8* out) {
+    constexpr float kWeight[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    std::array<float, 3> e0, e1;
+    axisEndpoints<3>(block, e0, e1);
+
+    Uint16 bestC0 = 0, bestC1 = 0;
+    Uint32 bestIndices = 0;
+    int bestError = INT32_MAX;
+    for (int pass = 0; pass < 3; ++pass) {
+        Uint16 c0 = packRgb565(e0), c1 = packRgb565(e1);
+        if (c0 < c1) std::swap(c0, c1);
+        std::array<std::array<int, 4>, 4> palette;
+        bc1Palette(c0, c1, palette);
+        const int colors = c0 > c1 ? 4 : 1;// equal endpoints: index 0 only
+
+        Uint32 indices = 0;
+        int error = 0;
+        float t[16];
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = INT32_MAX;
+            for (int p = 0; p < colors; ++p) {
+                int dist = 0;
+                for (int ch = 0; ch < 3; ++ch) {
+                    const int d = block[i * 4 + ch] - palette[p][ch];
+                    dist += d * d;
+                }
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= Uint32(best) << (i * 2);
+            error += bestDist;
+            t[i] = kWeight[best];
+        }
+        if (error < bestError) {
+            bestError = error;
+            bestC0 = c0;
+            bestC1 = c1;
+            bestIndices = indices;
+        }
+        if (error == 0 || colors == 1) break;
+        // Refit against the quantized palette's indices; e0 pairs with c0.
+        std::array<float, 3> r0 = e0, r1 = e1;
+        if (packRgb565(e0) < packRgb565(e1)) std::swap(r0, r1);
+        refitEndpoints<3>(block, t, r0, r1);
+        e0 = r0;
+        e1 = r1;
+    }
+    out[0] = static_cast<Uint8>(bestC0);
+    out[1] = static_cast<Uint8>(bestC0 >> 8);
+    out[2] = static_cast<Uint8>(bestC1);
+    out[3] = static_cast<Uint8>(bestC1 >> 8);
+    std::memcpy(out + 4, &bestIndices, 4);
+}
+
+void decodeBC1(const Uint8* in, Block& block) {
+    const Uint16 c0 = static_cast<Uint16>(in[0] | (in[1] << 8));
+    const Uint16 c1 = static_cast<Uint16>(in[2] | (in[3] << 8));
+    std::array<std::array<int, 4>, 4> palette;
+    bc1Palette(c0, c1, palette);
+    Uint32 indices;
+    std::memcpy(&indices, in + 4, 4);
+    for (int i = 0; i < 16; ++i) {
+        const auto& color = palette[(indices >> (i * 2)) & 3];
+        for (int ch = 0; ch < 4; ++ch) block[i * 4 + ch] = static_cast<Uint8>(color[ch]);
+    }
+}
+
+// BC4: one channel, two 8-bit endpoints + 3-bit indices. Emits 8-value mode
+// (r0 > r1), searching a small inset of the min/max range.
+void bc4Palette(int r0, int r1, int palette[8]) {
+    palette[0] = r0;
+    palette[1] = r1;
+    if (r0 > r1) {
+        for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * r0 + (i - 1) * r1 + 3) / 7;
+    } else {
+        for (int i = 2; i < 6; ++i) palette[i] = ((6 - i) * r0 + (i - 1) * r1 + 2) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encodeBC4(const Block& block, int channel, Uint8* out) {
+    int lo = 255, hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        lo = std::min<int>(lo, block[i * 4 + channel]);
+        hi = std::max<int>(hi, block[i * 4 + channel]);
+    }
+    std::memset(out, 0, 8);
+    if (lo == hi) {
+        out[0] = out[1] = static_cast<Uint8>(lo);
+        return;// all indices 0
+    }
+
+    uint64_t bestBits = 0;
+    int bestError = INT32_MAX, bestR0 = hi, bestR1 = lo;
+    const int inset = std::min(2, (hi - lo) / 4);
+    for (int d0 = 0; d0 <= inset; ++d0) {
+        for (int d1 = 0; d1 <= inset; ++d1) {
+            const int r0 = hi - d0, r1 = lo + d1;
+            if (r0 <= r1) continue;
+            int palette[8];
+            bc4Palette(r0, r1, palette);
+            uint64_t bits = 0;
+            int error = 0;
+            for (int i = 0; i < 16; ++i) {
+                const int v = block[i * 4 + channel];
+                int best = 0, bestDist = INT32_MAX;
+                for (int p = 0; p < 8; ++p) {
+                    const int dist = (v - palette[p]) * (v - palette[p]);
+                    if (dist < bestDist) {
+                        bestDist = dist;
+                        best = p;
+                    }
+                }
+                bits |= uint64_t(best) << (i * 3);
+                error += bestDist;
+            }
+            if (error < bestError) {
+                bestError = error;
+                bestBits = bits;
+                bestR0 = r0;
+                bestR1 = r1;
+            }
+        }
+    }
+    out[0] = static_cast<Uint8>(bestR0);
+    out[1] = static_cast<Uint8>(bestR1);
+    for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<Uint8>(bestBits >> (i * 8));
+}
+
+void decodeBC4(const Uint8* in, int channel, Block& block) {
+    int palette[8];
+    bc4Palette(in[0], in[1], palette);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) bits |= uint64_t(in[2 + i]) << (i * 8);
+    for (int i = 0; i < 16; ++i) block[i * 4 + channel] = static_cast<Uint8>(palette[(bits >> (i * 3)) & 7]);
+}
+
+// BC5 = BC4 red + BC4 green. The decoder rebuilds blue as the unit normal's z
+// (what the shaders do) so CPU-decoded normal maps stay usable as RGB.
+void encodeBC5(const Block& block, Uint8* out) {
+    encodeBC4(block, 0, out);
+    encodeBC4(block, 1, out + 8);
+}
+
+void decodeBC5(const Uint8* in, Block& block) {
+    decodeBC4(in, 0, block);
+    decodeBC4(in + 8, 1, block);
+    for (int i = 0; i < 16; ++i) {
+        const float x = block[i * 4 + 0] / 127.5f - 1.0f;
+        const float y = block[i * 4 + 1] / 127.5f - 1.0f;
+        const float z = std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+        block[i * 4 + 2] = toUnorm8(z * 0.5f + 0.5f);
+        block[i * 4 + 3] = 255;
+    }
+}
+
+// BC7, mode 6 only: one subset, RGBA 7-bit endpoints + a p-bit each, 4-bit
+// indices. The best single-subset mode for smooth content and alpha alike;
+// the multi-partition modes would buy a few dB on sharp-edged blocks at many
+// times the encode cost.
+constexpr int kBC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct BitWriter {
+    Uint8* out;
+    Uint32 pos = 0;
+    void write(Uint32 value, Uint32 bits) {
+        for (Uint32 b = 0; b < bits; ++b, ++pos)
+            if ((value >> b) & 1) out[pos >> 3] |= static_cast<Uint8>(1u << (pos & 7));
+    }
+};
+
+struct BitReader {
+    const Uint8* in;
+    Uint32 pos = 0;
+    Uint32 read(Uint32 bits) {
+        Uint32 value = 0;
+        for (Uint32 b = 0; b < bits; ++b, ++pos) value |= Uint32((in[pos >> 3] >> (pos & 7)) & 1) << b;
+        return value;
+    }
+};
+
+struct BC7Mode6 {
+    std::array<int, 4> c0{}, c1{};// 7-bit
+    int p0 = 0, p1 = 0;
+    std::array<Uint8, 16> indices{};
+    int error = INT32_MAX;
+};
+
+int bc7Quantize(float v, int pbit) {
+    return std::clamp(static_cast<int>(std::lround((v - pbit) * 0.5f)), 0, 127);
+}
+
+// Quantize e0/e1 under every p-bit pair and keep the pair (with its optimal
+// indices) that reconstructs the block best.
+BC7Mode6 bc7FitMode6(const Block& block, const std::array<float, 4>& e0, const std::array<float, 4>& e1) {
+    BC7Mode6 best;
+    for (int p0 = 0; p0 < 2; ++p0) {
+        for (int p1 = 0; p1 < 2; ++p1) {
+            BC7Mode6 fit;
+            fit.p0 = p0;
+            fit.p1 = p1;
+            int palette[16][4];
+            for (int ch = 0; ch < 4; ++ch) {
+                fit.c0[ch] = bc7Quantize(e0[ch], p0);
+                fit.c1[ch] = bc7Quantize(e1[ch], p1);
+                const int a = fit.c0[ch] * 2 + p0, b = fit.c1[ch] * 2 + p1;
+                for (int w = 0; w < 16; ++w)
+                    palette[w][ch] = ((64 - kBC7Weights4[w]) * a + kBC7Weights4[w] * b + 32) >> 6;
+            }
+            fit.error = 0;
+            for (int i = 0; i < 16; ++i) {
+                int bestIndex = 0, bestDist = INT32_MAX;
+                for (int w = 0; w < 16; ++w) {
+                    int dist = 0;
+                    for (int ch = 0; ch < 4; ++ch) {
+                        const int d = block[i * 4 + ch] - palette[w][ch];
+                        dist += d * d;
+                    }
+                    if (dist < bestDist) {
+                        bestDist = dist;
+                        bestIndex = w;
+                    }
+                }
+                fit.indices[i] = static_cast<Uint8>(bestIndex);
+                fit.error += bestDist;
+            }
+            if (fit.error < best.error) best = fit;
+        }
+    }
+    return best;
+}
+
+void encodeBC7(const Block& block, Uint8* out) {
+    std::array<float, 4> e0, e1;
+    axisEndpoints<4>(block, e0, e1);
+    BC7Mode6 best = bc7FitMode6(block, e0, e1);
+    for (int pass = 0; pass < 2 && best.error > 0; ++pass) {
+        float t[16];
+        for (int i = 0; i < 16; ++i) t[i] = kBC7Weights4[best.indices[i]] / 64.0f;
+        refitEndpoints<4>(block, t, e0, e1);
+        const BC7Mode6 refit = bc7FitMode6(block, e0, e1);
+        if (refit.error >= best.error) break;
+        best = refit;
+    }
+
+    // The anchor (texel 0) index is stored without its top bit: flip the
+    // endpoints so that bit is 0.
+    if (best.indices[0] & 8) {
+        std::swap(best.c0, best.c1);
+        std::swap(best.p0, best.p1);
+        for (Uint8& index : best.indices) index = static_cast<Uint8>(15 - index);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.write(1u << 6, 7);// mode 6
+    for (int ch = 0; ch < 4; ++ch) {
+        writer.write(static_cast<Uint32>(best.c0[ch]), 7);
+        writer.write(static_cast<Uint32>(best.c1[ch]), 7);
+    }
+    writer.write(static_cast<Uint32>(best.p0), 1);
+    writer.write(static_cast<Uint32>(best.p1), 1);
+    for (int i = 0; i < 16; ++i) writer.write(best.indices[i], i == 0 ? 3 : 4);
+}
+
+// Mode 6 only (what encodeBC7 emits); false for any other mode.
+bool decodeBC7(const Uint8* in, Block& block) {
+    if ((in[0] & 0x7F) != 0x40) return false;
+    BitReader reader{ in };
+    reader.read(7);
+    int c0[4], c1[4];
+    for (int ch = 0; ch < 4; ++ch) {
+        c0[ch] = static_cast<int>(reader.read(7));
+        c1[ch] = static_cast<int>(reader.read(7));
+    }
+    const int p0 = static_cast<int>(reader.read(1)), p1 = static_cast<int>(reader.read(1));
+    for (int i = 0; i < 16; ++i) {
+        const int w = kBC7Weights4[reader.read(i == 0 ? 3 : 4)];
+        for (int ch = 0; ch < 4; ++ch) {
+            const int a = c0[ch] * 2 + p0, b = c1[ch] * 2 + p1;
+            block[i * 4 + ch] = static_cast<Uint8>(((64 - w) * a + w * b + 32) >> 6);
+        }
+    }
+    return true;
+}
+
+// ── ASTC (astcenc) ───────────────────────────────────────────────────────────
+
+#ifdef VAPOR_HAS_ASTCENC
+struct AstcContext {
+    astcenc_context* context = nullptr;
+    explicit AstcContext(bool decompressOnly) {
+        astcenc_config config;
+        const unsigned flags = decompressOnly ? ASTCENC_FLG_DECOMPRESS_ONLY : 0;
+        if (astcenc_config_init(ASTCENC_PRF_LDR, 4, 4, 1, ASTCENC_PRE_MEDIUM, flags, &config) != ASTCENC_SUCCESS ||
+            astcenc_context_alloc(&config, 1, &context) != ASTCENC_SUCCESS) {
+            context = nullptr;
+        }
+    }
+    ~AstcContext() {
+        if (context) astcenc_context_free(context);
+    }
+    AstcContext(const AstcContext&) = delete;
+    AstcContext& operator=(const AstcContext&) = delete;
+};
+
+bool astcLevel(bool compress, Uint8* rgba, Uint32 width, Uint32 height, Uint8* blocks, size_t blockBytes) {
+    AstcContext ctx(!compress);
+    if (!ctx.context) return false;
+    void* slices[] = { rgba };
+    astcenc_image image{};
+    image.dim_x = width;
+    image.dim_y = height;
+    image.dim_z = 1;
+    image.data_type = ASTCENC_TYPE_U8;
+    image.data = slices;
+    const astcenc_swizzle swizzle{ ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A };
+    const astcenc_error status =
+        compress ? astcenc_compress_image(ctx.context, &image, &swizzle, blocks, blockBytes, 0)
+                 : astcenc_decompress_image(ctx.context, blocks, blockBytes, &image, &swizzle, 0);
+    return status == ASTCENC_SUCCESS;
+}
+#endif
+
+// ── Levels ───────────────────────────────────────────────────────────────────
+
+std::vector<Uint8> encodeLevel(std::vector<Uint8>& rgba, Uint32 width, Uint32 height, PixelFormat format,
+                               TaskScheduler* scheduler) {
+    std::vector<Uint8> out(pixelFormatLevelSize(format, width, height));
+#ifdef VAPOR_HAS_ASTCENC
+    if (format == PixelFormat::ASTC_4x4_UNORM) {
+        if (!astcLevel(true, rgba.data(), width, height, out.data(), out.size())) out.clear();
+        return out;
+    }
+#endif
+    const Uint32 blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const Uint32 blockBytes = pixelFormatBlockBytes(format);
+    TaskScheduler::forRange(scheduler, blocksY, 8, [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 by = begin; by < end; ++by) {
+            for (Uint32 bx = 0; bx < blocksX; ++bx) {
+                const Block block = loadBlock(rgba.data(), width, height, bx, by);
+                Uint8* dst = &out[(size_t(by) * blocksX + bx) * blockBytes];
+                switch (format) {
+                    case PixelFormat::BC1_RGBA_UNORM: encodeBC1(block, dst); break;
+                    case PixelFormat::BC5_UNORM: encodeBC5(block, dst); break;
+                    default: encodeBC7(block, dst); break;
+                }
+            }
+        }
+    });
+    return out;
+}
+
+bool decodeLevel(const Uint8* data, Uint32 width, Uint32 height, PixelFormat format, Uint8* rgba) {
+#ifdef VAPOR_HAS_ASTCENC
+    if (format == PixelFormat::ASTC_4x4_UNORM)
+        return astcLevel(false, rgba, width, height, const_cast<Uint8*>(data),
+                         pixelFormatLevelSize(format, width, height));
+#endif
+    if (format == PixelFormat::ASTC_4x4_UNORM) return false;
+    const Uint32 blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const Uint32 blockBytes = pixelFormatBlockBytes(format);
+    for (Uint32 by = 0; by < blocksY; ++by) {
+        for (Uint32 bx = 0; bx < blocksX; ++bx) {
+            const Uint8* src = &data[(size_t(by) * blocksX + bx) * blockBytes];
+            Block block;
+            switch (format) {
+                case PixelFormat::BC1_RGBA_UNORM: decodeBC1(src, block); break;
+                case PixelFormat::BC5_UNORM: decodeBC5(src, block); break;
+                case PixelFormat::BC7_UNORM:
+                    if (!decodeBC7(src, block)) return false;
+                    break;
+                default: return false;
+            }
+            storeBlock(block, rgba, width, height, bx, by);
+        }
+    }
+    return true;
+}
+
+PixelFormat chooseFormat(TextureCookUsage usage, const TextureCookOptions& options, bool opaque) {
+#ifdef VAPOR_HAS_ASTCENC
+    if (options.target == TextureCookTarget::Mobile) return PixelFormat::ASTC_4x4_UNORM;
+#endif
+    if (usage == TextureCookUsage::Normal) return PixelFormat::BC5_UNORM;
+    if (opaque && options.allowBC1) return PixelFormat::BC1_RGBA_UNORM;
+    return PixelFormat::BC7_UNORM;
+}
+
+// Loader output as tightly packed RGBA8, or nullopt if the sizes disagree.
+std::optional<std::vector<Uint8>> expandToRgba(const Image& image) {
+    const size_t texels = size_t(image.width) * image.height;
+    const Uint32 channels = image.channelCount;
+    if (channels < 1 || channels > 4 || image.byteArray.size() != texels * channels) return std::nullopt;
+    if (channels == 4) return image.byteArray;
+    std::vector<Uint8> rgba(texels * 4);
+    for (size_t i = 0; i < texels; ++i) {
+        const Uint8* src = &image.byteArray[i * channels];
+        Uint8* dst = &rgba[i * 4];
+        if (channels == 3) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+        } else {// gray, or gray + alpha
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = channels == 2 ? src[1] : 255;
+        }
+    }
+    return rgba;
+}
+
+// ── .vtex container ──────────────────────────────────────────────────────────
+// Header { 'VTEX', version, sourceHash, count, reserved }, then per image
+// { imageIndex, formatCode, width, height, channelCount, mipLevels,
+//   mipLevels x { offset, size } } (level 0 first), then the level data,
+// smallest level first, each 16-byte aligned. Little-endian, like VPAK.
+// Formats are stored as their own codes so PixelFormat can be reordered.
+
+constexpr char kVtexMagic[4] = { 'V', 'T', 'E', 'X' };
+constexpr uint32_t kVtexVersion = 1;
+constexpr uint32_t kVtexMaxLevels = 32;
+
+struct VtexFormat {
+    uint32_t code;
+    PixelFormat format;
+};
+constexpr VtexFormat kVtexFormats[] = {
+    { 1, PixelFormat::RGBA8_UNORM },
+    { 2, PixelFormat::BC1_RGBA_UNORM },
+    { 3, PixelFormat::BC5_UNORM },
+    { 4, PixelFormat::BC7_UNORM },
+    { 5, PixelFormat::ASTC_4x4_UNORM },
+};
+
+uint32_t vtexCode(PixelFormat format) {
+    for (const auto& f : kVtexFormats)
+        if (f.format == format) return f.code;
+    return 0;
+}
+
+size_t alignUp(size_t v, size_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+} // namespace
+
+namespace Vapor {
+
+std::vector<std::vector<Uint8>> TextureCook::buildMipChain(const std::vector<Uint8>& rgba, Uint32 width,
+                                                          Uint32 height, TextureCookUsage usage, MipFilter filter) {
+    std::vector<std::vector<Uint8>> levels;
+    levels.push_back(rgba);
+    FloatImage current = toFloat(rgba, width, height, usage);
+    while (current.width > 1 || current.height > 1) {
+        current = downsample(current, usage, filter);
+        levels.push_back(toBytes(current, usage));
+    }
+    return levels;
+}
+
+bool TextureCook::cook(Image& image, TextureCookUsage usage, const TextureCookOptions& options,
+                       TaskScheduler* scheduler) {
+    if (image.byteArray.empty() || image.width == 0 || image.height == 0 || isCooked(image)) return false;
+    auto rgba = expandToRgba(image);
+    if (!rgba) return false;
+
+    const bool opaque = [&] {
+        for (size_t i = 3; i < rgba->size(); i += 4)
+            if ((*rgba)[i] != 255) return false;
+        return true;
+    }();
+#ifndef VAPOR_HAS_ASTCENC
+    if (options.target == TextureCookTarget::Mobile) {
+        static std::atomic<bool> warned{ false };
+        if (!warned.exchange(true))
+            fmt::print(stderr, "texture cook: built without astcenc; cooking BCn instead of ASTC\n");
+    }
+#endif
+    const PixelFormat format = chooseFormat(usage, options, opaque);
+
+    std::vector<std::vector<Uint8>> levels;
+    if (options.generateMips) {
+        levels = buildMipChain(*rgba, image.width, image.height, usage, options.mipFilter);
+    } else {
+        levels.push_back(std::move(*rgba));
+    }
+
+    std::vector<Uint8> packed;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        const Uint32 w = std::max(1u, image.width >> level);
+        const Uint32 h = std::max(1u, image.height >> level);
+        const auto encoded = encodeLevel(levels[level], w, h, format, scheduler);
+        if (encoded.empty()) return false;
+        packed.insert(packed.end(), encoded.begin(), encoded.end());
+    }
+
+    image.byteArray = std::move(packed);
+    image.format = format;
+    image.mipLevels = static_cast<Uint32>(levels.size());
+    image.channelCount = 4;
+    return true;
+}
+
+void TextureCook::cookAll(const std::vector<Job>& jobs, const TextureCookOptions& options, TaskScheduler* scheduler) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<size_t> sourceBytes(jobs.size(), 0), cookedBytes(jobs.size(), 0);
+    TaskScheduler::forRange(scheduler, jobs.size(), 1, [&](Uint32 begin, Uint32 end, Uint32) {
+        for (Uint32 i = begin; i < end; ++i) {
+            Image* image = jobs[i].image.get();
+            if (!image) continue;
+            const size_t before = size_t(image->width) * image->height * 4;
+            if (!cook(*image, jobs[i].usage, options, scheduler)) continue;
+            sourceBytes[i] = before;
+            cookedBytes[i] = image->byteArray.size();
+        }
+    });
+
+    size_t count = 0, before = 0, after = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (!cookedBytes[i]) continue;
+        ++count;
+        before += sourceBytes[i];
+        after += cookedBytes[i];
+    }
+    if (count == 0) return;
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("texture cook: {} images, {:.1f} MB RGBA8 -> {:.1f} MB with mips, {:.1f} ms\n", count,
+               before / (1024.0 * 1024.0), after / (1024.0 * 1024.0), ms);
+}
+
+bool TextureCook::decompress(Image& image) {
+    if (!isCompressedPixelFormat(image.format)) return true;
+    const Uint32 levels = std::max(1u, image.mipLevels);
+    std::vector<Uint8> rgba;
+    size_t offset = 0;
+    for (Uint32 level = 0; level < levels; ++level) {
+        const Uint32 w = std::max(1u, image.width >> level);
+        const Uint32 h = std::max(1u, image.height >> level);
+        const size_t size = pixelFormatLevelSize(image.format, w, h);
+        if (offset + size > image.byteArray.size()) return false;
+        const size_t dst = rgba.size();
+        rgba.resize(dst + size_t(w) * h * 4);
+        if (!decodeLevel(image.byteArray.data() + offset, w, h, image.format, rgba.data() + dst)) return false;
+        offset += size;
+    }
+    image.byteArray = std::move(rgba);
+    image.format = PixelFormat::RGBA8_UNORM;
+    image.channelCount = 4;
+    return true;
+}
+
+bool TextureCook::writeContainer(const std::string& path, const std::vector<std::shared_ptr<Image>>& images,
+                                 uint64_t sourceHash) {
+    struct Record {
+        uint32_t index;
+        const Image* image;
+        std::vector<std::pair<uint64_t, uint64_t>> levels;// (offset, size), level 0 first
+    };
+    std::vector<Record> records;
+    size_t headerSize = 4 + 4 + 8 + 4 + 4;
+    for (size_t i = 0; i < images.size(); ++i) {
+        const Image* image = images[i].get();
+        if (!image || !isCooked(*image) || !vtexCode(image->format)) continue;
+        Record record{ static_cast<uint32_t>(i), image, {} };
+        uint64_t total = 0;
+        for (Uint32 level = 0; level < image->mipLevels; ++level) {
+            const uint64_t size = pixelFormatLevelSize(image->format, std::max(1u, image->width >> level),
+                                                       std::max(1u, image->height >> level));
+            record.levels.emplace_back(0, size);
+            total += size;
+        }
+        if (total != image->byteArray.size()) continue;// not a packed chain; leave it inline
+        headerSize += 6 * 4 + record.levels.size() * 16;
+        records.push_back(std::move(record));
+    }
+
+    // Lay the data out smallest level first.
+    size_t cursor = headerSize;
+    for (auto& record : records) {
+        for (size_t level = record.levels.size(); level-- > 0;) {
+            cursor = alignUp(cursor, 16);
+            record.levels[level].first = cursor;
+            cursor += record.levels[level].second;
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fmt::print(stderr, "texture cook: cannot write '{}'\n", path);
+        return false;
+    }
+    auto put = [&](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    out.write(kVtexMagic, sizeof(kVtexMagic));
+    put(kVtexVersion);
+    put(sourceHash);
+    put(static_cast<uint32_t>(records.size()));
+    put(uint32_t(0));
+    for (const auto& record : records) {
+        put(record.index);
+        put(vtexCode(record.image->format));
+        put(record.image->width);
+        put(record.image->height);
+        put(record.image->channelCount);
+        put(static_cast<uint32_t>(record.levels.size()));
+        for (const auto& [offset, size] : record.levels) {
+            put(offset);
+            put(size);
+        }
+    }
+    size_t written = headerSize;
+    const char zeros[16] = {};
+    for (const auto& record : records) {
+        std::vector<size_t> starts(record.levels.size(), 0);
+        for (size_t level = 1; level < record.levels.size(); ++level)
+            starts[level] = starts[level - 1] + record.levels[level - 1].second;
+        for (size_t level = record.levels.size(); level-- > 0;) {
+            const auto [offset, size] = record.levels[level];
+            out.write(zeros, static_cast<std::streamsize>(offset - written));
+            out.write(reinterpret_cast<const char*>(record.image->byteArray.data() + starts[level]),
+                      static_cast<std::streamsize>(size));
+            written = offset + size;
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool TextureCook::readContainer(const std::string& path, const std::vector<std::shared_ptr<Image>>& images,
+                                uint64_t sourceHash) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+    const std::streamsize fileSize = in.tellg();
+    if (fileSize < 0) return false;
+    std::vector<Uint8> file(static_cast<size_t>(fileSize));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(file.data()), fileSize)) return false;
+
+    size_t cursor = 0;
+    auto take = [&](auto& value) {
+        if (cursor + sizeof(value) > file.size()) return false;
+        std::memcpy(&value, file.data() + cursor, sizeof(value));
+        cursor += sizeof(value);
+        return true;
+    };
+    char magic[4];
+    uint32_t version = 0, count = 0, reserved = 0;
+    uint64_t hash = 0;
+    if (!take(magic) || std::memcmp(magic, kVtexMagic, sizeof(magic)) != 0 || !take(version) ||
+        version != kVtexVersion || !take(hash) || hash != sourceHash || !take(count) || !take(reserved)) {
+        return false;
+    }
+
+    struct Cooked {
+        Image* image;
+        PixelFormat format;
+        Uint32 channelCount;
+        Uint32 mipLevels;
+        std::vector<Uint8> bytes;
+    };
+    std::vector<Cooked> cooked;
+    for (uint32_t r = 0; r < count; ++r) {
+        uint32_t index = 0, code = 0, width = 0, height = 0, channels = 0, levels = 0;
+        if (!take(index) || !take(code) || !take(width) || !take(height) || !take(channels) || !take(levels))
+            return false;
+        const auto format = std::find_if(std::begin(kVtexFormats), std::end(kVtexFormats),
+                                         [&](const VtexFormat& f) { return f.code == code; });
+        if (index >= images.size() || !images[index] || format == std::end(kVtexFormats) || levels == 0 ||
+            levels > kVtexMaxLevels || images[index]->width != width || images[index]->height != height) {
+            return false;
+        }
+        Cooked entry{ images[index].get(), format->format, channels, levels, {} };
+        for (uint32_t level = 0; level < levels; ++level) {
+            uint64_t offset = 0, size = 0;
+            if (!take(offset) || !take(size)) return false;
+            const size_t expected = pixelFormatLevelSize(entry.format, std::max(1u, width >> level),
+                                                         std::max(1u, height >> level));
+            if (size != expected || offset > file.size() || size > file.size() - offset) return false;
+            entry.bytes.insert(entry.bytes.end(), file.begin() + static_cast<std::ptrdiff_t>(offset),
+                               file.begin() + static_cast<std::ptrdiff_t>(offset + size));
+        }
+        cooked.push_back(std::move(entry));
+    }
+
+    for (auto& entry : cooked) {
+        entry.image->byteArray = std::move(entry.bytes);
+        entry.image->format = entry.format;
+        entry.image->channelCount = entry.channelCount;
+        entry.image->mipLevels = entry.mipLevels;
+    }
+    return true;
+}
+
+} // namespace Vapor
@@ -0,0 +1,382 @@
+#include "Vapor/vfs_archive.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+
+#ifdef VAPOR_HAS_LZ4
+#include <lz4.h>
+#endif
+#ifdef VAPOR_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Vapor;
+
+namespace {
+
+constexpr char kArchiveMagic[4] = { 'V', 'P', 'A', 'K' };
+constexpr uint32_t kArchiveVersion = 1;
+constexpr uint64_t kMaxEntrySize = 1ull << 34;// sanity bound against a corrupt TOC
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t alignment;
+    uint32_t entryCount;
+    uint64_t tocOffset;
+    uint64_t tocSize;
+};
+static_assert(sizeof(ArchiveHeader) == 32);
+
+template <typename T> void appendPod(std::vector<uint8_t>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T> bool takePod(const uint8_t*& cursor, const uint8_t* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) return false;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+bool codecAvailable(VfsCodec codec) {
+    switch (codec) {
+    case VfsCodec::None:
+        return true;
+#ifdef VAPOR_HAS_LZ4
+    case VfsCodec::LZ4:
+        return true;
+#endif
+#ifdef VAPOR_HAS_ZSTD
+    case VfsCodec::Zstd:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+// Empty when the codec doesn't shrink `data` by at least 1/8 (stored raw then).
+std::vector<uint8_t> compress(VfsCodec codec, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out;
+    size_t written = 0;
+    switch (codec) {
+#ifdef VAPOR_HAS_LZ4
+    case VfsCodec::LZ4: {
+        if (data.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) return {};
+        out.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(data.size()))));
+        const int n = LZ4_compress_default(reinterpret_cast<const char*>(data.data()),
+                                           reinterpret_cast<char*>(out.data()), static_cast<int>(data.size()),
+                                           static_cast<int>(out.size()));
+        written = n > 0 ? static_cast<size_t>(n) : 0;
+        break;
+    }
+#endif
+#ifdef VAPOR_HAS_ZSTD
+    case VfsCodec::Zstd: {
+        out.resize(ZSTD_compressBound(data.size()));
+        const size_t n = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), 9);
+        written = ZSTD_isError(n) ? 0 : n;
+        break;
+    }
+#endif
+    default:
+        return {};
+    }
+    if (written == 0 || written > data.size() - data.size() / 8) return {};
+    out.resize(written);
+    return out;
+}
+
+bool decompress(VfsCodec codec, const std::vector<uint8_t>& stored, std::vector<uint8_t>& out) {
+    switch (codec) {
+#ifdef VAPOR_HAS_LZ4
+    case VfsCodec::LZ4: {
+        const int n = LZ4_decompress_safe(reinterpret_cast<const char*>(stored.data()),
+                                          reinterpret_cast<char*>(out.data()), static_cast<int>(stored.size()),
+                                          static_cast<int>(out.size()));
+        return n >= 0 && static_cast<size_t>(n) == out.size();
+    }
+#endif
+#ifdef VAPOR_HAS_ZSTD
+    case VfsCodec::Zstd: {
+        const size_t n = ZSTD_decompress(out.data(), out.size(), stored.data(), stored.size());
+        return !ZSTD_isError(n) && n == out.size();
+    }
+#endif
+    default:
+        (void)stored;
+        (void)out;
+        return false;
+    }
+}
+
+} // namespace
+
+namespace Vapor {
+
+std::optional<std::string> normalizeVfsPath(std::string_view path) {
+    std::string text(path);
+    std::replace(text.begin(), text.end(), '\\', '/');
+    const std::filesystem::path p(text);
+    if (p.has_root_path()) return std::nullopt;
+    std::string normalized = p.lexically_normal().generic_string();
+    while (!normalized.empty() && normalized.back() == '/') normalized.pop_back();
+    if (normalized == ".") normalized.clear();
+    if (normalized == ".." || normalized.rfind("../", 0) == 0) return std::nullopt;
+    return normalized;
+}
+
+std::string vfsLookupKey(std::string_view normalizedPath) {
+    std::string key(normalizedPath);
+#if defined(_WIN32) || defined(__APPLE__)
+    for (char& c : key)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+#endif
+    return key;
+}
+
+// ── VfsArchive ──────────────────────────────────────────────────────────────
+
+std::shared_ptr<VfsArchive> VfsArchive::open(const std::string& archivePath) {
+    std::ifstream in(archivePath, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        fmt::print(stderr, "[VfsArchive] cannot open '{}'\n", archivePath);
+        return nullptr;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    ArchiveHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, kArchiveMagic, sizeof(kArchiveMagic)) != 0 || header.version != kArchiveVersion
+        || header.tocOffset > fileSize || header.tocSize > fileSize - header.tocOffset) {
+        fmt::print(stderr, "[VfsArchive] '{}' is not an archive (or an older version)\n", archivePath);
+        return nullptr;
+    }
+
+    std::vector<uint8_t> toc(static_cast<size_t>(header.tocSize));
+    in.seekg(static_cast<std::streamoff>(header.tocOffset));
+    if (!in.read(reinterpret_cast<char*>(toc.data()), static_cast<std::streamsize>(toc.size()))) {
+        fmt::print(stderr, "[VfsArchive] '{}' is truncated\n", archivePath);
+        return nullptr;
+    }
+
+    std::shared_ptr<VfsArchive> archive(new VfsArchive());
+    archive->m_path = archivePath;
+    archive->m_entries.reserve(std::min<size_t>(header.entryCount, toc.size() / 32));
+    const uint8_t* cursor = toc.data();
+    const uint8_t* end = toc.data() + toc.size();
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        Entry entry;
+        uint32_t codec = 0, pathLength = 0;
+        bool ok = takePod(cursor, end, entry.offset) && takePod(cursor, end, entry.storedSize)
+                  && takePod(cursor, end, entry.size) && takePod(cursor, end, codec)
+                  && takePod(cursor, end, pathLength) && pathLength <= static_cast<size_t>(end - cursor);
+        ok = ok && entry.offset <= header.tocOffset && entry.storedSize <= header.tocOffset - entry.offset
+             && entry.size <= kMaxEntrySize && codec <= static_cast<uint32_t>(VfsCodec::Zstd);
+        if (!ok) {
+            fmt::print(stderr, "[VfsArchive] '{}' has a corrupt table of contents\n", archivePath);
+            return nullptr;
+        }
+        entry.codec = static_cast<VfsCodec>(codec);
+        entry.path.assign(reinterpret_cast<const char*>(cursor), pathLength);
+        cursor += pathLength;
+        archive->m_entries.push_back(std::move(entry));
+    }
+    std::sort(archive->m_entries.begin(), archive->m_entries.end(),
+              [](const Entry& a, const Entry& b) { return a.path < b.path; });
+    archive->m_lookup.reserve(archive->m_entries.size());
+    for (uint32_t i = 0; i < archive->m_entries.size(); ++i) {
+        const std::string& path = archive->m_entries[i].path;
+        archive->m_lookup.emplace(vfsLookupKey(path), i);
+        for (size_t slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+            archive->m_directories.insert(vfsLookupKey(std::string_view(path).substr(0, slash)));
+        }
+    }
+    archive->m_directories.insert(std::string());
+    in.close();
+
+#ifdef _WIN32
+    archive->m_file = std::fopen(archivePath.c_str(), "rb");
+    if (!archive->m_file) {
+#else
+    archive->m_fd = ::open(archivePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (archive->m_fd < 0) {
+#endif
+        fmt::print(stderr, "[VfsArchive] cannot open '{}'\n", archivePath);
+        return nullptr;
+    }
+    return archive;
+}
+
+VfsArchive::~VfsArchive() {
+#ifdef _WIN32
+    if (m_file) std::fclose(m_file);
+#else
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+}
+
+auto VfsArchive::find(std::string_view relativePath) const -> const Entry* {
+    const auto it = m_lookup.find(vfsLookupKey(relativePath));
+    return it != m_lookup.end() ? &m_entries[it->second] : nullptr;
+}
+
+bool VfsArchive::hasDirectory(std::string_view relativePath) const {
+    return m_directories.count(vfsLookupKey(relativePath)) > 0;
+}
+
+std::optional<std::vector<uint8_t>> VfsArchive::read(const Entry& entry) const {
+    if (!codecAvailable(entry.codec)) {
+        fmt::print(stderr, "[VfsArchive] '{}': '{}' uses a codec this build lacks\n", m_path, entry.path);
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> stored(static_cast<size_t>(entry.storedSize));
+#ifdef _WIN32
+    {
+        std::lock_guard<std::mutex> lock(m_readMutex);
+        if (_fseeki64(m_file, static_cast<__int64>(entry.offset), SEEK_SET) != 0
+            || std::fread(stored.data(), 1, stored.size(), m_file) != stored.size()) {
+            fmt::print(stderr, "[VfsArchive] '{}': read of '{}' failed\n", m_path, entry.path);
+            return std::nullopt;
+        }
+    }
+#else
+    // pread keeps no shared file position, so concurrent readers need no lock.
+    size_t done = 0;
+    while (done < stored.size()) {
+        const ssize_t n = ::pread(m_fd, stored.data() + done, stored.size() - done,
+                                  static_cast<off_t>(entry.offset + done));
+        if (n <= 0) {
+            fmt::print(stderr, "[VfsArchive] '{}': read of '{}' failed\n", m_path, entry.path);
+            return std::nullopt;
+        }
+        done += static_cast<size_t>(n);
+    }
+#endif
+
+    return decode(entry, std::move(stored));
+}
+
+std::optional<std::vector<uint8_t>> VfsArchive::decode(const Entry& entry, std::vector<uint8_t> stored) const {
+    if (!codecAvailable(entry.codec)) {
+        fmt::print(stderr, "[VfsArchive] '{}': '{}' uses a codec this build lacks\n", m_path, entry.path);
+        return std::nullopt;
+    }
+    if (stored.size() != entry.storedSize) {
+        fmt::print(stderr, "[VfsArchive] '{}': short read of '{}'\n", m_path, entry.path);
+        return std::nullopt;
+    }
+    if (entry.codec == VfsCodec::None) return stored;
+    std::vector<uint8_t> decoded(static_cast<size_t>(entry.size));
+    if (!decompress(entry.codec, stored, decoded)) {
+        fmt::print(stderr, "[VfsArchive] '{}': '{}' is corrupt\n", m_path, entry.path);
+        return std::nullopt;
+    }
+    return decoded;
+}
+
+// ── Writer ──────────────────────────────────────────────────────────────────
+
+bool writeVfsArchive(const std::string& archivePath, const std::string& sourceDir, const VfsArchiveOptions& options) {
+    namespace fs = std::filesystem;
+    if (!codecAvailable(options.codec)) {
+        fmt::print(stderr, "[VfsArchive] requested codec is not compiled into this build\n");
+        return false;
+    }
+    const uint64_t alignment = std::max<uint32_t>(options.alignment, 1);
+    if ((alignment & (alignment - 1)) != 0) {
+        fmt::print(stderr, "[VfsArchive] alignment {} is not a power of two\n", alignment);
+        return false;
+    }
+
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(sourceDir, fs::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        std::error_code fec;
+        if (it->is_regular_file(fec)) files.push_back(it->path().lexically_relative(sourceDir).generic_string());
+    }
+    if (ec) {
+        fmt::print(stderr, "[VfsArchive] cannot walk '{}': {}\n", sourceDir, ec.message());
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::ofstream out(archivePath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fmt::print(stderr, "[VfsArchive] cannot write '{}'\n", archivePath);
+        return false;
+    }
+    ArchiveHeader header{};
+    std::memcpy(header.magic, kArchiveMagic, sizeof(kArchiveMagic));
+    header.version = kArchiveVersion;
+    header.alignment = static_cast<uint32_t>(alignment);
+    header.entryCount = static_cast<uint32_t>(files.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<uint8_t> toc;
+    uint64_t offset = sizeof(header);
+    const char padding[256] = {};
+    for (const std::string& rel : files) {
+        std::ifstream in(fs::path(sourceDir) / rel, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) {
+            fmt::print(stderr, "[VfsArchive] cannot read '{}'\n", rel);
+            return false;
+        }
+        const std::streamoff size = in.tellg();
+        std::vector<uint8_t> data(static_cast<size_t>(std::max<std::streamoff>(size, 0)));
+        in.seekg(0);
+        // A short read would otherwise pack garbage under a valid TOC entry.
+        if (size < 0 || !in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            fmt::print(stderr, "[VfsArchive] short read of '{}'\n", rel);
+            return false;
+        }
+
+        for (uint64_t pad = (alignment - offset % alignment) % alignment; pad > 0;) {
+            const uint64_t n = std::min<uint64_t>(pad, sizeof(padding));
+            out.write(padding, static_cast<std::streamsize>(n));
+            offset += n;
+            pad -= n;
+        }
+
+        std::vector<uint8_t> packed = options.codec != VfsCodec::None ? compress(options.codec, data)
+                                                                      : std::vector<uint8_t>{};
+        const VfsCodec codec = packed.empty() ? VfsCodec::None : options.codec;
+        const std::vector<uint8_t>& stored = packed.empty() ? data : packed;
+        out.write(reinterpret_cast<const char*>(stored.data()), static_cast<std::streamsize>(stored.size()));
+
+        appendPod(toc, offset);
+        appendPod(toc, static_cast<uint64_t>(stored.size()));
+        appendPod(toc, static_cast<uint64_t>(data.size()));
+        appendPod(toc, static_cast<uint32_t>(codec));
+        appendPod(toc, static_cast<uint32_t>(rel.size()));
+        toc.insert(toc.end(), rel.begin(), rel.end());
+        offset += stored.size();
+    }
+
+    header.tocOffset = offset;
+    header.tocSize = toc.size();
+    out.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size()));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        fmt::print(stderr, "[VfsArchive] write of '{}' failed\n", archivePath);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Vapor
@@ -741,6 +741,9 @@ auto main(int argc, char* args[]) -> int {
 
     // Return (and zero-clear) particle slots when an emitter entity is destroyed.
     Vapor::ParticleEmitterSystem::attach(registry, renderer.get());
+    // Destroy a rigidbody's Jolt body with its component (entity destruction,
+    // registry snapshot restore).
+    physics->attach(registry);
 
     // Blueprint -> live entities: real hierarchy (local TRS + parent links)
     // instead of the old flatten-then-decompose-world-matrices conversion.
@@ -752,6 +755,8 @@ auto main(int argc, char* args[]) -> int {
     // lights, cameras, UI pages, particles). scene_builder.hpp is retired.
     registerAppBlueprintComponents(resourceManager);
     if (sceneBlueprint && sceneBlueprint->ok) {
+        // Decode the authored components once, now that every applier is known.
+        Vapor::resolveComponents(*sceneBlueprint);
         std::vector<entt::entity> sceneEntities;
         Vapor::instantiate(registry, *scene, *sceneBlueprint, entt::null, "", &sceneEntities);
         for (auto e : sceneEntities)// marks scene-spawned geometry for serializer
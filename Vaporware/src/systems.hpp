@@ -1,5 +1,6 @@
 #pragma once
 #include "Vapor/character_controller.hpp"
+#include "Vapor/collision_shape_cache.hpp"
 #include "Vapor/components.hpp"
 #include "Vapor/engine_core.hpp"
 #include "Vapor/fsm.hpp"
@@ -64,56 +65,53 @@ public:
         IRenderer* renderer,
         Vapor::ResourceManager* resourceManager
     ) {
-        // Collect visible sprites
-        std::vector<std::tuple<glm::mat4, Vapor::Sprite2DComponent*, entt::entity>> sprites;
-
+        // One descriptor per visible sprite, submitted in a single call; the
+        // renderer sorts them by layer/order (radix) and batches them, copying
+        // what it keeps, so the list is per call.
         auto view = reg.view<Vapor::TransformComponent, Vapor::Sprite2DComponent>(
             entt::exclude<Vapor::InactiveComponent>);
+        std::vector<Vapor::SpriteDraw2D> sprites;
+        sprites.reserve(view.size_hint());
+
+        // Sprites of one atlas tend to be adjacent in the pool; getAtlas locks
+        Vapor::AtlasHandle lastAtlasHandle;
+        const Vapor::SpriteAtlas* atlas = nullptr;
         for (auto entity : view) {
             auto& sprite = view.get<Vapor::Sprite2DComponent>(entity);
             if (!sprite.visible || !sprite.atlas.valid()) continue;
 
-            auto& transform = view.get<Vapor::TransformComponent>(entity);
-            sprites.push_back({transform.worldTransform, &sprite, entity});
-        }
-
-        // Sort by layer, then order
-        std::sort(sprites.begin(), sprites.end(), [](const auto& a, const auto& b) {
-            auto* sa = std::get<1>(a);
-            auto* sb = std::get<1>(b);
-            if (sa->sortingLayer != sb->sortingLayer) return sa->sortingLayer < sb->sortingLayer;
-            return sa->orderInLayer < sb->orderInLayer;
-        });
-
-        // Render
-        for (auto& [worldTransform, sprite, entity] : sprites) {
-            const auto* atlas = resourceManager->getAtlas(sprite->atlas);
+            if (!atlas || sprite.atlas != lastAtlasHandle) {
+                atlas = resourceManager->getAtlas(sprite.atlas);
+                lastAtlasHandle = sprite.atlas;
+            }
             if (!atlas) continue;
 
-            const auto* frame = atlas->getFrame(sprite->frameIndex);
+            const auto* frame = atlas->getFrame(sprite.frameIndex);
             if (!frame) continue;
 
-            // Build sprite transform with pivot offset
-            glm::vec2 pivotOffset = (sprite->pivot - glm::vec2(0.5f)) * sprite->size;
-            glm::mat4 spriteTransform = worldTransform;
-            spriteTransform = glm::translate(spriteTransform, glm::vec3(-pivotOffset, 0.0f));
-            spriteTransform = glm::scale(spriteTransform, glm::vec3(sprite->size, 1.0f));
+            // worldTransform * translate(-pivotOffset) * scale(size), kept
+            // as its x/y axes and origin
+            const glm::mat4& worldTransform = view.get<Vapor::TransformComponent>(entity).worldTransform;
+            glm::vec2 pivotOffset = (sprite.pivot - glm::vec2(0.5f)) * sprite.size;
 
-            // Handle flip
-            glm::vec4 uv = frame->uvRect;
-            if (sprite->flipX) std::swap(uv.x, uv.z);
-            if (sprite->flipY) std::swap(uv.y, uv.w);
-
-            // Convert uvRect to texCoords array
-            glm::vec2 texCoords[4] = {
-                {uv.x, uv.w},  // bottom-left
-                {uv.z, uv.w},  // bottom-right
-                {uv.z, uv.y},  // top-right
-                {uv.x, uv.y}   // top-left
-            };
+            Vapor::SpriteDraw2D& draw = sprites.emplace_back();
+            draw.axisX = glm::vec2(worldTransform[0]) * sprite.size.x;
+            draw.axisY = glm::vec2(worldTransform[1]) * sprite.size.y;
+            draw.origin = glm::vec3(worldTransform * glm::vec4(-pivotOffset, 0.0f, 1.0f));
+            draw.texture = atlas->texture;
 
-            renderer->drawQuad2D(spriteTransform, atlas->texture, texCoords, sprite->tint, static_cast<int>(entity));
+            // Handle flip
+            draw.uvRect = frame->uvRect;
+            if (sprite.flipX) std::swap(draw.uvRect.x, draw.uvRect.z);
+            if (sprite.flipY) std::swap(draw.uvRect.y, draw.uvRect.w);
+
+            draw.tint = sprite.tint;
+            draw.layer = sprite.sortingLayer;
+            draw.order = sprite.orderInLayer;
+            draw.entityID = static_cast<int>(entity);
         }
+
+        renderer->drawSprites2D(sprites);
     }
 };
 
@@ -271,6 +269,25 @@ public:
             rb.body = physics->createSphereBody(col.radius, transform.position, transform.rotation, rb.motionType);
             physics->addBody(rb.body, true);
         }
+        auto meshView = reg.view<
+            Vapor::RigidbodyComponent, Vapor::TransformComponent, Vapor::MeshColliderComponent,
+            Vapor::MeshRendererComponent>();
+        std::vector<glm::vec3> vertices;
+        std::vector<Uint32> indices;
+        for (auto entity : meshView) {
+            auto& transform = meshView.get<Vapor::TransformComponent>(entity);
+            auto& rb = meshView.get<Vapor::RigidbodyComponent>(entity);
+            auto& col = meshView.get<Vapor::MeshColliderComponent>(entity);
+            if (rb.body.valid()) continue;
+            Vapor::CollisionShapeCache::gatherGeometry(
+                meshView.get<Vapor::MeshRendererComponent>(entity).meshes, vertices, indices
+            );
+            if (vertices.empty()) continue;
+            rb.body = col.convex
+                          ? physics->createConvexHullBody(vertices, transform.position, transform.rotation, rb.motionType)
+                          : physics->createMeshBody(vertices, indices, transform.position, transform.rotation, rb.motionType);
+            physics->addBody(rb.body, true);
+        }
     }
 };
 
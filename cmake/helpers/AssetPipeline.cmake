@@ -56,15 +56,17 @@ function(vapor_compile_glsl_shaders TARGET SHADER_DIR)
         )
         list(APPEND _spirv_outputs ${_spirv})
 
-        # Bindless MDI variant: RHIMain.frag is compiled a second time with
-        # -DBINDLESS (material textures from the set-3 runtime descriptor array
-        # instead of per-draw set-2 slots). Needs SPIR-V 1.4+ for
+        # Bindless variants: RHIMain.frag (Bindless MDI) and RHISprite.frag
+        # (sprite batches) are compiled a second time with -DBINDLESS (textures
+        # from the set-3 runtime descriptor array instead of per-draw set-2
+        # slots) to <name>Bindless.frag.spv. Needs SPIR-V 1.4+ for
         # GL_EXT_nonuniform_qualifier's descriptor-indexing capabilities —
         # vulkan1.2 (SPIR-V 1.5) satisfies that AND stays loadable on MoltenVK's
         # 1.2 environment (descriptor indexing is core in Vulkan 1.2). See the
         # task/mesh note above for why 1.3/SPIR-V 1.6 is rejected on macOS.
-        if(_name STREQUAL "RHIMain.frag")
-            set(_bindless_spirv "${SHADER_DIR}/RHIMainBindless.frag.spv")
+        if(_name STREQUAL "RHIMain.frag" OR _name STREQUAL "RHISprite.frag")
+            string(REPLACE ".frag" "Bindless.frag.spv" _bindless_name "${_name}")
+            set(_bindless_spirv "${SHADER_DIR}/${_bindless_name}")
             add_custom_command(
                 OUTPUT  ${_bindless_spirv}
                 COMMAND ${GLSL_VALIDATOR} -V --target-env vulkan1.2 -DBINDLESS ${_glsl} -o ${_bindless_spirv}
@@ -1,11 +1,14 @@
 #include "Vapor/asset_serializer.hpp"
 #include "Vapor/graphics.hpp"
+#include "Vapor/meshlet_builder.hpp"
 #include "Vapor/scene_blueprint.hpp"
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <glm/glm.hpp>
 #include <memory>
@@ -108,6 +111,92 @@ TEST_CASE("AssetSerializer - blueprint mesh round-trip preserves meshletData",
     CHECK(loaded.meshes[0]->meshletData.lodLevelCount == 1u);
 }
 
+static std::shared_ptr<Mesh> makeBumpyGrid(int N) {
+    auto mesh = std::make_shared<Mesh>();
+    mesh->primitiveMode = PrimitiveMode::TRIANGLES;
+    for (int y = 0; y <= N; ++y)
+        for (int x = 0; x <= N; ++x) {
+            float fx = float(x) / N, fy = float(y) / N;
+            VertexData v{};
+            v.position = glm::vec3(fx, 0.05f * std::sin(fx * 9.0f) * std::cos(fy * 7.0f), fy);
+            v.uv = glm::vec2(fx, fy);
+            v.normal = glm::normalize(glm::vec3(-0.1f * fx, 1.0f, 0.1f * fy));
+            v.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+            mesh->vertices.push_back(v);
+        }
+    for (int y = 0; y < N; ++y)
+        for (int x = 0; x < N; ++x) {
+            Uint32 a = Uint32(y * (N + 1) + x), b = a + 1, c = a + N + 1, d = c + 1;
+            mesh->indices.insert(mesh->indices.end(), { a, b, d, a, d, c });
+        }
+    MeshletBuilder::build(*mesh);
+    return mesh;
+}
+
+static std::string serializeMeshes(const std::shared_ptr<Mesh>& mesh) {
+    SceneBlueprint bp;
+    bp.meshes.push_back(mesh);
+    std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+    {
+        cereal::BinaryOutputArchive out(ss);
+        AssetSerializer::serializeBlueprint(out, bp);
+    }
+    return ss.str();
+}
+
+static SceneBlueprint deserializeMeshes(const std::string& bytes) {
+    std::stringstream ss(bytes, std::ios::in | std::ios::binary);
+    cereal::BinaryInputArchive in(ss);
+    return AssetSerializer::deserializeBlueprint(in);
+}
+
+TEST_CASE("AssetSerializer - meshopt-coded mesh streams round-trip bit-exactly",
+          "[asset][serializer][blueprint]") {
+    auto mesh = makeBumpyGrid(64);
+    const std::string bytes = serializeMeshes(mesh);
+    const size_t rawBytes = mesh->vertices.size() * sizeof(VertexData) + mesh->indices.size() * sizeof(Uint32) +
+                            mesh->meshletData.meshletVertices.size() * sizeof(Uint32);
+    CHECK(bytes.size() < rawBytes);
+
+    SceneBlueprint loaded = deserializeMeshes(bytes);
+    REQUIRE(loaded.ok);
+    const Mesh& back = *loaded.meshes[0];
+    REQUIRE(back.vertices.size() == mesh->vertices.size());
+    CHECK(std::memcmp(back.vertices.data(), mesh->vertices.data(), mesh->vertices.size() * sizeof(VertexData)) == 0);
+    CHECK(back.indices == mesh->indices);
+    CHECK(back.meshletData.meshletVertices == mesh->meshletData.meshletVertices);
+    CHECK(back.meshletData.meshletTriangles == mesh->meshletData.meshletTriangles);
+    CHECK_FALSE(back.meshletData.isCompressed());
+}
+
+TEST_CASE("AssetSerializer - compressed meshes ship the packed stream and decode in source order",
+          "[asset][serializer][blueprint]") {
+    auto mesh = makeBumpyGrid(64);
+    const Mesh source = *mesh;
+    const size_t plainBytes = serializeMeshes(mesh).size();
+    MeshletBuilder::compress(*mesh);
+    REQUIRE(mesh->meshletData.isCompressed());
+    const std::string bytes = serializeMeshes(mesh);
+    CHECK(bytes.size() < plainBytes);
+
+    // The loader's decode is the reference decode of what was cooked, which
+    // is also what compress left in the cooking mesh.
+    Mesh expected = *mesh;
+    MeshletBuilder::decompress(expected);
+    REQUIRE(expected.vertices.size() == mesh->vertices.size());
+    CHECK(std::memcmp(expected.vertices.data(), mesh->vertices.data(), mesh->vertices.size() * sizeof(VertexData)) == 0);
+
+    SceneBlueprint loaded = deserializeMeshes(bytes);
+    REQUIRE(loaded.ok);
+    const Mesh& back = *loaded.meshes[0];
+    CHECK_FALSE(back.meshletData.isCompressed());
+    REQUIRE(back.vertices.size() == source.vertices.size());
+    CHECK(std::memcmp(back.vertices.data(), expected.vertices.data(), expected.vertices.size() * sizeof(VertexData)) == 0);
+    CHECK(back.indices == source.indices);
+    CHECK(back.meshletData.meshletVertices == source.meshletData.meshletVertices);
+    CHECK(back.meshletData.meshletTriangles == source.meshletData.meshletTriangles);
+}
+
 TEST_CASE("AssetSerializer - blueprint version mismatch yields ok == false",
           "[asset][serializer][blueprint]") {
     std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
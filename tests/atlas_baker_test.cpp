@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+#include "Vapor/atlas_baker.hpp"
+#include "Vapor/task_scheduler.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Vapor;
+
+// A w x h sprite with `channels` channels. With 4 channels only the inner
+// rect [bx, bx + bw) x [by, by + bh) is opaque; every texel encodes its
+// sprite and position so misplaced copies are caught.
+static std::shared_ptr<Image> makeSprite(Uint32 id, Uint32 w, Uint32 h, Uint32 channels,
+                                         Uint32 bx = 0, Uint32 by = 0, Uint32 bw = 0, Uint32 bh = 0) {
+    auto image = std::make_shared<Image>();
+    image->width = w;
+    image->height = h;
+    image->channelCount = channels;
+    image->byteArray.resize(size_t(w) * h * channels);
+    if (bw == 0) { bw = w; bh = h; }
+    for (Uint32 y = 0; y < h; ++y)
+        for (Uint32 x = 0; x < w; ++x) {
+            Uint8* p = &image->byteArray[(size_t(y) * w + x) * channels];
+            for (Uint32 c = 0; c < channels; ++c) p[c] = Uint8(id * 31 + x * 7 + y * 13 + c);
+            if (channels == 4) {
+                const bool inside = x >= bx && x < bx + bw && y >= by && y < by + bh;
+                p[3] = inside ? Uint8(1 + (x + y) % 250) : 0;
+            }
+        }
+    return image;
+}
+
+static std::vector<AtlasBaker::SpriteInput> makeSprites(size_t count) {
+    std::vector<AtlasBaker::SpriteInput> sprites;
+    for (size_t i = 0; i < count; ++i) {
+        const Uint32 w = 8 + Uint32(i * 7 % 41), h = 8 + Uint32(i * 13 % 37);
+        const Uint32 channels = i % 5 == 0 ? 3 : 4;
+        sprites.push_back({ "s" + std::to_string(i),
+                            makeSprite(Uint32(i), w, h, channels, Uint32(i % 3), Uint32(i % 4), w / 2 + 1, h / 2 + 1) });
+    }
+    return sprites;
+}
+
+// The texel the atlas must hold for a frame's (x, y), or false outside it.
+static bool expectedTexel(const Image& src, const SpriteFrame& frame, Uint32 x, Uint32 y, Uint8 out[4]) {
+    const Uint32 sx = Uint32(frame.offset.x) + x, sy = Uint32(frame.offset.y) + y;
+    const Uint8* p = &src.byteArray[(size_t(sy) * src.width + sx) * src.channelCount];
+    for (Uint32 c = 0; c < 3; ++c) out[c] = p[std::min(c, src.channelCount - 1)];
+    out[3] = src.channelCount == 4 ? p[3] : 255;
+    return true;
+}
+
+static void checkAtlas(const AtlasBaker::Result& result, const std::vector<AtlasBaker::SpriteInput>& sprites) {
+    REQUIRE(result.success);
+    const Image& atlas = *result.atlasImage;
+    REQUIRE(result.atlas.frames.size() == sprites.size());
+
+    std::vector<Uint8> covered(size_t(atlas.width) * atlas.height, 0);
+    for (const auto& sprite : sprites) {
+        const SpriteFrame* frame = result.atlas.getFrame(sprite.name);
+        REQUIRE(frame);
+        const Uint32 x0 = Uint32(frame->uvRect.x * atlas.width + 0.5f);
+        const Uint32 y0 = Uint32(frame->uvRect.y * atlas.height + 0.5f);
+        const Uint32 x1 = Uint32(frame->uvRect.z * atlas.width + 0.5f);
+        const Uint32 y1 = Uint32(frame->uvRect.w * atlas.height + 0.5f);
+        REQUIRE(x1 <= atlas.width);
+        REQUIRE(y1 <= atlas.height);
+        for (Uint32 y = y0; y < y1; ++y)
+            for (Uint32 x = x0; x < x1; ++x) {
+                REQUIRE(covered[size_t(y) * atlas.width + x]++ == 0);// no overlap
+                Uint8 want[4];
+                expectedTexel(*sprite.image, *frame, x - x0, y - y0, want);
+                const Uint8* got = &atlas.byteArray[(size_t(y) * atlas.width + x) * 4];
+                REQUIRE(std::equal(want, want + 4, got));
+            }
+    }
+}
+
+TEST_CASE("AtlasBaker - trim finds the tight alpha bounds", "[atlas_baker]") {
+    // Wider than one 16-texel scan chunk on both sides of the box.
+    auto sprites = std::vector<AtlasBaker::SpriteInput>{
+        { "wide", makeSprite(1, 70, 9, 4, 19, 2, 33, 5) },
+        { "opaque", makeSprite(2, 17, 17, 4) },
+        { "rgb", makeSprite(3, 12, 10, 3) },
+    };
+    auto empty = makeSprite(4, 40, 4, 4);
+    for (size_t i = 3; i < empty->byteArray.size(); i += 4) empty->byteArray[i] = 0;
+    sprites.push_back({ "empty", empty });
+
+    const auto result = AtlasBaker::pack(sprites);
+    checkAtlas(result, sprites);
+    const SpriteFrame* wide = result.atlas.getFrame("wide");
+    CHECK(wide->offset.x == 19.0f);
+    CHECK(wide->offset.y == 2.0f);
+    CHECK(wide->sourceSize.x == 70.0f);
+    CHECK(Uint32((wide->uvRect.z - wide->uvRect.x) * result.atlasImage->width + 0.5f) == 33);
+    CHECK(Uint32((result.atlas.getFrame("empty")->uvRect.z - result.atlas.getFrame("empty")->uvRect.x)
+                 * result.atlasImage->width + 0.5f) == 1);
+    CHECK(Uint32((result.atlas.getFrame("rgb")->uvRect.z - result.atlas.getFrame("rgb")->uvRect.x)
+                 * result.atlasImage->width + 0.5f) == 12);
+}
+
+TEST_CASE("AtlasBaker - many sprites pack without overlap into an estimated size", "[atlas_baker]") {
+    const auto sprites = makeSprites(600);
+    const auto result = AtlasBaker::pack(sprites, 4096, 1, true);
+    checkAtlas(result, sprites);
+
+    // The estimate lands on the smallest power-of-two size that fits, or
+    // one step above it: never a square much larger than the content.
+    const Image& atlas = *result.atlasImage;
+    CHECK((atlas.width == atlas.height || atlas.width == atlas.height * 2));
+    CHECK(atlas.width <= 1024);
+
+    // Nothing fits below the largest sprite.
+    CHECK_FALSE(AtlasBaker::pack(sprites, 32).success);
+}
+
+TEST_CASE("AtlasBaker - parallel bake matches the serial bake", "[atlas_baker]") {
+    const auto sprites = makeSprites(300);
+    const auto serial = AtlasBaker::pack(sprites);
+
+    TaskScheduler scheduler;
+    scheduler.init(4);
+    const auto parallel = AtlasBaker::pack(sprites, 4096, 1, true, &scheduler);
+    scheduler.shutdown();
+
+    REQUIRE(parallel.success);
+    CHECK(parallel.atlasImage->byteArray == serial.atlasImage->byteArray);
+    REQUIRE(parallel.atlas.frames.size() == serial.atlas.frames.size());
+    for (size_t i = 0; i < serial.atlas.frames.size(); ++i) {
+        CHECK(parallel.atlas.frames[i].name == serial.atlas.frames[i].name);
+        CHECK(parallel.atlas.frames[i].uvRect.x == serial.atlas.frames[i].uvRect.x);
+        CHECK(parallel.atlas.frames[i].uvRect.w == serial.atlas.frames[i].uvRect.w);
+    }
+}
+
+TEST_CASE("AtlasBaker - bake cache reuses unchanged inputs", "[atlas_baker]") {
+    const auto path = (std::filesystem::temp_directory_path() / "vapor_atlas_baker_test.vatl").string();
+    std::filesystem::remove(path);
+    auto sprites = makeSprites(40);
+
+    const auto baked = AtlasBaker::packCached(path, sprites);
+    REQUIRE(baked.success);
+    REQUIRE(std::filesystem::exists(path));
+
+    const auto cached = AtlasBaker::packCached(path, sprites);
+    checkAtlas(cached, sprites);
+    CHECK(cached.atlasImage->byteArray == baked.atlasImage->byteArray);
+    CHECK(cached.atlas.size.x == baked.atlas.size.x);
+    CHECK(cached.atlas.nameToIndex == baked.atlas.nameToIndex);
+
+    // One changed texel (or setting) is a different key: re-bake.
+    const uint64_t key = AtlasBaker::inputHash(sprites, 4096, 1, true);
+    CHECK(AtlasBaker::inputHash(sprites, 4096, 2, true) != key);
+    sprites[7].image->byteArray[5] ^= 0x40;
+    CHECK(AtlasBaker::inputHash(sprites, 4096, 1, true) != key);
+    checkAtlas(AtlasBaker::packCached(path, sprites), sprites);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AtlasBaker - bake cache rejects forged headers and name splits", "[atlas_baker]") {
+    const auto path = (std::filesystem::temp_directory_path() / "vapor_atlas_baker_forged.vatl").string();
+    auto sprites = makeSprites(2);
+
+    // Moving bytes between adjacent names is a different key.
+    sprites[0].name = "ab";
+    sprites[1].name = "c";
+    const uint64_t key = AtlasBaker::inputHash(sprites, 4096, 1, true);
+    sprites[0].name = "a";
+    sprites[1].name = "bc";
+    CHECK(AtlasBaker::inputHash(sprites, 4096, 1, true) != key);
+
+    // A header with the right key but an atlas larger than maxSize is a miss,
+    // not a multi-GB allocation.
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        const uint32_t version = 1, width = 0x10000, height = 0x10000, frameCount = 2;
+        const uint64_t storedKey = AtlasBaker::inputHash(sprites, 4096, 1, true);
+        out.write("VATL", 4);
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&storedKey), sizeof(storedKey));
+        out.write(reinterpret_cast<const char*>(&width), sizeof(width));
+        out.write(reinterpret_cast<const char*>(&height), sizeof(height));
+        out.write(reinterpret_cast<const char*>(&frameCount), sizeof(frameCount));
+    }
+    const auto result = AtlasBaker::packCached(path, sprites);
+    checkAtlas(result, sprites);
+    CHECK(result.atlas.size.x <= 4096.0f);
+
+    std::filesystem::remove(path);
+}
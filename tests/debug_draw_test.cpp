@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include "Vapor/debug_draw.hpp"
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace Vapor;
+
+static const glm::quat kIdentity(1.0f, 0.0f, 0.0f, 0.0f);
+
+TEST_CASE("DebugDraw - threads record concurrently and merge at flush", "[debug_draw]") {
+    DebugDraw debugDraw;
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 500;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&debugDraw, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                const glm::vec3 p(float(t), float(i), 0.0f);
+                debugDraw.addLine(p, p + glm::vec3(1.0f), DebugColors::Red);
+                debugDraw.addSphere(p, 0.5f, DebugColors::Green);
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+
+    CHECK_FALSE(debugDraw.hasContent());// nothing is visible before flush()
+    debugDraw.flush(0.0);
+    CHECK(debugDraw.getLineVertexCount() == kThreads * kPerThread * 2);
+    CHECK(debugDraw.getInstances(DebugShape::Sphere).size() == kThreads * kPerThread);
+    CHECK(debugDraw.getInstanceCount() == kThreads * kPerThread);
+
+    // Transient commands are consumed by the flush
+    debugDraw.flush(0.1);
+    CHECK_FALSE(debugDraw.hasContent());
+}
+
+TEST_CASE("DebugDraw - shapes are instances of unit meshes", "[debug_draw]") {
+    DebugDraw debugDraw;
+    const glm::vec3 center(1.0f, 2.0f, 3.0f);
+    debugDraw.addSphere(center, 2.0f, DebugColors::White);
+    debugDraw.addCapsule(center, 3.0f, 0.5f, kIdentity, DebugColors::White);
+    debugDraw.addAABB(glm::vec3(-1.0f), glm::vec3(3.0f), DebugColors::White);
+    debugDraw.flush(0.0);
+    CHECK(debugDraw.getLineVertexCount() == 0);
+
+    // Every sphere vertex lands on the sphere
+    const DebugInstance& sphere = debugDraw.getInstances(DebugShape::Sphere).at(0);
+    const auto& sphereLines = DebugDraw::getShapeLines(DebugShape::Sphere);
+    CHECK(sphereLines.size() == 3 * DebugDraw::kSphereSegments * 2);
+    for (const DebugShapeVertex& v : sphereLines) {
+        REQUIRE(std::abs(glm::distance(DebugDraw::transformShapeVertex(sphere, v), center) - 2.0f) < 1e-4f);
+    }
+
+    // Capsule vertices are within radius of the segment between the cap centers
+    const DebugInstance& capsule = debugDraw.getInstances(DebugShape::Capsule).at(0);
+    float top = -1e9f, bottom = 1e9f;
+    for (const DebugShapeVertex& v : DebugDraw::getShapeLines(DebugShape::Capsule)) {
+        const glm::vec3 p = DebugDraw::transformShapeVertex(capsule, v) - center;
+        const float axial = std::max(std::abs(p.y) - 3.0f, 0.0f);
+        REQUIRE(std::abs(std::sqrt(p.x * p.x + p.z * p.z + axial * axial) - 0.5f) < 1e-4f);
+        top = std::max(top, p.y);
+        bottom = std::min(bottom, p.y);
+    }
+    CHECK(std::abs(top - 3.5f) < 1e-4f);
+    CHECK(std::abs(bottom + 3.5f) < 1e-4f);
+
+    // The AABB's box spans min..max
+    const DebugInstance& box = debugDraw.getInstances(DebugShape::Box).at(0);
+    const glm::vec3 corner = DebugDraw::transformShapeVertex(box, { glm::vec3(1.0f), 0.0f });
+    CHECK(glm::distance(corner, glm::vec3(3.0f)) < 1e-5f);
+}
+
+TEST_CASE("DebugDraw - other segment counts fall back to lines", "[debug_draw]") {
+    DebugDraw debugDraw;
+    debugDraw.addSphere(glm::vec3(0.0f), 1.0f, DebugColors::White, 8);
+    debugDraw.addCylinder(glm::vec3(0.0f), 1.0f, 1.0f, kIdentity, DebugColors::White, 6);
+    debugDraw.flush(0.0);
+    CHECK(debugDraw.getInstanceCount() == 0);
+    CHECK(debugDraw.getLineVertexCount() == (3 * 8 + 2 * 6 + 4) * 2);
+}
+
+TEST_CASE("DebugDraw - persistent geometry survives flushes until it expires", "[debug_draw]") {
+    DebugDraw debugDraw;
+
+    debugDraw.beginPersistent(42);
+    debugDraw.addBox(glm::vec3(0.0f), glm::vec3(1.0f), kIdentity, DebugColors::StaticBody);
+    debugDraw.addBox(glm::vec3(5.0f), glm::vec3(1.0f), kIdentity, DebugColors::StaticBody);
+    debugDraw.endPersistent();
+
+    // A timed marker drawn for 1 second, and one drawn exactly once
+    debugDraw.beginPersistent(0, 1.0f);
+    debugDraw.addCross(glm::vec3(0.0f), 1.0f, DebugColors::Yellow);
+    debugDraw.endPersistent();
+    debugDraw.beginPersistent(0, 0.0f);
+    debugDraw.addLine(glm::vec3(0.0f), glm::vec3(1.0f), DebugColors::Yellow);
+    debugDraw.endPersistent();
+    CHECK(debugDraw.getPersistentCount() == 3);
+
+    debugDraw.addSphere(glm::vec3(0.0f), 1.0f, DebugColors::Red);// transient
+    debugDraw.flush(10.0);
+    CHECK(debugDraw.getInstances(DebugShape::Box).size() == 2);
+    CHECK(debugDraw.getInstances(DebugShape::Sphere).size() == 1);
+    CHECK(debugDraw.getLineVertexCount() == 3 * 2 + 2);
+
+    debugDraw.flush(10.5);
+    CHECK(debugDraw.getInstances(DebugShape::Box).size() == 2);
+    CHECK(debugDraw.getInstances(DebugShape::Sphere).empty());
+    CHECK(debugDraw.getLineVertexCount() == 3 * 2);
+    CHECK(debugDraw.getPersistentCount() == 2);
+
+    debugDraw.flush(11.0);
+    CHECK(debugDraw.getLineVertexCount() == 0);
+    CHECK(debugDraw.getPersistentCount() == 1);
+
+    // Recording the key again replaces its geometry; clear() leaves it alone
+    debugDraw.beginPersistent(42);
+    debugDraw.addBox(glm::vec3(0.0f), glm::vec3(2.0f), kIdentity, DebugColors::StaticBody);
+    debugDraw.endPersistent();
+    debugDraw.clear();
+    debugDraw.flush(12.0);
+    CHECK(debugDraw.getInstances(DebugShape::Box).size() == 1);
+
+    debugDraw.removePersistent(42);
+    debugDraw.flush(13.0);
+    CHECK_FALSE(debugDraw.hasContent());
+}
@@ -0,0 +1,138 @@
+#include <catch2/catch_test_macros.hpp>
+#include "Vapor/dynamic_atlas.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace Vapor;
+
+// w x h RGBA block filled with one value, so copies can be traced back.
+static std::vector<Uint8> block(Uint32 w, Uint32 h, Uint8 value) {
+    return std::vector<Uint8>(size_t(w) * h * 4, value);
+}
+
+static bool overlaps(const DynamicAtlas::Region& a, const DynamicAtlas::Region& b) {
+    return a.page == b.page && a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height
+        && b.y < a.y + a.height;
+}
+
+// Every texel of the region holds value in the atlas's CPU copy.
+static bool holds(const DynamicAtlas& atlas, const DynamicAtlas::Region& r, Uint8 value) {
+    const auto& pixels = atlas.getPagePixels(r.page);
+    const Uint32 size = atlas.getDesc().pageSize;
+    for (Uint32 y = r.y; y < r.y + r.height; ++y)
+        for (Uint32 x = r.x; x < r.x + r.width; ++x)
+            for (int c = 0; c < 4; ++c)
+                if (pixels[(size_t(y) * size + x) * 4 + c] != value) return false;
+    return true;
+}
+
+TEST_CASE("SkylineAllocator - rects never overlap and stay inside the page", "[dynamic_atlas]") {
+    SkylineAllocator sky(128, 128);
+    struct Placed { Uint32 x, y, w, h; };
+    std::vector<Placed> placed;
+    for (Uint32 i = 0; i < 400; ++i) {
+        const Uint32 w = 3 + i * 7 % 13, h = 4 + i * 5 % 11;
+        Uint32 x, y;
+        if (!sky.allocate(w, h, x, y)) continue;
+        REQUIRE(x + w <= 128);
+        REQUIRE(y + h <= 128);
+        for (const Placed& p : placed)
+            REQUIRE((x >= p.x + p.w || p.x >= x + w || y >= p.y + p.h || p.y >= y + h));
+        placed.push_back({ x, y, w, h });
+    }
+    CHECK(placed.size() > 100);
+    CHECK(sky.usedArea() > 128 * 128 * 7 / 10);// glyph-like mix packs densely
+
+    Uint32 x, y;
+    CHECK_FALSE(sky.allocate(129, 1, x, y));
+    sky.clear();
+    CHECK(sky.allocate(128, 128, x, y));
+    CHECK((x == 0 && y == 0));
+}
+
+TEST_CASE("DynamicAtlas - entries are added and uploaded incrementally", "[dynamic_atlas]") {
+    DynamicAtlasDesc desc;
+    desc.pageSize = 64;
+    DynamicAtlas atlas(desc);
+
+    struct Upload { Uint32 page, x, y, w, h; size_t size; };
+    std::vector<Upload> uploads;
+    auto flush = [&] {
+        uploads.clear();
+        atlas.flushUploads([&](Uint32 page, Uint32 x, Uint32 y, Uint32 w, Uint32 h, const Uint8*, size_t size) {
+            uploads.push_back({ page, x, y, w, h, size });
+        });
+    };
+
+    const auto a = block(10, 12, 1);
+    const auto* ra = atlas.insert(1, 10, 12, a.data());
+    REQUIRE(ra);
+    CHECK(ra->uvRect.x == ra->x / 64.0f);
+    CHECK(ra->uvRect.w == (ra->y + 12) / 64.0f);
+    CHECK(holds(atlas, *ra, 1));
+
+    // A new page goes up whole, once.
+    flush();
+    REQUIRE(uploads.size() == 1);
+    CHECK((uploads[0].w == 64 && uploads[0].h == 64 && uploads[0].size == 64 * 64 * 4));
+
+    // Later entries only upload their own rect.
+    const auto b = block(5, 7, 2);
+    const auto* rb = atlas.insert(2, 5, 7, b.data());
+    REQUIRE(rb);
+    CHECK_FALSE(overlaps(*atlas.find(1), *rb));
+    flush();
+    REQUIRE(uploads.size() == 1);
+    CHECK((uploads[0].x == rb->x && uploads[0].y == rb->y && uploads[0].w == 5 && uploads[0].h == 7));
+    CHECK(uploads[0].size == 5 * 7 * 4);
+    flush();
+    CHECK(uploads.empty());
+
+    CHECK(atlas.find(3) == nullptr);
+    atlas.remove(1);
+    CHECK(atlas.find(1) == nullptr);
+    CHECK(atlas.insert(4, 65, 4, block(65, 4, 0).data()) == nullptr);// larger than a page
+}
+
+TEST_CASE("DynamicAtlas - full pages defragment the least recently used one", "[dynamic_atlas]") {
+    DynamicAtlasDesc desc;
+    desc.pageSize = 32;
+    desc.maxPages = 2;
+    desc.padding = 0;
+    desc.retainFrames = 2;
+    DynamicAtlas atlas(desc);
+    const auto pixels = block(16, 16, 0);
+
+    // Frame 1 fills page 0, frame 2 fills page 1 (4 tiles of 16x16 each).
+    for (Uint64 key = 0; key < 4; ++key) REQUIRE(atlas.insert(key, 16, 16, block(16, 16, Uint8(key)).data()));
+    atlas.beginFrame();
+    for (Uint64 key = 4; key < 8; ++key) REQUIRE(atlas.insert(key, 16, 16, pixels.data()));
+    CHECK(atlas.pageCount() == 2);
+
+    // Frames later, only key 1 of page 0 is still in use.
+    for (int i = 0; i < 3; ++i) atlas.beginFrame();
+    atlas.find(1);
+    atlas.beginFrame();
+    for (Uint64 key = 4; key < 8; ++key) atlas.find(key);// page 1 is pinned this frame
+
+    const auto* r = atlas.insert(100, 16, 16, block(16, 16, 9).data());
+    REQUIRE(r);
+    CHECK(r->page == 0);
+    CHECK(atlas.getStats().defrags == 1);
+    CHECK(atlas.getStats().evictions == 3);// keys 0, 2, 3
+    CHECK(atlas.find(0) == nullptr);
+    const auto* kept = atlas.find(1);
+    REQUIRE(kept);
+    CHECK(kept->page == 0);
+    CHECK(holds(atlas, *kept, 1));// moved with its pixels
+    CHECK(holds(atlas, *r, 9));
+    CHECK_FALSE(overlaps(*kept, *r));
+    for (Uint64 key = 4; key < 8; ++key) CHECK(atlas.find(key));
+
+    // Everything pinned this frame and no room: refuse rather than move them.
+    atlas.insert(101, 16, 16, pixels.data());
+    atlas.insert(102, 16, 16, pixels.data());
+    CHECK(atlas.insert(103, 16, 16, pixels.data()) == nullptr);
+    atlas.beginFrame();
+    CHECK(atlas.insert(103, 16, 16, pixels.data()) != nullptr);
+}
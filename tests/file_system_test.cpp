@@ -1,8 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
 #include "Vapor/file_system.hpp"
+#include "Vapor/vfs_archive.hpp"
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <stdexcept>
+#include <vector>
 
 static std::filesystem::path makeTempDir(const std::string& suffix) {
     auto p = std::filesystem::temp_directory_path() / ("vapor_fs_test_" + suffix);
@@ -14,6 +18,15 @@ static void touchFile(const std::filesystem::path& dir, const std::string& name)
     std::ofstream(dir / name);
 }
 
+static void writeText(const std::filesystem::path& file, const std::string& text) {
+    std::filesystem::create_directories(file.parent_path());
+    std::ofstream(file, std::ios::binary) << text;
+}
+
+static std::string asText(const std::optional<std::vector<uint8_t>>& bytes) {
+    return bytes ? std::string(bytes->begin(), bytes->end()) : std::string("<missing>");
+}
+
 TEST_CASE("FileSystem - resolvePath finds file in registered search path", "[filesystem]") {
     auto dir = makeTempDir("basic");
     touchFile(dir, "hello.txt");
@@ -104,3 +117,81 @@ TEST_CASE("FileSystem - initialize is idempotent", "[filesystem]") {
     FileSystem::instance().removeSearchPath(dir.string());
     std::filesystem::remove_all(dir);
 }
+
+TEST_CASE("FileSystem - index is rebuilt only when invalidated or changed", "[filesystem]") {
+    auto dir = makeTempDir("index");
+    FileSystem::instance().addSearchPath(dir.string(), 99);
+    REQUIRE_FALSE(FileSystem::instance().resolvePath("late_vapor_fs.txt").has_value());
+
+    // The index was built by the lookup above; a new file isn't seen until
+    // the index is dropped.
+    touchFile(dir, "late_vapor_fs.txt");
+    CHECK_FALSE(FileSystem::instance().exists("late_vapor_fs.txt"));
+    FileSystem::instance().invalidate();
+    CHECK(FileSystem::instance().exists("late_vapor_fs.txt"));
+
+    // pollChanges notices the directory's mtime moving. Bump it explicitly:
+    // two writes within one timestamp tick would otherwise look unchanged.
+    CHECK_FALSE(FileSystem::instance().pollChanges());
+    writeText(dir / "sub" / "later_vapor_fs.txt", "x");
+    std::filesystem::last_write_time(dir, std::filesystem::last_write_time(dir) + std::chrono::seconds(2));
+    CHECK(FileSystem::instance().pollChanges());
+    CHECK(FileSystem::instance().resolvePath("sub/later_vapor_fs.txt").has_value());
+    CHECK(FileSystem::instance().resolvePath("sub").has_value());
+
+    FileSystem::instance().removeSearchPath(dir.string());
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("FileSystem - packed archive mounts alongside search paths", "[filesystem]") {
+    auto src = makeTempDir("pack_src");
+    auto loose = makeTempDir("pack_loose");
+    const auto archive = std::filesystem::temp_directory_path() / "vapor_fs_test_pack.vpak";
+    writeText(src / "vpak_fs" / "a.txt", "archived a");
+    writeText(src / "vpak_fs" / "nested" / "b.txt", std::string(5000, 'b'));
+    writeText(loose / "vpak_fs" / "a.txt", "loose a");
+    writeText(loose / "vpak_fs" / "c.txt", "loose c");
+
+    REQUIRE(writeVfsArchive(archive.string(), src.string(), { VfsCodec::None, 64 }));
+    REQUIRE(FileSystem::instance().mountArchive(archive.string(), 50));
+    FileSystem::instance().addSearchPath(loose.string(), 60);
+
+    SECTION("Reads come from the highest-priority mount") {
+        CHECK(asText(FileSystem::instance().readFile("vpak_fs/a.txt")) == "archived a");
+        CHECK(asText(FileSystem::instance().readFile("vpak_fs/nested/b.txt")) == std::string(5000, 'b'));
+        CHECK(asText(FileSystem::instance().readFile("vpak_fs/c.txt")) == "loose c");
+        CHECK_FALSE(FileSystem::instance().readFile("vpak_fs/missing.txt").has_value());
+    }
+
+    SECTION("Archive entries exist but have no OS path") {
+        CHECK(FileSystem::instance().exists("vpak_fs/nested/b.txt"));
+        CHECK_FALSE(FileSystem::instance().resolvePath("vpak_fs/nested/b.txt").has_value());
+        // Directories only the archive holds exist too, as they would loose.
+        CHECK(FileSystem::instance().exists("vpak_fs/nested"));
+        CHECK(FileSystem::instance().exists("vpak_fs/nested/"));
+        CHECK_FALSE(FileSystem::instance().exists("vpak_fs/nest"));
+        // A lower-priority loose copy still resolves.
+        CHECK(FileSystem::instance().resolvePath("vpak_fs/a.txt").has_value());
+    }
+
+    SECTION("list merges archives and directories") {
+        CHECK(FileSystem::instance().list("vpak_fs") == std::vector<std::string>{ "vpak_fs/a.txt", "vpak_fs/c.txt" });
+        CHECK(FileSystem::instance().list("vpak_fs", "txt", 1)
+              == std::vector<std::string>{ "vpak_fs/a.txt", "vpak_fs/c.txt", "vpak_fs/nested/b.txt" });
+    }
+
+    SECTION("Entries are aligned") {
+        auto pack = VfsArchive::open(archive.string());
+        REQUIRE(pack);
+        REQUIRE(pack->getEntries().size() == 2);
+        for (const auto& entry : pack->getEntries()) CHECK(entry.offset % 64 == 0);
+    }
+
+    FileSystem::instance().unmountArchive(archive.string());
+    FileSystem::instance().removeSearchPath(loose.string());
+    CHECK_FALSE(FileSystem::instance().exists("vpak_fs/nested/b.txt"));
+    CHECK_FALSE(FileSystem::instance().exists("vpak_fs/nested"));
+    std::filesystem::remove(archive);
+    std::filesystem::remove_all(src);
+    std::filesystem::remove_all(loose);
+}
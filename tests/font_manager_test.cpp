@@ -0,0 +1,90 @@
+#include "Vapor/file_system.hpp"
+#include "Vapor/font_manager.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace Vapor;
+
+static FontHandle loadTestFont(FontManager& fonts) {
+    FileSystem::instance().initialize();
+    const std::string fontPath = "fonts/NotoSans-SemiBold.ttf";
+    if (!FileSystem::instance().resolvePath(fontPath)) {
+        SKIP("Test font not found: " << fontPath);
+    }
+    FontHandle font = fonts.loadFont(fontPath, 32.0f);
+    REQUIRE(font.isValid());
+    return font;
+}
+
+TEST_CASE("FontManager - nextCodepoint decodes UTF-8", "[font]") {
+    const std::string text = "A\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80\xC0\xAF\xE4\xB8";
+    size_t offset = 0;
+    CHECK(FontManager::nextCodepoint(text, offset) == 'A');
+    CHECK(FontManager::nextCodepoint(text, offset) == 0xE9);
+    CHECK(FontManager::nextCodepoint(text, offset) == 0x4E2D);
+    CHECK(FontManager::nextCodepoint(text, offset) == 0x1F600);
+    CHECK(offset == 10);
+    CHECK(FontManager::nextCodepoint(text, offset) == 0xFFFD);// overlong '/'
+    CHECK(FontManager::nextCodepoint(text, offset) == 0xFFFD);// truncated
+    CHECK(FontManager::nextCodepoint(text, offset) == 0xFFFD);
+    CHECK(offset == text.size());
+}
+
+TEST_CASE("FontManager - layouts are cached per font, scale and text", "[font]") {
+    FontManager fonts;
+    const FontHandle font = loadTestFont(fonts);
+    const Font* fontData = fonts.getFont(font);
+
+    const TextLayout* hello = fonts.layoutText(font, "Hello, world", 1.0f);
+    REQUIRE(hello);
+    CHECK(hello->quads.size() == 11);// the space has no quad
+    CHECK_FALSE(hello->usesGlyphAtlas);
+    CHECK(fonts.layoutText(font, "Hello, world", 1.0f) == hello);
+    const glm::vec2 helloSize = hello->size;
+    CHECK(fonts.measureText(font, "Hello, world", 1.0f) == helloSize);
+
+    // Quads follow the advances; 'H' sits on the first line
+    const Glyph* h = fonts.getGlyph(font, 'H');
+    REQUIRE(h);
+    CHECK(hello->quads[0].rect.x == h->xOffset);
+    CHECK(hello->quads[0].rect.y == h->yOffset + fontData->ascent);
+    CHECK(hello->quads[0].uv.x == h->u0);
+
+    const TextLayout* twice = fonts.layoutText(font, "Hello, world", 2.0f);
+    REQUIRE(twice);
+    CHECK(twice->size.x == helloSize.x * 2.0f);
+
+    // '\n' starts a new line at the left edge
+    const TextLayout* lines = fonts.layoutText(font, "H\nH", 1.0f);
+    REQUIRE(lines->quads.size() == 2);
+    CHECK(lines->quads[1].rect.x == lines->quads[0].rect.x);
+    CHECK(lines->quads[1].rect.y == lines->quads[0].rect.y + fontData->lineHeight);
+
+    // Per-frame strings are swept once they stop being drawn
+    for (int frame = 0; frame < 400; ++frame) fonts.beginFrame();
+    CHECK(fonts.layoutText(font, "Hello, world", 1.0f)->size == helloSize);
+}
+
+TEST_CASE("FontManager - glyphs outside the baked range use the glyph atlas", "[font]") {
+    FontManager fonts;
+    const FontHandle font = loadTestFont(fonts);
+
+    const std::string text = "\xD0\x96\xD0\xB8\xD0\xB2";// Cyrillic, not baked
+    const TextLayout* layout = fonts.layoutText(font, text, 1.0f);
+    REQUIRE(layout);
+    REQUIRE(layout->quads.size() == 3);
+    CHECK(layout->usesGlyphAtlas);
+    CHECK(layout->quads[0].atlasPage == 0);
+    CHECK(fonts.getGlyphAtlas().entryCount() == 3);
+    const glm::vec4 uv = layout->quads[0].uv;
+
+    // Drawn every frame, the glyphs stay put and the layout stays cached
+    for (int frame = 0; frame < 300; ++frame) {
+        fonts.beginFrame();
+        CHECK(fonts.layoutText(font, text, 1.0f)->quads[0].uv == uv);
+    }
+    CHECK(fonts.getGlyphAtlas().getStats().inserts == 3);
+
+    fonts.unloadFont(font);
+    CHECK(fonts.getGlyphAtlas().entryCount() == 0);
+}
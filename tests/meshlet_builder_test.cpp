@@ -1,8 +1,17 @@
 #include <catch2/catch_test_macros.hpp>
 #include "Vapor/meshlet_builder.hpp"
+#include "Vapor/meshlet_cull.hpp"
+#include "Vapor/camera.hpp"
 #include "Vapor/graphics.hpp"
 #include "Vapor/asset_serializer.hpp"
+#include "Vapor/task_scheduler.hpp"
+#include <algorithm>
+#include <array>
+#include <cfloat>
 #include <cmath>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/mat3x3.hpp>
 #include <sstream>
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/vector.hpp>
@@ -88,6 +97,176 @@ TEST_CASE("MeshletBuilder - grid produces a valid cluster-LOD DAG", "[meshlet]")
     }
 }
 
+TEST_CASE("MeshletBuilder - parallel bake matches the serial bake", "[meshlet]") {
+    Mesh serial = makeGrid(128);
+    for (VertexData& v : serial.vertices) v.uv = glm::vec2(v.position.x, v.position.z) + 0.5f;
+    Mesh parallel = serial;
+
+    MeshletBuilder::Report report;
+    MeshletBuilder::build(serial);
+    TaskScheduler scheduler;
+    scheduler.init(4);
+    MeshletBuilder::build(parallel, &scheduler, &report);
+    scheduler.shutdown();
+
+    const MeshletData& a = serial.meshletData;
+    const MeshletData& b = parallel.meshletData;
+    REQUIRE(a.lodLevelCount == b.lodLevelCount);
+    REQUIRE(a.meshlets.size() == b.meshlets.size());
+    REQUIRE(a.meshletVertices == b.meshletVertices);
+    REQUIRE(a.meshletTriangles == b.meshletTriangles);
+    for (size_t i = 0; i < a.bounds.size(); ++i) {
+        REQUIRE(a.bounds[i].group == b.bounds[i].group);
+        REQUIRE(a.bounds[i].refined == b.bounds[i].refined);
+        REQUIRE(a.bounds[i].lodError == b.bounds[i].lodError);
+        REQUIRE(a.bounds[i].parentError == b.bounds[i].parentError);
+        REQUIRE(a.bounds[i].cullSphere == b.bounds[i].cullSphere);
+        REQUIRE(a.bounds[i].coneAxisCutoff == b.bounds[i].coneAxisCutoff);
+    }
+
+    REQUIRE(report.levels.size() == b.lodLevelCount);
+    Uint32 clusters = 0;
+    for (const auto& level : report.levels) clusters += level.clusters;
+    REQUIRE(clusters == b.meshlets.size());
+    REQUIRE(report.levels[0].triangles == parallel.indices.size() / 3);
+    REQUIRE(report.levels[0].maxLodError == 0.0f);
+}
+
+// Per vertex, the step of the coarsest meshlet grid referencing it: the grid
+// compress snaps it to.
+static std::vector<float> vertexSteps(const Mesh& mesh) {
+    const MeshletData& md = mesh.meshletData;
+    std::vector<float> steps(mesh.vertices.size(), 0.0f);
+    for (size_t i = 0; i < md.meshlets.size(); ++i) {
+        const Meshlet& m = md.meshlets[i];
+        const float step = std::ldexp(1.0f, md.quantization[i].stepExponent);
+        for (Uint32 k = 0; k < m.vertexCount; ++k) {
+            float& s = steps[md.meshletVertices[m.vertexOffset + k]];
+            s = std::max(s, step);
+        }
+    }
+    return steps;
+}
+
+TEST_CASE("MeshletBuilder - compressed vertices decode within quantization error", "[meshlet][compress]") {
+    Mesh mesh = makeGrid(96);
+    for (VertexData& v : mesh.vertices) {
+        v.uv = glm::vec2(v.position.x, v.position.z) * 3.0f;
+        v.normal = glm::normalize(glm::vec3(v.position.x, 1.0f, -v.position.z));
+        v.tangent = glm::vec4(glm::normalize(glm::vec3(1.0f, -v.position.x, 0.2f)), v.position.x < 0.0f ? -1.0f : 1.0f);
+    }
+    MeshletBuilder::build(mesh);
+    const std::vector<VertexData> source = mesh.vertices;
+    MeshletBuilder::compress(mesh);
+    const MeshletData& md = mesh.meshletData;
+    REQUIRE(md.isCompressed());
+    REQUIRE(md.packedVertices.size() == source.size());
+    REQUIRE(md.quantization.size() == md.meshlets.size());
+    REQUIRE(mesh.vertices.size() == source.size());
+
+    // Every meshlet referencing a vertex carries its position exactly on its
+    // own grid, so seams and LOD borders decode to identical bits: no cracks.
+    for (size_t i = 0; i < md.meshlets.size(); ++i) {
+        const Meshlet& m = md.meshlets[i];
+        for (Uint32 k = 0; k < m.vertexCount; ++k) {
+            const VertexData& v = mesh.vertices[md.meshletVertices[m.vertexOffset + k]];
+            const PackedMeshletVertex p = MeshletBuilder::encodeVertex(v, md.quantization[i]);
+            const VertexData dec = MeshletBuilder::decodeVertex(p, md.quantization[i]);
+            REQUIRE(std::memcmp(&dec.position, &v.position, sizeof(v.position)) == 0);
+        }
+    }
+
+    const std::vector<float> steps = vertexSteps(mesh);
+    float minNormalDot = 1.0f, minTangentDot = 1.0f, maxUvError = 0.0f;
+    for (size_t v = 0; v < source.size(); ++v) {
+        const VertexData& src = source[v];
+        const VertexData& dec = mesh.vertices[v];
+        for (int axis = 0; axis < 3; ++axis)
+            REQUIRE(std::abs(dec.position[axis] - src.position[axis]) <= 0.5f * steps[v]);
+        maxUvError = std::max(maxUvError, glm::length(dec.uv - src.uv));
+        minNormalDot = std::min(minNormalDot, glm::dot(dec.normal, src.normal));
+        minTangentDot = std::min(minTangentDot, glm::dot(glm::vec3(dec.tangent), glm::vec3(src.tangent)));
+        REQUIRE(dec.tangent.w == src.tangent.w);
+    }
+    CHECK(maxUvError < 2e-3f);         // half precision over [0, 3)
+    CHECK(minNormalDot > 0.99995f);    // 12-bit octahedral
+    CHECK(minTangentDot > 0.9998f);    // 11-bit octahedral
+}
+
+TEST_CASE("MeshletBuilder - packed positions keep per-meshlet precision on a large mesh", "[meshlet][compress]") {
+    Mesh mesh = makeGrid(96);
+    for (VertexData& v : mesh.vertices) v.position *= 10000.0f;  // a 10 km tile, ~100 m cells
+    MeshletBuilder::build(mesh);
+    const std::vector<VertexData> source = mesh.vertices;
+    MeshletBuilder::compress(mesh);
+    const MeshletData& md = mesh.meshletData;
+    REQUIRE(md.isCompressed());
+
+    // Each meshlet's step follows its own bounds (15 bits across its cull
+    // sphere, rounded up to a power of two), not the mesh's.
+    std::vector<int> maxDepth(source.size(), 0);
+    for (size_t i = 0; i < md.meshlets.size(); ++i) {
+        CHECK(std::ldexp(1.0f, md.quantization[i].stepExponent) <= 4.0f * md.bounds[i].cullSphere.w / 32767.0f);
+        const Meshlet& m = md.meshlets[i];
+        for (Uint32 k = 0; k < m.vertexCount; ++k) {
+            int& d = maxDepth[md.meshletVertices[m.vertexOffset + k]];
+            d = std::max(d, md.bounds[i].depth);
+        }
+    }
+
+    // A 16-bit grid spanning the whole mesh, for scale.
+    glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+    for (const VertexData& v : source) {
+        lo = glm::min(lo, v.position);
+        hi = glm::max(hi, v.position);
+    }
+    const float meshGrid = glm::length(hi - lo) / 65535.0f;
+
+    const std::vector<float> steps = vertexSteps(mesh);
+    float fullDetailError = 0.0f;  // vertices only full-detail meshlets use
+    for (size_t v = 0; v < source.size(); ++v) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const float error = std::abs(mesh.vertices[v].position[axis] - source[v].position[axis]);
+            REQUIRE(error <= 0.5f * steps[v]);
+            if (maxDepth[v] == 0) fullDetailError = std::max(fullDetailError, error);
+        }
+    }
+    CHECK(fullDetailError < 0.25f * meshGrid);
+}
+
+TEST_CASE("MeshletBuilder - decompress restores the source vertex order", "[meshlet][compress]") {
+    Mesh mesh = makeGrid(96);
+    for (VertexData& v : mesh.vertices) {
+        v.uv = glm::vec2(v.position.x, v.position.z);
+        v.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+    }
+    MeshletBuilder::build(mesh);
+    const Mesh source = mesh;
+    MeshletBuilder::compress(mesh);
+    const Mesh cooked = mesh;
+
+    // What a load does with the cooked streams: only the full vertices are
+    // missing, and they come back in their original slots.
+    mesh.vertices.clear();
+    MeshletBuilder::decompress(mesh);
+    CHECK_FALSE(mesh.meshletData.isCompressed());
+    CHECK(mesh.meshletData.quantization.empty());
+    REQUIRE(mesh.vertices.size() == source.vertices.size());
+    CHECK(std::memcmp(mesh.vertices.data(), cooked.vertices.data(), mesh.vertices.size() * sizeof(VertexData)) == 0);
+    CHECK(mesh.indices == source.indices);
+    CHECK(mesh.meshletData.meshletVertices == source.meshletData.meshletVertices);
+    for (size_t v = 0; v < source.vertices.size(); ++v) {
+        REQUIRE(glm::length(mesh.vertices[v].position - source.vertices[v].position) < 1e-3f);
+        REQUIRE(glm::length(mesh.vertices[v].uv - source.vertices[v].uv) < 1e-3f);
+    }
+
+    // A vertex no meshlet references can't be carried: such meshes stay plain.
+    Mesh loose = source;
+    loose.vertices.push_back(VertexData{});
+    MeshletBuilder::compress(loose);
+    CHECK_FALSE(loose.meshletData.isCompressed());
+}
+
 TEST_CASE("MeshletBuilder - degenerate inputs don't crash", "[meshlet]") {
     SECTION("empty mesh") {
         Mesh mesh;
@@ -128,3 +307,81 @@ TEST_CASE("MeshletData survives a cereal round-trip", "[meshlet][serializer]") {
     // spot-check a bound field survived
     REQUIRE(rt.bounds[0].cullSphere.w == mesh.meshletData.bounds[0].cullSphere.w);
 }
+
+// Straight transliteration of Meshlet.task's per-meshlet test: the oracle the
+// CPU cull has to reproduce.
+static bool taskShaderSelects(const MeshletBounds& b, const glm::mat4& model, const MeshletCullView& view) {
+    if (view.errorThreshold < 0.0f) return true;
+    float maxScale = std::max(glm::length(glm::vec3(model[0])),
+                              std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    glm::vec3 wc = glm::vec3(model * glm::vec4(glm::vec3(b.cullSphere), 1.0f));
+    float wr = b.cullSphere.w * maxScale;
+    for (const glm::vec4& plane : view.frustumPlanes)
+        if (glm::dot(glm::vec3(plane), wc) + plane.w < -wr) return false;
+    if (b.coneAxisCutoff.w < 1.0f) {
+        glm::vec3 apexW = glm::vec3(model * glm::vec4(glm::vec3(b.coneApex), 1.0f));
+        glm::vec3 axisW = glm::normalize(glm::mat3(model) * glm::vec3(b.coneAxisCutoff));
+        if (glm::dot(glm::normalize(apexW - view.position), axisW) >= b.coneAxisCutoff.w) return false;
+    }
+    auto projectError = [&](const glm::vec4& sphere, float error) {
+        glm::vec3 c = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+        float d = std::max(glm::distance(c, view.position) - sphere.w * maxScale, view.nearPlane);
+        return error * maxScale / d * (view.projScale * 0.5f);
+    };
+    bool parentTooCoarse = projectError(b.parentSphere, b.parentError) > view.errorThreshold;
+    bool thisFineEnough = b.refined < 0 || projectError(b.lodSphere, b.lodError) <= view.errorThreshold;
+    return parentTooCoarse && thisFineEnough;
+}
+
+TEST_CASE("MeshletCull - CPU cull selects the task shader's clusters", "[meshlet][cull]") {
+    Mesh mesh = makeGrid(160);
+    MeshletBuilder::build(mesh);
+    const MeshletData& md = mesh.meshletData;
+    MeshletCullBounds soa;
+    soa.build(md.bounds);
+    REQUIRE(soa.count == md.bounds.size());
+
+    const glm::mat4 model = glm::rotate(glm::scale(glm::mat4(1.0f), glm::vec3(4.0f)), 0.3f, glm::vec3(0, 1, 0));
+    const long inputTris = long(mesh.indices.size() / 3);
+
+    long nearTris = -1, farTris = -1;
+    for (float dist : { 0.5f, 2.0f, 8.0f, 32.0f, 128.0f }) {
+        // Oblique view so the frustum clips part of the grid and some cones face away.
+        Camera camera(glm::vec3(0.6f * dist, 0.4f * dist, 1.5f), glm::vec3(0.0f), glm::vec3(0, 1, 0),
+                      glm::radians(60.0f), 16.0f / 9.0f, 0.05f, 1000.0f);
+        const MeshletCullView view = MeshletCullView::fromCamera(camera, 1.0f / 1080.0f);
+
+        std::vector<Uint32> selected;
+        MeshletCullStats stats;
+        const Uint32 n = cullMeshlets(soa, model, view, selected, 100, &stats);
+        REQUIRE(n == selected.size());
+        REQUIRE(stats.tested == md.bounds.size());
+        REQUIRE(stats.frustumCulled + stats.coneCulled + stats.lodRejected + stats.selected == stats.tested);
+
+        std::vector<Uint32> expected;
+        for (Uint32 i = 0; i < md.bounds.size(); ++i)
+            if (taskShaderSelects(md.bounds[i], model, view)) expected.push_back(100 + i);
+        REQUIRE(selected == expected);
+
+        long tris = 0;
+        for (Uint32 mi : selected) tris += md.meshlets[mi - 100].triangleCount;
+        if (nearTris < 0) nearTris = tris;
+        farTris = tris;
+    }
+    REQUIRE(farTris < nearTris);
+    REQUIRE(nearTris <= inputTris);
+
+    SECTION("negative threshold bypasses every test and expands to the full mesh") {
+        Camera camera(glm::vec3(0, 0, 5), glm::vec3(0, 0, 10));   // looking away
+        std::vector<Uint32> all;
+        cullMeshlets(soa, model, MeshletCullView::fromCamera(camera, -1.0f), all);
+        REQUIRE(all.size() == md.meshlets.size());
+
+        std::vector<Uint32> lvl0;
+        for (Uint32 mi : all)
+            if (md.bounds[mi].depth == 0) lvl0.push_back(mi);
+        std::vector<Uint32> indices;
+        appendMeshletTriangles(md, lvl0.data(), lvl0.size(), indices);
+        REQUIRE(long(indices.size()) == inputTris * 3);
+    }
+}
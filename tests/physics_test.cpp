@@ -1,9 +1,24 @@
+#include <Vapor/character_controller.hpp>
+#include <Vapor/collision_shape_cache.hpp>
+#include <Vapor/components.hpp>
+#include <Vapor/fluid_volume.hpp>
+#include <Vapor/input_manager.hpp>
+#include <Vapor/lockstep.hpp>
 #include <Vapor/physics_3d.hpp>
+#include <Vapor/registry_snapshot.hpp>
+#include <Vapor/rng.hpp>
 #include <Vapor/task_scheduler.hpp>
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
 using namespace Vapor;
 using Catch::Approx;
 
@@ -22,6 +37,31 @@ TEST_CASE("Physics3D Combined Tests", "[physics]") {
         physics.destroyBody(body);
     }
 
+    SECTION("Stale Handles") {
+        BodyHandle first = physics.createSphereBody(0.5f, { 0, 0, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        physics.addBody(first, true);
+        const JPH::BodyID firstID = physics.getBodyID(first);
+        REQUIRE(physics.isValid(first));
+        REQUIRE(physics.getBodyHandle(firstID) == first);
+
+        physics.destroyBody(first);
+        REQUIRE_FALSE(physics.isValid(first));
+
+        // The slot is reused with a new generation: the old handle stays dead.
+        BodyHandle second = physics.createBoxBody({ 1, 1, 1 }, { 3, 0, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        REQUIRE(physics.isValid(second));
+        REQUIRE_FALSE(second == first);
+        REQUIRE_FALSE(physics.isValid(first));
+        REQUIRE(physics.getPosition(first) == glm::vec3(0.0f));
+        REQUIRE(physics.getPosition(second).x == Approx(3.0f));
+        physics.setPosition(first, { 100, 100, 100 }); // ignored
+        REQUIRE(physics.getPosition(second).x == Approx(3.0f));
+        physics.destroyBody(first); // no-op
+
+        REQUIRE(physics.getBodyHandle(physics.getBodyID(second)) == second);
+        physics.destroyBody(second);
+    }
+
     SECTION("Falling Body") {
         physics.setGravity({ 0, -10.0f, 0 });
 
@@ -40,6 +80,552 @@ TEST_CASE("Physics3D Combined Tests", "[physics]") {
         physics.destroyBody(body);
     }
 
+    SECTION("Batched Transform Sync") {
+        physics.setGravity({ 0, -10.0f, 0 });
+
+        entt::registry reg;
+        std::vector<entt::entity> falling;
+        for (int i = 0; i < 600; ++i) {
+            glm::vec3 start(float(i % 30) * 3.0f, 10.0f, float(i / 30) * 3.0f);
+            BodyHandle body =
+                physics.createSphereBody(0.5f, start, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+            physics.addBody(body, true);
+
+            auto e = reg.create();
+            reg.emplace<RigidbodyComponent>(e).body = body;
+            reg.emplace<TransformComponent>(e).position = start;
+            falling.push_back(e);
+        }
+
+        // Never activated: not on the active list, but its pose still syncs once.
+        BodyHandle sleeper =
+            physics.createSphereBody(0.5f, { -10, 10, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        physics.addBody(sleeper, false);
+        auto sleeperEntity = reg.create();
+        reg.emplace<RigidbodyComponent>(sleeperEntity).body = sleeper;
+        reg.emplace<TransformComponent>(sleeperEntity).position = { 1, 2, 3 };
+
+        // Static bodies driven from the scene move without being woken.
+        BodyHandle wall = physics.createBoxBody({ 1, 1, 1 }, { 0, -50, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        physics.addBody(wall, false);
+        auto wallEntity = reg.create();
+        auto& wallBody = reg.emplace<RigidbodyComponent>(wallEntity);
+        wallBody.body = wall;
+        wallBody.motionType = BodyMotionType::Static;
+        wallBody.syncToPhysics = true;
+        wallBody.syncFromPhysics = false;
+        reg.emplace<TransformComponent>(wallEntity).position = { 0, -60, 0 };
+        physics.syncToPhysics(reg);
+        REQUIRE(physics.getPosition(wall).y == Approx(-60.0f));
+        REQUIRE_FALSE(physics.isActive(wall));
+
+        for (int i = 0; i < 30; ++i) {
+            physics.process(reg, 1.0f / 60.0f);
+        }
+
+        for (auto e : falling) {
+            const auto& t = reg.get<TransformComponent>(e);
+            const glm::vec3 pos = physics.getPosition(reg.get<RigidbodyComponent>(e).body);
+            REQUIRE(t.position.y < 10.0f);
+            REQUIRE(t.position.x == Approx(pos.x));
+            REQUIRE(t.position.y == Approx(pos.y));
+            REQUIRE(t.position.z == Approx(pos.z));
+        }
+        REQUIRE(reg.get<TransformComponent>(sleeperEntity).position.x == Approx(-10.0f));
+        REQUIRE(reg.get<TransformComponent>(sleeperEntity).position.y == Approx(10.0f));
+
+        // Teleported and put back to sleep before the next sync: still written.
+        physics.setPosition(sleeper, { -10, 20, 0 });
+        physics.deactivateBody(sleeper);
+        REQUIRE_FALSE(physics.isActive(sleeper));
+        physics.syncFromPhysics(reg);
+        REQUIRE(reg.get<TransformComponent>(sleeperEntity).position.y == Approx(20.0f));
+    }
+
+    SECTION("Render Interpolation") {
+        physics.setGravity({ 0, -10.0f, 0 });
+
+        entt::registry reg;
+        auto makeBall = [&](float x, bool interpolate) {
+            BodyHandle body = physics.createSphereBody(0.5f, { x, 10, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+            physics.addBody(body, true);
+            auto e = reg.create();
+            auto& rb = reg.emplace<RigidbodyComponent>(e);
+            rb.body = body;
+            rb.interpolate = interpolate;
+            reg.emplace<TransformComponent>(e).position = { x, 10, 0 };
+            return e;
+        };
+        auto smooth = makeBall(0, true);
+        auto snapped = makeBall(5, false);
+
+        // Half a fixed step per frame: every other frame renders between two steps.
+        for (int i = 0; i < 21; ++i) {
+            physics.process(reg, 1.0f / 120.0f);
+
+            const auto& rbSmooth = reg.get<RigidbodyComponent>(smooth);
+            const auto& rbSnapped = reg.get<RigidbodyComponent>(snapped);
+            const float smoothY = reg.get<TransformComponent>(smooth).position.y;
+            REQUIRE(reg.get<TransformComponent>(snapped).position.y == Approx(physics.getPosition(rbSnapped.body).y));
+            REQUIRE(smoothY == Approx(physics.getInterpolatedPosition(rbSmooth.body).y));
+            REQUIRE(smoothY >= physics.getPosition(rbSmooth.body).y); // falling: the blend trails the latest step
+        }
+        const auto& rbSmooth = reg.get<RigidbodyComponent>(smooth);
+        REQUIRE(reg.get<TransformComponent>(smooth).position.y > physics.getPosition(rbSmooth.body).y);
+    }
+
+    SECTION("Snapshot Restore") {
+        physics.setGravity({ 0, -10.0f, 0 });
+        BodyHandle ground =
+            physics.createBoxBody({ 50, 1, 50 }, { 0, -1, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        physics.addBody(ground);
+        std::vector<BodyHandle> balls;
+        for (int i = 0; i < 50; ++i) {
+            BodyHandle ball = physics.createSphereBody(
+                0.5f, { float(i % 5) * 0.8f, 2.0f + float(i / 5), 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic
+            );
+            physics.addBody(ball, true);
+            balls.push_back(ball);
+        }
+        for (int i = 0; i < 10; ++i) physics.process(1.0f / 60.0f);
+
+        PhysicsSnapshot snapshot;
+        physics.saveState(snapshot);
+        REQUIRE_FALSE(snapshot.empty());
+        const Uint64 savedHash = physics.hashState();
+
+        auto run = [&]() {
+            physics.clearStepHashes();
+            physics.setStepHashingEnabled(true);
+            for (int i = 0; i < 60; ++i) physics.process(1.0f / 60.0f);
+            physics.setStepHashingEnabled(false);
+            return physics.getStepHashes();
+        };
+        const auto first = run();
+        const glm::vec3 firstPos = physics.getPosition(balls.back());
+        REQUIRE(first.size() == 60);
+        REQUIRE(physics.hashState() != savedHash);
+
+        REQUIRE(physics.restoreState(snapshot));
+        REQUIRE(physics.hashState() == savedHash);
+        const auto second = run();
+        REQUIRE(second.size() == first.size());
+        for (size_t i = 0; i < first.size(); ++i) {
+            REQUIRE(second[i].step == first[i].step);
+            REQUIRE(second[i].hash == first[i].hash);
+        }
+        REQUIRE(physics.getPosition(balls.back()) == firstPos);
+
+        // Only the last `window` step hashes are kept.
+        REQUIRE(physics.restoreState(snapshot));
+        physics.clearStepHashes();
+        physics.setStepHashingEnabled(true, 16);
+        for (int i = 0; i < 60; ++i) physics.process(1.0f / 60.0f);
+        physics.setStepHashingEnabled(false);
+        const auto windowed = physics.getStepHashes();
+        REQUIRE(windowed.size() == 16);
+        REQUIRE(windowed.back().step == first.back().step);
+        REQUIRE(windowed.back().hash == first.back().hash);
+        Uint64 hash = 0;
+        REQUIRE(physics.getStepHash(first[50].step, hash));
+        REQUIRE(hash == first[50].hash);
+        REQUIRE_FALSE(physics.getStepHash(first[0].step, hash));
+
+        // Delta: only the bodies awake at save time are rewound.
+        PhysicsSnapshot delta;
+        physics.applyCentralImpulse(balls.front(), { 0, 50, 0 });
+        physics.saveState(delta, PhysicsSnapshotMode::ActiveBodies);
+        const glm::vec3 deltaPos = physics.getPosition(balls.front());
+        for (int i = 0; i < 10; ++i) physics.process(1.0f / 60.0f);
+        REQUIRE(physics.restoreState(delta));
+        REQUIRE(physics.getPosition(balls.front()) == deltaPos);
+    }
+
+    SECTION("Registry Snapshot Restore") {
+        physics.setGravity({ 0, -10.0f, 0 });
+
+        entt::registry reg;
+        physics.attach(reg);
+        auto makeBall = [&](float x) {
+            auto e = reg.create();
+            reg.emplace<TransformComponent>(e).position = { x, 10, 0 };
+            auto& rb = reg.emplace<RigidbodyComponent>(e);
+            rb.interpolate = false;
+            rb.body = physics.createSphereBody(0.5f, { x, 10, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+            physics.addBody(rb.body, true);
+            return e;
+        };
+        const auto ball = makeBall(0);
+        RegistrySnapshot snapshot;
+        captureRegistry(reg, snapshot);
+
+        for (int i = 0; i < 30; ++i) physics.process(reg, 1.0f / 60.0f);
+        REQUIRE(reg.get<TransformComponent>(ball).position.y < 9.0f);
+        const BodyHandle liveBody = reg.get<RigidbodyComponent>(ball).body;
+        const BodyHandle lateBody = reg.get<RigidbodyComponent>(makeBall(5)).body;
+
+        // The clear destroyed every live body, including the one created
+        // after the snapshot; the restored rigidbody has no body yet.
+        REQUIRE(restoreRegistry(reg, snapshot));
+        REQUIRE(physics.getBodyID(liveBody).IsInvalid());
+        REQUIRE(physics.getBodyID(lateBody).IsInvalid());
+        REQUIRE_FALSE(reg.get<RigidbodyComponent>(ball).body.valid());
+        REQUIRE(reg.get<TransformComponent>(ball).position.y == Approx(10.0f));
+
+        // What the body-create system does: the new body starts at the
+        // restored pose, and a step moves on from there, not from the old pose.
+        auto& rb = reg.get<RigidbodyComponent>(ball);
+        const auto& t = reg.get<TransformComponent>(ball);
+        rb.body = physics.createSphereBody(0.5f, t.position, t.rotation, BodyMotionType::Dynamic);
+        physics.addBody(rb.body, true);
+        physics.process(reg, 1.0f / 60.0f);
+        const float y = reg.get<TransformComponent>(ball).position.y;
+        REQUIRE(y < 10.0f);
+        REQUIRE(y > 9.9f);
+        REQUIRE(y == Approx(physics.getPosition(rb.body).y));
+        const BodyHandle restoredBody = rb.body;
+        reg.clear();
+        REQUIRE(physics.getBodyID(restoredBody).IsInvalid());
+    }
+
+    SECTION("Batched Scene Queries") {
+        BodyHandle ground =
+            physics.createBoxBody({ 50, 1, 50 }, { 0, -1, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        physics.addBody(ground);
+        BodyHandle ball = physics.createSphereBody(1.0f, { 5, 1, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        physics.addBody(ball);
+        physics.process(1.0f / 60.0f); // let the broadphase see the new bodies
+
+        SceneQueryBatch batch;
+        for (int i = 0; i < 200; ++i) {
+            float x = float(i % 20) - 10.0f;
+            batch.rays.push_back({ { x, 10, 0 }, { x, -10, 0 } });
+        }
+        batch.rays.push_back({ { 0, 10, 100 }, { 0, -10, 100 } }); // misses the ground
+        batch.rays.push_back({ { 5, 10, 0 }, { 5, -10, 0 }, ball }); // ignores the ball
+        batch.sweeps.push_back({ { 5, 10, 0 }, { 5, -10, 0 }, 0.5f });
+        batch.overlaps.push_back({ OverlapQuery::Shape::Sphere, { 5, 1, 0 }, 1.5f });
+        batch.overlaps.push_back({ OverlapQuery::Shape::Box, { -20, 5, 0 }, 0.0f, { 1, 1, 1 } });
+        // Capsule lying along X above the ground: reaches the ball only when long enough.
+        const glm::quat alongX = glm::angleAxis(glm::radians(90.0f), glm::vec3(0, 0, 1));
+        batch.overlaps.push_back({ OverlapQuery::Shape::Capsule, { 0, 3, 0 }, 0.5f, {}, alongX, 1.0f });
+        batch.overlaps.push_back({ OverlapQuery::Shape::Capsule, { 0, 3, 0 }, 1.5f, {}, alongX, 4.0f });
+        physics.executeQueries(batch);
+
+        REQUIRE(batch.isResolved());
+        REQUIRE(batch.rayHits.size() == batch.rays.size());
+        for (int i = 0; i < 200; ++i) {
+            RaycastHit single;
+            bool hasHit = physics.raycast(batch.rays[i].from, batch.rays[i].to, single);
+            REQUIRE(batch.rayHits[i].hasHit == hasHit);
+            REQUIRE(batch.rayHits[i].point.y == Approx(single.point.y));
+            REQUIRE(batch.rayHits[i].hitFraction == Approx(single.hitFraction));
+        }
+        REQUIRE_FALSE(batch.rayHits[200].hasHit);
+        REQUIRE(batch.rayHits[201].body == ground);
+        REQUIRE(batch.rayHits[201].point.y == Approx(0.0f).margin(0.01f));
+
+        REQUIRE(batch.sweepHits[0].hasHit);
+        REQUIRE(batch.sweepHits[0].body == ball);
+        REQUIRE(batch.sweepHits[0].point.y == Approx(2.0f).margin(0.01f));
+        REQUIRE(batch.sweepHits[0].normal.y == Approx(1.0f).margin(0.01f));
+
+        const auto& near = batch.overlapResults[0].bodies;
+        REQUIRE(near.size() == 2);
+        REQUIRE(std::find(near.begin(), near.end(), ball) != near.end());
+        REQUIRE(batch.overlapResults[1].bodies.empty());
+        REQUIRE(batch.overlapResults[2].bodies.empty());
+        const auto& reach = batch.overlapResults[3].bodies;
+        REQUIRE(reach.size() == 1);
+        REQUIRE(reach[0] == ball);
+        const OverlapResult single = physics.overlapCapsule({ 1, 3, 0 }, { 7, 3, 0 }, 1.5f);
+        REQUIRE(single.bodies == reach);
+
+        // Reuse: clear() drops the previous results along with the queries.
+        batch.clear();
+        REQUIRE_FALSE(batch.isResolved());
+        REQUIRE(batch.rayHits.empty());
+        REQUIRE(batch.overlapResults.empty());
+        batch.rays.push_back({ { 0, 10, 100 }, { 0, -10, 100 } });
+        physics.executeQueries(batch);
+        REQUIRE(batch.rayHits.size() == 1);
+        REQUIRE(batch.sweepHits.empty());
+
+        // Deferred: nothing happens until the next process().
+        SceneQueryBatch deferred;
+        deferred.rays.push_back({ { 5, 10, 0 }, { 5, -10, 0 } });
+        physics.deferQueries(deferred);
+        REQUIRE_FALSE(deferred.isResolved());
+        physics.process(1.0f / 60.0f);
+        REQUIRE(deferred.isResolved());
+        REQUIRE(deferred.rayHits[0].body == ball);
+    }
+
+    SECTION("Fluid Buoyancy") {
+        physics.setGravity({ 0, -10.0f, 0 });
+
+        // Three times as dense as the (default 1000 kg/m³) bodies: they float up.
+        auto settings = FluidVolumeSettings::createWaterVolume({ 0, 0, 0 }, { 5, 5, 5 });
+        settings.density = 3000.0f;
+        auto water = std::make_shared<FluidVolume>(settings);
+        physics.registerFluidVolume(water);
+
+        BodyHandle inside = physics.createSphereBody(0.5f, { 0, -2, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        BodyHandle outside =
+            physics.createSphereBody(0.5f, { 20, -2, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        physics.addBody(inside, true);
+        physics.addBody(outside, true);
+
+        for (int i = 0; i < 30; ++i) {
+            physics.process(1.0f / 60.0f);
+        }
+
+        REQUIRE(physics.getPosition(inside).y > -2.0f);
+        REQUIRE(physics.getPosition(outside).y < -2.0f);
+
+        physics.unregisterFluidVolume(water.get()); // the body now just falls
+        glm::vec3 before = physics.getPosition(inside);
+        physics.setLinearVelocity(inside, glm::vec3(0.0f));
+        for (int i = 0; i < 30; ++i) {
+            physics.process(1.0f / 60.0f);
+        }
+        REQUIRE(physics.getPosition(inside).y < before.y);
+    }
+
+    SECTION("Fluid Buoyancy Uses The Oriented Box") {
+        physics.setGravity({ 0, -10.0f, 0 });
+
+        // A thin slab turned 45° about Y: its world AABB covers the corner
+        // at (3.5, y, 3.5), which is well outside the slab itself.
+        auto slabSettings = FluidVolumeSettings::createWaterVolume({ 0, 0, 0 }, { 5, 5, 1 });
+        slabSettings.density = 3000.0f;
+        slabSettings.rotation = glm::angleAxis(glm::radians(45.0f), glm::vec3(0, 1, 0));
+        auto slab = std::make_shared<FluidVolume>(slabSettings);
+        physics.registerFluidVolume(slab);
+
+        // A slab tilted 45° about Z: (-20, -3, 0) relative to it lies below
+        // its bottom face yet under the surface plane and inside the AABB.
+        auto tiltedSettings = FluidVolumeSettings::createWaterVolume({ -20, 0, 0 }, { 5, 1, 5 });
+        tiltedSettings.density = 3000.0f;
+        tiltedSettings.rotation = glm::angleAxis(glm::radians(45.0f), glm::vec3(0, 0, 1));
+        auto tilted = std::make_shared<FluidVolume>(tiltedSettings);
+        physics.registerFluidVolume(tilted);
+
+        BodyHandle corner =
+            physics.createSphereBody(0.5f, { 3.5f, -2, 3.5f }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        BodyHandle below =
+            physics.createSphereBody(0.5f, { -20, -3, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        BodyHandle inSlab = physics.createSphereBody(0.5f, { 0, -2, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        physics.addBody(corner, true);
+        physics.addBody(below, true);
+        physics.addBody(inSlab, true);
+
+        for (int i = 0; i < 30; ++i) {
+            physics.process(1.0f / 60.0f);
+        }
+
+        // Free fall over half a second is ~1.25 m; buoyancy would lift them.
+        REQUIRE(physics.getPosition(corner).y < -3.0f);
+        REQUIRE(physics.getPosition(below).y < -4.0f);
+        REQUIRE(physics.getPosition(inSlab).y > -2.0f);
+
+        physics.unregisterFluidVolume(slab.get());
+        physics.unregisterFluidVolume(tilted.get());
+    }
+
+    SECTION("Parallel Character Updates") {
+        BodyHandle ground =
+            physics.createBoxBody({ 50, 1, 50 }, { 0, -1, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        physics.addBody(ground);
+
+        // A spread-out crowd (one group each) plus two overlapping characters
+        // that must end up in one group and push apart.
+        std::vector<std::unique_ptr<CharacterController>> crowd;
+        for (int x = 0; x < 8; ++x) {
+            for (int z = 0; z < 8; ++z) {
+                crowd.push_back(std::make_unique<CharacterController>(&physics, CharacterControllerSettings{}));
+                crowd.back()->warp({ 10.0f + x * 3.0f, 1.0f, z * 3.0f });
+            }
+        }
+        auto& a = crowd.emplace_back(std::make_unique<CharacterController>(&physics, CharacterControllerSettings{}));
+        a->warp({ -10.0f, 1.0f, 0.0f });
+        auto& b = crowd.emplace_back(std::make_unique<CharacterController>(&physics, CharacterControllerSettings{}));
+        b->warp({ -10.2f, 1.0f, 0.0f });
+        for (auto& ctrl : crowd) physics.registerCharacterController(ctrl.get());
+
+        for (int i = 0; i < 60; ++i) {
+            physics.process(1.0f / 60.0f);
+        }
+
+        for (auto& ctrl : crowd) {
+            REQUIRE(ctrl->getPosition().y > 0.5f); // stood on the ground, didn't fall through
+        }
+        REQUIRE(glm::distance(a->getPosition(), b->getPosition()) > 0.2f);
+
+        for (auto& ctrl : crowd) physics.unregisterCharacterController(ctrl.get());
+        physics.destroyBody(ground);
+    }
+
+    SECTION("Cooked Collision Shapes") {
+        auto& cache = CollisionShapeCache::instance();
+        cache.clear();
+
+        // Unit cube: 8 corners, 12 triangles.
+        const std::vector<glm::vec3> vertices = { { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+                                                  { -1, -1, 1 },  { 1, -1, 1 },  { 1, 1, 1 },  { -1, 1, 1 } };
+        const std::vector<Uint32> indices = { 0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                                              3, 7, 6, 3, 6, 2, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5 };
+
+        BodyHandle first = physics.createMeshBody(vertices, indices, { 0, 0, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        BodyHandle second =
+            physics.createMeshBody(vertices, indices, { 5, 0, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        BodyHandle hull =
+            physics.createConvexHullBody(vertices, { 0, 5, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        REQUIRE(first.valid());
+        REQUIRE(second.valid());
+        REQUIRE(hull.valid());
+        REQUIRE(cache.size() == 2); // one mesh + one hull; the second mesh body hit
+
+        const auto path = std::filesystem::temp_directory_path() / "vapor_physics_test.vshapes";
+        const Uint64 meshKey = cache.cook(CollisionShapeCache::Kind::Mesh, vertices, indices);
+        const Uint64 hullKey = cache.cook(CollisionShapeCache::Kind::ConvexHull, vertices, {});
+        REQUIRE(meshKey != 0);
+        REQUIRE(hullKey != 0);
+        REQUIRE(cache.save(path.string(), { meshKey, hullKey }));
+
+        // Round trip: restored shapes are live without a rebuild.
+        cache.clear();
+        REQUIRE(cache.load(path.string()));
+        REQUIRE(cache.size() == 2);
+        cache.restoreAll(&scheduler);
+        REQUIRE(cache.acquire(CollisionShapeCache::Kind::Mesh, vertices, indices) != nullptr);
+        REQUIRE(cache.size() == 2);
+
+        // Trim drops the shapes no body holds: the restored hull right away,
+        // the restored mesh once its body is gone.
+        BodyHandle third =
+            physics.createMeshBody(vertices, indices, { 10, 0, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        REQUIRE(cache.trim() == 1);
+        REQUIRE(cache.size() == 1);
+        physics.destroyBody(third);
+        REQUIRE(cache.trim() == 1);
+        REQUIRE(cache.size() == 0);
+
+        physics.destroyBody(first);
+        physics.destroyBody(second);
+        physics.destroyBody(hull);
+        std::filesystem::remove(path);
+        cache.clear();
+    }
+
     physics.deinit();
     scheduler.shutdown();
 }
+
+TEST_CASE("Lockstep Record And Replay", "[physics][lockstep]") {
+    TaskScheduler scheduler;
+    scheduler.init(2);
+
+    SECTION("Clock") {
+        LockstepClock clock(60);
+        REQUIRE(clock.accumulate(1'000'000'000ull / 60 * 3 + 5) == 3);
+        REQUIRE(clock.accumulate(1'000'000'000ull) == 4); // capped; backlog dropped
+        REQUIRE(clock.accumulate(0) == 0);
+
+        // 3 Hz doesn't divide a second: the third tick is due only once a
+        // full second has been banked.
+        LockstepClock slow(3);
+        uint32_t ticks = 0;
+        for (int i = 0; i < 3; ++i) ticks += slow.accumulate(333'333'333);
+        REQUIRE(ticks == 2);
+        REQUIRE(slow.accumulate(1) == 1);
+        REQUIRE(slow.getAlpha() == 0.0f);
+    }
+
+    // The "game": a ball kicked up while Jump is held, pushed by a random
+    // wind drawn from a named RNG stream.
+    struct World {
+        Physics3D physics;
+        BodyHandle ball;
+    };
+    auto initWorld = [&](World& world) {
+        world.physics.init(scheduler);
+        world.physics.setLockstep(true);
+        BodyHandle ground =
+            world.physics.createBoxBody({ 20, 1, 20 }, { 0, -1, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Static);
+        world.physics.addBody(ground);
+        world.ball = world.physics.createSphereBody(0.5f, { 0, 1, 0 }, glm::quat(1, 0, 0, 0), BodyMotionType::Dynamic);
+        world.physics.addBody(world.ball, true);
+    };
+    auto tickWorld = [](World& world, const InputState& input) {
+        std::uniform_real_distribution<float> wind(-5.0f, 5.0f);
+        world.physics.applyCentralForce(world.ball, { wind(RngStreams::instance().stream("test.wind")), 0, 0 });
+        if (input.isHeld(InputAction::Jump)) world.physics.applyCentralImpulse(world.ball, { 0, 0.5f, 0 });
+        world.physics.process(0.0f); // lockstep: one fixed step regardless of dt
+    };
+    const uint64_t ticks = 120;
+    const auto path = std::filesystem::temp_directory_path() / "vapor_lockstep_test.vinl";
+
+    // Record
+    {
+        World world;
+        initWorld(world);
+        InputManager input;
+        InputLog log;
+        log.begin(60, 1234);
+        for (uint64_t t = 0; t < ticks; ++t) {
+            input.update(1.0f / 60.0f);
+            if (t == 10 || t == 40) {
+                SDL_Event e{};
+                e.type = t == 10 ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+                e.key.scancode = SDL_SCANCODE_SPACE;
+                input.processEvent(e);
+            }
+            tickWorld(world, input.getInputState());
+            log.record(input.captureFrame(), world.physics.hashState());
+        }
+        REQUIRE(log.getChangeCount() < ticks); // only changes are stored
+        REQUIRE(log.save(path.string()));
+        world.physics.deinit();
+    }
+
+    InputLog log;
+    REQUIRE(log.load(path.string()));
+    REQUIRE(log.getTickCount() == ticks);
+    REQUIRE(log.frameAt(10).pressed != 0);
+    REQUIRE(log.frameAt(11).pressed == 0);
+    REQUIRE(log.frameAt(20).held != 0);
+
+    SECTION("Replay matches") {
+        World world;
+        initWorld(world);
+        InputManager input;
+        ReplayResult result = replayInputLog(
+            log, input, [&](uint64_t, float) { tickWorld(world, input.getInputState()); },
+            [&] { return world.physics.hashState(); }
+        );
+        REQUIRE(result.ok());
+        REQUIRE(result.ticks == ticks);
+        world.physics.deinit();
+    }
+
+    SECTION("Desync is pinpointed") {
+        World world;
+        initWorld(world);
+        InputManager input;
+        ReplayResult result = replayInputLog(
+            log, input,
+            [&](uint64_t t, float) {
+                if (t == 50) world.physics.applyCentralImpulse(world.ball, { 1, 0, 0 });
+                tickWorld(world, input.getInputState());
+            },
+            [&] { return world.physics.hashState(); }
+        );
+        REQUIRE_FALSE(result.ok());
+        REQUIRE(result.firstDesync == 50);
+        world.physics.deinit();
+    }
+
+    std::filesystem::remove(path);
+    scheduler.shutdown();
+}
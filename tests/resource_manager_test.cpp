@@ -1,9 +1,14 @@
+#include <Vapor/async_io.hpp>
 #include <Vapor/resource_manager.hpp>
 #include <Vapor/task_scheduler.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace Vapor;
 
@@ -54,6 +59,30 @@ TEST_CASE("ResourceManager Basic Loading", "[resource]") {
     scheduler.shutdown();
 }
 
+TEST_CASE("ResourceManager reads text from a packed archive", "[resource]") {
+    namespace fs = std::filesystem;
+    const fs::path src = fs::temp_directory_path() / "vapor_rm_pack_src";
+    const fs::path archive = fs::temp_directory_path() / "vapor_rm_pack.vpak";
+    fs::create_directories(src / "rm_pack");
+    std::ofstream(src / "rm_pack" / "shader.txt", std::ios::binary) << "packed text";
+    REQUIRE(writeVfsArchive(archive.string(), src.string()));
+    fs::remove_all(src);
+    REQUIRE(FileSystem::instance().mountArchive(archive.string(), -100));
+
+    TaskScheduler scheduler;
+    scheduler.init(1);
+    {
+        ResourceManager rm(scheduler);
+        auto resource = rm.loadText("rm_pack/shader.txt", LoadMode::Sync);
+        REQUIRE(resource->isReady());
+        REQUIRE(*resource->get() == "packed text");
+    }
+    scheduler.shutdown();
+
+    FileSystem::instance().unmountArchive(archive.string());
+    fs::remove(archive);
+}
+
 TEST_CASE("ResourceManager Cache Management", "[resource]") {
     TaskScheduler scheduler;
     scheduler.init(1);
@@ -74,3 +103,190 @@ TEST_CASE("ResourceManager Cache Management", "[resource]") {
     std::filesystem::remove(testFile);
     scheduler.shutdown();
 }
+
+TEST_CASE("ResourceManager Memory Budget", "[resource]") {
+    TaskScheduler scheduler;
+    scheduler.init(1);
+    ResourceManager rm(scheduler);
+
+    const std::vector<std::string> files = { "test_budget_0.txt", "test_budget_1.txt", "test_budget_2.txt",
+                                             "test_budget_3.txt" };
+    for (const auto& file : files) {
+        std::ofstream f(file);
+        f << std::string(1000, 'x');
+    }
+
+    SECTION("Usage tracks loaded bytes") {
+        rm.loadText(files[0], LoadMode::Sync);
+        REQUIRE(rm.getTextMemoryUsage() >= 1000);
+        REQUIRE(rm.getMemoryUsage() == rm.getTextMemoryUsage());
+
+        rm.clearTextCache();
+        REQUIRE(rm.getMemoryUsage() == 0);
+    }
+
+    SECTION("Least recently used entries are evicted") {
+        rm.setMemoryBudget(2500);
+        for (const auto& file : files) rm.loadText(file, LoadMode::Sync);
+
+        REQUIRE(rm.getTextCacheSize() == 2);
+        REQUIRE(rm.getMemoryUsage() <= 2500);
+        REQUIRE(rm.getCacheStats().evictions == 2);
+        // The two most recent loads survive.
+        auto hit = rm.loadText(files[3], LoadMode::Sync);
+        REQUIRE(hit->isReady());
+        REQUIRE(rm.getCacheStats().hits == 1);
+    }
+
+    SECTION("Held resources are never evicted") {
+        rm.setMemoryBudget(2500);
+        auto pinned = rm.loadText(files[0], LoadMode::Sync);
+        for (size_t i = 1; i < files.size(); ++i) rm.loadText(files[i], LoadMode::Sync);
+
+        REQUIRE(pinned->isReady());
+        REQUIRE(rm.getTextCacheSize() == 2);
+        REQUIRE(rm.loadText(files[0], LoadMode::Sync) == pinned);
+    }
+
+    for (const auto& file : files) std::filesystem::remove(file);
+    scheduler.shutdown();
+}
+
+TEST_CASE("ResourceManager Load Priority", "[resource]") {
+    TaskScheduler scheduler;
+    scheduler.init(1);// no workers: queued loads run in waitForAll, in priority order
+    ResourceManager rm(scheduler);
+
+    const std::vector<std::string> files = { "test_prio_a.txt", "test_prio_b.txt", "test_prio_c.txt",
+                                             "test_prio_d.txt" };
+    for (const auto& file : files) {
+        std::ofstream f(file);
+        f << file;
+    }
+
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    auto record = [&](std::shared_ptr<std::string> text) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(*text);
+    };
+
+    SECTION("Higher priority runs first") {
+        for (size_t i = 0; i < 3; ++i) rm.loadText(files[i], LoadMode::Async, record, LoadPriority::Background);
+        rm.loadText(files[3], LoadMode::Async, record, LoadPriority::High);
+        rm.waitForAll();
+
+        REQUIRE(order == std::vector<std::string>{ files[3], files[0], files[1], files[2] });
+        REQUIRE_FALSE(rm.hasPendingLoads());
+    }
+
+    SECTION("Re-requesting promotes a queued load") {
+        for (size_t i = 0; i < 3; ++i) rm.loadText(files[i], LoadMode::Async, nullptr, LoadPriority::Background);
+        rm.loadText(files[2], LoadMode::Async, record, LoadPriority::High);
+        rm.loadText(files[0], LoadMode::Async, record);
+        rm.loadText(files[1], LoadMode::Async, record);
+        rm.waitForAll();
+
+        REQUIRE(order.front() == files[2]);
+        REQUIRE(order.size() == 3);
+        REQUIRE_FALSE(rm.hasPendingLoads());
+    }
+
+    for (const auto& file : files) std::filesystem::remove(file);
+    scheduler.shutdown();
+}
+
+TEST_CASE("ResourceManager Single Flight", "[resource]") {
+    TaskScheduler scheduler;
+    scheduler.init(4);
+    ResourceManager rm(scheduler);
+
+    const std::string testFile = "test_single_flight.txt";
+    {
+        std::ofstream f(testFile);
+        f << "shared";
+    }
+
+    SECTION("Concurrent requests share one load") {
+        constexpr int kThreads = 8;
+        constexpr int kRequests = 1000;
+        std::atomic<int> completions{ 0 };
+        std::vector<std::shared_ptr<Resource<std::string>>> first(kThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kRequests; ++i) {
+                    auto resource = rm.loadText(testFile, LoadMode::Async, [&](auto) { completions++; });
+                    if (i == 0) first[t] = resource;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        rm.waitForAll();
+
+        for (const auto& resource : first) REQUIRE(resource == first[0]);
+        REQUIRE(*first[0]->get() == "shared");
+        REQUIRE(rm.getTextCacheSize() == 1);
+        REQUIRE(rm.getCacheStats().misses == 1);
+        // Every subscriber ran once.
+        REQUIRE(completions.load() == kThreads * kRequests);
+    }
+
+    SECTION("Callbacks accumulate") {
+        int calls = 0;
+        auto resource = rm.loadText(testFile, LoadMode::Async, [&](auto) { ++calls; });
+        rm.loadText(testFile, LoadMode::Async, [&](auto) { ++calls; });
+        rm.waitForAll();
+        REQUIRE(resource->isReady());
+        // Subscribing after completion runs immediately.
+        resource->addCallback([&](auto) { ++calls; });
+        REQUIRE(calls == 3);
+    }
+
+    std::filesystem::remove(testFile);
+    scheduler.shutdown();
+}
+
+TEST_CASE("AsyncIo Reads", "[resource]") {
+    const std::string testFile = "test_async_io.bin";
+    {
+        std::ofstream f(testFile, std::ios::binary);
+        for (int i = 0; i < 256; ++i) f.put(static_cast<char>(i));
+    }
+
+    AsyncIo io;
+    std::mutex resultMutex;
+    std::vector<std::optional<std::vector<uint8_t>>> results(3);
+    auto store = [&](size_t slot) {
+        return [&, slot](std::optional<std::vector<uint8_t>> bytes) {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results[slot] = std::move(bytes);
+        };
+    };
+
+    io.read({ testFile }, store(0));
+    io.read({ testFile, 16, 4 }, store(1));
+    io.read({ "test_async_io_missing.bin" }, store(2));
+    io.waitIdle();
+
+    REQUIRE(io.getPendingCount() == 0);
+    REQUIRE(results[0]);
+    REQUIRE(results[0]->size() == 256);
+    REQUIRE((*results[0])[255] == 255);
+    REQUIRE(results[1]);
+    REQUIRE(*results[1] == std::vector<uint8_t>{ 16, 17, 18, 19 });
+    REQUIRE_FALSE(results[2]);
+
+    SECTION("Many reads in flight") {
+        std::atomic<int> done{ 0 };
+        for (int i = 0; i < 500; ++i) {
+            io.read({ testFile, static_cast<uint64_t>(i % 256), 1 }, [&, i](auto bytes) {
+                if (bytes && bytes->size() == 1 && (*bytes)[0] == i % 256) done++;
+            });
+        }
+        io.waitIdle();
+        REQUIRE(done.load() == 500);
+    }
+
+    std::filesystem::remove(testFile);
+}
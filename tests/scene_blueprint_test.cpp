@@ -7,6 +7,7 @@
 
 #include "Vapor/components.hpp"
 #include "Vapor/fsm.hpp"
+#include "Vapor/registry_snapshot.hpp"
 #include "Vapor/render_scene.hpp"
 #include "Vapor/scene_blueprint.hpp"
 
@@ -213,6 +214,7 @@ TEST_CASE("instantiate on a bad blueprint is a null no-op", "[scene_blueprint]")
 
 #include "Vapor/asset_serializer.hpp"
 #include "Vapor/file_system.hpp"
+#include "Vapor/vfs_archive.hpp"
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
@@ -307,6 +309,26 @@ TEST_CASE("scene cook is written, replayed and invalidated by edits", "[scene_bl
     fs::remove_all(dir);
 }
 
+TEST_CASE("scene served only from a packed archive loads", "[scene_blueprint][cook]") {
+    namespace fs = std::filesystem;
+    const fs::path src = fs::temp_directory_path() / "vapor_packed_scene_src";
+    const fs::path archive = fs::temp_directory_path() / "vapor_packed_scene.vpak";
+    fs::create_directories(src / "packed_scenes");
+    std::ofstream(src / "packed_scenes" / "level.json", std::ios::binary)
+        << R"({ "name": "packed", "entities": [ { "name": "One" }, { "name": "Two" } ] })";
+    REQUIRE(writeVfsArchive(archive.string(), src.string()));
+    fs::remove_all(src);// nothing loose left to fall back on
+    REQUIRE(FileSystem::instance().mountArchive(archive.string(), -100));
+
+    SceneBlueprint bp = loadSceneBlueprint("packed_scenes/level.json");
+    REQUIRE(bp.ok);
+    CHECK(bp.name == "packed");
+    CHECK(bp.entities.size() == 2);
+
+    FileSystem::instance().unmountArchive(archive.string());
+    fs::remove(archive);
+}
+
 // ── Components blob + material schema ───────────────────────────────────────
 
 TEST_CASE("parse stores the components blob and material declarations", "[scene_blueprint][components]") {
@@ -526,3 +548,132 @@ TEST_CASE("blueprint cook round-trips primitives (format v3)", "[scene_blueprint
     CHECK(back.entities[0].primitive.height == Catch::Approx(1.8f));
     CHECK(back.entities[0].primitive.material == 0);
 }
+
+// ── Resolved component records ──────────────────────────────────────────────
+
+#ifdef VAPOR_HAS_BOOST_PFR
+TEST_CASE("resolved records instantiate repeatedly without re-parsing", "[scene_blueprint][components]") {
+    SceneBlueprint bp = parseSceneBlueprint(R"({
+        "entities": [
+            { "name": "Lamp",
+              "components": { "sun": {}, "pointLight": { "intensity": 3 },
+                              "rigidbody": { "motionType": "kinematic" } } },
+            { "name": "Chaser", "components": { "followCamera": { "target": "Lamp" } } }
+        ]
+    })");
+    REQUIRE(bp.ok);
+    resolveComponents(bp);
+    REQUIRE(bp.entities[0].components.size() == 3);
+    CHECK(bp.componentsRevision == BlueprintComponents::instance().getRevision());
+    // The records are all instantiate() reads now.
+    for (auto& e : bp.entities) e.componentsJson = "not json";
+
+    entt::registry registry;
+    RenderScene scene("records");
+    for (int spawn = 0; spawn < 100; ++spawn) {
+        std::vector<entt::entity> created;
+        instantiate(registry, scene, bp, entt::null, "", &created);
+        REQUIRE(created.size() == 3);
+        const entt::entity lamp = created[1];
+        CHECK(registry.all_of<SunComponent>(lamp));
+        CHECK(registry.get<PointLightComponent>(lamp).intensity == Approx(3.0f));
+        CHECK(registry.get<RigidbodyComponent>(lamp).motionType == BodyMotionType::Kinematic);
+        // Entity references still resolve per batch, to this spawn's Lamp.
+        CHECK((registry.get<FollowCameraComponent>(created[2]).target == lamp));
+    }
+    CHECK(registry.storage<PointLightComponent>().size() == 100);
+}
+
+TEST_CASE("stale records fall back to resolving per instantiate", "[scene_blueprint][components]") {
+    SceneBlueprint bp = parseSceneBlueprint(R"({
+        "entities": [ { "name": "A", "components": { "pointLight": { "radius": 4 }, "testLateTag": {} } } ]
+    })");
+    REQUIRE(bp.ok);
+    resolveComponents(bp);// "testLateTag" is unknown yet: logs, dropped
+    REQUIRE(bp.entities[0].components.size() == 1);
+
+    struct TestLateTag {};
+    BlueprintComponents::instance().registerComponent<TestLateTag>("testLateTag");
+    CHECK(bp.componentsRevision != BlueprintComponents::instance().getRevision());
+
+    entt::registry registry;
+    RenderScene scene("stale");
+    std::vector<entt::entity> created;
+    instantiate(registry, scene, bp, entt::null, "", &created);
+    REQUIRE(created.size() == 2);
+    CHECK(registry.all_of<TestLateTag>(created[1]));
+    CHECK(registry.get<PointLightComponent>(created[1]).radius == Approx(4.0f));
+}
+#endif// VAPOR_HAS_BOOST_PFR
+
+// ── Registry snapshots ──────────────────────────────────────────────────────
+
+#ifdef VAPOR_HAS_BOOST_PFR
+TEST_CASE("registry snapshot restores ids, references and columns", "[scene_blueprint][snapshot]") {
+    entt::registry registry;
+    std::vector<entt::entity> entities;
+    for (int i = 0; i < 3000; ++i) {
+        const entt::entity e = registry.create();
+        registry.emplace<NameComponent>(e, NameComponent{ "e" + std::to_string(i) });
+        auto& t = registry.emplace<TransformComponent>(e);
+        t.position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+        if (i > 0) t.parent = entities[i / 2];
+        if (i % 7 == 0) registry.emplace<SunComponent>(e);
+        if (i % 5 == 0) registry.emplace<PointLightComponent>(e, PointLightComponent{ glm::vec3(1.0f), 2.0f + i, 0.5f });
+        entities.push_back(e);
+    }
+    // Holes and bumped versions in the id space.
+    for (int i = 10; i < 3000; i += 97) registry.destroy(entities[i]);
+    const entt::entity recycled = registry.create();
+    registry.emplace<NameComponent>(recycled, NameComponent{ "recycled" });
+
+    RegistrySnapshot snapshot;
+    captureRegistry(registry, snapshot);
+    REQUIRE_FALSE(snapshot.empty());
+    CHECK(snapshot.entityCount == 3000 - 31 + 1);
+
+    // Diverge, then roll back.
+    registry.get<TransformComponent>(entities[1]).position = glm::vec3(-1.0f);
+    registry.destroy(entities[2]);
+    const entt::entity extra = registry.create();
+    registry.emplace<SunComponent>(extra);
+
+    const std::string path = "test_registry_snapshot.vrs";
+    REQUIRE(snapshot.save(path));
+    RegistrySnapshot loaded;
+    REQUIRE(loaded.load(path));
+    std::remove(path.c_str());
+    REQUIRE(restoreRegistry(registry, loaded));
+
+    CHECK(registry.valid(recycled));
+    CHECK(registry.get<NameComponent>(recycled).name == "recycled");
+    CHECK_FALSE(registry.valid(extra));
+    for (int i = 0; i < 3000; ++i) {
+        const entt::entity e = entities[i];
+        if (i >= 10 && (i - 10) % 97 == 0) {
+            CHECK_FALSE(registry.valid(e));
+            continue;
+        }
+        REQUIRE(registry.valid(e));
+        CHECK(registry.get<NameComponent>(e).name == "e" + std::to_string(i));
+        const auto& t = registry.get<TransformComponent>(e);
+        CHECK(t.position.x == Approx(static_cast<float>(i)));
+        CHECK(t.parent == (i > 0 ? entities[i / 2] : entt::null));
+        CHECK(registry.all_of<SunComponent>(e) == (i % 7 == 0));
+        if (i % 5 == 0) CHECK(registry.get<PointLightComponent>(e).intensity == Approx(2.0f + i));
+    }
+}
+
+TEST_CASE("registry snapshot rejects truncated data without touching the registry", "[scene_blueprint][snapshot]") {
+    entt::registry registry;
+    const entt::entity e = registry.create();
+    registry.emplace<NameComponent>(e, NameComponent{ "keep" });
+
+    RegistrySnapshot snapshot;
+    captureRegistry(registry, snapshot);
+    snapshot.bytes.resize(snapshot.bytes.size() - 3);
+    CHECK_FALSE(restoreRegistry(registry, snapshot));
+    REQUIRE(registry.valid(e));
+    CHECK(registry.get<NameComponent>(e).name == "keep");
+}
+#endif// VAPOR_HAS_BOOST_PFR
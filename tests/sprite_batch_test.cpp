@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include "Vapor/sprite_batch.hpp"
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace Vapor;
+
+static SpriteDraw2D makeSprite(Uint32 texture, int layer, int order, int entityID) {
+    SpriteDraw2D sprite;
+    sprite.texture = TextureHandle{texture};
+    sprite.layer = layer;
+    sprite.order = order;
+    sprite.entityID = entityID;
+    return sprite;
+}
+
+TEST_CASE("SpriteBatch - radix sort orders by layer, order, then texture", "[sprite_batch]") {
+    SpriteBatch batch;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> layerDist(-3, 3), orderDist(-300, 300), textureDist(10, 15);
+
+    std::vector<SpriteDraw2D> sprites;
+    for (int i = 0; i < 20000; ++i) {
+        sprites.push_back(makeSprite(Uint32(textureDist(rng)), layerDist(rng), orderDist(rng), i));
+    }
+    batch.add(sprites);
+    batch.build(false);
+
+    // Reference: stable sort on (layer, order, table slot); slots follow first use
+    const std::vector<TextureHandle>& table = batch.getTableTextures();
+    auto slotOf = [&](TextureHandle texture) {
+        return std::find_if(table.begin(), table.end(), [&](TextureHandle t) { return t.id == texture.id; }) -
+               table.begin();
+    };
+    std::vector<SpriteDraw2D> expected = sprites;
+    std::stable_sort(expected.begin(), expected.end(), [&](const SpriteDraw2D& a, const SpriteDraw2D& b) {
+        return std::make_tuple(a.layer, a.order, slotOf(a.texture)) <
+               std::make_tuple(b.layer, b.order, slotOf(b.texture));
+    });
+
+    const std::vector<SpriteInstance>& instances = batch.getInstances();
+    REQUIRE(instances.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(instances[i].entityID == expected[i].entityID);
+    }
+
+    // Out-of-range layers clamp instead of wrapping
+    batch.clear();
+    batch.add(makeSprite(1, 100000, 0, 0));
+    batch.add(makeSprite(1, -100000, 0, 1));
+    batch.build(false);
+    CHECK(batch.getInstances()[0].entityID == 1);
+}
+
+TEST_CASE("SpriteBatch - draws split per texture run unless bindless", "[sprite_batch]") {
+    SpriteBatch batch;
+    SpriteDraw2D sprite = makeSprite(7, 0, 0, 3);
+    sprite.axisX = glm::vec2(2.0f, 0.5f);
+    sprite.axisY = glm::vec2(-0.5f, 4.0f);
+    sprite.origin = glm::vec3(10.0f, 20.0f, 0.25f);
+    sprite.uvRect = glm::vec4(0.25f, 0.5f, 0.75f, 1.0f);
+    sprite.tint = glm::vec4(0.5f);
+    batch.add(sprite);
+    batch.add(makeSprite(8, 0, 0, 4));
+    batch.add(makeSprite(7, 1, 0, 5));
+    batch.add(makeSprite(7, 1, 0, 6));
+    batch.add(makeSprite(8, 1, 0, 7));
+
+    batch.build(false);
+    CHECK_FALSE(batch.usesTextureTable());
+    const std::vector<SpriteBatch::Draw>& draws = batch.getDraws();
+    REQUIRE(draws.size() == 4);
+    CHECK(draws[0].texture.id == 7);
+    CHECK(draws[2].firstInstance == 2);
+    CHECK(draws[2].instanceCount == 2);
+    CHECK(draws[3].texture.id == 8);
+
+    // The instance carries the sprite's placement as submitted
+    const SpriteInstance& first = batch.getInstances()[0];
+    CHECK(first.axes == glm::vec4(2.0f, 0.5f, -0.5f, 4.0f));
+    CHECK(first.origin == glm::vec4(10.0f, 20.0f, 0.25f, 1.0f));
+    CHECK(first.uvRect == sprite.uvRect);
+    CHECK(first.color == sprite.tint);
+    CHECK(first.textureIndex == 0);
+
+    batch.build(true);
+    CHECK(batch.usesTextureTable());
+    REQUIRE(batch.getDraws().size() == 1);
+    CHECK(batch.getDraws()[0].instanceCount == 5);
+
+    // Table slots are sticky across frames
+    batch.clear();
+    batch.add(makeSprite(9, 0, 0, 0));
+    batch.add(makeSprite(7, 0, 0, 1));
+    batch.build(true);
+    REQUIRE(batch.getTableTextures().size() == 3);
+    CHECK(batch.getTableTextures()[2].id == 9);
+    CHECK(batch.getInstances()[0].textureIndex == 0);
+    CHECK(batch.getInstances()[1].textureIndex == 2);
+}
+
+TEST_CASE("SpriteBatch - a full texture table falls back to per-texture draws", "[sprite_batch]") {
+    SpriteBatch batch;
+    for (Uint32 t = 0; t <= SpriteBatch::kMaxTextures; ++t) batch.add(makeSprite(t, 0, 0, int(t)));
+    batch.build(true);
+    CHECK(batch.getTableTextures().size() == SpriteBatch::kMaxTextures);
+    CHECK_FALSE(batch.usesTextureTable());
+    REQUIRE(batch.getDraws().size() == SpriteBatch::kMaxTextures + 1);
+    CHECK(batch.getDraws().back().texture.id == SpriteBatch::kMaxTextures);
+
+    // Frames drawing only table textures collapse again
+    batch.clear();
+    batch.add(makeSprite(5, 0, 0, 0));
+    batch.add(makeSprite(900, 0, 0, 1));
+    batch.build(true);
+    CHECK(batch.usesTextureTable());
+    CHECK(batch.getDraws().size() == 1);
+}
+
+TEST_CASE("SpriteBatch - runs keep submission order and split draws", "[sprite_batch]") {
+    SpriteBatch batch;
+    CHECK(batch.beginRun() == 1);
+    batch.add(makeSprite(7, 5, 0, 0));
+    batch.add(makeSprite(7, 0, 0, 1));
+    CHECK(batch.beginRun() == 2);
+    batch.add(makeSprite(7, -5, 0, 2));
+    batch.add(makeSprite(8, -5, 0, 3));
+
+    // Layers sort within a run only: run 2's layer -5 still follows run 1
+    batch.build(false);
+    const std::vector<SpriteInstance>& instances = batch.getInstances();
+    REQUIRE(instances.size() == 4);
+    CHECK(instances[0].entityID == 1);
+    CHECK(instances[1].entityID == 0);
+    CHECK(instances[2].entityID == 2);
+    CHECK(instances[3].entityID == 3);
+    const std::vector<SpriteBatch::Draw>& draws = batch.getDraws();
+    REQUIRE(draws.size() == 3);
+    CHECK(draws[0].run == 1);
+    CHECK(draws[0].instanceCount == 2);
+    CHECK(draws[1].run == 2);
+    CHECK(draws[2].texture.id == 8);
+
+    // One draw per run with the texture table
+    batch.build(true);
+    REQUIRE(batch.getDraws().size() == 2);
+    CHECK(batch.getDraws()[1].firstInstance == 2);
+    CHECK(batch.getDraws()[1].run == 2);
+
+    // clear() restarts the runs
+    batch.clear();
+    CHECK(batch.beginRun() == 1);
+}
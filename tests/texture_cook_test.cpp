@@ -0,0 +1,228 @@
+#include <catch2/catch_test_macros.hpp>
+#include "Vapor/texture_cook.hpp"
+#include "Vapor/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+using namespace Vapor;
+
+// Smooth gradients plus a little noise: the content block compressors are
+// judged on (flat images would round-trip exactly and prove nothing).
+static std::shared_ptr<Image> makeColorImage(Uint32 width, Uint32 height, bool withAlpha) {
+    auto image = std::make_shared<Image>();
+    image->width = width;
+    image->height = height;
+    image->channelCount = 4;
+    image->byteArray.resize(size_t(width) * height * 4);
+    uint32_t seed = 1234;
+    for (Uint32 y = 0; y < height; ++y)
+        for (Uint32 x = 0; x < width; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const int noise = int(seed >> 29) - 4;
+            Uint8* p = &image->byteArray[(size_t(y) * width + x) * 4];
+            p[0] = Uint8(std::clamp(int(255.0f * x / width) + noise, 0, 255));
+            p[1] = Uint8(std::clamp(int(255.0f * y / height) + noise, 0, 255));
+            p[2] = Uint8(128 + int(100.0f * std::sin(x * 0.2f) * std::cos(y * 0.15f)));
+            p[3] = withAlpha ? Uint8(255.0f * (x + y) / (width + height)) : 255;
+        }
+    return image;
+}
+
+// Unit tangent-space normals of a bumpy height field, encoded 0..255.
+static std::shared_ptr<Image> makeNormalImage(Uint32 size) {
+    auto image = std::make_shared<Image>();
+    image->width = image->height = size;
+    image->channelCount = 4;
+    image->byteArray.resize(size_t(size) * size * 4);
+    for (Uint32 y = 0; y < size; ++y)
+        for (Uint32 x = 0; x < size; ++x) {
+            const float dx = 0.6f * std::cos(x * 0.3f), dy = 0.6f * std::sin(y * 0.25f);
+            const float len = std::sqrt(dx * dx + dy * dy + 1.0f);
+            const float n[3] = { -dx / len, -dy / len, 1.0f / len };
+            Uint8* p = &image->byteArray[(size_t(y) * size + x) * 4];
+            for (int c = 0; c < 3; ++c) p[c] = Uint8(std::lround((n[c] * 0.5f + 0.5f) * 255.0f));
+            p[3] = 255;
+        }
+    return image;
+}
+
+// PSNR of the first `channels` channels of level 0.
+static double psnr(const std::vector<Uint8>& a, const std::vector<Uint8>& b, size_t texels, int channels) {
+    double sum = 0.0;
+    for (size_t i = 0; i < texels; ++i)
+        for (int c = 0; c < channels; ++c) {
+            const double d = double(a[i * 4 + c]) - double(b[i * 4 + c]);
+            sum += d * d;
+        }
+    const double mse = sum / double(texels * channels);
+    return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+static size_t chainBytes(PixelFormat format, Uint32 width, Uint32 height, Uint32 levels) {
+    size_t total = 0;
+    for (Uint32 level = 0; level < levels; ++level)
+        total += pixelFormatLevelSize(format, std::max(1u, width >> level), std::max(1u, height >> level));
+    return total;
+}
+
+TEST_CASE("TextureCook - mip chain runs down to 1x1", "[texture_cook]") {
+    auto image = makeColorImage(40, 12, false);
+    for (MipFilter filter : { MipFilter::Box, MipFilter::Kaiser }) {
+        const auto levels = TextureCook::buildMipChain(image->byteArray, 40, 12, TextureCookUsage::Color, filter);
+        REQUIRE(levels.size() == 6);// 40x12, 20x6, 10x3, 5x1, 2x1, 1x1
+        CHECK(levels[0] == image->byteArray);
+        CHECK(levels[1].size() == 20 * 6 * 4);
+        CHECK(levels[3].size() == 5 * 1 * 4);
+        CHECK(levels[5].size() == 4);
+    }
+
+    // A flat image stays flat at every level (weights sum to one, even at
+    // the clamped edges and with Kaiser's negative lobes).
+    std::vector<Uint8> flat(16 * 16 * 4, 77);
+    const auto levels = TextureCook::buildMipChain(flat, 16, 16, TextureCookUsage::Data, MipFilter::Kaiser);
+    for (const auto& level : levels)
+        for (Uint8 v : level) REQUIRE(v == 77);
+}
+
+TEST_CASE("TextureCook - normal mips stay unit length", "[texture_cook]") {
+    auto image = makeNormalImage(32);
+    const auto levels =
+        TextureCook::buildMipChain(image->byteArray, 32, 32, TextureCookUsage::Normal, MipFilter::Kaiser);
+    for (size_t level = 1; level < levels.size(); ++level)
+        for (size_t i = 0; i < levels[level].size(); i += 4) {
+            float len2 = 0.0f;
+            for (int c = 0; c < 3; ++c) {
+                const float n = levels[level][i + c] / 127.5f - 1.0f;
+                len2 += n * n;
+            }
+            REQUIRE(std::abs(std::sqrt(len2) - 1.0f) < 0.02f);
+        }
+}
+
+TEST_CASE("TextureCook - BC7 / BC1 / BC5 round-trip quality", "[texture_cook]") {
+    SECTION("BC7 color with alpha") {
+        auto image = makeColorImage(64, 48, true);
+        const auto source = image->byteArray;
+        REQUIRE(TextureCook::cook(*image, TextureCookUsage::Color, {}));
+        CHECK(image->format == PixelFormat::BC7_UNORM);
+        CHECK(image->mipLevels == 7);
+        CHECK(image->byteArray.size() == chainBytes(PixelFormat::BC7_UNORM, 64, 48, 7));
+
+        REQUIRE(TextureCook::decompress(*image));
+        CHECK(image->format == PixelFormat::RGBA8_UNORM);
+        CHECK(image->mipLevels == 7);
+        CHECK(psnr(source, image->byteArray, 64 * 48, 4) > 36.0);
+    }
+    SECTION("BC1 for opaque images when allowed") {
+        auto image = makeColorImage(64, 64, false);
+        const auto source = image->byteArray;
+        TextureCookOptions options;
+        options.allowBC1 = true;
+        REQUIRE(TextureCook::cook(*image, TextureCookUsage::Color, options));
+        CHECK(image->format == PixelFormat::BC1_RGBA_UNORM);
+        CHECK(image->byteArray.size() == chainBytes(PixelFormat::BC1_RGBA_UNORM, 64, 64, 7));
+        REQUIRE(TextureCook::decompress(*image));
+        CHECK(psnr(source, image->byteArray, 64 * 64, 3) > 30.0);
+    }
+    SECTION("BC1 is never used with alpha") {
+        auto image = makeColorImage(16, 16, true);
+        TextureCookOptions options;
+        options.allowBC1 = true;
+        REQUIRE(TextureCook::cook(*image, TextureCookUsage::Color, options));
+        CHECK(image->format == PixelFormat::BC7_UNORM);
+    }
+    SECTION("BC5 normals keep xy and rebuild z") {
+        auto image = makeNormalImage(64);
+        const auto source = image->byteArray;
+        REQUIRE(TextureCook::cook(*image, TextureCookUsage::Normal, {}));
+        CHECK(image->format == PixelFormat::BC5_UNORM);
+        REQUIRE(TextureCook::decompress(*image));
+        CHECK(psnr(source, image->byteArray, 64 * 64, 2) > 40.0);
+        CHECK(psnr(source, image->byteArray, 64 * 64, 3) > 36.0);
+    }
+}
+
+TEST_CASE("TextureCook - odd sizes, gray input and re-cooks", "[texture_cook]") {
+    auto gray = std::make_shared<Image>();
+    gray->width = 5;
+    gray->height = 3;
+    gray->channelCount = 1;
+    gray->byteArray = { 0, 40, 80, 120, 160, 10, 50, 90, 130, 170, 20, 60, 100, 140, 180 };
+    REQUIRE(TextureCook::cook(*gray, TextureCookUsage::Data, {}));
+    CHECK(gray->channelCount == 4);
+    CHECK(gray->mipLevels == 3);// 5x3, 2x1, 1x1
+    CHECK(gray->byteArray.size() == chainBytes(PixelFormat::BC7_UNORM, 5, 3, 3));
+
+    // Already cooked, or the pixel count disagrees with the size: untouched.
+    CHECK_FALSE(TextureCook::cook(*gray, TextureCookUsage::Data, {}));
+    auto broken = makeColorImage(8, 8, false);
+    broken->byteArray.resize(10);
+    CHECK_FALSE(TextureCook::cook(*broken, TextureCookUsage::Color, {}));
+    CHECK(broken->byteArray.size() == 10);
+}
+
+TEST_CASE("TextureCook - parallel cook matches the serial cook", "[texture_cook]") {
+    std::vector<TextureCook::Job> serialJobs, parallelJobs;
+    for (Uint32 i = 0; i < 4; ++i) {
+        const auto usage = i == 1 ? TextureCookUsage::Normal : TextureCookUsage::Color;
+        serialJobs.push_back({ i == 1 ? makeNormalImage(48) : makeColorImage(48 + i * 8, 40, i == 2), usage });
+        parallelJobs.push_back({ std::make_shared<Image>(*serialJobs.back().image), usage });
+    }
+    TextureCook::cookAll(serialJobs, {});
+
+    TaskScheduler scheduler;
+    scheduler.init(4);
+    TextureCook::cookAll(parallelJobs, {}, &scheduler);
+    scheduler.shutdown();
+
+    for (size_t i = 0; i < serialJobs.size(); ++i) {
+        CHECK(parallelJobs[i].image->format == serialJobs[i].image->format);
+        CHECK(parallelJobs[i].image->byteArray == serialJobs[i].image->byteArray);
+    }
+}
+
+TEST_CASE("TextureCook - .vtex container round-trip", "[texture_cook]") {
+    const auto path = (std::filesystem::temp_directory_path() / "vapor_texture_cook_test.vtex").string();
+    std::vector<std::shared_ptr<Image>> images = { makeColorImage(32, 16, true), nullptr, makeNormalImage(16),
+                                                   makeColorImage(8, 8, false) };
+    REQUIRE(TextureCook::cook(*images[0], TextureCookUsage::Color, {}));
+    REQUIRE(TextureCook::cook(*images[2], TextureCookUsage::Normal, {}));
+    // images[3] stays uncooked and is not written.
+    REQUIRE(TextureCook::writeContainer(path, images, 0xC0FFEEull));
+
+    auto stubs = [&] {
+        std::vector<std::shared_ptr<Image>> out;
+        for (const auto& image : images) {
+            if (!image) {
+                out.push_back(nullptr);
+                continue;
+            }
+            auto stub = std::make_shared<Image>();
+            stub->width = image->width;
+            stub->height = image->height;
+            out.push_back(stub);
+        }
+        return out;
+    };
+
+    auto loaded = stubs();
+    REQUIRE(TextureCook::readContainer(path, loaded, 0xC0FFEEull));
+    for (size_t i : { size_t(0), size_t(2) }) {
+        CHECK(loaded[i]->format == images[i]->format);
+        CHECK(loaded[i]->mipLevels == images[i]->mipLevels);
+        CHECK(loaded[i]->byteArray == images[i]->byteArray);
+    }
+    CHECK(loaded[3]->byteArray.empty());
+
+    // A different source hash is a miss, and leaves the images alone.
+    auto stale = stubs();
+    CHECK_FALSE(TextureCook::readContainer(path, stale, 0xBADull));
+    CHECK(stale[0]->byteArray.empty());
+    CHECK_FALSE(TextureCook::readContainer(path + ".missing", stale, 0xC0FFEEull));
+
+    std::filesystem::remove(path);
+}
@@ -259,6 +259,24 @@ TEST_CASE("sparse generation matches the dense reference voxel-for-voxel", "[vox
     REQUIRE(world.droppedBricks() == 0);
 }
 
+TEST_CASE("brick-blocked kernel matches the dense reference on partial chunks", "[voxel_world]") {
+    // 96^3 leaves a half-width chunk on the +x/+z edges, and a second seed
+    // moves caves and features so the kernel's brick-level early-outs (air
+    // above the surface, cave-bound classification) meet different terrain.
+    const int N = 96;
+    const uint32_t seed = 7u;
+    VoxelWorld world;
+    makeWorld(world, N, seed);
+    std::vector<uint8_t> dense = ref::generateDense(N, seed);
+
+    size_t mismatches = 0;
+    for (int z = 0; z < N && mismatches < 16; z++)
+        for (int y = 0; y < N; y++)
+            for (int x = 0; x < N; x++)
+                if (world.voxelAt({ x, y, z }) != dense[(static_cast<size_t>(z) * N + y) * N + x]) mismatches++;
+    REQUIRE(mismatches == 0);
+}
+
 TEST_CASE("generation is deterministic per seed and diverges across seeds", "[voxel_world]") {
     VoxelWorld a;
     makeWorld(a, 64, 7u);